@@ -22,6 +22,7 @@
  */
 #include "audiobuffer.h"
 #include <utilities/bufferutility.h>
+#include <utilities/bufferpool.h>
 #include <algorithm>
 #include <string.h>
 
@@ -33,27 +34,50 @@ AudioBuffer::AudioBuffer( int aAmountOfChannels, int aBufferSize )
     amountOfChannels = aAmountOfChannels;
     bufferSize       = aBufferSize;
 
-    // create silent buffers for each channel
+    // all channels are stored in a single silent block of memory, each channel padded to keep
+    // the start of the next channel aligned. Buffers of the engines BUFFER_SIZE are
+    // rendered into frequently (by channels, synth events, etc.) and are pooled by the BufferPool
 
-    _buffers = BufferUtility::createSampleBuffers( aAmountOfChannels, aBufferSize );
+    const int alignment = MEMORY_ALIGNMENT / sizeof( SAMPLE_TYPE );
+
+    _stride  = (( aBufferSize + alignment - 1 ) / alignment ) * alignment;
+    _data    = BufferPool::allocateBuffer( aAmountOfChannels * _stride, aBufferSize == AudioEngineProps::BUFFER_SIZE );
+    _buffers = new SAMPLE_TYPE*[ std::max( 1, aAmountOfChannels ) ];
+
+    for ( int i = 0; i < aAmountOfChannels; ++i ) {
+        _buffers[ i ] = _data + i * _stride;
+    }
+}
+
+AudioBuffer::AudioBuffer()
+{
+    loopeable        = false;
+    amountOfChannels = 0;
+    bufferSize       = 0;
+    _data            = nullptr;
+    _buffers         = nullptr;
+    _stride          = 0;
 }
 
 AudioBuffer::~AudioBuffer()
 {
-    if ( _buffers != nullptr ) {
-        while ( !_buffers->empty()) {
-            delete[] _buffers->back(), _buffers->pop_back();
-        }
-        delete _buffers;
-        _buffers = nullptr;
-    }
+    BufferPool::releaseBuffer( _data, amountOfChannels * _stride );
+    _data = nullptr;
+
+    delete[] _buffers;
+    _buffers = nullptr;
 }
 
 /* public methods */
 
-SAMPLE_TYPE* AudioBuffer::getBufferForChannel( int aChannelNum )
+int AudioBuffer::getChannelStride()
+{
+    return _stride;
+}
+
+SAMPLE_TYPE AudioBuffer::readSample( int aChannelNum, int aPosition )
 {
-    return _buffers->at( aChannelNum );
+    return _buffers[ aChannelNum ][ aPosition ];
 }
 
 int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume )
@@ -79,6 +103,8 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
         if ( c > maxSourceChannel )
             break;
 
+        // source buffers that do not store SAMPLE_TYPE (e.g. CompactAudioBuffer) are read value by value
+
         SAMPLE_TYPE* srcBuffer    = aBuffer->getBufferForChannel( c );
         SAMPLE_TYPE* targetBuffer = getBufferForChannel( c );
 
@@ -91,7 +117,8 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
                 else
                     break;
             }
-            targetBuffer[ i ] += ( srcBuffer[ r ] * aMixVolume );
+            SAMPLE_TYPE sample = ( srcBuffer != nullptr ) ? srcBuffer[ r ] : aBuffer->readSample( c, r );
+            targetBuffer[ i ] += ( sample * aMixVolume );
             ++writtenSamples;
         }
     }
@@ -121,12 +148,30 @@ bool AudioBuffer::isSilent()
 void AudioBuffer::silenceBuffers()
 {
     // use memset to quickly erase existing buffer contents, zero bits should equal 0.0f
+    // when the channels are stored contiguously, these are erased at once
+
+    if ( _data != nullptr ) {
+        memset( _data, 0, ( size_t ) amountOfChannels * _stride * sizeof( SAMPLE_TYPE ));
+        return;
+    }
+
     for ( int i = 0; i < amountOfChannels; ++i )
         memset( getBufferForChannel( i ), 0, bufferSize * sizeof( SAMPLE_TYPE ));
 }
 
 void AudioBuffer::adjustBufferVolumes( SAMPLE_TYPE amp )
 {
+    // when the channels are stored contiguously, these are processed in a single loop
+    // (the padding between channels is never read)
+
+    if ( _data != nullptr )
+    {
+        for ( int i = 0, l = amountOfChannels * _stride; i < l; ++i )
+            _data[ i ] *= amp;
+
+        return;
+    }
+
     for ( int i = 0; i < amountOfChannels; ++i )
     {
         SAMPLE_TYPE* buffer = getBufferForChannel( i );
@@ -168,4 +213,44 @@ AudioBuffer* AudioBuffer::clone()
     return output;
 }
 
+size_t AudioBuffer::getMemoryUsage()
+{
+    return ( size_t ) amountOfChannels * bufferSize * sizeof( SAMPLE_TYPE );
+}
+
+/* AudioBufferView */
+
+AudioBufferView::AudioBufferView( AudioBuffer* buffer, int offset, int length )
+{
+    offset = std::max( 0, std::min( offset, buffer->bufferSize ));
+
+    _buffer          = buffer;
+    _offset          = offset;
+    amountOfChannels = buffer->amountOfChannels;
+    bufferSize       = std::max( 0, std::min( length, buffer->bufferSize - offset ));
+}
+
+AudioBufferView AudioBufferView::slice( int offset, int length )
+{
+    offset = std::max( 0, std::min( offset, bufferSize ));
+    return AudioBufferView( _buffer, _offset + offset, std::min( length, bufferSize - offset ));
+}
+
+void AudioBufferView::silenceBuffers()
+{
+    for ( int i = 0; i < amountOfChannels; ++i )
+        memset( getBufferForChannel( i ), 0, bufferSize * sizeof( SAMPLE_TYPE ));
+}
+
+void AudioBufferView::adjustBufferVolumes( SAMPLE_TYPE amp )
+{
+    for ( int i = 0; i < amountOfChannels; ++i )
+    {
+        SAMPLE_TYPE* buffer = getBufferForChannel( i );
+
+        for ( int j = 0; j < bufferSize; ++j )
+            buffer[ j ] *= amp;
+    }
+}
+
 } // E.O namespace MWEngine
@@ -31,23 +31,81 @@ class AudioBuffer
 {
     public:
         AudioBuffer( int aAmountOfChannels, int aBufferSize );
-        ~AudioBuffer();
+        virtual ~AudioBuffer();
 
         int amountOfChannels;
         int bufferSize;
         bool loopeable;
 
-        SAMPLE_TYPE* getBufferForChannel( int aChannelNum );
-        int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
-        bool isSilent();
+        // retrieves the samples of given channel. The channels of a buffer are stored inside a single
+        // block of memory where each channel is aligned to MEMORY_ALIGNMENT bytes (consecutive channels
+        // being getChannelStride() samples apart). For performance reasons given channel is not bounds checked
+        // NOTE : returns nullptr for buffers that do not store their contents as SAMPLE_TYPE (see CompactAudioBuffer)
+
+        inline SAMPLE_TYPE* getBufferForChannel( int aChannelNum )
+        {
+            return _buffers[ aChannelNum ];
+        }
+        int getChannelStride();
+
+        // retrieves a single sample value, regardless of the format the buffer stores its contents in
+        virtual SAMPLE_TYPE readSample( int aChannelNum, int aPosition );
+
+        virtual int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
+        virtual bool isSilent();
+        virtual void silenceBuffers();
+        virtual void adjustBufferVolumes( SAMPLE_TYPE amp );
+        virtual void applyMonoSource();
+        virtual AudioBuffer* clone();
+
+        // the amount of memory (in bytes) occupied by the sample data
+        virtual size_t getMemoryUsage();
+
+        static const int MEMORY_ALIGNMENT = 64;
+
+    protected:
+        AudioBuffer(); // for derived classes that do not store their contents as SAMPLE_TYPE (see CompactAudioBuffer)
+
+        SAMPLE_TYPE*  _data;    // contiguous storage of all channels (when allocated by this buffer)
+        SAMPLE_TYPE** _buffers; // start of each channels samples
+        int _stride;            // distance (in samples) between the start of consecutive channels
+};
+
+#ifndef SWIG
+// internal to the engine
+
+/**
+ * AudioBufferView is a non-owning slice of an AudioBuffer, describing bufferSize sample
+ * frames of all channels, starting at the given offset. Views are cheap to create and copy
+ * and allow processing a sub-block of a buffer without copying its contents. A view does
+ * not outlive its AudioBuffer.
+ */
+class AudioBufferView
+{
+    public:
+        // creates a view of given range of given buffer (clamped to the buffers size)
+        AudioBufferView( AudioBuffer* buffer, int offset, int length );
+
+        int amountOfChannels;
+        int bufferSize;
+
+        inline SAMPLE_TYPE* getBufferForChannel( int aChannelNum )
+        {
+            return _buffer->getBufferForChannel( aChannelNum ) + _offset;
+        }
+
+        // creates a view of a range within this view (offset relative to this view)
+        AudioBufferView slice( int offset, int length );
+
         void silenceBuffers();
         void adjustBufferVolumes( SAMPLE_TYPE amp );
-        void applyMonoSource();
-        AudioBuffer* clone();
 
     protected:
-        std::vector<SAMPLE_TYPE*>* _buffers;
+        AudioBuffer* _buffer;
+        int _offset;
 };
+#endif
+
 } // E.O namespace MWEngine
 
 #endif
@@ -25,10 +25,14 @@
 
 #include "audiobuffer.h"
 #include "audiochannel.h"
+#include "audioenginecontext.h"
 #include "global.h"
 #include "processingchain.h"
 #include "channelgroup.h"
 #include <definitions/drivers.h>
+#include <processors/lookaheadlimiter.h>
+#include <utilities/audiosink.h>
+#include <string>
 
 namespace MWEngine {
 class AudioEngine
@@ -50,76 +54,104 @@ class AudioEngine
 
         static AudioChannel* getInputChannel();
 
+        /**
+         * renders the sequencer range between rangeStart and rangeEnd (in samples) into given
+         * WAV file as fast as the CPU allows, without involving the audio driver. Stems registered
+         * in the StemExporter are written in the same pass. Can only be invoked while the engine
+         * is stopped. Progress is broadcast as Notifications::OFFLINE_RENDER_PROGRESS.
+         */
+        static bool renderOffline( int rangeStart, int rangeEnd, std::string outputFile );
+
         /* engine properties */
 
-        static int samples_per_beat; // the amount of samples necessary for a single beat at the current tempo and sample rate
-        static int samples_per_bar;  // the amount of samples for a full bar at the current tempo and sample rate
-        static int samples_per_step; // the amount of samples within a single status update subdivision
-        static int amount_of_bars;   // the amount of measures in the current sequencer
-        static int steps_per_bar;    // the amount of subdivisions in a single measure the engine broadcast a status update for
+#ifdef SWIG
+        static int samples_per_beat;
+        static int samples_per_bar;
+        static int samples_per_step;
+        static int amount_of_bars;
+        static int steps_per_bar;
+#else
+        // the properties below reference the default AudioEngineContext (i.e. the state that is
+        // rendered by the audio driver), additional contexts maintain their own copies
+
+        static int& samples_per_beat; // the amount of samples necessary for a single beat at the current tempo and sample rate
+        static int& samples_per_bar;  // the amount of samples for a full bar at the current tempo and sample rate
+        static int& samples_per_step; // the amount of samples within a single status update subdivision
+        static int& amount_of_bars;   // the amount of measures in the current sequencer
+        static int& steps_per_bar;    // the amount of subdivisions in a single measure the engine broadcast a status update for
+#endif
 
         static bool recordDeviceInput; // whether audio from the Android device input should be audible
 
 #ifndef SWIG
         // internal to the engine
 
+        static AudioEngineContext defaultContext;
+
         // renders the audio. this should not be called directly (is called
         // by the audio drivers). Use start() instead (triggers driver activity)
 
         static bool render( int amountOfSamples );
 
-        static int min_buffer_position;    // the lowest sample offset in the current loop range
-        static int max_buffer_position;    // the maximum sample offset in the current loop range
-        static int marked_buffer_position; // the buffer position that should launch a notification when playback exceeds this position
-        static int min_step_position;      // the lowest step in the current sequence
-        static int max_step_position;      // the maximum step in the current sequence (e.g. 15 for single measure using a 16 step sequencer - step starts at 0.)
-        static bool recordOutputToDisk;    // whether to record rendered output
-        static bool bouncing;              // whether bouncing audio (i.e. rendering in inaudible offline mode without thread lock)
-        static bool recordInputToDisk;     // whether to record audio from the Android device input to disk
+        // renders the sequencer range between rangeStart and rangeEnd (in samples) into given sink
+        // (on the calling thread) while the engine is stopped. Returns false when the engine is running
+
+        static bool renderOffline( int rangeStart, int rangeEnd, AudioSink* sink );
+
+        static int& min_buffer_position;    // the lowest sample offset in the current loop range
+        static int& max_buffer_position;    // the maximum sample offset in the current loop range
+        static int& marked_buffer_position; // the buffer position that should launch a notification when playback exceeds this position
+        static int& min_step_position;      // the lowest step in the current sequence
+        static int& max_step_position;      // the maximum step in the current sequence (e.g. 15 for single measure using a 16 step sequencer - step starts at 0.)
+        static bool recordOutputToDisk;     // whether to record rendered output
+        static bool bouncing;               // whether bouncing audio (i.e. rendering in inaudible offline mode without thread lock)
+        static bool recordInputToDisk;      // whether to record audio from the Android device input to disk
 
         /* buffer read/write pointers */
 
-        static int bufferPosition;      // the current sequence position in samples ("playback head" offset)
-        static int stepPosition;        // the current sequence bar subdivided position (e.g. 16th note of a bar)
+        static int& bufferPosition;     // the current sequence position in samples ("playback head" offset)
+        static int& stepPosition;       // the current sequence bar subdivided position (e.g. 16th note of a bar)
         static int bounceRangeStart;    // when bouncing, this defines the starting point of the bounce range
         static int bounceRangeEnd;      // when bouncing, this defines the end point of the bounce range
 
         /* tempo related */
 
-        static float tempo;                     // the tempo of the sequencer
-        static float queuedTempo;               // the tempo the sequencer will move to once current render cycle completes
-        static int time_sig_beat_amount;        // time signature upper numeral (i.e. the "3" in 3/4)
-        static int time_sig_beat_unit;          // time signature lower numeral (i.e. the "4" in 3/4)
-        static int queuedTime_sig_beat_amount;  // the time signature beat amount the sequencer moves to on next cycle
-        static int queuedTime_sig_beat_unit;    // the time signature beat unit the sequencer moves to on next cycle
+        static float& tempo;                     // the tempo of the sequencer
+        static float& queuedTempo;               // the tempo the sequencer will move to once current render cycle completes
+        static int& time_sig_beat_amount;        // time signature upper numeral (i.e. the "3" in 3/4)
+        static int& time_sig_beat_unit;          // time signature lower numeral (i.e. the "4" in 3/4)
+        static int& queuedTime_sig_beat_amount;  // the time signature beat amount the sequencer moves to on next cycle
+        static int& queuedTime_sig_beat_unit;    // the time signature beat unit the sequencer moves to on next cycle
 
         /* output related */
 
-        static float volume; // master volume
+        static float& volume; // master volume
 
-        static std::vector<ChannelGroup*> groups;
+        static std::vector<ChannelGroup*>& groups;
+
+        // applies given tempo onto the default context and publishes its updated transport properties
 
         static void handleTempoUpdate( float aQueuedTempo, bool broadcastUpdate );
 #endif
 
-        static ProcessingChain* masterBus;  // processing chain for the master bus
+#ifdef SWIG
+        static ProcessingChain* masterBus;
+        static LookAheadLimiter* masterLimiter;
+        static bool limitOutput;
+#else
+        static ProcessingChain*& masterBus;      // processing chain for the master bus
+        static LookAheadLimiter*& masterLimiter; // limiter applied last onto the output to prevent clipping
+        static bool& limitOutput;                // when false, the output is hard clipped at MAX_OUTPUT instead
+#endif
 
         static void addChannelGroup( ChannelGroup* group );
         static void removeChannelGroup( ChannelGroup* group );
 
     private:
 
-        /* render properties */
+        friend class AudioEngineContext;
 
-        static bool loopStarted; // whether the current buffer will exceed the end offset of the loop (read remaining samples from the start)
-        static int  loopOffset;   // the offset within the current buffer where we exceed max_buf_pos and start reading from min_buf_pos
-        static int  loopAmount;   // amount of samples we must read from the current loop ranges start offset (== min_buffer_position)
-        static int  outputChannels;
-        static int  thread;
-        static bool isMono;
-        static std::vector<AudioChannel*>* channels;
-        static AudioBuffer* inBuffer;
-        static float*       outBuffer;
+        static int thread;
 
 #ifdef PREVENT_CPU_FREQUENCY_SCALING
 
@@ -137,11 +169,6 @@ class AudioEngine
         static float* recbufferIn;
         static AudioChannel* inputChannel;
 #endif
-
-        /* internal render methods */
-
-        static void handleSequencerPositionUpdate( int bufferOffset );
-        static bool writeChannelCache            ( AudioChannel* channel, AudioBuffer* channelBuffer, int cacheReadPos );
 };
 } // E.O namespace MWEngine
 
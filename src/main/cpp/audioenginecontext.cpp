@@ -0,0 +1,910 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "audioenginecontext.h"
+#include "audioengine.h"
+#include "global.h"
+#include "sequencer.h"
+#include <drivers/adapter.h>
+#include <definitions/notifications.h>
+#include <messaging/notifier.h>
+#include <events/baseaudioevent.h>
+#include <events/basesynthevent.h>
+#include <events/sampleevent.h>
+#include <instruments/baseinstrument.h>
+#include <utilities/bufferpool.h>
+#include <utilities/bufferutility.h>
+#include <utilities/channelutility.h>
+#include <utilities/perfutility.h>
+#include <utilities/wavestreamwriter.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef RECORD_TO_DISK
+#include <utilities/stemexporter.h>
+#endif
+
+#ifdef USE_JNI
+#include <jni.h>
+#include <jni/javabridge.h>
+#endif
+
+namespace MWEngine {
+
+/**
+ * event mix kernels, these invoke the implementations of the engines event types directly
+ * (see EventTypes) without virtual dispatch. Event types unknown to the engine are mixed
+ * using their virtual methods
+ */
+inline void mixSequencedEvent( BaseAudioEvent* audioEvent, AudioBuffer* outputBuffer, int bufferPosition,
+                               int minBufferPosition, int maxBufferPosition, bool loopStarted, int loopOffset,
+                               bool useChannelRange )
+{
+    switch ( audioEvent->getEventType() )
+    {
+        case EventTypes::SAMPLE:
+            if ( !audioEvent->BaseAudioEvent::isLocked() ) // make sure we're allowed to query the contents
+                static_cast<SampleEvent*>( audioEvent )->SampleEvent::mixBuffer( outputBuffer, bufferPosition, minBufferPosition,
+                                                                                 maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+            break;
+
+        case EventTypes::SYNTH:
+            if ( !audioEvent->BaseAudioEvent::isLocked() )
+                static_cast<BaseSynthEvent*>( audioEvent )->BaseSynthEvent::mixBuffer( outputBuffer, bufferPosition, minBufferPosition,
+                                                                                       maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+            break;
+
+        case EventTypes::BASE:
+            if ( !audioEvent->BaseAudioEvent::isLocked() )
+                audioEvent->BaseAudioEvent::mixBuffer( outputBuffer, bufferPosition, minBufferPosition,
+                                                       maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+            break;
+
+        default:
+            if ( !audioEvent->isLocked() )
+                audioEvent->mixBuffer( outputBuffer, bufferPosition, minBufferPosition,
+                                       maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+            break;
+    }
+}
+
+inline void mixLiveEvent( BaseAudioEvent* liveEvent, AudioBuffer* outputBuffer )
+{
+    switch ( liveEvent->getEventType() )
+    {
+        case EventTypes::SAMPLE:
+            static_cast<SampleEvent*>( liveEvent )->SampleEvent::mixBuffer( outputBuffer );
+            break;
+
+        case EventTypes::SYNTH:
+            static_cast<BaseSynthEvent*>( liveEvent )->BaseSynthEvent::mixBuffer( outputBuffer );
+            break;
+
+        case EventTypes::BASE:
+            liveEvent->BaseAudioEvent::mixBuffer( outputBuffer );
+            break;
+
+        default:
+            liveEvent->mixBuffer( outputBuffer );
+            break;
+    }
+}
+
+// the context rendering on the current thread (see getRenderingContext())
+
+static thread_local AudioEngineContext* renderingContext = nullptr;
+
+/* constructor / destructor */
+
+AudioEngineContext::AudioEngineContext()
+{
+    masterBus      = new ProcessingChain();
+    masterLimiter  = new LookAheadLimiter();
+    outputChannels = AudioEngineProps::OUTPUT_CHANNELS;
+    isMono         = ( outputChannels == 1 );
+
+    // all snapshot slots describe the initial transport
+
+    for ( int i = 0; i < 3; ++i ) {
+        captureTransport( &_transportSlots[ i ]);
+    }
+    captureTransport( &_transport );
+
+    _publishedTransport = &_transportSlots[ 0 ];
+    _renderTransport    = &_transportSlots[ 1 ];
+    _pendingTransport.store( &_transportSlots[ 2 ]);
+}
+
+AudioEngineContext::~AudioEngineContext()
+{
+    destroyRenderBuffers();
+
+    delete masterBus;
+    delete masterLimiter;
+
+    delete _tempoMap.load();
+    disposeRetiredTempoMaps( true );
+}
+
+/* public methods */
+
+int AudioEngineContext::registerInstrument( BaseInstrument* instrument )
+{
+    if ( std::find( instruments.begin(), instruments.end(), instrument ) != instruments.end() ) {
+        return -1; // prevent double addition
+    }
+    instruments.push_back( instrument );
+    instrument->setContext( this );
+
+    return ( int ) instruments.size() - 1; // the index this instrument is registered at
+}
+
+bool AudioEngineContext::unregisterInstrument( BaseInstrument* instrument )
+{
+    auto it = std::find( instruments.begin(), instruments.end(), instrument );
+
+    if ( it == instruments.end() ) {
+        return false;
+    }
+    instruments.erase( it );
+
+    if ( instrument->getContext() == this )
+        instrument->setContext( nullptr );
+
+    return true;
+}
+
+void AudioEngineContext::updateEvents()
+{
+    for ( size_t i = 0, l = instruments.size(); i < l; ++i ) {
+        instruments.at( i )->updateEvents();
+    }
+}
+
+void AudioEngineContext::addChannelGroup( ChannelGroup* group )
+{
+    auto it = std::find( groups.begin(), groups.end(), group );
+    if ( it == groups.end() ) {
+        groups.push_back( group );
+    }
+}
+
+void AudioEngineContext::removeChannelGroup( ChannelGroup* group )
+{
+    auto it = std::find( groups.begin(), groups.end(), group );
+    if ( it != groups.end() ) {
+        groups.erase( it );
+    }
+}
+
+void AudioEngineContext::publishTransport()
+{
+    captureTransport( _publishedTransport );
+    _publishedTransport->version = ++_transportVersion;
+
+    // swap the snapshot in, in return we receive a slot the render thread no longer reads from
+
+    _publishedTransport = _pendingTransport.exchange( _publishedTransport, std::memory_order_acq_rel );
+}
+
+void AudioEngineContext::seek( int position )
+{
+    _seekPosition.store( position, std::memory_order_release );
+}
+
+const transportState& AudioEngineContext::getTransport()
+{
+    return _transport;
+}
+
+AudioEngineContext* AudioEngineContext::getRenderingContext()
+{
+    return renderingContext;
+}
+
+void AudioEngineContext::setTempoMap( TempoMap* map )
+{
+    TempoMap* previousMap = _tempoMap.exchange(( map != nullptr ) ? new TempoMap( *map ) : nullptr );
+
+    publishTransport();
+
+    // the render thread might still read from the previous map until it has consumed the
+    // snapshot published above, as such it is disposed once that has happened
+
+    if ( previousMap != nullptr )
+        _retiredTempoMaps.push_back({ _transportVersion.load(), previousMap });
+
+    disposeRetiredTempoMaps( false );
+
+    // events follow the tempo of the context sequencing them through their musical position
+
+    updateMeasureCaches();
+}
+
+TempoMap* AudioEngineContext::getTempoMap()
+{
+    return _tempoMap.load();
+}
+
+int AudioEngineContext::getMeasureStart( int measure )
+{
+    TempoMap* tempoMap = _tempoMap.load();
+    return ( tempoMap != nullptr ) ? tempoMap->getMeasureStart( measure ) : samples_per_bar * measure;
+}
+
+bool AudioEngineContext::renderOffline( int rangeStart, int rangeEnd, std::string outputFile )
+{
+    if ( isDefault() && AudioEngine::thread == 1 )
+        return false;
+
+    // rendering isn't bound to the hardware clock, as such the writer
+    // waits for storage rather than discarding audio
+
+    WaveStreamWriter* writer = new WaveStreamWriter();
+
+    if ( !writer->open( outputFile, AudioEngineProps::SAMPLE_RATE, AudioEngineProps::OUTPUT_CHANNELS, true )) {
+        delete writer;
+        return false;
+    }
+
+#ifdef RECORD_TO_DISK
+    // stems are registered for the channels of the default context
+    if ( isDefault() )
+        StemExporter::prepare( AudioEngineProps::SAMPLE_RATE );
+#endif
+    bool rendered = renderOffline( rangeStart, rangeEnd, writer );
+
+#ifdef RECORD_TO_DISK
+    if ( isDefault() )
+        StemExporter::finish();
+#endif
+    writer->close();
+    delete writer;
+
+    return rendered;
+}
+
+bool AudioEngineContext::renderOffline( int rangeStart, int rangeEnd, AudioSink* sink )
+{
+    // the default context cannot be rendered offline while the render thread is
+    // running, offline rendering takes place on the calling thread
+
+    if (( isDefault() && AudioEngine::thread == 1 ) || sink == nullptr || rangeEnd <= rangeStart )
+        return false;
+
+    // the playback head wraps at the end of the loop, when the range exceeds the loop
+    // it is sequenced as the loop for the duration of the render
+
+    int loopStart   = min_buffer_position;
+    int loopEnd     = max_buffer_position;
+    bool rangeLoops = rangeStart < loopStart || rangeEnd - 1 > loopEnd;
+
+    if ( rangeLoops ) {
+        min_buffer_position = rangeStart;
+        max_buffer_position = rangeEnd - 1;
+        publishTransport();
+    }
+    createRenderBuffers();
+
+    // flush denormals while rendering, the calling thread's floating point state is restored afterwards
+
+    PerfUtility::DenormalGuard denormalGuard;
+
+    bool wasPlaying = playing;
+    int position    = bufferPosition;
+    int step        = stepPosition;
+    playing         = true;
+    bufferPosition  = rangeStart;
+    stepPosition    = 0;
+
+    int totalSamples    = rangeEnd - rangeStart;
+    int renderedSamples = 0;
+    int progress        = 0;
+
+    // render without involving the driver, applying CPU stabilizing
+    // load or broadcasting sequencer notifications
+
+    while ( renderedSamples < totalSamples )
+    {
+        int amountOfSamples = std::min(( int ) AudioEngineProps::BUFFER_SIZE, totalSamples - renderedSamples );
+
+        renderOutput( amountOfSamples, true );
+        sink->write( outBuffer, amountOfSamples, outputChannels );
+
+        renderedSamples += amountOfSamples;
+
+        // broadcast progress in whole percentages
+
+        int percentage = ( int )(( renderedSamples * 100LL ) / totalSamples );
+
+        if ( percentage != progress ) {
+            progress = percentage;
+            Notifier::broadcast( Notifications::OFFLINE_RENDER_PROGRESS, progress );
+        }
+    }
+    playing        = wasPlaying;
+    bufferPosition = position;
+    stepPosition   = step;
+
+    destroyRenderBuffers();
+
+    if ( rangeLoops ) {
+        min_buffer_position = loopStart;
+        max_buffer_position = loopEnd;
+        publishTransport();
+    }
+    return true;
+}
+
+void AudioEngineContext::handleTempoUpdate( float aQueuedTempo, bool broadcastUpdate )
+{
+    float ratio = applyTempo( aQueuedTempo, broadcastUpdate );
+
+    // while rendering, the playback head is owned by the render thread, which scales
+    // it (and broadcasts the update) once it applies the snapshot published below
+
+    if ( !isRendering() )
+    {
+        bufferPosition = ( int )(( float ) bufferPosition * ratio );
+
+        if ( broadcastUpdate )
+            broadcastTempoUpdate( tempo );
+    }
+    publishTransport();
+}
+
+/* protected methods */
+
+/**
+ * applies given tempo (when rescale is true, positions are scaled to the new tempo) and the queued
+ * time signature onto the transport properties, repositioning the events accordingly. Returns the
+ * ratio by which the positions have been scaled. Invoked by the controlling thread only
+ */
+float AudioEngineContext::applyTempo( float aQueuedTempo, bool rescale )
+{
+    float ratio = 1;
+
+    if ( rescale ) {
+        ratio = tempo / aQueuedTempo;
+        tempo = aQueuedTempo;
+    };
+
+    time_sig_beat_amount = queuedTime_sig_beat_amount; // upper numeral (the "3" in "3/4")
+    time_sig_beat_unit   = queuedTime_sig_beat_unit;   // lower numeral (the "4" in "4/4")
+
+    samples_per_bar  = BufferUtility::getSamplesPerBar( AudioEngineProps::SAMPLE_RATE, tempo, time_sig_beat_amount, time_sig_beat_unit );
+    samples_per_beat = samples_per_bar / time_sig_beat_amount;
+    samples_per_step = samples_per_bar / steps_per_bar;
+
+    int loopLength = max_buffer_position - min_buffer_position;
+
+    min_buffer_position = ( int )(( float ) min_buffer_position * ratio );
+    max_buffer_position = min_buffer_position + ( int )(( float ) loopLength * ratio );
+
+    // make sure relative positions remain in sync (see handleTempoUpdate() for the playback head)
+    if ( marked_buffer_position > 0 ) {
+        marked_buffer_position = ( int )(( float ) marked_buffer_position * ratio );
+    }
+
+    // events follow the tempo of the context sequencing them through their musical position
+    updateMeasureCaches();
+
+    return ratio;
+}
+
+/**
+ * informs the instruments of a change in tempo. Their events remain untouched (see BaseInstrument::updateMeasureCache())
+ * as the sample based positions are derived upon access, by the render thread at the tempo of the snapshot it renders
+ */
+void AudioEngineContext::updateMeasureCaches()
+{
+    for ( size_t i = 0, l = instruments.size(); i < l; ++i ) {
+        instruments.at( i )->updateMeasureCache();
+    }
+}
+
+void AudioEngineContext::broadcastTempoUpdate( float aTempo )
+{
+    // broadcast update (so the Sequencer can invoke a re-calculation
+    // on all existing audio events to match the new tempo / time signature)
+    // the broadcast is tied to the default context
+
+    if ( isDefault() )
+    {
+#ifdef USE_JNI
+        // when using the engine through JNI with Java, we don't broadcast using
+        // the Notifier, but instantly invoke a callback directly on the bridge
+        // as it allows us to update multiple parameters at once
+
+        jmethodID native_method_id = JavaBridge::getJavaMethod( JavaAPIs::TEMPO_UPDATED );
+
+        if ( native_method_id != 0 )
+        {
+            JNIEnv* env = JavaBridge::getEnvironment();
+
+            if ( env != nullptr )
+                env->CallStaticVoidMethod( JavaBridge::getJavaInterface(), native_method_id, aTempo );
+        }
+#else
+        Notifier::broadcast( Notifications::SEQUENCER_TEMPO_UPDATED );
+#endif
+    }
+}
+
+void AudioEngineContext::captureTransport( transportState* state )
+{
+    state->version                    = _transportVersion.load( std::memory_order_relaxed );
+    state->tempo                      = tempo;
+    state->time_sig_beat_amount       = time_sig_beat_amount;
+    state->time_sig_beat_unit         = time_sig_beat_unit;
+    state->samples_per_beat           = samples_per_beat;
+    state->samples_per_bar            = samples_per_bar;
+    state->samples_per_step           = samples_per_step;
+    state->amount_of_bars             = amount_of_bars;
+    state->steps_per_bar              = steps_per_bar;
+    state->min_buffer_position        = min_buffer_position;
+    state->max_buffer_position        = max_buffer_position;
+    state->marked_buffer_position     = marked_buffer_position;
+    state->min_step_position          = min_step_position;
+    state->max_step_position          = max_step_position;
+    state->tempoMap                   = _tempoMap.load();
+}
+
+/**
+ * invoked by the render thread at the start of the render cycle, applies the last published
+ * snapshot. Returns whether the snapshot moved the transport to a different tempo
+ */
+bool AudioEngineContext::consumeTransport()
+{
+    bool tempoUpdated = false;
+
+    // exchange the slot we last read from for the last published one, this
+    // is either a newer snapshot or the slot we handed back in the previous cycle
+
+    _renderTransport = _pendingTransport.exchange( _renderTransport, std::memory_order_acq_rel );
+
+    if ( _renderTransport->version > _transport.version )
+    {
+        float previousTempo = _transport.tempo;
+
+        _transport = *_renderTransport;
+        _consumedTransportVersion.store( _transport.version, std::memory_order_release );
+
+        // the tempo has been changed by the controlling thread, keep the playback head in sync
+
+        if ( _transport.tempo != previousTempo ) {
+            bufferPosition = ( int )(( float ) bufferPosition * ( previousTempo / _transport.tempo ));
+            tempoUpdated   = true;
+        }
+    }
+
+    int seekPosition = _seekPosition.exchange( -1, std::memory_order_acq_rel );
+
+    if ( seekPosition >= 0 ) {
+        bufferPosition = seekPosition;
+    }
+    return tempoUpdated;
+}
+
+void AudioEngineContext::disposeRetiredTempoMaps( bool force )
+{
+    // maps can be disposed when the render thread has moved onto a more recent snapshot
+    // (or when no rendering takes place, e.g. the render buffers do not exist)
+
+    unsigned int consumedVersion = _consumedTransportVersion.load( std::memory_order_acquire );
+    bool rendering               = isRendering();
+
+    for ( auto it = _retiredTempoMaps.begin(); it != _retiredTempoMaps.end(); )
+    {
+        if ( force || !rendering || it->first <= consumedVersion ) {
+            delete it->second;
+            it = _retiredTempoMaps.erase( it );
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool AudioEngineContext::isDefault()
+{
+    return this == &AudioEngine::defaultContext;
+}
+
+bool AudioEngineContext::isRendering()
+{
+    return channels != nullptr;
+}
+
+void AudioEngineContext::renderOutput( int amountOfSamples, bool offline )
+{
+    size_t i, j, k, c, ci;
+    float sample;
+
+    renderingContext = this;
+
+    // apply the last published transport properties, these remain unchanged for the duration of this cycle
+    // (offline rendering does not broadcast tempo updates)
+
+    if ( consumeTransport() && !offline )
+        broadcastTempoUpdate( _transport.tempo );
+
+    // the step boundaries depend on the tempo (map) of the applied transport
+
+    updateStep( bufferPosition );
+
+    // erase previous buffer contents
+    inBuffer->silenceBuffers();
+
+    // gather the audio events by the sequencer range currently being processed
+    loopStarted = Sequencer::getAudioEvents( this, channels, bufferPosition, amountOfSamples, true, true );
+
+    // read pointer exceeds maximum allowed offset (max_buffer_position) ? => sequencer has started its loop
+    // we must now also gather extra events at the start position (min_buffer_position)
+    loopOffset = ( _transport.max_buffer_position - bufferPosition ) + 1; // buffer iterator index at which the loop will occur
+    loopAmount = amountOfSamples - loopOffset;                 // the amount of samples to write after looping starts
+
+    // collect all audio events at the start of the loop offset that are also eligible for playback in this iteration
+    if ( loopAmount > 0 ) {
+        Sequencer::getAudioEvents( this, channels, _transport.min_buffer_position, loopAmount, false, false );
+    }
+
+#ifdef RECORD_DEVICE_INPUT
+    // record audio from Android device ?
+    // (device input is only available to the default context)
+    if ( !offline && isDefault() && ( AudioEngine::recordDeviceInput || AudioEngine::recordInputToDisk ) && AudioEngineProps::INPUT_CHANNELS > 0 )
+    {
+        AudioChannel* inputChannel    = AudioEngine::inputChannel;
+        float* recbufferIn            = AudioEngine::recbufferIn;
+        int recordedSamples           = DriverAdapter::getInput( recbufferIn, amountOfSamples );
+        SAMPLE_TYPE* recBufferChannel = inputChannel->getOutputBuffer()->getBufferForChannel( 0 );
+
+        for ( j = 0; j < recordedSamples; ++j ) {
+            recBufferChannel[ j ] = recbufferIn[ j ];//static_cast<float>( recbufferIn[ j ] );
+        }
+
+        // apply processing chain onto the input
+
+        std::vector<BaseProcessor*> processors = inputChannel->processingChain->getActiveProcessors();
+        for ( k = 0; k < processors.size(); ++k ) {
+            processors[ k ]->apply( inputChannel->getOutputBuffer(), AudioEngineProps::INPUT_CHANNELS == 1 );
+        }
+
+        // merge recording into current input buffer for instant monitoring
+
+        if ( inputChannel->getVolume() > 0.F ) {
+            inputChannel->mixBuffer( inBuffer, inputChannel->getVolume() );
+        }
+    }
+#endif
+#ifdef RECORD_TO_DISK
+    // stems are registered for the channels of the default context
+    bool exportStems = isDefault() && StemExporter::isExporting();
+#endif
+    // channel loop
+    size_t channelAmount = channels->size();
+    size_t groupAmount   = groups.size();
+
+    for ( j = 0; j < channelAmount; ++j )
+    {
+        AudioChannel* channel = channels->at( j );
+        bool isCached         = channel->hasCache;                // whether this channel has a fully cached buffer
+        bool mustCache        = AudioEngineProps::CHANNEL_CACHING && channel->canCache() && !isCached; // whether to cache this channels output
+        int cacheReadPos      = 0;  // the offset we start ready from the channel buffer (when writing to cache)
+
+        std::vector<BaseAudioEvent*> audioEvents = channel->audioEvents;
+        unsigned long amount = audioEvents.size();
+
+        // divide the channels volume by the amount of channels to provide extra headroom
+        SAMPLE_TYPE channelVolume = ( SAMPLE_TYPE ) channel->getVolumeLogarithmic() / ( SAMPLE_TYPE ) channelAmount;
+
+        // get channel output buffer and clear previous contents
+        AudioBuffer* channelBuffer = channel->getOutputBuffer();
+
+        if ( channelBuffer == nullptr ) continue;
+
+        channelBuffer->silenceBuffers();
+
+        bool useChannelRange  = channel->maxBufferPosition != 0; // channel has its own buffer range (i.e. drummachine)
+        int maxBufferPosition = useChannelRange ? channel->maxBufferPosition : _transport.max_buffer_position;
+
+        // we make a copy of the current buffer position indicator
+        int bufferPos = bufferPosition;
+
+        // ...in case the AudioChannels maxBufferPosition differs from the sequencer loop range
+        // note that these buffer positions are always a full measure in length (as we loop by measures)
+        while ( bufferPos > maxBufferPosition )
+            bufferPos -= getPrecedingMeasureLength( bufferPos );
+
+        // only render sequenced events when the sequencer isn't in the paused state
+        // and the channel volume is actually at an audible level! ( > 0 )
+
+        if ( playing && amount > 0 && channelVolume > 0.0 )
+        {
+            if ( !isCached )
+            {
+                // write the audioEvent buffers into the main output buffer
+                for ( k = 0; k < amount; ++k )
+                {
+                    BaseAudioEvent* audioEvent = audioEvents[ k ];
+
+                    if ( audioEvent != nullptr )
+                    {
+                        mixSequencedEvent( audioEvent, channelBuffer, bufferPos, _transport.min_buffer_position,
+                                           maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+                    }
+                }
+            }
+            else {
+                channel->readCachedBuffer( channelBuffer, bufferPos );
+            }
+        }
+
+        // perform live rendering for this channels instrument
+        if ( channel->hasLiveEvents )
+        {
+            size_t lAmount = channel->liveEvents.size();
+
+            for ( k = 0; k < lAmount; ++k )
+            {
+                BaseAudioEvent* liveEvent = channel->liveEvents[ k ];
+                mixLiveEvent( liveEvent, channelBuffer );
+            }
+        }
+
+#ifdef RECORD_TO_DISK
+        // exporting stems ? write the dry channel output
+        if ( exportStems )
+            StemExporter::writeChannel( channel, channelBuffer, amountOfSamples, true, 1.0 );
+#endif
+        // apply the processing chains processors / modulators
+        ProcessingChain* chain = channel->processingChain;
+        std::vector<BaseProcessor*> processors = chain->getActiveProcessors();
+
+        for ( k = 0; k < processors.size(); ++k )
+        {
+            BaseProcessor* processor = processors[ k ];
+            bool canCacheProcessor   = processor->isCacheable();
+
+            // only apply processor when we're not caching or cannot cache its output
+            if ( !isCached || !canCacheProcessor )
+            {
+                // cannot cache this processor and we're caching ? write all contents
+                // of the channelBuffer into the channels cache
+                if ( mustCache && !canCacheProcessor )
+                    mustCache = !writeChannelCache( channel, channelBuffer, cacheReadPos );
+
+                processor->apply( channelBuffer, channel->isMono );
+            }
+        }
+
+        // write cache if it didn't happen yet ;) (bus processors are (currently) non-cacheable)
+        if ( mustCache ) {
+            mustCache = !writeChannelCache( channel, channelBuffer, cacheReadPos );
+        }
+
+        // write the channel buffer into the combined output buffer, apply channel volume
+        // (note live events are always audible as their volume is relative to the instrument)
+        if ( channel->hasLiveEvents && channelVolume == 0.0 ) {
+            channelVolume = 1.0;
+        }
+
+#ifdef RECORD_TO_DISK
+        // exporting stems ? write the channel output as it is mixed into the output
+        if ( exportStems )
+            StemExporter::writeChannel( channel, channelBuffer, amountOfSamples, false, channelVolume );
+#endif
+
+        // note we don't mix the channel if it belongs to a group (group will sum into the output)
+        if ( groupAmount == 0 || !ChannelUtility::channelBelongsToGroup( channel, groups )) {
+            channel->mixBuffer( inBuffer, channelVolume );
+        }
+    }
+
+    // apply group effects onto the mix buffer
+
+    for ( j = 0; j < groupAmount; ++j ) {
+        groups[ j ]->applyEffectsToChannels( inBuffer, amountOfSamples );
+    }
+
+    // apply master bus processors (e.g. high/low pass filters, limiter, etc.) onto the mix buffer
+
+    std::vector<BaseProcessor*> processors = masterBus->getActiveProcessors();
+
+    for ( j = 0; j < processors.size(); ++j ) {
+        processors[ j ]->apply( inBuffer, isMono );
+    }
+
+    // apply the master volume and keep the output below the headroom ceiling
+
+    if ( limitOutput ) {
+        inBuffer->adjustBufferVolumes( volume );
+        masterLimiter->apply( inBuffer, isMono );
+    }
+
+    // write the accumulated buffers into the output buffer
+
+    for ( i = 0, c = 0; i < amountOfSamples; i++, c += outputChannels )
+    {
+        for ( ci = 0; ci < outputChannels; ci++ )
+        {
+            sample = ( float ) inBuffer->getBufferForChannel(( int ) ci )[ i ];
+
+            if ( !limitOutput )
+            {
+                // apply the master volume onto the output
+                sample *= volume;
+
+                // and perform a fail-safe check in case we're exceeding the headroom ceiling
+
+                if ( sample < -MAX_OUTPUT )
+                    sample = -MAX_OUTPUT;
+
+                else if ( sample > +MAX_OUTPUT )
+                    sample = +MAX_OUTPUT;
+            }
+
+            // write output interleaved (e.g. a sample per output channel
+            // before continuing writing the next sample for the next channel range)
+
+            outBuffer[ c + ci ] = sample;
+        }
+
+        // update the buffer pointers and sequencer position
+        if ( playing )
+        {
+            // the boundaries of the current step are only recalculated once the playback head leaves it
+
+            if ( bufferPosition >= stepEnd || bufferPosition < stepStart )
+                updateStep( bufferPosition );
+
+            if ( bufferPosition == stepStart )
+                handleSequencerPositionUpdate(( int ) i, !offline );
+
+            if ( !offline && _transport.marked_buffer_position > 0 && bufferPosition == _transport.marked_buffer_position )
+                 Notifier::broadcast( Notifications::MARKER_POSITION_REACHED );
+
+            bufferPosition++;
+
+            if ( bufferPosition > _transport.max_buffer_position )
+                bufferPosition = _transport.min_buffer_position;
+        }
+    }
+    renderingContext = nullptr;
+}
+
+/**
+ * determines the step containing given position (in samples) and the offsets at which it starts
+ * and ends. Steps subdivide the measures of the tempo map (when set) or the constant tempo
+ */
+void AudioEngineContext::updateStep( int position )
+{
+    TempoMap* tempoMap = _transport.tempoMap;
+
+    if ( tempoMap != nullptr ) {
+        double ticksPerStep = ( double ) TICKS_PER_MEASURE / _transport.steps_per_bar;
+
+        step      = ( int ) floor( tempoMap->samplesToTicks( position ) / ticksPerStep );
+        stepStart = tempoMap->ticksToSamples( step * ticksPerStep );
+        stepEnd   = tempoMap->ticksToSamples(( step + 1 ) * ticksPerStep );
+
+        // step boundaries are rounded to whole samples, a position rounding onto the
+        // start of the next step belongs to that step
+
+        if ( position >= stepEnd ) {
+            ++step;
+            stepStart = stepEnd;
+            stepEnd   = tempoMap->ticksToSamples(( step + 1 ) * ticksPerStep );
+        }
+    } else {
+        int samplesPerStep = std::max( 1, _transport.samples_per_step );
+
+        step      = position / samplesPerStep;
+        stepStart = step * samplesPerStep;
+        stepEnd   = stepStart + samplesPerStep;
+    }
+    stepEnd = std::max( stepStart + 1, stepEnd );
+}
+
+/**
+ * the length (in samples) of the measure preceding the measure containing given position
+ * subtracting this from given position moves it onto the same offset within the preceding measure
+ */
+int AudioEngineContext::getPrecedingMeasureLength( int position )
+{
+    TempoMap* tempoMap = _transport.tempoMap;
+
+    if ( tempoMap == nullptr )
+        return _transport.samples_per_bar;
+
+    return tempoMap->getMeasureLength( std::max( 0, tempoMap->getMeasureAt( position ) - 1 ));
+}
+
+void AudioEngineContext::handleSequencerPositionUpdate( int bufferOffset, bool broadcastUpdate )
+{
+    stepPosition = step;
+
+    if ( stepPosition > _transport.max_step_position )
+        stepPosition = _transport.min_step_position;
+
+    if ( broadcastUpdate )
+        Notifier::broadcast( Notifications::SEQUENCER_POSITION_UPDATED, bufferOffset );
+}
+
+void AudioEngineContext::createRenderBuffers()
+{
+    channels       = new std::vector<AudioChannel*>();
+    outputChannels = AudioEngineProps::OUTPUT_CHANNELS;
+    isMono         = ( outputChannels == 1 );
+    outBuffer      = new float[ AudioEngineProps::BUFFER_SIZE * outputChannels ]();
+
+    // accumulates all channels ("master strip")
+
+    inBuffer = new AudioBuffer( outputChannels, AudioEngineProps::BUFFER_SIZE );
+
+    // synthesized events render into pooled buffers of the same size, reserve these ahead of the
+    // render cycle so allocating them does not allocate memory on the render thread
+
+    BufferPool::reserveBuffers( outputChannels * inBuffer->getChannelStride(), BufferPool::BUFFERS_PER_CHUNK );
+
+    // the render cycle starts from the current transport properties (this
+    // includes all previously published snapshots)
+
+    captureTransport( &_transport );
+    _seekPosition.store( -1 );
+    _consumedTransportVersion.store( _transport.version );
+
+    // clear the limiters history (and adapt it to a changed sample rate, if applicable)
+
+    masterLimiter->reset();
+
+    // ensure all AudioChannel buffers have the correct properties (in case engine is
+    // restarting after changing buffer size, for instance)
+
+    for ( size_t i = 0; i < instruments.size(); ++i ) {
+        instruments[ i ]->audioChannel->createOutputBuffer();
+    }
+}
+
+void AudioEngineContext::destroyRenderBuffers()
+{
+    delete channels;
+    delete[] outBuffer;
+    delete inBuffer;
+
+    channels  = nullptr;
+    outBuffer = nullptr;
+    inBuffer  = nullptr;
+}
+
+bool AudioEngineContext::writeChannelCache( AudioChannel* channel, AudioBuffer* channelBuffer, int cacheReadPos )
+{
+    // mustCache isn't the same as isCaching (likely sequencer is waiting for start offset ;))
+    if ( channel->isCaching )
+        channel->writeCache( channelBuffer, cacheReadPos );
+    else
+        return false;
+
+    return true; // indicates we have written the buffer to the cache
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,240 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__AUDIOENGINECONTEXT_H_INCLUDED__
+#define __MWENGINE__AUDIOENGINECONTEXT_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "audiochannel.h"
+#include "channelgroup.h"
+#include "processingchain.h"
+#include "tempomap.h"
+#include <processors/lookaheadlimiter.h>
+#include <utilities/audiosink.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace MWEngine {
+
+class BaseInstrument;
+
+/**
+ * immutable snapshot of the transport properties of an AudioEngineContext, published by
+ * the controlling thread and consumed by the render thread at the start of a render cycle
+ */
+typedef struct {
+    unsigned int version; // increments for each published snapshot
+    float tempo;
+    int time_sig_beat_amount;
+    int time_sig_beat_unit;
+    int samples_per_beat;
+    int samples_per_bar;
+    int samples_per_step;
+    int amount_of_bars;
+    int steps_per_bar;
+    int min_buffer_position;
+    int max_buffer_position;
+    int marked_buffer_position;
+    int min_step_position;
+    int max_step_position;
+    TempoMap* tempoMap;   // tempo changes over the course of the sequence (nullptr at a constant tempo)
+} transportState;
+
+/**
+ * AudioEngineContext holds the state of a single engine: its sequencer transport,
+ * the instruments it sequences, its master bus and the buffers used while rendering.
+ *
+ * The static AudioEngine (and Sequencer) API operates on a default context (see
+ * AudioEngine::defaultContext) which is rendered by the audio driver. Additional
+ * contexts can be created to render offline concurrently, e.g. a background bounce
+ * while the engine is running or parallel renders of different projects, as long as
+ * each context sequences its own instruments (see registerInstrument()).
+ *
+ * Events are positioned relative to the tempo (map) of the context their instrument is
+ * registered in. Note the following state is shared by all contexts:
+ *
+ * - AudioEngineProps (e.g. sample rate and buffer size) must not change while any context renders
+ * - TablePool and the Notifier observers are not synchronized, register wave tables and
+ *   observers before rendering contexts concurrently
+ * - SampleManager, EventPool and BufferPool are synchronized and can be used by all contexts
+ * - device input, DiskWriter recording, StemExporter, the Sequencers BulkCacher and the tempo
+ *   broadcast (see broadcastTempoUpdate()) are only available to the default context
+ */
+class AudioEngineContext
+{
+    friend class AudioEngine;
+
+    public:
+        AudioEngineContext();
+        ~AudioEngineContext();
+
+        /* transport */
+
+        int samples_per_beat       = 4;  // the amount of samples necessary for a single beat at the current tempo and sample rate
+        int samples_per_bar        = 16; // the amount of samples for a full bar at the current tempo and sample rate
+        int samples_per_step       = 1;  // the amount of samples within a single status update subdivision
+        int amount_of_bars         = 1;  // the amount of measures in the current sequencer
+        int steps_per_bar          = 16; // the amount of subdivisions in a single measure the engine broadcast a status update for
+        int min_buffer_position    = 0;  // the lowest sample offset in the current loop range
+        int max_buffer_position    = 16; // the maximum sample offset in the current loop range
+        int marked_buffer_position = -1; // the buffer position that should launch a notification when playback exceeds this position
+        int min_step_position      = 0;  // the lowest step in the current sequence
+        int max_step_position      = 15; // the maximum step in the current sequence (steps start at 0)
+        int bufferPosition         = 0;  // the current sequence position in samples ("playback head" offset)
+        int stepPosition           = 0;  // the current sequence bar subdivided position (e.g. 16th note of a bar)
+
+        /* tempo related */
+
+        float tempo                    = 90.0F;  // the tempo of the sequencer
+        float queuedTempo              = 120.0F; // the tempo the sequencer will move to once current render cycle completes
+        int time_sig_beat_amount       = 4;      // time signature upper numeral (i.e. the "3" in 3/4)
+        int time_sig_beat_unit         = 4;      // time signature lower numeral (i.e. the "4" in 3/4)
+        int queuedTime_sig_beat_amount = 4;      // the time signature beat amount the sequencer moves to on next cycle
+        int queuedTime_sig_beat_unit   = 4;      // the time signature beat unit the sequencer moves to on next cycle
+
+        // the transport and tempo properties above are not read by the render thread directly. Once
+        // they have been updated, publishTransport() hands a snapshot of their values to the render
+        // thread, which applies it at the start of its next render cycle. This should be invoked from
+        // a single (controlling) thread. Note bufferPosition and stepPosition are updated by the
+        // render thread, seek() moves the playback head in sync with the render cycle. Tempo changes
+        // are applied by the controlling thread as well (see handleTempoUpdate()), upon applying the
+        // snapshot of a different tempo the render thread keeps its playback head in place musically
+
+        void publishTransport();
+        void seek( int position );
+
+        // the snapshot of the transport properties the current render cycle operates on
+
+        const transportState& getTransport();
+
+        // the context that is rendering on the calling thread (nullptr when invoked outside of a render cycle)
+        // this allows processors to read the transport of the context they are processing audio for
+
+        static AudioEngineContext* getRenderingContext();
+
+        // an optional TempoMap describing tempo ramps and time signature changes over the course of the
+        // sequence. When set, the transport (and the events sequenced by this context) are positioned
+        // through the map instead of the constant tempo. The context keeps a copy of given map, changes
+        // require setting the map again. Pass nullptr to return to sequencing at a constant tempo.
+
+        void setTempoMap( TempoMap* map );
+        TempoMap* getTempoMap();
+
+        int getMeasureStart( int measure ); // offset in samples at which given measure starts
+
+        /* sequenced content */
+
+        bool playing = false;
+        std::vector<BaseInstrument*> instruments;
+
+        // adds given instrument to this contexts sequencer, returns the index it is registered at (-1 when
+        // it was registered already). Note an instrument should only be registered in a single context
+        // (new instruments register in the default context, see BaseInstrument::unregisterFromSequencer())
+
+        int registerInstrument( BaseInstrument* instrument );
+        bool unregisterInstrument( BaseInstrument* instrument );
+
+        // stores the positions of the events of all registered instruments for the current tempo. Note this is
+        // not required after a tempo change as the events derive their positions upon access (the render thread
+        // at the tempo of the snapshot it renders, see BaseAudioEvent::getEventStart())
+
+        void updateEvents();
+
+        /* output related */
+
+        float volume = 1.0F;               // master volume
+        ProcessingChain* masterBus;        // processing chain for the master bus
+        LookAheadLimiter* masterLimiter;   // limiter applied last onto the output to prevent clipping
+        bool limitOutput = true;           // when false, the output is hard clipped at MAX_OUTPUT instead
+        std::vector<ChannelGroup*> groups;
+
+        void addChannelGroup( ChannelGroup* group );
+        void removeChannelGroup( ChannelGroup* group );
+
+        /* rendering */
+
+        // renders the sequencer range between rangeStart and rangeEnd (in samples) into given sink
+        // on the calling thread. Progress is broadcast as Notifications::OFFLINE_RENDER_PROGRESS
+        // The playback head (and the loop range, when exceeded by given range) is restored afterwards
+
+        bool renderOffline( int rangeStart, int rangeEnd, AudioSink* sink );
+        bool renderOffline( int rangeStart, int rangeEnd, std::string outputFile );
+
+        // applies given tempo and the queued time signature onto the transport and publishes the
+        // result, when broadcastUpdate is true positions are scaled to the new tempo and the update is
+        // broadcast (by the render thread once it applies the new tempo, when the context is rendering)
+
+        void handleTempoUpdate( float aQueuedTempo, bool broadcastUpdate );
+
+    protected:
+
+        /* render properties */
+
+        bool loopStarted   = false; // whether the current buffer will exceed the end offset of the loop (read remaining samples from the start)
+        int  loopOffset    = 0;     // the offset within the current buffer where we exceed max_buf_pos and start reading from min_buf_pos
+        int  loopAmount    = 0;     // amount of samples we must read from the current loop ranges start offset (== min_buffer_position)
+        int  stepStart     = 0;     // offset in samples at which the step containing the playback head starts
+        int  stepEnd       = 0;     // offset in samples at which the next step starts
+        int  step          = 0;     // the step containing the playback head (see updateStep())
+        int  outputChannels;
+        bool isMono;
+        std::vector<AudioChannel*>* channels = nullptr;
+        AudioBuffer* inBuffer                = nullptr;
+        float*       outBuffer               = nullptr;
+
+        /* transport snapshots */
+
+        transportState _transport;                          // snapshot applied by the render thread
+        transportState _transportSlots[ 3 ];                // storage for the snapshot exchange
+        transportState* _publishedTransport;                // slot owned by the publishing thread
+        transportState* _renderTransport;                   // slot owned by the render thread
+        std::atomic<transportState*> _pendingTransport;     // slot holding the last published snapshot
+        std::atomic<unsigned int>    _transportVersion { 0 };
+        std::atomic<int>             _seekPosition { -1 };  // playback head position requested by seek()
+        std::atomic<unsigned int>    _consumedTransportVersion { 0 }; // version of the snapshot the render thread operates on
+
+        std::atomic<TempoMap*> _tempoMap { nullptr };
+        std::vector<std::pair<unsigned int, TempoMap*>> _retiredTempoMaps; // replaced maps (and the version replacing them)
+
+        void captureTransport( transportState* state );
+        bool consumeTransport();
+        float applyTempo( float aQueuedTempo, bool rescale );
+        void updateMeasureCaches();
+        void broadcastTempoUpdate( float aTempo );
+        void disposeRetiredTempoMaps( bool force );
+
+        /* internal render methods */
+
+        bool isDefault();
+        bool isRendering();
+        void renderOutput( int amountOfSamples, bool offline );
+        void createRenderBuffers();
+        void destroyRenderBuffers();
+        void updateStep( int position );
+        int getPrecedingMeasureLength( int position );
+        void handleSequencerPositionUpdate( int bufferOffset, bool broadcastUpdate );
+        bool writeChannelCache( AudioChannel* channel, AudioBuffer* channelBuffer, int cacheReadPos );
+};
+} // E.O namespace MWEngine
+
+#endif
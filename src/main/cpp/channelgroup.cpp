@@ -22,6 +22,7 @@
  */
 #include <channelgroup.h>
 #include <audioengine.h>
+#include <utilities/stemexporter.h>
 #include <utilities/volumeutil.h>
 
 namespace MWEngine {
@@ -95,6 +96,11 @@ bool ChannelGroup::containsAudioChannel( AudioChannel* audioChannel )
 }
 
 bool ChannelGroup::applyEffectsToChannels( AudioBuffer* bufferToMixInto )
+{
+    return applyEffectsToChannels( bufferToMixInto, _mixBuffer->bufferSize );
+}
+
+bool ChannelGroup::applyEffectsToChannels( AudioBuffer* bufferToMixInto, int amountOfSamples )
 {
     if ( _audioChannels.empty() ) {
         return false;
@@ -118,15 +124,27 @@ bool ChannelGroup::applyEffectsToChannels( AudioBuffer* bufferToMixInto )
         if ( !audioChannel->isMono ) isMono = false;
     }
 
+#ifdef RECORD_TO_DISK
+    // exporting stems ? write the dry group output
+    if ( StemExporter::isExporting())
+        StemExporter::writeGroup( this, _mixBuffer, amountOfSamples, true, 1.0 );
+#endif
+
     // apply the processing chain onto the mix buffer
 
     auto processors = _processingChain->getActiveProcessors();
     total = processors.size();
 
     for ( i = 0; i < total; ++i ) {
-        processors[ i ]->process( _mixBuffer, isMono );
+        processors[ i ]->apply( _mixBuffer, isMono );
     }
 
+#ifdef RECORD_TO_DISK
+    // exporting stems ? write the group output as it is mixed into the output
+    if ( StemExporter::isExporting())
+        StemExporter::writeGroup( this, _mixBuffer, amountOfSamples, false, getVolumeLogarithmic() );
+#endif
+
     // write the processed mix buffer into the output
 
     bufferToMixInto->mergeBuffers( _mixBuffer, 0, 0, getVolumeLogarithmic() );
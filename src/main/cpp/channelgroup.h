@@ -51,6 +51,7 @@ class ChannelGroup
         bool containsAudioChannel( AudioChannel* audioChannel );
 
         bool applyEffectsToChannels( AudioBuffer* bufferToMixInto );
+        bool applyEffectsToChannels( AudioBuffer* bufferToMixInto, int amountOfSamples );
 
     protected:
         float _volume = 1.F;
@@ -0,0 +1,200 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "compactaudiobuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string.h>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+CompactAudioBuffer::CompactAudioBuffer( AudioBuffer* sourceBuffer, SampleFormats::types format ) :
+    CompactAudioBuffer( sourceBuffer->amountOfChannels, sourceBuffer->bufferSize, format )
+{
+    loopeable = sourceBuffer->loopeable;
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        for ( int i = 0; i < bufferSize; ++i )
+            writeSample( c, i, sourceBuffer->readSample( c, i ));
+    }
+}
+
+CompactAudioBuffer::CompactAudioBuffer( int aAmountOfChannels, int aBufferSize, SampleFormats::types format ) :
+    AudioBuffer()
+{
+    amountOfChannels = aAmountOfChannels;
+    bufferSize       = aBufferSize;
+
+    // the contents are not stored as SAMPLE_TYPE, getBufferForChannel() returns nullptr for all channels
+
+    _buffers = new SAMPLE_TYPE*[ std::max( 1, aAmountOfChannels ) ]();
+
+    // SAMPLE_TYPE is not a valid compact format, store as floating point instead
+    _format = ( format == SampleFormats::PCM16 ) ? SampleFormats::PCM16 : SampleFormats::FLOAT32;
+
+    allocateChannels();
+}
+
+CompactAudioBuffer::~CompactAudioBuffer()
+{
+    while ( !_channels.empty()) {
+        delete[] _channels.back(), _channels.pop_back();
+    }
+}
+
+/* public methods */
+
+SampleFormats::types CompactAudioBuffer::getFormat()
+{
+    return _format;
+}
+
+AudioBuffer* CompactAudioBuffer::clone()
+{
+    CompactAudioBuffer* output = new CompactAudioBuffer( amountOfChannels, bufferSize, _format );
+    output->loopeable = loopeable;
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+        memcpy( output->_channels[ c ], _channels[ c ], bufferSize * getSampleSize() );
+
+    return output;
+}
+
+size_t CompactAudioBuffer::getMemoryUsage()
+{
+    return ( size_t ) amountOfChannels * bufferSize * getSampleSize();
+}
+
+SAMPLE_TYPE CompactAudioBuffer::readSample( int aChannelNum, int aPosition )
+{
+    if ( _format == SampleFormats::PCM16 )
+        return ( SAMPLE_TYPE ) reinterpret_cast<int16_t*>( _channels[ aChannelNum ])[ aPosition ] * getScale();
+
+    return ( SAMPLE_TYPE ) reinterpret_cast<float*>( _channels[ aChannelNum ])[ aPosition ];
+}
+
+void CompactAudioBuffer::writeSample( int aChannelNum, int aPosition, SAMPLE_TYPE value )
+{
+    if ( _format == SampleFormats::PCM16 )
+    {
+        // values are rounded so the contents of 16-bit source files are stored losslessly
+
+        SAMPLE_TYPE sample = std::max(( SAMPLE_TYPE ) -1.0, std::min(( SAMPLE_TYPE ) 1.0, value ));
+        reinterpret_cast<int16_t*>( _channels[ aChannelNum ])[ aPosition ] = ( int16_t ) round( sample * 32767.0 );
+    }
+    else {
+        reinterpret_cast<float*>( _channels[ aChannelNum ])[ aPosition ] = ( float ) value;
+    }
+}
+
+int CompactAudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume )
+{
+    if ( aBuffer == nullptr || aWriteOffset >= bufferSize )
+        return 0;
+
+    int sourceLength     = aBuffer->bufferSize;
+    int maxSourceChannel = aBuffer->amountOfChannels - 1;
+    int maxWriteOffset   = bufferSize;
+    int writtenSamples   = 0;
+    int c;
+
+    for ( c = 0; c < amountOfChannels; ++c )
+    {
+        if ( c > maxSourceChannel )
+            break;
+
+        for ( int i = aWriteOffset, r = aReadOffset; i < maxWriteOffset; ++i, ++r )
+        {
+            if ( r >= sourceLength )
+            {
+                if ( aBuffer->loopeable )
+                    r = 0;
+                else
+                    break;
+            }
+            writeSample( c, i, readSample( c, i ) + aBuffer->readSample( c, r ) * aMixVolume );
+            ++writtenSamples;
+        }
+    }
+    // return the amount of samples written (per buffer)
+    return ( c == 0 ) ? writtenSamples : writtenSamples / c;
+}
+
+bool CompactAudioBuffer::isSilent()
+{
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            if ( readSample( c, i ) != 0.0 )
+                return false;
+        }
+    }
+    return true;
+}
+
+void CompactAudioBuffer::silenceBuffers()
+{
+    // zero bits equal 0 for both integer and floating point formats
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+        memset( _channels[ c ], 0, bufferSize * getSampleSize() );
+}
+
+void CompactAudioBuffer::adjustBufferVolumes( SAMPLE_TYPE amp )
+{
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        for ( int i = 0; i < bufferSize; ++i )
+            writeSample( c, i, readSample( c, i ) * amp );
+    }
+}
+
+void CompactAudioBuffer::applyMonoSource()
+{
+    for ( int c = 1; c < amountOfChannels; ++c )
+        memcpy( _channels[ c ], _channels[ 0 ], bufferSize * getSampleSize() );
+}
+
+SAMPLE_TYPE CompactAudioBuffer::getScale()
+{
+    return ( _format == SampleFormats::PCM16 ) ? 1.0 / 32767.0 : 1.0;
+}
+
+/* protected methods */
+
+size_t CompactAudioBuffer::getSampleSize()
+{
+    return ( _format == SampleFormats::PCM16 ) ? sizeof( int16_t ) : sizeof( float );
+}
+
+void CompactAudioBuffer::allocateChannels()
+{
+    for ( int c = 0; c < amountOfChannels; ++c )
+        _channels.push_back( new char[ bufferSize * getSampleSize() ]);
+}
+
+} // E.O namespace MWEngine
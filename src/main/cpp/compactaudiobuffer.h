@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__COMPACTAUDIOBUFFER_H_INCLUDED__
+#define __MWENGINE__COMPACTAUDIOBUFFER_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "definitions/sampleformats.h"
+
+/**
+ * CompactAudioBuffer holds sample data in a format that requires less memory than
+ * SAMPLE_TYPE (see SampleFormats), for instance to reduce the memory footprint of
+ * the samples registered in the SampleManager. The stored values are converted to
+ * SAMPLE_TYPE while SampleEvents mix their contents.
+ *
+ * NOTE : as the contents are not stored as SAMPLE_TYPE, getBufferForChannel() returns nullptr.
+ * The remaining AudioBuffer methods operate on the stored values directly (or read values through
+ * readSample()), though CompactAudioBuffers are intended to be used as sample sources only
+ */
+namespace MWEngine {
+class CompactAudioBuffer : public AudioBuffer
+{
+    public:
+        // creates a copy of the contents of given AudioBuffer in given format
+        CompactAudioBuffer( AudioBuffer* sourceBuffer, SampleFormats::types format );
+        ~CompactAudioBuffer();
+
+        SampleFormats::types getFormat();
+        AudioBuffer* clone();
+        size_t getMemoryUsage();
+
+        SAMPLE_TYPE readSample( int aChannelNum, int aPosition );
+        void writeSample( int aChannelNum, int aPosition, SAMPLE_TYPE value );
+
+        int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
+        bool isSilent();
+        void silenceBuffers();
+        void adjustBufferVolumes( SAMPLE_TYPE amp );
+        void applyMonoSource();
+
+        // the stored values multiplied by this scale give their SAMPLE_TYPE value
+
+        SAMPLE_TYPE getScale();
+
+        // the data for given channel, T should match the storage format
+        // (e.g. int16_t for SampleFormats::PCM16 and float for SampleFormats::FLOAT32)
+
+        template <typename T>
+        inline const T* getChannel( int channel )
+        {
+            return reinterpret_cast<const T*>( _channels[ channel ]);
+        }
+
+    protected:
+        CompactAudioBuffer( int aAmountOfChannels, int aBufferSize, SampleFormats::types format );
+
+        SampleFormats::types _format;
+        std::vector<char*> _channels;
+
+        size_t getSampleSize();
+        void allocateChannels();
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__EVENTTYPES_H_INCLUDED__
+#define __MWENGINE__EVENTTYPES_H_INCLUDED__
+
+namespace MWEngine {
+class EventTypes
+{
+    public:
+        // the concrete type of an audio event (see BaseAudioEvent::getEventType()), this allows
+        // the sequencer and renderer to invoke the implementations of the engines event types directly
+        // CUSTOM describes types derived outside of the engine, which are invoked through their virtual methods
+
+        enum types {
+            UNCLASSIFIED,
+            BASE,   // BaseAudioEvent
+            SAMPLE, // SampleEvent, DrumEvent
+            SYNTH,  // BaseSynthEvent, SynthEvent
+            CUSTOM
+        };
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -44,10 +44,17 @@ class Notifications
 
             /* recording actions */
 
-            RECORDED_SNIPPET_READY,     // single snippet is ready for writing to storage
-            RECORDED_SNIPPET_SAVED,     // single snippet has been written to storage and flushed from memory
-            RECORDING_COMPLETED,        // recording has completed in full all snippets have been saved into requested output file, memory and temp files flushed
+            RECORDED_SNIPPET_READY,     // no longer broadcast (recordings are streamed onto storage by the DiskWriter)
+            RECORDED_SNIPPET_SAVED,     // no longer broadcast (recordings are streamed onto storage by the DiskWriter)
+            RECORDING_COMPLETED,        // recording has completed in full and has been written into the requested output file
             BOUNCE_COMPLETE,            // bouncing has completed, see RECORDING_COMPLETED
+            OFFLINE_RENDER_PROGRESS,    // AudioEngine::renderOffline() has progressed, payload describes the rendered percentage
+
+            /* sample loading actions */
+
+            SAMPLE_LOAD_PROGRESS,       // a file has been processed by the SampleLoader, payload describes the amount of processed files
+            SAMPLE_LOAD_ERROR,          // a file could not be read by the SampleLoader, payload describes the index of the file
+            SAMPLE_LOAD_COMPLETE,       // the SampleLoader has registered its samples, payload describes the amount of registered samples
 
             /* system messages */
 
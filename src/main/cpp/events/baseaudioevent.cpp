@@ -24,10 +24,15 @@
 #include <global.h>
 #include <audioengine.h>
 #include <instruments/baseinstrument.h>
+#include <events/basecacheableaudioevent.h>
+#include <events/drumevent.h>
+#include <events/synthevent.h>
 #include <utilities/bufferutility.h>
 #include <utilities/eventutility.h>
+#include <utilities/eventpool.h>
 #include <utilities/volumeutil.h>
 #include <algorithm>
+#include <typeinfo>
 
 namespace MWEngine {
 
@@ -52,6 +57,17 @@ BaseAudioEvent::~BaseAudioEvent()
 
 /* public methods */
 
+void* BaseAudioEvent::operator new( size_t size )
+{
+    return EventPool::allocate( size );
+}
+
+void BaseAudioEvent::operator delete( void* event, size_t size )
+{
+    // as the destructor is virtual, size describes the derived type of the deleted event
+    EventPool::release( event, size );
+}
+
 BaseInstrument* BaseAudioEvent::getInstrument()
 {
     return _instrument;
@@ -141,11 +157,16 @@ void BaseAudioEvent::removeFromSequencer()
 
 int BaseAudioEvent::getEventLength()
 {
-    return _eventLength;
+    int eventStart, eventEnd, eventLength;
+    resolveRange( eventStart, eventEnd, eventLength );
+
+    return eventLength;
 }
 
 void BaseAudioEvent::setEventLength( int value )
 {
+    syncToTempo();
+
     if ( _eventLength == value ) return;
 
     // if the events playback range is about to change, remove/add the event after the update
@@ -170,16 +191,23 @@ void BaseAudioEvent::setEventLength( int value )
     // update end position in seconds
     _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
 
+    updateTicks();
+
     if ( mustSyncWithInstrument ) _instrument->addEvent( this, false );
 }
 
 int BaseAudioEvent::getEventStart()
 {
-    return _eventStart;
+    int eventStart, eventEnd, eventLength;
+    resolveRange( eventStart, eventEnd, eventLength );
+
+    return eventStart;
 }
 
 void BaseAudioEvent::setEventStart( int value )
 {
+    syncToTempo();
+
     if ( _eventStart == value ) return;
 
     // if the events playback range is about to change, remove/add the event after the update
@@ -201,16 +229,23 @@ void BaseAudioEvent::setEventStart( int value )
     // update start position in seconds
     _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
 
+    updateTicks();
+
     if ( mustSyncWithInstrument ) _instrument->addEvent( this, false );
 }
 
 int BaseAudioEvent::getEventEnd()
 {
-    return _eventEnd;
+    int eventStart, eventEnd, eventLength;
+    resolveRange( eventStart, eventEnd, eventLength );
+
+    return eventEnd;
 }
 
 void BaseAudioEvent::setEventEnd( int value )
 {
+    syncToTempo();
+
     if ( _eventEnd == value ) return;
 
     // if the events playback range is about to change, remove/add the event after the update
@@ -238,12 +273,14 @@ void BaseAudioEvent::setEventEnd( int value )
     if ( _eventLength != expectedLength ) {
         _eventLength = expectedLength;
     }
+    updateTicks();
+
     if ( mustSyncWithInstrument ) _instrument->addEvent( this, false );
 }
 
 void BaseAudioEvent::positionEvent( int startMeasure, int subdivisions, int offset )
 {
-    int samplesPerBar = AudioEngine::samples_per_bar; // will always match current tempo, time sig at right sample rate
+    int samplesPerBar = getContext()->samples_per_bar; // will always match current tempo, time sig at right sample rate
 
     int startOffset = samplesPerBar * startMeasure;
     startOffset    += offset * samplesPerBar / subdivisions;
@@ -251,16 +288,50 @@ void BaseAudioEvent::positionEvent( int startMeasure, int subdivisions, int offs
     setEventStart( startOffset );
 }
 
+double BaseAudioEvent::getEventStartTicks()
+{
+    return _eventStartTicks;
+}
+
+void BaseAudioEvent::setEventStartTicks( double value )
+{
+    AudioEngineContext* context = getContext();
+
+    if ( context->getTempoMap() == nullptr && context->samples_per_bar <= 0 ) return;
+
+    // translates to the start offset in samples, after which
+    // the musical position is set to the exact given value
+
+    syncToTempo();
+    setEventStart( ticksToSamples( value ));
+    _eventStartTicks = value;
+}
+
+double BaseAudioEvent::getEventEndTicks()
+{
+    return _eventStartTicks + _eventLengthTicks;
+}
+
+bool BaseAudioEvent::hasFixedDuration()
+{
+    return !_tempoRelative || _eventLength <= 0;
+}
+
 void BaseAudioEvent::repositionToTempoChange( float ratio )
 {
     // updating the start offset should automatically adjust the eventEnd accordingly
     // observe we keep the event length equal (BaseSynthEvent does adjust the length to the tempo)
-    setEventStart(( int )( _eventStart  * ratio ));
+    setEventStart(( int )( getEventStart() * ratio ));
 }
 
 float BaseAudioEvent::getStartPosition()
 {
-    return _startPosition;
+    int eventStart, eventEnd, eventLength;
+
+    if ( !resolveRange( eventStart, eventEnd, eventLength ))
+        return _startPosition;
+
+    return BufferUtility::bufferToSeconds( eventStart, AudioEngineProps::SAMPLE_RATE );
 }
 
 void BaseAudioEvent::setStartPosition( float value )
@@ -273,7 +344,12 @@ void BaseAudioEvent::setStartPosition( float value )
 
 float BaseAudioEvent::getEndPosition()
 {
-    return _endPosition;
+    int eventStart, eventEnd, eventLength;
+
+    if ( !resolveRange( eventStart, eventEnd, eventLength ))
+        return _endPosition;
+
+    return BufferUtility::bufferToSeconds( eventEnd, AudioEngineProps::SAMPLE_RATE );
 }
 
 void BaseAudioEvent::setEndPosition( float value )
@@ -286,12 +362,12 @@ void BaseAudioEvent::setEndPosition( float value )
 
 float BaseAudioEvent::getDuration()
 {
-    return _endPosition - _startPosition;
+    return getEndPosition() - getStartPosition();
 }
 
 void BaseAudioEvent::setDuration( float value )
 {
-    setEndPosition( _startPosition + value );
+    setEndPosition( getStartPosition() + value );
 }
 
 bool BaseAudioEvent::isDeletable()
@@ -302,6 +378,7 @@ bool BaseAudioEvent::isDeletable()
 void BaseAudioEvent::setDeletable( bool value )
 {
     _deleteMe = value;
+    invalidateEventHeader();
 }
 
 bool BaseAudioEvent::isEnabled()
@@ -312,6 +389,7 @@ bool BaseAudioEvent::isEnabled()
 void BaseAudioEvent::setEnabled( bool value )
 {
     _enabled = value;
+    invalidateEventHeader();
 }
 
 void BaseAudioEvent::lock()
@@ -357,77 +435,9 @@ void BaseAudioEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     if ( !hasBuffer() )
         return;
 
-    lock(); // prevents buffer mutations (from outside threads) during this read cycle
-
-    int bufferSize = outputBuffer->bufferSize;
-
-    // if the buffer channel amount differs from the output channel amount, we might
-    // potentially have a bad time (e.g. engine has mono output while this event is stereo)
-    // ideally events should never hold more channels than AudioEngineProps::OUTPUT_CHANNELS
-
-    int outputChannels = outputBuffer->amountOfChannels;
-
-    // but mixing mono events into multichannel output is OK
-    bool mixMono = _buffer->amountOfChannels < outputChannels;
-
-    int bufferPointer, readPointer, i, c;
-    SAMPLE_TYPE* srcBuffer;
-    SAMPLE_TYPE* tgtBuffer;
-
     // prevent overflowing allocated memory when reading from the source buffer
-    int maxReadPos = _buffer->bufferSize;
-
-    for ( i = 0; i < bufferSize; ++i )
-    {
-        bufferPointer = i + bufferPosition;
-
-        // over the max position ? read from the start ( implies that sequence has started loop )
-        if ( bufferPointer > maxBufferPosition )
-        {
-            if ( useChannelRange )  // TODO: channels use a min buffer position too ? (currently drummachine only)
-                bufferPointer -= maxBufferPosition;
-
-            else if ( !loopStarted )
-                break;
-        }
-
-        if ( bufferPointer >= _eventStart && bufferPointer <= _eventEnd )
-        {
-            // mind the offset here ( source buffer starts at 0 while
-            // the _eventStart defines where the event is positioned
-            // subtract it from current sequencer pointer to get the
-            // offset relative to the source buffer
-
-            readPointer = bufferPointer - _eventStart;
-
-            for ( c = 0; c < outputChannels; ++c )
-            {
-                srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
-                tgtBuffer = outputBuffer->getBufferForChannel( c );
-
-                if ( readPointer < maxReadPos )
-                    tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
-            }
-        }
-        else if ( loopStarted && i >= loopOffset )
-        {
-            bufferPointer = minBufferPosition + ( i - loopOffset );
-
-            if ( bufferPointer >= _eventStart && bufferPointer <= _eventEnd )
-            {
-                readPointer = bufferPointer - _eventStart;
-
-                for ( c = 0; c < outputChannels; ++c )
-                {
-                    srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
-                    tgtBuffer = outputBuffer->getBufferForChannel( c );
-
-                    tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
-                }
-            }
-        }
-    }
-    unlock();   // release lock
+    mixSequencedSource( BufferSource( _buffer ), _buffer->bufferSize, outputBuffer, bufferPosition,
+                        minBufferPosition, maxBufferPosition, loopStarted, loopOffset, useChannelRange );
 }
 
 /**
@@ -468,11 +478,18 @@ void BaseAudioEvent::construct()
     _eventStart        = 0;
     _eventEnd          = 0;
     _eventLength       = 0;
+    _eventStartTicks   = 0.0;
+    _eventLengthTicks  = 0.0;
+    _ticksBarLength    = 0;
+    _ticksTempoMap     = 0;
+    _tempoRelative     = false;
     _startPosition     = 0.F;
     _endPosition       = 0.F;
     _instrument        = nullptr;
     _deleteMe          = false;
     _livePlayback      = false;
+    _eventType         = EventTypes::UNCLASSIFIED;
+    _cacheable         = false;
     isSequenced        = true;
 }
 
@@ -485,6 +502,178 @@ void BaseAudioEvent::destroyBuffer()
     }
 }
 
+void BaseAudioEvent::syncToTempo()
+{
+    AudioEngineContext* context = getContext();
+    TempoMap* tempoMap          = context->getTempoMap();
+    int samplesPerBar           = context->samples_per_bar;
+
+    if ( !isOutOfSync( tempoMap, samplesPerBar ))
+        return;
+
+    // event was positioned while the bar length was unknown, sample based properties are leading
+
+    if ( _ticksTempoMap == 0 && _ticksBarLength <= 0 ) {
+        updateTicks();
+        return;
+    }
+
+    int eventStart, eventEnd, eventLength;
+    deriveRange( tempoMap, samplesPerBar, eventStart, eventEnd, eventLength );
+
+    _ticksTempoMap  = ( tempoMap != nullptr ) ? tempoMap->getVersion() : 0;
+    _ticksBarLength = samplesPerBar;
+
+    _eventStart    = eventStart;
+    _eventEnd      = eventEnd;
+    _eventLength   = eventLength;
+    _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
+    _endPosition   = BufferUtility::bufferToSeconds( _eventEnd,   AudioEngineProps::SAMPLE_RATE );
+}
+
+void BaseAudioEvent::updateTicks()
+{
+    // invoked whenever the sample based properties have changed
+
+    invalidateEventHeader();
+
+    AudioEngineContext* context = getContext();
+    TempoMap* tempoMap          = context->getTempoMap();
+    int samplesPerBar           = context->samples_per_bar;
+
+    _ticksTempoMap  = ( tempoMap != nullptr ) ? tempoMap->getVersion() : 0;
+    _ticksBarLength = std::max( 0, samplesPerBar );
+
+    if ( tempoMap == nullptr && samplesPerBar <= 0 ) {
+        return;
+    }
+    _eventStartTicks  = samplesToTicks( _eventStart );
+    _eventLengthTicks = samplesToTicks( _eventStart + _eventLength ) - _eventStartTicks;
+}
+
+bool BaseAudioEvent::resolveRange( int& eventStart, int& eventEnd, int& eventLength )
+{
+    eventStart  = _eventStart;
+    eventEnd    = _eventEnd;
+    eventLength = _eventLength;
+
+    // the render thread operates on the transport snapshot of the context it renders, which can
+    // describe a different tempo than the context currently has (see AudioEngineContext::publishTransport())
+
+    TempoMap* tempoMap;
+    int samplesPerBar;
+
+    AudioEngineContext* renderingContext = AudioEngineContext::getRenderingContext();
+
+    if ( renderingContext != nullptr ) {
+        const transportState& transport = renderingContext->getTransport();
+        tempoMap      = transport.tempoMap;
+        samplesPerBar = transport.samples_per_bar;
+    } else {
+        AudioEngineContext* context = getContext();
+        tempoMap      = context->getTempoMap();
+        samplesPerBar = context->samples_per_bar;
+    }
+
+    // stored properties are leading when the event was positioned while the bar length was unknown
+
+    if ( !isOutOfSync( tempoMap, samplesPerBar ) || ( _ticksTempoMap == 0 && _ticksBarLength <= 0 ))
+        return false;
+
+    deriveRange( tempoMap, samplesPerBar, eventStart, eventEnd, eventLength );
+
+    return true;
+}
+
+bool BaseAudioEvent::isOutOfSync( TempoMap* tempoMap, int samplesPerBar )
+{
+    if ( tempoMap != nullptr )
+        return _ticksTempoMap != tempoMap->getVersion();
+
+    return samplesPerBar > 0 && ( _ticksTempoMap != 0 || _ticksBarLength != samplesPerBar );
+}
+
+void BaseAudioEvent::deriveRange( TempoMap* tempoMap, int samplesPerBar, int& eventStart, int& eventEnd, int& eventLength )
+{
+    // events of a fixed duration (e.g. samples) only move their start offset while
+    // tempo relative events (e.g. synthesized notes) scale their duration as well
+
+    int eventSpan = _eventEnd - _eventStart;
+
+    eventStart  = ticksToSamples( _eventStartTicks, tempoMap, samplesPerBar );
+    eventLength = _eventLength;
+
+    if ( _tempoRelative && _eventLength > 0 ) {
+        eventLength = std::max( 1, ticksToSamples( _eventStartTicks + _eventLengthTicks, tempoMap, samplesPerBar ) - eventStart );
+        eventEnd    = eventStart + ( eventLength - 1 );
+    }
+    else {
+        eventEnd = eventStart + eventSpan;
+    }
+}
+
+void BaseAudioEvent::invalidateEventHeader()
+{
+    // only sequenced events are described by headers, live events can be
+    // updated by the render thread, which should not contend for the instrument lock
+
+    if ( _instrument != nullptr && isSequenced ) {
+        _instrument->updateEventHeader( this );
+    }
+}
+
+void BaseAudioEvent::classifyEventType()
+{
+    // only exact matches are classified as the engines types, derived types
+    // might override the methods the sequencer and renderer invoke directly
+
+    _cacheable = dynamic_cast<BaseCacheableAudioEvent*>( this ) != nullptr;
+
+    const std::type_info& type = typeid( *this );
+
+    if ( type == typeid( SampleEvent ) || type == typeid( DrumEvent )) {
+        _eventType = EventTypes::SAMPLE;
+    } else if ( type == typeid( SynthEvent ) || type == typeid( BaseSynthEvent )) {
+        _eventType = EventTypes::SYNTH;
+    } else if ( type == typeid( BaseAudioEvent )) {
+        _eventType = EventTypes::BASE;
+    } else {
+        _eventType = EventTypes::CUSTOM;
+    }
+}
+
+double BaseAudioEvent::samplesToTicks( int samples )
+{
+    AudioEngineContext* context = getContext();
+    TempoMap* tempoMap          = context->getTempoMap();
+
+    if ( tempoMap != nullptr )
+        return tempoMap->samplesToTicks( samples );
+
+    return BufferUtility::samplesToTicks( samples, context->samples_per_bar );
+}
+
+int BaseAudioEvent::ticksToSamples( double ticks )
+{
+    AudioEngineContext* context = getContext();
+    return ticksToSamples( ticks, context->getTempoMap(), context->samples_per_bar );
+}
+
+int BaseAudioEvent::ticksToSamples( double ticks, TempoMap* tempoMap, int samplesPerBar )
+{
+    if ( tempoMap != nullptr )
+        return tempoMap->ticksToSamples( ticks );
+
+    return BufferUtility::ticksToSamples( ticks, samplesPerBar );
+}
+
+AudioEngineContext* BaseAudioEvent::getContext()
+{
+    // events are positioned relative to the tempo of the context sequencing their instrument
+
+    return ( _instrument != nullptr ) ? _instrument->getContext() : &AudioEngine::defaultContext;
+}
+
 bool BaseAudioEvent::isAddedToSequencer()
 {
     if ( _instrument != nullptr )
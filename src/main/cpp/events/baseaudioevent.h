@@ -24,10 +24,34 @@
 #define __MWENGINE__BASEAUDIOEVENT_H_INCLUDED__
 
 #include "../audiobuffer.h"
+#include "../definitions/eventtypes.h"
 
 namespace MWEngine {
 
-class BaseInstrument;  // forward declaration, see <instruments/baseinstrument.h>
+class BaseInstrument;      // forward declaration, see <instruments/baseinstrument.h>
+class AudioEngineContext;  // forward declaration, see <audioenginecontext.h>
+class TempoMap;            // forward declaration, see <tempomap.h>
+
+#ifndef SWIG
+// internal to the engine
+
+/**
+ * describes the source the sequenced mixing routine (see BaseAudioEvent::mixSequencedSource())
+ * reads its sample data from. Derived event types can provide their own sources (e.g.
+ * SampleEvent reads compact and streamed samples), where channel() returns a channel
+ * that is indexed by sample frame position
+ */
+struct BufferSource
+{
+    BufferSource( AudioBuffer* buffer ) : buffer( buffer ), amountOfChannels( buffer->amountOfChannels ) {}
+
+    inline SAMPLE_TYPE* channel( int c ) const { return buffer->getBufferForChannel( c ); }
+
+    AudioBuffer* buffer;
+    int amountOfChannels;
+};
+#endif
+
 class BaseAudioEvent
 {
     public:
@@ -47,6 +71,13 @@ class BaseAudioEvent
 #ifndef SWIG
         // internal to the engine
 
+        /**
+         * events (of all derived types) are allocated from the EventPool, which
+         * stores events of similar size in contiguous memory, see utilities/eventpool.h
+         */
+        static void* operator new( size_t size );
+        static void operator delete( void* event, size_t size );
+
         /**
          * Used by the AudioEngine to mix in parts of this events buffer for a specific range
          * the buffer samples written are equal to the length of given outputBuffers buffer size
@@ -84,6 +115,27 @@ class BaseAudioEvent
         virtual void setBuffer( AudioBuffer* buffer, bool destroyable );
         virtual bool hasBuffer();
 
+        // the measure range this event is indexed under in its instruments measure cache
+        unsigned long cachedStartMeasure = 0;
+        unsigned long cachedEndMeasure   = 0;
+
+        // the concrete type of this event (classified on first request) and whether
+        // it is a BaseCacheableAudioEvent, see definitions/eventtypes.h
+
+        inline EventTypes::types getEventType()
+        {
+            if ( _eventType == EventTypes::UNCLASSIFIED ) {
+                classifyEventType();
+            }
+            return _eventType;
+        }
+
+        inline bool isCacheable()
+        {
+            getEventType(); // ensures the event has been classified
+            return _cacheable;
+        }
+
 #endif
 
         virtual BaseInstrument* getInstrument(); // retrieve reference to the instrument this event belongs to
@@ -142,9 +194,35 @@ class BaseAudioEvent
         // ( 1, 32, 4 ) positions audioEvent at 4 / 32 = 1/8th note in the second measure
         virtual void positionEvent( int startMeasure, int subdivisions, int offset );
 
-        // when changing the sequencer tempo, this adjust the events
-        // position properties (e.g. start / end offset) relative to the previous tempo
+        // internally the AudioEvent is anchored to the Sequencer in musical time, where a single
+        // measure spans TICKS_PER_MEASURE ticks. The positions in buffer samples are derived from the
+        // musical position once the tempo / time signature has changed (e.g. the events remain in place
+        // on the grid). Tempo changes do not update the events, the getters above derive the positions
+        // for the tempo the calling thread operates at instead (see resolveRange())
+
+        virtual double getEventStartTicks();
+        virtual void setEventStartTicks( double value );
+
+#ifndef SWIG
+        // internal to the engine, stores the sample based properties derived from the musical position
+        // when the tempo has changed. Invoked by the controlling thread when mutating the event
+
+        void syncToTempo();
+
+        // the musical end of the event (in ticks), only describes the end of events whose
+        // duration follows the tempo (e.g. synthesized notes, see hasFixedDuration())
+
+        double getEventEndTicks();
+
+        // whether the duration of this event is expressed in samples (e.g. samples) and
+        // as such remains equal when the tempo changes
+
+        bool hasFixedDuration();
+#endif
+
+        // scales the events position properties (e.g. start / end offset) by given ratio
         // a value above 1.0 implies a decrease in speed, a value below 1.0 an increase
+        // NOTE : tempo changes no longer require this as events follow the tempo through their musical position
 
         virtual void repositionToTempoChange( float ratio );
 
@@ -187,11 +265,59 @@ class BaseAudioEvent
 
         void construct();   // basic initialization which can be shared across overloaded constructors
 
+#ifndef SWIG
+        // mixes the contents of given source for the sequencer range described in mixBuffer(), where
+        // maxReadPos describes the amount of sample frames that can be read from the source
+
+        template <class Source>
+        void mixSequencedSource( const Source& source, int maxReadPos, AudioBuffer* outputBuffer, int bufferPosition,
+                                 int minBufferPosition, int maxBufferPosition, bool loopStarted, int loopOffset,
+                                 bool useChannelRange );
+#endif
+
         float _volume;
         int _eventStart;
         int _eventEnd;
         int _eventLength;
 
+        // musical position (see getEventStartTicks()), from which the
+        // sample based properties above are derived on tempo change
+
+        double _eventStartTicks;
+        double _eventLengthTicks;
+        int          _ticksBarLength; // the bar length the sample based properties were last derived at
+        unsigned int _ticksTempoMap;  // the TempoMap version the sample based properties were last derived at (0 for none)
+        bool         _tempoRelative;  // whether the event length scales with the tempo (e.g. synthesized events)
+
+        void updateTicks(); // derives the musical position from the sample based properties
+
+        // informs the instrument the sequencing properties (e.g. range, enabled state) of this event have changed
+
+        void invalidateEventHeader();
+
+        // resolves the sample based range of this event at the tempo the calling thread operates at (the
+        // transport snapshot when invoked by the render thread). When the stored properties were derived
+        // at a different tempo, the range is derived from the musical position without storing it, in
+        // which case true is returned
+
+        bool resolveRange( int& eventStart, int& eventEnd, int& eventLength );
+
+        // whether the stored sample based properties were derived at a different tempo than given tempo
+
+        bool isOutOfSync( TempoMap* tempoMap, int samplesPerBar );
+
+        // derives the sample based range of this event from its musical position at given tempo
+
+        void deriveRange( TempoMap* tempoMap, int samplesPerBar, int& eventStart, int& eventEnd, int& eventLength );
+
+        // conversion between musical ticks and buffer samples at the current tempo (see AudioEngineContext::getTempoMap())
+        // of the context sequencing this event (the default context when the event has no instrument)
+
+        double samplesToTicks( int samples );
+        int ticksToSamples( double ticks );
+        int ticksToSamples( double ticks, TempoMap* tempoMap, int samplesPerBar );
+        AudioEngineContext* getContext();
+
         // buffer regions
 
         float _startPosition;
@@ -219,7 +345,94 @@ class BaseAudioEvent
         // managed / disposed outside of this AudioEvent!)
 
         bool _destroyableBuffer;
+
+        EventTypes::types _eventType;
+        bool _cacheable;
+        void classifyEventType();
 };
+
+#ifndef SWIG
+
+template <class Source>
+void BaseAudioEvent::mixSequencedSource( const Source& source, int maxReadPos, AudioBuffer* outputBuffer, int bufferPosition,
+                                         int minBufferPosition, int maxBufferPosition, bool loopStarted, int loopOffset,
+                                         bool useChannelRange )
+{
+    lock(); // prevents buffer mutations (from outside threads) during this read cycle
+
+    int bufferSize = outputBuffer->bufferSize;
+
+    // if the buffer channel amount differs from the output channel amount, we might
+    // potentially have a bad time (e.g. engine has mono output while this event is stereo)
+    // ideally events should never hold more channels than AudioEngineProps::OUTPUT_CHANNELS
+
+    int outputChannels = outputBuffer->amountOfChannels;
+
+    // but mixing mono events into multichannel output is OK
+    bool mixMono = source.amountOfChannels < outputChannels;
+
+    // the range of the event at the tempo of the current render cycle
+
+    int eventStart, eventEnd, eventLength;
+    resolveRange( eventStart, eventEnd, eventLength );
+
+    int bufferPointer, readPointer, i, c;
+    SAMPLE_TYPE* tgtBuffer;
+
+    for ( i = 0; i < bufferSize; ++i )
+    {
+        bufferPointer = i + bufferPosition;
+
+        // over the max position ? read from the start ( implies that sequence has started loop )
+        if ( bufferPointer > maxBufferPosition )
+        {
+            if ( useChannelRange )  // TODO: channels use a min buffer position too ? (currently drummachine only)
+                bufferPointer -= maxBufferPosition;
+
+            else if ( !loopStarted )
+                break;
+        }
+
+        if ( bufferPointer >= eventStart && bufferPointer <= eventEnd )
+        {
+            // mind the offset here ( source buffer starts at 0 while
+            // the eventStart defines where the event is positioned
+            // subtract it from current sequencer pointer to get the
+            // offset relative to the source buffer
+
+            readPointer = bufferPointer - eventStart;
+
+            for ( c = 0; c < outputChannels; ++c )
+            {
+                auto srcBuffer = source.channel( mixMono ? 0 : c );
+                tgtBuffer      = outputBuffer->getBufferForChannel( c );
+
+                if ( readPointer < maxReadPos )
+                    tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
+            }
+        }
+        else if ( loopStarted && i >= loopOffset )
+        {
+            bufferPointer = minBufferPosition + ( i - loopOffset );
+
+            if ( bufferPointer >= eventStart && bufferPointer <= eventEnd )
+            {
+                readPointer = bufferPointer - eventStart;
+
+                for ( c = 0; c < outputChannels; ++c )
+                {
+                    auto srcBuffer = source.channel( mixMono ? 0 : c );
+                    tgtBuffer      = outputBuffer->getBufferForChannel( c );
+
+                    tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
+                }
+            }
+        }
+    }
+    unlock();   // release lock
+}
+
+#endif
 } // E.O namespace MWEngine
 
 #endif
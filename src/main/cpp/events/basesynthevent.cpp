@@ -97,7 +97,7 @@ void BaseSynthEvent::stop()
         // so we know events are audible for at least a 64th
         _minLength = std::max(
             _synthInstrument->adsr->getReleaseDuration(),
-            AudioEngine::samples_per_bar / 64
+            getContext()->samples_per_bar / 64
         );
         _hasMinLength = false;
 
@@ -181,8 +181,8 @@ void BaseSynthEvent::unlock()
 
 void BaseSynthEvent::repositionToTempoChange( float ratio )
 {
-    auto orgStart  = ( float ) _eventStart;
-    auto orgLength = ( float ) _eventLength;
+    auto orgStart  = ( float ) getEventStart();
+    auto orgLength = ( float ) getEventLength();
 
     setEventStart(( int )( orgStart  * ratio ));
 
@@ -199,15 +199,17 @@ void BaseSynthEvent::calculateBuffers()
         return;
     }
 
+    AudioEngineContext* context = getContext();
+
     if ( isSequenced )
     {
-        setEventStart( position * AudioEngine::samples_per_step );
-        setEventLength(( int )( length * AudioEngine::samples_per_step ));
+        setEventStart( position * context->samples_per_step );
+        setEventLength(( int )( length * context->samples_per_step ));
     }
     else {
         // quick releases of a noteOn-instruction should ring for at least a 64th note
-        setEventLength( AudioEngine::samples_per_bar );     // important for amplitude swell in
-        _minLength    = AudioEngine::samples_per_bar / 64;
+        setEventLength( context->samples_per_bar );         // important for amplitude swell in
+        _minLength    = context->samples_per_bar / 64;
         _hasMinLength = false;                          // keeping track if the min length has been rendered
     }
 
@@ -242,19 +244,23 @@ void BaseSynthEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPos,
 
     int bufferEndPos = bufferPos + outputBuffer->bufferSize;
 
-    // we use the overridden getter method as the event length can be
-    // extended by a positive release time on the instruments ADSR envelope
-    int eventEnd = getEventEnd();
+    // the range of the event at the tempo of the current render cycle
+
+    int eventStart, noteEnd, eventLength;
+    resolveRange( eventStart, noteEnd, eventLength );
 
-    if (( bufferPos >= _eventStart || bufferEndPos > _eventStart ) &&
+    // the event length can be extended by a positive release time on the instruments ADSR envelope
+    int eventEnd = noteEnd + _synthInstrument->adsr->getReleaseDuration();
+
+    if (( bufferPos >= eventStart || bufferEndPos > eventStart ) &&
           bufferPos < eventEnd )
     {
-        lastWriteIndex  = _eventStart > bufferPos ? 0 : bufferPos - _eventStart;
-        int writeOffset = _eventStart > bufferPos ? _eventStart - bufferPos : 0;
+        lastWriteIndex  = eventStart > bufferPos ? 0 : bufferPos - eventStart;
+        int writeOffset = eventStart > bufferPos ? eventStart - bufferPos : 0;
 
         // if we're mixing into the ADSR release tail, make sure release envelope is triggered
 
-        if ( bufferPos > _eventEnd ) {
+        if ( bufferPos > noteEnd ) {
             if ( !released ) {
                 triggerRelease();
             }
@@ -270,7 +276,7 @@ void BaseSynthEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPos,
         outputBuffer->mergeBuffers( _buffer, 0, writeOffset, 1.0 );
 
         // reset of event properties at end of write
-        if ( lastWriteIndex >= _eventLength )
+        if ( lastWriteIndex >= eventLength )
             calculateBuffers();
     }
 
@@ -281,7 +287,7 @@ void BaseSynthEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPos,
 
         int totalSamplesToWrite = outputBuffer->bufferSize - loopOffset;
 
-        if (( minBufferPosition >= _eventStart || ( minBufferPosition + totalSamplesToWrite ) > _eventStart ) &&
+        if (( minBufferPosition >= eventStart || ( minBufferPosition + totalSamplesToWrite ) > eventStart ) &&
               minBufferPosition < eventEnd )
         {
             // render the snippet from the starts
@@ -375,6 +381,8 @@ void BaseSynthEvent::setDeletable( bool value )
         _deleteMe = value;
     else
         _queuedForDeletion = value;
+
+    invalidateEventHeader();
 }
 
 void BaseSynthEvent::triggerRelease()
@@ -420,6 +428,7 @@ void BaseSynthEvent::init( SynthInstrument* aInstrument, float aFrequency,
     _queuedForDeletion = false;
     _deleteMe          = false;
     _hasMinLength      = isSequenced; // a sequenced event has no early cancel
+    _tempoRelative     = true;        // the event duration is expressed in sequencer steps
     _eventLength       = 0;
     lastWriteIndex     = 0;
 
@@ -45,7 +45,8 @@ DrumEvent::DrumEvent( int aPosition, int aDrumType, int aDrumTimbre, BaseInstrum
     init( aInstrument );
 
     position    = aPosition;
-    _eventStart = position * AudioEngine::samples_per_step;
+    _eventStart = position * getContext()->samples_per_step;
+    updateTicks();
 
     setType  ( aDrumType );
     setTimbre( aDrumTimbre );
@@ -104,40 +105,37 @@ void DrumEvent::unlock()
 
 void DrumEvent::updateSample()
 {
-    std::string smp;
+    // the sample identifiers are interned once, their SampleIds remain
+    // valid when the samples are (re)registered in the SampleManager
+
+    static const SampleId kick        = SampleManager::getSampleId( "kd" );
+    static const SampleId kickGravel  = SampleManager::getSampleId( "kdg" );
+    static const SampleId stick       = SampleManager::getSampleId( "st" );
+    static const SampleId stickGravel = SampleManager::getSampleId( "stg" );
+    static const SampleId snare       = SampleManager::getSampleId( "sn" );
+    static const SampleId snareGravel = SampleManager::getSampleId( "sng" );
+    static const SampleId hiHat       = SampleManager::getSampleId( "hh" );
+    static const SampleId hiHatGravel = SampleManager::getSampleId( "hhg" );
+
+    bool gravel  = ( _timbre == DrumTimbres::GRAVEL );
+    SampleId smp = SampleManager::NO_SAMPLE;
 
     switch ( _type )
     {
         case PercussionTypes::KICK_808:
-
-            if ( _timbre == DrumTimbres::GRAVEL )
-                smp = "kdg";
-            else
-                smp = "kd";
+            smp = gravel ? kickGravel : kick;
             break;
 
         case PercussionTypes::STICK:
-
-            if ( _timbre == DrumTimbres::GRAVEL )
-                smp = "stg";
-            else
-                smp = "st";
+            smp = gravel ? stickGravel : stick;
             break;
 
         case PercussionTypes::SNARE:
-
-            if ( _timbre == DrumTimbres::GRAVEL )
-                smp = "sng";
-            else
-                smp = "sn";
+            smp = gravel ? snareGravel : snare;
             break;
 
         case PercussionTypes::HI_HAT:
-
-            if ( _timbre == DrumTimbres::GRAVEL )
-                smp = "hhg";
-            else
-                smp = "hh";
+            smp = gravel ? hiHatGravel : hiHat;
             break;
     }
     setSample( SampleManager::getSample( smp ));
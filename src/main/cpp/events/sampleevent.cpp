@@ -21,6 +21,8 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <utilities/bufferutility.h>
+#include <utilities/diskstreamer.h>
+#include <utilities/samplemanager.h>
 #include "sampleevent.h"
 #include "../audioengine.h"
 #include "../global.h"
@@ -28,6 +30,51 @@
 
 namespace MWEngine {
 
+/**
+ * the sources the mixing routines read their sample data from, in memory samples
+ * are read directly from their AudioBuffer (see BufferSource), compact samples are
+ * converted while reading and streamed samples via their SampleStreamReader
+ * (in both cases the channel returned by channel() is indexed by sample frame position)
+ */
+template <typename T>
+struct CompactChannel
+{
+    inline SAMPLE_TYPE operator[]( int position ) const { return ( SAMPLE_TYPE ) data[ position ] * scale; }
+
+    const T* data;
+    SAMPLE_TYPE scale;
+};
+
+template <typename T>
+struct CompactSource
+{
+    CompactSource( CompactAudioBuffer* buffer ) : buffer( buffer ), amountOfChannels( buffer->amountOfChannels ), scale( buffer->getScale()) {}
+
+    inline CompactChannel<T> channel( int c ) const { return { buffer->getChannel<T>( c ), scale }; }
+
+    CompactAudioBuffer* buffer;
+    int amountOfChannels;
+    SAMPLE_TYPE scale;
+};
+
+struct StreamChannel
+{
+    inline SAMPLE_TYPE operator[]( int position ) const { return reader->read( channel, position ); }
+
+    SampleStreamReader* reader;
+    int channel;
+};
+
+struct StreamSource
+{
+    StreamSource( SampleStreamReader* reader ) : reader( reader ), amountOfChannels( reader->getStream()->getAmountOfChannels() ) {}
+
+    inline StreamChannel channel( int c ) const { return { reader, c }; }
+
+    SampleStreamReader* reader;
+    int amountOfChannels;
+};
+
 /* constructor / destructor */
 
 SampleEvent::SampleEvent()
@@ -44,7 +91,8 @@ SampleEvent::SampleEvent( BaseInstrument* aInstrument )
 
 SampleEvent::~SampleEvent()
 {
-    // nowt...
+    destroyStreamReader();
+    releaseBuffer();
 }
 
 /* public methods */
@@ -65,6 +113,8 @@ void SampleEvent::setEventLength( int value )
 {
     if ( _loopeable ) {
 
+        syncToTempo();
+
         _eventLength = value;
 
         // loopeable-events differ from non-loopable events in that
@@ -80,6 +130,8 @@ void SampleEvent::setEventLength( int value )
 
         // update end position in seconds
         _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+
+        updateTicks();
     }
     else {
         BaseAudioEvent::setEventLength( value );
@@ -93,10 +145,14 @@ void SampleEvent::setEventEnd( int value )
         return;
     }
 
+    syncToTempo();
+
     _eventEnd = value;
 
     // update end position in seconds
     _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+
+    updateTicks();
 }
 
 int SampleEvent::getBufferRangeStart()
@@ -123,11 +179,16 @@ void SampleEvent::setBufferRangeStart( int value )
 
     // buffer range may never exceed the length of the source buffer (which can be unequal to the sample length)
 
-    if ( _buffer != nullptr && _bufferRangeEnd >= _buffer->bufferSize )
-        setBufferRangeEnd( _buffer->bufferSize - 1 );
+    if ( hasBuffer() && _bufferRangeEnd >= getSourceLength() )
+        setBufferRangeEnd( getSourceLength() - 1 );
 
     _bufferRangeLength = ( _bufferRangeEnd - _bufferRangeStart ) + 1;
     setRangeBasedPlayback( _bufferRangeLength != _eventLength );
+
+    // streamed samples keep the range start in memory so playback can instantly jump to it
+
+    if ( _streamReader != nullptr )
+        _streamReader->setAnchor( 0, _bufferRangeStart );
 }
 
 int SampleEvent::getBufferRangeEnd()
@@ -138,7 +199,7 @@ int SampleEvent::getBufferRangeEnd()
 void SampleEvent::setBufferRangeEnd( int value )
 {
     // buffer range may never exceed the length of the source buffer (which can be unequal to the sample length)
-    _bufferRangeEnd = ( _buffer != nullptr ) ? std::min( value, _buffer->bufferSize - 1 ): value;
+    _bufferRangeEnd = hasBuffer() ? std::min( value, getSourceLength() - 1 ): value;
 
     if ( _rangePointer > _bufferRangeEnd )
         _rangePointer = _bufferRangeEnd;
@@ -189,11 +250,14 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
     _locked        = true;
 
     int sampleLength = sampleBuffer->bufferSize;
+    AudioBuffer* previousBuffer = _retainedBuffer ? _buffer : nullptr;
 
     // delete previous contents
     if ( _eventLength != sampleLength )
         destroyBuffer();
 
+    destroyStreamReader();
+
     // is this events buffer destroyable ? then clone
     // the input buffer, if not, merely point to it to
     // minimize memory consumption when re-using existing samples
@@ -204,30 +268,36 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
         _buffer = sampleBuffer;
 
     _buffer->loopeable = _loopeable;
-    setEventLength( sampleLength );
-    setEventEnd   ( _eventStart + ( _eventLength - 1 ));
+    _compactBuffer     = dynamic_cast<CompactAudioBuffer*>( _buffer );
+    retainBuffer( previousBuffer );
+    initSample( sampleLength, sampleRate );
 
-    // in case the given event has a sample rate that differs from the engine
-    // adjust the playback rate of the sample accordingly
+    if ( !wasLocked )
+        _locked = false;
 
-    _sampleRate = sampleRate;
-    if ( _sampleRate != AudioEngineProps::SAMPLE_RATE ) {
-        setPlaybackRate( _playbackRate / ( float ) AudioEngineProps::SAMPLE_RATE * ( float ) _sampleRate );
-    }
+    return true;
+}
 
-    // when switching samples, existing buffer ranges are reset
+bool SampleEvent::setSample( SampleStream* sampleStream )
+{
+    if ( sampleStream == nullptr || !sampleStream->isValid() )
+        return false;
 
-    _bufferRangeStart  = 0;
-    setBufferRangeEnd( _bufferRangeStart + ( _eventLength - 1 )); // also updates range length
-    setRangeBasedPlayback( false );
+    bool wasLocked = _locked;
+    _locked        = true;
 
-    // reset loop offsets to play the full sample
+    // release the previous contents, streamed samples hold no buffer
 
-    _loopStartOffset = 0;
-    _loopEndOffset   = sampleLength - 1;
-    cacheFades();
+    releaseBuffer();
+    destroyBuffer();
+    destroyStreamReader();
+    _buffer        = nullptr;
+    _compactBuffer = nullptr;
 
-    _updateAfterUnlock = false; // unnecessary
+    _streamReader = new SampleStreamReader( sampleStream );
+    DiskStreamer::addReader( _streamReader );
+
+    initSample( sampleStream->getLength(), sampleStream->getSampleRate() );
 
     if ( !wasLocked )
         _locked = false;
@@ -235,6 +305,31 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
     return true;
 }
 
+SampleStream* SampleEvent::getSampleStream()
+{
+    return ( _streamReader != nullptr ) ? _streamReader->getStream() : nullptr;
+}
+
+bool SampleEvent::hasBuffer()
+{
+    return _buffer != nullptr || _streamReader != nullptr;
+}
+
+void SampleEvent::setBuffer( AudioBuffer* buffer, bool destroyable )
+{
+    AudioBuffer* previousBuffer = nullptr;
+
+    // a retained buffer is owned by the SampleManager and should not be deleted by the base class
+
+    if ( _retainedBuffer ) {
+        previousBuffer = _buffer;
+        _buffer = nullptr;
+    }
+    BaseAudioEvent::setBuffer( buffer, destroyable );
+    _compactBuffer = dynamic_cast<CompactAudioBuffer*>( _buffer );
+    retainBuffer( previousBuffer );
+}
+
 float SampleEvent::getPlaybackRate()
 {
     return _playbackRate;
@@ -244,6 +339,7 @@ void SampleEvent::setPlaybackRate( float value )
 {
     // allow only 100x slowdown and speed up
     _playbackRate = std::max( 0.01f, std::min( 100.f, value ));
+    invalidateEventHeader(); // affects the event end
 }
 
 bool SampleEvent::isLoopeable()
@@ -260,6 +356,8 @@ void SampleEvent::setLoopeable( bool value, int crossfadeInMilliseconds )
 
     _crossfadeMs = crossfadeInMilliseconds;
     cacheFades();
+
+    invalidateEventHeader(); // affects the event end
 }
 
 int SampleEvent::getReadPointer()
@@ -274,9 +372,14 @@ int SampleEvent::getLoopStartOffset()
 
 void SampleEvent::setLoopStartOffset( int value )
 {
-    int max = _buffer != nullptr ? _buffer->bufferSize : _eventLength;
+    int max = hasBuffer() ? getSourceLength() : _eventLength;
     _loopStartOffset = std::min( value, std::max( 0, max - 1 ));
     cacheFades();
+
+    // streamed samples keep the loop start in memory so playback can instantly jump to it
+
+    if ( _streamReader != nullptr )
+        _streamReader->setAnchor( 1, _loopStartOffset );
 }
 
 int SampleEvent::getLoopEndOffset()
@@ -286,7 +389,7 @@ int SampleEvent::getLoopEndOffset()
 
 void SampleEvent::setLoopEndOffset( int value )
 {
-    int max = _buffer != nullptr ? _buffer->bufferSize : _eventLength;
+    int max = hasBuffer() ? getSourceLength() : _eventLength;
     _loopEndOffset = std::min( value, std::max( 0, max - 1 ));
     cacheFades();
 }
@@ -303,7 +406,7 @@ int SampleEvent::getOriginalEventLength()
 
 int SampleEvent::getEventEnd()
 {
-    return ( _playbackRate == 1.f || _loopeable ) ? _eventEnd : _eventStart + getEventLength();
+    return ( _playbackRate == 1.f || _loopeable ) ? BaseAudioEvent::getEventEnd() : getEventStart() + getEventLength();
 }
 
 void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
@@ -313,11 +416,193 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     if ( !hasBuffer() )
         return;
 
+    // streamed samples publish their last read position to the disk thread prior to reading
+
+    if ( _streamReader != nullptr ) {
+        _streamReader->sync();
+        mixSource( StreamSource( _streamReader ), outputBuffer, bufferPosition, minBufferPosition,
+                   maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+    }
+    else if ( _compactBuffer == nullptr ) {
+        mixSource( BufferSource( _buffer ), outputBuffer, bufferPosition, minBufferPosition,
+                   maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+    }
+    else if ( _compactBuffer->getFormat() == SampleFormats::PCM16 ) {
+        mixSource( CompactSource<int16_t>( _compactBuffer ), outputBuffer, bufferPosition, minBufferPosition,
+                   maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+    }
+    else {
+        mixSource( CompactSource<float>( _compactBuffer ), outputBuffer, bufferPosition, minBufferPosition,
+                   maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+    }
+}
+
+/**
+ * Invoked by the Sequencer in case this event isn't sequenced
+ * but triggered manually via a "noteOn" / "noteOff" operation for instant "live" playback
+ */
+void SampleEvent::mixBuffer( AudioBuffer* outputBuffer )
+{
+    // write sample contents into live buffer
+    // we specify the maximum buffer position as the full sample playback range
+    mixBuffer( outputBuffer, _lastPlaybackPosition, 0, getBufferRangeLength(), false, 0, false );
+
+    if (( _lastPlaybackPosition += outputBuffer->bufferSize ) >= getBufferRangeEnd() )
+    {
+        // if this is a one-shot SampleEvent, remove it from the sequencer when we have exceeded
+        // the sample length (e.g. played it in its entirety)
+
+        if ( !_loopeable )
+            stop();
+        else
+            _lastPlaybackPosition = std::max( _bufferRangeStart, _lastPlaybackPosition - getBufferRangeLength());
+    }
+}
+
+bool SampleEvent::getRangeBasedPlayback()
+{
+    return _useBufferRange;
+}
+
+void SampleEvent::setRangeBasedPlayback( bool value )
+{
+    _useBufferRange = value;
+}
+
+bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
+{
+    if ( _streamReader != nullptr )
+        return mixRange( StreamSource( _streamReader ), buffer, readPos );
+
+    if ( _compactBuffer == nullptr )
+        return mixRange( BufferSource( _buffer ), buffer, readPos );
+
+    if ( _compactBuffer->getFormat() == SampleFormats::PCM16 )
+        return mixRange( CompactSource<int16_t>( _compactBuffer ), buffer, readPos );
+
+    return mixRange( CompactSource<float>( _compactBuffer ), buffer, readPos );
+}
+
+/* protected methods */
+
+void SampleEvent::init( BaseInstrument* instrument )
+{
+    _bufferRangeStart     = 0;
+    _bufferRangeEnd       = 0;
+    _bufferRangeLength    = 0;
+    _loopeable            = false;
+    _crossfadeMs          = 0;
+    _crossfadeStart       = 0;
+    _crossfadeEnd         = 0;
+    _readPointer          = 0;
+    _loopStartOffset      = 0;
+    _loopEndOffset        = 0;
+    _rangePointer         = 0;     // integer for non altered playback rates
+    _rangePointerF        = 0.f;   // floating point for alternate playback rates
+    _lastPlaybackPosition = 0;
+    _playbackRate         = 1.f;
+    _readPointerF         = 0.f;
+    _destroyableBuffer    = false; // is referenced via SampleManager !
+    _useBufferRange       = false;
+    _instrument           = instrument;
+    _sampleRate           = ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
+    _streamReader         = nullptr;
+    _compactBuffer        = nullptr;
+    _retainedBuffer       = false;
+}
+
+void SampleEvent::initSample( int sampleLength, unsigned int sampleRate )
+{
+    setEventLength( sampleLength );
+    setEventEnd   ( _eventStart + ( _eventLength - 1 ));
+
+    // in case the given event has a sample rate that differs from the engine
+    // adjust the playback rate of the sample accordingly
+
+    _sampleRate = sampleRate;
+    if ( _sampleRate != AudioEngineProps::SAMPLE_RATE ) {
+        setPlaybackRate( _playbackRate / ( float ) AudioEngineProps::SAMPLE_RATE * ( float ) _sampleRate );
+    }
+
+    // when switching samples, existing buffer ranges are reset
+
+    _bufferRangeStart  = 0;
+    setBufferRangeEnd( _bufferRangeStart + ( _eventLength - 1 )); // also updates range length
+    setRangeBasedPlayback( false );
+
+    // reset loop offsets to play the full sample
+
+    _loopStartOffset = 0;
+    _loopEndOffset   = sampleLength - 1;
+    cacheFades();
+
+    _updateAfterUnlock = false; // unnecessary
+}
+
+int SampleEvent::getSourceLength()
+{
+    if ( _streamReader != nullptr )
+        return _streamReader->getStream()->getLength();
+
+    return ( _buffer != nullptr ) ? _buffer->bufferSize : 0;
+}
+
+void SampleEvent::destroyStreamReader()
+{
+    if ( _streamReader == nullptr )
+        return;
+
+    // once removed from the DiskStreamer, the reader is no longer accessed by the disk thread
+
+    DiskStreamer::removeReader( _streamReader );
+    delete _streamReader;
+    _streamReader = nullptr;
+}
+
+void SampleEvent::retainBuffer( AudioBuffer* previousBuffer )
+{
+    // buffers owned by this event are not managed by the SampleManager
+    // the new buffer is retained before the previous one is released as they can be equal
+
+    _retainedBuffer = !_destroyableBuffer && _buffer != nullptr && SampleManager::retainSample( _buffer );
+
+    if ( previousBuffer != nullptr )
+        SampleManager::releaseSample( previousBuffer );
+}
+
+void SampleEvent::releaseBuffer()
+{
+    if ( _retainedBuffer )
+        SampleManager::releaseSample( _buffer );
+
+    _retainedBuffer = false;
+}
+
+void SampleEvent::cacheFades()
+{
+    if ( _crossfadeMs > 0 ) {
+
+        // calculate the amount of samples we deem satisfactory to prevent popping at non-zero crossings
+        int samplesToFade = BufferUtility::millisecondsToBuffer( _crossfadeMs, AudioEngineProps::SAMPLE_RATE );
+        _crossfadeStart   = _loopEndOffset   - samplesToFade; // at end of sample, prior to looping
+        _crossfadeEnd     = _loopStartOffset + samplesToFade; // from beginning of loop start offset
+    }
+    else {
+        _crossfadeStart = _loopEndOffset;
+        _crossfadeEnd   = 0;
+    }
+}
+
+template <class Source>
+void SampleEvent::mixSource( const Source& source, AudioBuffer* outputBuffer, int bufferPosition,
+                             int minBufferPosition, int maxBufferPosition,
+                             bool loopStarted, int loopOffset, bool useChannelRange )
+{
     // if we have a range length that is unequal to the total sample duration, read from the range
     // otherwise invoke the base mixBuffer method
 
     if ( _useBufferRange ) {
-        getBufferForRange( outputBuffer, bufferPosition );
+        mixRange( source, outputBuffer, bufferPosition );
         return;
     }
 
@@ -325,6 +610,11 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     int maxReadPos = _loopEndOffset;
     bool crossfade = _crossfadeStart != _loopEndOffset || _crossfadeEnd != 0;
 
+    // the range of the event at the tempo of the current render cycle
+
+    int eventStart, eventEnd, eventLength;
+    resolveRange( eventStart, eventEnd, eventLength );
+
     // if the buffer channel amount differs from the output channel amount, we might
     // potentially have a bad time (e.g. engine has mono output while this event is stereo)
     // ideally events should never hold more channels than AudioEngineProps::OUTPUT_CHANNELS
@@ -332,22 +622,21 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     int outputChannels = outputBuffer->amountOfChannels;
 
     // but mixing mono events into multichannel output is OK
-    bool mixMono = _buffer->amountOfChannels < outputChannels;
+    bool mixMono = source.amountOfChannels < outputChannels;
 
     if ( _playbackRate == 1.f )
     {
         // use BaseAudioEvent behaviour if no custom playback rate nor looping is set
 
         if ( !_loopeable ) {
-            BaseAudioEvent::mixBuffer( outputBuffer, bufferPosition, minBufferPosition,
-                                       maxBufferPosition, loopStarted, loopOffset, useChannelRange );
+            mixSequencedSource( source, getSourceLength(), outputBuffer, bufferPosition, minBufferPosition,
+                                maxBufferPosition, loopStarted, loopOffset, useChannelRange );
         }
         else
         {
             // loopeable events mix their buffer contents using an internal read pointer
 
             int bufferPointer, i, c, ca;
-            SAMPLE_TYPE* srcBuffer;
             SAMPLE_TYPE* tgtBuffer;
 
             bool sampleLoopStarted = false;
@@ -361,11 +650,11 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                 // read sample when the read pointer is within event start and end points
                 // (or always read when live playback)
 
-                if ( _livePlayback || ( bufferPointer >= _eventStart && bufferPointer <= _eventEnd ))
+                if ( _livePlayback || ( bufferPointer >= eventStart && bufferPointer <= eventEnd ))
                 {
                     // when playing event from the beginning, ensure that its looped sample is playing from the beginning
 
-                    if ( bufferPointer == _eventStart && !_livePlayback )
+                    if ( bufferPointer == eventStart && !_livePlayback )
                         _readPointer = 0;
 
                     if ( crossfade )
@@ -384,7 +673,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                     // use range pointers to read within the specific buffer ranges
                     for ( c = 0, ca = outputChannels; c < ca; ++c )
                     {
-                        srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
+                        auto srcBuffer = source.channel( mixMono ? 0 : c );
 
                         tgtBuffer       = outputBuffer->getBufferForChannel( c );
                         tgtBuffer[ i ] += ( srcBuffer[ _readPointer ] * volume );
@@ -407,7 +696,6 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
 
     int i, t, t2, c, ca;
     float frac;
-    SAMPLE_TYPE* srcBuffer;
     SAMPLE_TYPE* tgtBuffer;
     SAMPLE_TYPE s1, s2;
 
@@ -417,7 +705,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     // offset as due to rounding of floating point increments, we rely on integer comparison
     // to ensure we remain in range to prevent overflowing of allocated memory ranges
 
-    float fEventStart        = ( float ) _eventStart;
+    float fEventStart        = ( float ) eventStart;
     float fEventEnd          = ( float ) getEventEnd();
     float fMinBufferPosition = ( float ) minBufferPosition;
     float fMaxBufferPosition = _playbackRate < 1.F ? maxBufferPosition / _playbackRate : maxBufferPosition * _playbackRate;
@@ -435,7 +723,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
 
     if ( !_loopeable )
     {
-        fEventEnd = _eventEnd; // use unstretched end (see below fBufferPointer calculation)
+        fEventEnd = eventEnd; // use unstretched end (see below fBufferPointer calculation)
 
         for ( i = 0; i < bufferSize; ++i, fi += _playbackRate )
         {
@@ -466,7 +754,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
 
                 for ( c = 0; c < outputChannels; ++c )
                 {
-                    srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
+                    auto srcBuffer = source.channel( mixMono ? 0 : c );
                     tgtBuffer = outputBuffer->getBufferForChannel( c );
 
                     t2 = t + 1;
@@ -509,7 +797,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                     fBufferPosition = 0.0f;
                     fi              = 0.0f;
                 }
-                else if (( bufferPosition + i ) == _eventStart ) {
+                else if (( bufferPosition + i ) == eventStart ) {
                     _readPointerF = 0.0f;
                     fi            = 0.0f;
                 }
@@ -552,7 +840,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                 // use range pointers to read within the specific buffer ranges
                 for ( c = 0, ca = outputChannels; c < ca; ++c )
                 {
-                    srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
+                    auto srcBuffer = source.channel( mixMono ? 0 : c );
                     tgtBuffer = outputBuffer->getBufferForChannel( c );
 
                     t2 = t + 1;
@@ -583,55 +871,22 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     }
 }
 
-/**
- * Invoked by the Sequencer in case this event isn't sequenced
- * but triggered manually via a "noteOn" / "noteOff" operation for instant "live" playback
- */
-void SampleEvent::mixBuffer( AudioBuffer* outputBuffer )
-{
-    // write sample contents into live buffer
-    // we specify the maximum buffer position as the full sample playback range
-    mixBuffer( outputBuffer, _lastPlaybackPosition, 0, getBufferRangeLength(), false, 0, false );
-
-    if (( _lastPlaybackPosition += outputBuffer->bufferSize ) >= getBufferRangeEnd() )
-    {
-        // if this is a one-shot SampleEvent, remove it from the sequencer when we have exceeded
-        // the sample length (e.g. played it in its entirety)
-
-        if ( !_loopeable )
-            stop();
-        else
-            _lastPlaybackPosition = std::max( _bufferRangeStart, _lastPlaybackPosition - getBufferRangeLength());
-    }
-}
-
-bool SampleEvent::getRangeBasedPlayback()
-{
-    return _useBufferRange;
-}
-
-void SampleEvent::setRangeBasedPlayback( bool value )
-{
-    _useBufferRange = value;
-}
-
-bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
+template <class Source>
+bool SampleEvent::mixRange( const Source& source, AudioBuffer* buffer, int readPos )
 {
     int bufferSize          = buffer->bufferSize;
     int amountOfChannels    = buffer->amountOfChannels;
     bool gotBuffer          = false;
-    bool monoCopy           = _buffer->amountOfChannels < amountOfChannels;
+    bool monoCopy           = source.amountOfChannels < amountOfChannels;
 
     bool useInternalPointer = _loopeable;
 
     if ( useInternalPointer )
         readPos = _readPointer;
 
-    int eventStart = _eventStart;
+    int eventStart = getEventStart();
     int eventEnd   = getEventEnd();
 
-    SAMPLE_TYPE* srcBuffer;
-
     if ( _playbackRate == 1.f )
     {
         for ( int i = 0; i < bufferSize; ++i )
@@ -643,10 +898,7 @@ bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
                 for ( int c = 0; c < amountOfChannels; ++c )
                 {
                     // this sample might have less channels than the output buffer
-                    if ( !monoCopy )
-                        srcBuffer = _buffer->getBufferForChannel( c );
-                    else
-                        srcBuffer = _buffer->getBufferForChannel( 0 );
+                    auto srcBuffer = source.channel( monoCopy ? 0 : c );
 
                     SAMPLE_TYPE* targetBuffer = buffer->getBufferForChannel( c );
                     targetBuffer[ i ]        += ( srcBuffer[ _rangePointer ] * _volume );
@@ -686,10 +938,7 @@ bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
                 for ( int c = 0; c < amountOfChannels; ++c )
                 {
                     // this sample might have less channels than the output buffer
-                    if ( !monoCopy )
-                        srcBuffer = _buffer->getBufferForChannel( c );
-                    else
-                        srcBuffer = _buffer->getBufferForChannel( 0 );
+                    auto srcBuffer = source.channel( monoCopy ? 0 : c );
 
                     s1 = srcBuffer[ t ];
                     s2 = srcBuffer[ t + 1 ];
@@ -718,44 +967,4 @@ bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
     return gotBuffer;
 }
 
-/* protected methods */
-
-void SampleEvent::init( BaseInstrument* instrument )
-{
-    _bufferRangeStart     = 0;
-    _bufferRangeEnd       = 0;
-    _bufferRangeLength    = 0;
-    _loopeable            = false;
-    _crossfadeMs          = 0;
-    _crossfadeStart       = 0;
-    _crossfadeEnd         = 0;
-    _readPointer          = 0;
-    _loopStartOffset      = 0;
-    _loopEndOffset        = 0;
-    _rangePointer         = 0;     // integer for non altered playback rates
-    _rangePointerF        = 0.f;   // floating point for alternate playback rates
-    _lastPlaybackPosition = 0;
-    _playbackRate         = 1.f;
-    _readPointerF         = 0.f;
-    _destroyableBuffer    = false; // is referenced via SampleManager !
-    _useBufferRange       = false;
-    _instrument           = instrument;
-    _sampleRate           = ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
-}
-
-void SampleEvent::cacheFades()
-{
-    if ( _crossfadeMs > 0 ) {
-
-        // calculate the amount of samples we deem satisfactory to prevent popping at non-zero crossings
-        int samplesToFade = BufferUtility::millisecondsToBuffer( _crossfadeMs, AudioEngineProps::SAMPLE_RATE );
-        _crossfadeStart   = _loopEndOffset   - samplesToFade; // at end of sample, prior to looping
-        _crossfadeEnd     = _loopStartOffset + samplesToFade; // from beginning of loop start offset
-    }
-    else {
-        _crossfadeStart = _loopEndOffset;
-        _crossfadeEnd   = 0;
-    }
-}
-
 } // E.O namespace MWEngine
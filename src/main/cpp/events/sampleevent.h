@@ -24,7 +24,10 @@
 #define __MWENGINE__SAMPLEEVENT_H_INCLUDED__
 
 #include "baseaudioevent.h"
+#include "../compactaudiobuffer.h"
 #include <instruments/baseinstrument.h>
+#include <utilities/samplestream.h>
+#include <utilities/samplestreamreader.h>
 
 namespace MWEngine {
 class SampleEvent : public BaseAudioEvent
@@ -55,6 +58,19 @@ class SampleEvent : public BaseAudioEvent
 
         bool setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate );
 
+        // use this method to play back a sample directly from disk (e.g. for long samples that would
+        // otherwise occupy a large amount of memory), the sampling rate is that of the streamed file
+        // NOTE : the SampleStream is not owned by this event and can be shared by multiple events
+
+        bool setSample( SampleStream* sampleStream );
+
+        // the SampleStream this event is streaming from (null when playing back an in-memory sample)
+
+        SampleStream* getSampleStream();
+
+        bool hasBuffer();
+        void setBuffer( AudioBuffer* buffer, bool destroyable );
+
         float getPlaybackRate();
         void setPlaybackRate( float value );
 
@@ -130,8 +146,38 @@ class SampleEvent : public BaseAudioEvent
         unsigned int _sampleRate;
         int _lastPlaybackPosition;
 
+        // streamed samples are read through a reader owned by this event
+
+        SampleStreamReader* _streamReader;
+
+        // samples stored in a compact format are converted during mixing
+        // (references _buffer when it is a CompactAudioBuffer)
+
+        CompactAudioBuffer* _compactBuffer;
+
+        // whether _buffer is retained in the SampleManager (preventing its eviction/deletion while in use)
+
+        bool _retainedBuffer;
+
         void init( BaseInstrument* aInstrument );
+        void initSample( int sampleLength, unsigned int sampleRate );
         void cacheFades();
+        void destroyStreamReader();
+        void retainBuffer( AudioBuffer* previousBuffer );
+        void releaseBuffer();
+        int getSourceLength(); // amount of sample frames in the in-memory buffer or stream
+
+#ifndef SWIG
+        // the mixing routines are shared by in-memory and streamed samples, where
+        // Source describes how sample frames are read (see sampleevent.cpp)
+
+        template <class Source>
+        void mixSource( const Source& source, AudioBuffer* outputBuffer, int bufferPosition, int minBufferPosition,
+                        int maxBufferPosition, bool loopStarted, int loopOffset, bool useChannelRange );
+
+        template <class Source>
+        bool mixRange( const Source& source, AudioBuffer* buffer, int readPos );
+#endif
 };
 } // E.O namespace MWEngine
 
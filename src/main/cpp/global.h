@@ -108,6 +108,7 @@ const SAMPLE_TYPE TWO_PI = PI * 2.0;
 // other
 
 const int WAVE_TABLE_PRECISION = 128; // the amount of samples contained within a wave table
+const int TICKS_PER_MEASURE    = 3840; // resolution of the musical time events are positioned in (see BaseAudioEvent)
 
 #ifdef PREVENT_CPU_FREQUENCY_SCALING
 
@@ -25,9 +25,26 @@
 #include <sequencer.h>
 #include <utilities/eventutility.h>
 #include <algorithm>
+#include <unordered_set>
+#include <climits>
 
 namespace MWEngine {
 
+// describes the sequencing properties of given event in given header
+
+inline void writeEventHeader( eventHeader& header, BaseAudioEvent* audioEvent )
+{
+    header.event = audioEvent;
+    header.type  = audioEvent->getEventType();
+    header.start = audioEvent->getEventStartTicks();
+    header.end   = audioEvent->getEventEndTicks();
+    header.span  = (( header.type == EventTypes::SYNTH ) ? audioEvent->BaseAudioEvent::getEventEnd() : audioEvent->getEventEnd() ) -
+                   audioEvent->getEventStart();
+    header.flags = ( audioEvent->isEnabled()        ? EVENT_HEADER_ENABLED        : 0 ) |
+                   ( audioEvent->isDeletable()      ? EVENT_HEADER_DELETABLE      : 0 ) |
+                   ( audioEvent->hasFixedDuration() ? EVENT_HEADER_FIXED_DURATION : 0 );
+}
+
 /* constructor / destructor */
 
 BaseInstrument::BaseInstrument()
@@ -83,73 +100,62 @@ std::vector<BaseAudioEvent*>* BaseInstrument::getLiveEvents()
 void BaseInstrument::updateEvents()
 {
     // when updating to reflect changes in the instruments propertes
-    // or to update event properties responding to tempo changes
     // override this function in your derived class for custom implementations
 
-    if ( _oldTempo == AudioEngine::tempo ) {
+    // stores the sample based positions of all events for the current tempo (these are otherwise
+    // derived upon access, see BaseAudioEvent::getEventStart()) while the sequencer is locked out
+
+    if ( _audioEvents == nullptr ) {
         return;
     }
 
-    //std::lock_guard<std::mutex> guard( _lock );
     toggleReadLock( true );
 
-    // when tempo has updated, we update the offsets of all associated events
-    // note the measure cache remains untouched (nothing changes with regards to
-    // measure separation)
-
-    float ratio = _oldTempo / AudioEngine::tempo;
-    _oldTempo   = AudioEngine::tempo;
-
-    // TODO: there is an issue that creeps in with regards to maintaining an accurate measure
-    // cache, get(Start|End)MeasureForEvent relies on AudioEngine::samples_per_bar so the removal is
-    // calculating for the new start/end measure range, therefor possibly missing the old (prior to
-    // tempo change) range values. Additionally, we might risk undefined behaviour on the read locks
-    // for an already locked mutex. We set a flag to prevent event add/remove changes (triggered by their
-    // repositioning) and invoke a manual flush and recache after all sequenced events have been repositioned.
-
-    _freezeEvents = true;
-
-    size_t i = 0, total = _audioEvents->size();
-    for ( ; i < total; ++i ) {
-        _audioEvents->at( i )->repositionToTempoChange( ratio );
+    for ( auto audioEvent : *_audioEvents ) {
+        audioEvent->syncToTempo();
     }
 
-    _freezeEvents = false;
-    clearMeasureCache();
+    for ( auto liveEvent : *_liveAudioEvents ) {
+        liveEvent->syncToTempo();
+    }
+    updateMeasureCache();
+    updateEventHeaders();
 
-    for ( i = 0; i < total; ++i ) {
-        addEventToMeasureCache( _audioEvents->at( i ));
-    };
     toggleReadLock( false );
 }
 
 void BaseInstrument::clearEvents()
 {
+    // copy the lists as removeEvents() mutates them
+
     if ( _audioEvents != nullptr )
     {
-        while ( !_audioEvents->empty() ) {
-            removeEvent( _audioEvents->at( 0 ), false );
-        }
+        std::vector<BaseAudioEvent*> audioEvents( *_audioEvents );
+        removeEvents( &audioEvents, false );
     }
 
     if ( _liveAudioEvents != nullptr )
     {
-        while ( !_liveAudioEvents->empty() ) {
-            removeEvent( _liveAudioEvents->at( 0 ), true );
-        }
+        std::vector<BaseAudioEvent*> liveEvents( *_liveAudioEvents );
+        removeEvents( &liveEvents, true );
     }
 }
 
 void BaseInstrument::addEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
 {
-    if ( _freezeEvents ) return;
-
     //std::lock_guard<std::mutex> guard( _lock );
     toggleReadLock( true );
 
+    // the event might have been positioned at a different tempo
+    audioEvent->syncToTempo();
+
     if ( isLiveEvent ) {
         _liveAudioEvents->push_back( audioEvent );
     } else {
+        // an empty measure cache can be indexed at the current bar length
+        if ( _audioEvents->empty() ) {
+            _measureCacheBarLength = getShortestBarLength();
+        }
         _audioEvents->push_back( audioEvent );
         addEventToMeasureCache( audioEvent );
     }
@@ -158,8 +164,6 @@ void BaseInstrument::addEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
 
 bool BaseInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
 {
-    if ( _freezeEvents ) return false;
-
     bool removed = false;
 
     if ( audioEvent == nullptr || _liveAudioEvents == nullptr || _audioEvents == nullptr ) {
@@ -188,10 +192,159 @@ bool BaseInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
     return removed;
 }
 
+void BaseInstrument::addEvents( std::vector<BaseAudioEvent*>* audioEvents, bool isLiveEvent )
+{
+    if ( audioEvents == nullptr || audioEvents->empty() ) {
+        return;
+    }
+
+    toggleReadLock( true );
+
+    std::vector<BaseAudioEvent*>* events = isLiveEvent ? _liveAudioEvents : _audioEvents;
+
+    // a hash set of the present events replaces a linear lookup per added event
+
+    std::unordered_set<BaseAudioEvent*> addedEvents( events->begin(), events->end() );
+    addedEvents.reserve( events->size() + audioEvents->size() );
+
+    if ( !isLiveEvent && events->empty() ) {
+        _measureCacheBarLength = getShortestBarLength();
+    }
+    events->reserve( events->size() + audioEvents->size() );
+
+    for ( auto audioEvent : *audioEvents )
+    {
+        if ( audioEvent == nullptr || !addedEvents.insert( audioEvent ).second ) {
+            continue;
+        }
+        audioEvent->syncToTempo();
+        events->push_back( audioEvent );
+
+        if ( !isLiveEvent ) {
+            addEventToMeasureCache( audioEvent );
+        }
+    }
+    toggleReadLock( false );
+}
+
+int BaseInstrument::removeEvents( std::vector<BaseAudioEvent*>* audioEvents, bool isLiveEvent )
+{
+    if ( audioEvents == nullptr || audioEvents->empty() || _liveAudioEvents == nullptr || _audioEvents == nullptr ) {
+        return 0;
+    }
+
+    toggleReadLock( true );
+
+    std::vector<BaseAudioEvent*>* events = isLiveEvent ? _liveAudioEvents : _audioEvents;
+    std::unordered_set<BaseAudioEvent*> removals( audioEvents->begin(), audioEvents->end() );
+
+    // a single pass over the event list, collecting the measure range of the removed events
+
+    unsigned long firstMeasure = ULONG_MAX;
+    unsigned long lastMeasure  = 0;
+
+    auto removed = std::remove_if( events->begin(), events->end(), [ & ]( BaseAudioEvent* audioEvent )
+    {
+        if ( removals.find( audioEvent ) == removals.end() ) {
+            return false;
+        }
+        if ( isLiveEvent ) {
+            audioEvent->resetPlayState();
+        } else {
+            firstMeasure = std::min( firstMeasure, audioEvent->cachedStartMeasure );
+            lastMeasure  = std::max( lastMeasure,  audioEvent->cachedEndMeasure );
+        }
+        return true;
+    });
+    int amountRemoved = ( int ) std::distance( removed, events->end() );
+    events->erase( removed, events->end() );
+
+    if ( !isLiveEvent )
+    {
+        for ( size_t i = firstMeasure, l = _audioEventsPerMeasure.size(); i <= lastMeasure && i < l; ++i )
+        {
+            auto eventVector = _audioEventsPerMeasure.at( i );
+            eventVector->erase( std::remove_if( eventVector->begin(), eventVector->end(), [ & ]( BaseAudioEvent* audioEvent ) {
+                return removals.find( audioEvent ) != removals.end();
+            }), eventVector->end() );
+
+            auto headers = _eventHeadersPerMeasure.at( i );
+            headers->erase( std::remove_if( headers->begin(), headers->end(), [ & ]( const eventHeader& header ) {
+                return removals.find( header.event ) != removals.end();
+            }), headers->end() );
+        }
+    }
+    toggleReadLock( false );
+
+    return amountRemoved;
+}
+
+std::vector<eventHeader>* BaseInstrument::getEventHeadersForMeasure( int measureNum )
+{
+    // headers are allocated alongside the measure cache by the controlling thread, no
+    // allocations nor derivations of event properties take place on the render thread
+
+    return _eventHeadersPerMeasure.size() <= ( size_t ) measureNum ? nullptr : _eventHeadersPerMeasure.at( measureNum );
+}
+
+void BaseInstrument::updateMeasureCache()
+{
+    // when the bar length decreases, events of a fixed duration can span more measures than
+    // indexed in the measure cache. This only applies to tempos exceeding those the cache has
+    // been indexed at before, the events themselves are not updated
+
+    int samplesPerBar = getShortestBarLength();
+
+    if ( _audioEvents == nullptr || samplesPerBar <= 0 || samplesPerBar >= _measureCacheBarLength ) {
+        return;
+    }
+
+    toggleReadLock( true );
+
+    _measureCacheBarLength = samplesPerBar;
+    clearMeasureCache();
+
+    for ( size_t i = 0, total = _audioEvents->size(); i < total; ++i ) {
+        addEventToMeasureCache( _audioEvents->at( i ));
+    }
+    toggleReadLock( false );
+}
+
+void BaseInstrument::updateEventHeader( BaseAudioEvent* audioEvent )
+{
+    // updates the headers of given event in place within the measures it has been indexed in
+
+    toggleReadLock( true );
+
+    for ( size_t i = audioEvent->cachedStartMeasure, l = _eventHeadersPerMeasure.size(); i <= audioEvent->cachedEndMeasure && i < l; ++i )
+    {
+        for ( auto& header : *_eventHeadersPerMeasure.at( i )) {
+            if ( header.event == audioEvent ) {
+                writeEventHeader( header, audioEvent );
+            }
+        }
+    }
+    toggleReadLock( false );
+}
+
+int BaseInstrument::getReleaseDuration()
+{
+    return 0;
+}
+
+AudioEngineContext* BaseInstrument::getContext()
+{
+    return ( _context != nullptr ) ? _context : &AudioEngine::defaultContext;
+}
+
+void BaseInstrument::setContext( AudioEngineContext* context )
+{
+    _context = context;
+}
+
 void BaseInstrument::registerInSequencer()
 {
-    index     = Sequencer::registerInstrument( this );
-    _oldTempo = AudioEngine::tempo;
+    index = Sequencer::registerInstrument( this );
 }
 
 void BaseInstrument::unregisterFromSequencer()
@@ -202,12 +355,12 @@ void BaseInstrument::unregisterFromSequencer()
 
 void BaseInstrument::toggleReadLock( bool lock )
 {
-    if ( lock && !_locked ) {
+    // calls must be balanced (each lock followed by an unlock on the same thread)
+
+    if ( lock ) {
         _lock->lock();
-        _locked = true;
-    } else if ( !lock && _locked ){
+    } else {
         _lock->unlock();
-        _locked = false;
     }
 }
 
@@ -216,13 +369,15 @@ void BaseInstrument::toggleReadLock( bool lock )
 void BaseInstrument::construct()
 {
     audioChannel = new AudioChannel( 1.F );
-    _lock        = new std::mutex();
+    _lock        = new std::recursive_mutex();
 
     // events
 
     _audioEvents     = new std::vector<BaseAudioEvent*>();
     _liveAudioEvents = new std::vector<BaseAudioEvent*>();
 
+    _measureCacheBarLength = getShortestBarLength();
+
     // register instrument inside the sequencer
 
     registerInSequencer();
@@ -230,32 +385,64 @@ void BaseInstrument::construct()
 
 void BaseInstrument::addEventToMeasureCache( BaseAudioEvent* audioEvent )
 {
+    // events are indexed by their musical position, which does not change with the tempo
+    // the end measure of events with a fixed duration does, as such we calculate it for the
+    // shortest bar length the cache has been indexed at (see updateEvents())
+
+    int samplesPerBar = std::max( 1, std::min( getShortestBarLength(), _measureCacheBarLength ));
+
+    double startTicks = audioEvent->getEventStartTicks();
+    double endTicks   = startTicks + ( double )( audioEvent->getEventEnd() - audioEvent->getEventStart() ) * TICKS_PER_MEASURE / samplesPerBar;
+
     unsigned long startMeasureForEvent = EventUtility::getStartMeasureForEvent( audioEvent );
-    unsigned long endMeasureForEvent   = EventUtility::getEndMeasureForEvent( audioEvent );
+    unsigned long endMeasureForEvent   = std::max( startMeasureForEvent, ( unsigned long ) floor( endTicks / TICKS_PER_MEASURE ));
+
+    eventHeader header;
+    writeEventHeader( header, audioEvent );
 
     for ( unsigned long i = startMeasureForEvent; i <= endMeasureForEvent; ++i ) {
         while ( _audioEventsPerMeasure.size() <= i ) {
             _audioEventsPerMeasure.push_back( new std::vector<BaseAudioEvent*>() );
+            _eventHeadersPerMeasure.push_back( new std::vector<eventHeader>() );
         }
         _audioEventsPerMeasure.at( i )->push_back( audioEvent );
+        _eventHeadersPerMeasure.at( i )->push_back( header );
     }
+
+    // store the indexed range so removal is not affected by changes in tempo
+
+    audioEvent->cachedStartMeasure = startMeasureForEvent;
+    audioEvent->cachedEndMeasure   = endMeasureForEvent;
 }
 
 void BaseInstrument::removeEventFromMeasureCache( BaseAudioEvent* audioEvent )
 {
-    unsigned long startMeasureForEvent     = EventUtility::getStartMeasureForEvent( audioEvent );
-    unsigned long endMeasureForEvent       = EventUtility::getEndMeasureForEvent( audioEvent );
     unsigned long audioEventPerMeasureSize = _audioEventsPerMeasure.size();
 
-    for ( size_t i = startMeasureForEvent; i <= endMeasureForEvent; ++i ) {
+    for ( size_t i = audioEvent->cachedStartMeasure; i <= audioEvent->cachedEndMeasure; ++i ) {
         if ( i >= audioEventPerMeasureSize ) {
             return;
         }
         auto eventVector = _audioEventsPerMeasure.at( i );
         EventUtility::removeEventFromVector( eventVector, audioEvent );
+
+        auto headers = _eventHeadersPerMeasure.at( i );
+        headers->erase( std::remove_if( headers->begin(), headers->end(), [ audioEvent ]( const eventHeader& header ) {
+            return header.event == audioEvent;
+        }), headers->end() );
     }
 }
 
+int BaseInstrument::getShortestBarLength()
+{
+    // events are positioned relative to the tempo of the context sequencing this instrument
+
+    AudioEngineContext* context = getContext();
+    TempoMap* tempoMap          = context->getTempoMap();
+
+    return ( tempoMap != nullptr ) ? tempoMap->getShortestBarLength() : context->samples_per_bar;
+}
+
 void BaseInstrument::clearMeasureCache()
 {
     size_t i = _audioEventsPerMeasure.size();
@@ -263,8 +450,21 @@ void BaseInstrument::clearMeasureCache()
         auto eventVector = _audioEventsPerMeasure.at( i );
         eventVector->clear();
         delete eventVector;
+        delete _eventHeadersPerMeasure.at( i );
     }
     _audioEventsPerMeasure.clear();
+    _eventHeadersPerMeasure.clear();
+}
+
+void BaseInstrument::updateEventHeaders()
+{
+    // invoked while the read lock is held, after the events have been updated
+
+    for ( auto headers : _eventHeadersPerMeasure ) {
+        for ( auto& header : *headers ) {
+            writeEventHeader( header, header.event );
+        }
+    }
 }
 
 } // E.O namespace MWEngine
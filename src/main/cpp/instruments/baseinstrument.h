@@ -28,6 +28,32 @@
 #include <mutex>
 
 namespace MWEngine {
+
+class AudioEngineContext;
+
+#ifndef SWIG
+// internal to the engine
+
+// a compact description of a sequenced event, used by the sequencer to
+// scan the events of a measure without dereferencing the events themselves
+// positions are musical, as such the headers remain valid when the tempo changes
+
+typedef struct
+{
+    double start;            // event start (in ticks, see BaseAudioEvent::getEventStartTicks())
+    double end;              // event end (in ticks, exclusive) for events following the tempo, excluding the instruments release (see getReleaseDuration())
+    int span;                // distance between event start and end (in samples) for events of a fixed duration
+    unsigned int flags;      // see EVENT_HEADER_ flags below
+    EventTypes::types type;
+    BaseAudioEvent* event;
+} eventHeader;
+
+const unsigned int EVENT_HEADER_ENABLED        = 1;
+const unsigned int EVENT_HEADER_DELETABLE      = 2;
+const unsigned int EVENT_HEADER_FIXED_DURATION = 4; // the event end is described by span instead of end
+
+#endif
+
 class BaseInstrument
 {
     public:
@@ -36,7 +62,7 @@ class BaseInstrument
 
         virtual bool hasEvents();     // whether the instrument has events to sequence
         virtual bool hasLiveEvents(); // whether the instruments has events to synthesize on the fly
-        virtual void updateEvents();  // updates all associated events after changing instrument properties / tempo change
+        virtual void updateEvents();  // updates all associated events after changing instrument properties
 
         virtual std::vector<BaseAudioEvent*>* getEvents();
         virtual std::vector<BaseAudioEvent*>* getEventsForMeasure( int measureNum );
@@ -46,6 +72,39 @@ class BaseInstrument
         virtual void addEvent( BaseAudioEvent* audioEvent, bool isLiveEvent );
         virtual bool removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent );
 
+        // bulk variants of addEvent() and removeEvent(), these mutate the event lists and
+        // measure cache under a single lock, ignoring duplicate events / events not
+        // belonging to this instrument. removeEvents() returns the amount of removed events
+        virtual void addEvents( std::vector<BaseAudioEvent*>* audioEvents, bool isLiveEvent );
+        virtual int removeEvents( std::vector<BaseAudioEvent*>* audioEvents, bool isLiveEvent );
+
+#ifndef SWIG
+        // internal to the engine
+
+        // retrieves the headers of all events in given measure. These are maintained by the controlling
+        // thread whenever the events change, as such the render thread only reads them and the read lock
+        // should be held while doing so
+        std::vector<eventHeader>* getEventHeadersForMeasure( int measureNum );
+
+        // invoked by the context upon tempo change. The events and their headers follow the tempo through
+        // their musical position and remain untouched, only when the bar length drops below the length the
+        // measure cache has been indexed at is the cache rebuilt (events of a fixed duration span more measures)
+        void updateMeasureCache();
+
+        // invoked by events when their sequencing properties have changed
+        void updateEventHeader( BaseAudioEvent* audioEvent );
+
+        // the amount of samples the instruments envelope extends its
+        // synthesized events beyond their end (see BaseSynthEvent::getEventEnd())
+        virtual int getReleaseDuration();
+
+        // the context sequencing this instrument, its events are positioned relative to the
+        // tempo of this context. Assigned by AudioEngineContext::registerInstrument()
+
+        AudioEngineContext* getContext();
+        void setContext( AudioEngineContext* context );
+#endif
+
         void toggleReadLock( bool lock );
         void registerInSequencer();
         void unregisterFromSequencer();
@@ -62,16 +121,22 @@ class BaseInstrument
         // a vector that indexes all sequenced events by measure for easy lookup by the sequencer
         std::vector<std::vector<BaseAudioEvent*>*> _audioEventsPerMeasure;
 
-        float _oldTempo; // last known sequencer tempo
+        int _measureCacheBarLength; // shortest bar length (in samples) the measure cache has been indexed at
+
+        // headers of the events in each measure (see getEventHeadersForMeasure()), indexed alongside the measure cache
+        std::vector<std::vector<eventHeader>*> _eventHeadersPerMeasure;
+
+        AudioEngineContext* _context = nullptr; // context the instrument is registered in (nullptr for the default context)
 
-        // mutex to lock event vector mutations
-        std::mutex* _lock;
-        bool _locked       = false;
-        bool _freezeEvents = false;
+        // mutex to lock event vector mutations, recursive as events update
+        // their header while they are being added (see updateEventHeader())
+        std::recursive_mutex* _lock;
 
+        int getShortestBarLength();
         void clearMeasureCache();
         void addEventToMeasureCache( BaseAudioEvent* audioEvent );
         void removeEventFromMeasureCache( BaseAudioEvent* audioEvent );
+        void updateEventHeaders();
 };
 } // E.O namespace MWEngine
 
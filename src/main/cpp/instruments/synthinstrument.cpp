@@ -86,6 +86,11 @@ OscillatorProperties* SynthInstrument::getOscillatorProperties( int aOscillatorN
     return oscillators.at( aOscillatorNum );
 }
 
+int SynthInstrument::getReleaseDuration()
+{
+    return adsr->getReleaseDuration();
+}
+
 /* protected methods */
 
 void SynthInstrument::init()
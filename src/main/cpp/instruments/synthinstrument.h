@@ -60,6 +60,12 @@ class SynthInstrument : public BaseInstrument
         RouteableOscillator *rOsc;
         ADSR* adsr;
 
+#ifndef SWIG
+        // base class overrides
+
+        int getReleaseDuration();
+#endif
+
     protected:
 
         int oscAmount;      // amount of oscillators, minimum == 1
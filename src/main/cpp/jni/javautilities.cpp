@@ -23,6 +23,7 @@
 #include "javautilities.h"
 #include "../audiobuffer.h"
 #include "..//wavetable.h"
+#include <utilities/samplecache.h>
 #include <utilities/samplemanager.h>
 #include <utilities/tablepool.h>
 #include <generators/wavegenerator.h>
@@ -37,17 +38,34 @@ namespace MWEngine {
 
 bool JavaUtilities::createSampleFromFile( jstring aKey, jstring aWAVFilePath )
 {
-    std::string thePath = JavaBridge::getString( aWAVFilePath );
-    waveFile WAV = WaveReader::fileToBuffer( thePath );
+    // samples loaded from file can be reloaded when evicted by the SampleManager's memory budget
+    // returns false on error during loading of WAV file
 
-    // error during loading of WAV file ?
+    std::string key      = JavaBridge::getString( aKey );
+    std::string filePath = JavaBridge::getString( aWAVFilePath );
 
-    if ( WAV.buffer == nullptr )
-        return false;
+    // a sample that is already registered under given key is replaced by the contents of the file
+    // (the existing sample remains in place when the file can't be read)
 
-    SampleManager::setSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate );
+    if ( SampleManager::hasSample( key ))
+    {
+        waveFile WAV = SampleCache::load( filePath, SampleManager::getLoadSampleRate() );
 
-    return true;
+        if ( WAV.buffer == nullptr )
+            return false;
+
+        SampleId id = SampleManager::getSampleId( key );
+
+        SampleManager::removeSample( id, true ); // referenced samples are deleted once released
+
+        if ( !SampleManager::setSample( id, WAV.buffer, WAV.sampleRate, SampleManager::getSampleFormat() ))
+            delete WAV.buffer;
+        else
+            SampleManager::setSampleSource( id, filePath );
+
+        return true;
+    }
+    return SampleManager::loadSample( key, filePath );
 }
 
 bool JavaUtilities::createSampleFromAsset( jstring aKey, jobject assetManager, jstring cacheDir, jstring assetName )
@@ -121,7 +139,10 @@ bool JavaUtilities::createSampleFromAsset( jstring aKey, jobject assetManager, j
     if ( WAV.buffer == nullptr )
         return false;
 
-    SampleManager::setSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate );
+    // the SampleManager takes ownership of the buffer (unless a sample is registered under the same key)
+
+    if ( !SampleManager::setSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate ))
+        delete WAV.buffer;
 
     return true;
 }
@@ -163,9 +184,10 @@ void JavaUtilities::createSampleFromBuffer( jstring aKey, jint aBufferLength, ji
 
         JavaBridge::getEnvironment()->ReleaseDoubleArrayElements( aOptRightBuffer, c_array, 0 );
     }
-    SampleManager::setSample(
-            JavaBridge::getString( aKey ), sampleBuffer, AudioEngineProps::SAMPLE_RATE
-    );
+    // the SampleManager takes ownership of the buffer (unless a sample is registered under the same key)
+
+    if ( !SampleManager::setSample( JavaBridge::getString( aKey ), sampleBuffer, AudioEngineProps::SAMPLE_RATE ))
+        delete sampleBuffer;
 }
 
 /* TablePool hooks */
@@ -0,0 +1,55 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "mappedaudiobuffer.h"
+#include <sys/mman.h>
+#include <algorithm>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+MappedAudioBuffer::MappedAudioBuffer( int aAmountOfChannels, int aBufferSize, void* mapping, size_t mappingLength,
+                                      size_t dataOffset, size_t channelStride ) : AudioBuffer()
+{
+    amountOfChannels = aAmountOfChannels;
+    bufferSize       = aBufferSize;
+    _mapping         = mapping;
+    _mappingLength   = mappingLength;
+
+    // the channels point directly into the mapping
+
+    _stride  = ( int )( channelStride / sizeof( SAMPLE_TYPE ));
+    _buffers = new SAMPLE_TYPE*[ std::max( 1, amountOfChannels ) ];
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+        _buffers[ c ] = reinterpret_cast<SAMPLE_TYPE*>( static_cast<char*>( mapping ) + dataOffset + c * channelStride );
+}
+
+MappedAudioBuffer::~MappedAudioBuffer()
+{
+    // the channel data is not owned by the base class, release the mapping instead
+
+    munmap( _mapping, _mappingLength );
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,53 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__MAPPEDAUDIOBUFFER_H_INCLUDED__
+#define __MWENGINE__MAPPEDAUDIOBUFFER_H_INCLUDED__
+
+#include "audiobuffer.h"
+
+/**
+ * MappedAudioBuffer is an AudioBuffer whose channels reside inside a memory
+ * mapped file (see SampleCache), where each channel is stored as a contiguous
+ * block of SAMPLE_TYPE values. No copy of the file contents is made, the pages
+ * of the file are read on demand as the buffer contents are accessed.
+ *
+ * The mapping is private: writing to the buffer alters its contents in
+ * memory only (copy on write), the mapped file remains unchanged.
+ */
+namespace MWEngine {
+class MappedAudioBuffer : public AudioBuffer
+{
+    public:
+        // takes ownership of given mapping (created using mmap()) of given length, the first channel
+        // starts at given data offset (in bytes), the subsequent channels are channelStride bytes apart
+        MappedAudioBuffer( int aAmountOfChannels, int aBufferSize, void* mapping, size_t mappingLength,
+                           size_t dataOffset, size_t channelStride );
+        ~MappedAudioBuffer();
+
+    protected:
+        void* _mapping;
+        size_t _mappingLength;
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -55,13 +55,13 @@ namespace Notifier
 
         if ( it != _observerMap.end() )
         {
-            std::vector<Observer*> observers = it->second;
+            std::vector<Observer*>& observers = it->second;
 
             if ( std::find( observers.begin(), observers.end(), aObserver ) != observers.end())
                 observers.erase( std::find( observers.begin(), observers.end(), aObserver ));
 
-            if ( _observerMap.size() == 0 )
-                _observerMap.erase( _observerMap.find( aNotificationType ));
+            if ( observers.size() == 0 )
+                _observerMap.erase( it );
         }
     }
 
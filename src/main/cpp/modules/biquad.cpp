@@ -0,0 +1,352 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "biquad.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+/**
+ * @param amountOfChannels {int} the amount of channels to maintain filter state for
+ * @param amountOfSections {int} the amount of cascaded second order sections
+ */
+Biquad::Biquad( int amountOfChannels, int amountOfSections )
+{
+    _amountOfChannels = amountOfChannels;
+    _amountOfSections = amountOfSections;
+
+    _coeffs     = new Coefficients[ amountOfSections ];
+    _targets    = new Coefficients[ amountOfSections ];
+    _increments = new Coefficients[ amountOfSections ];
+
+    // by default all sections pass the signal unaltered
+
+    for ( int s = 0; s < amountOfSections; ++s ) {
+        _coeffs[ s ]     = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+        _targets[ s ]    = _coeffs[ s ];
+        _increments[ s ] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    }
+
+    _smoothing          = 0;
+    _smoothingRemaining = 0;
+
+    int stateSize = amountOfChannels * amountOfSections;
+
+    _z1       = new SAMPLE_TYPE[ stateSize ];
+    _z2       = new SAMPLE_TYPE[ stateSize ];
+    _storedZ1 = new SAMPLE_TYPE[ stateSize ];
+    _storedZ2 = new SAMPLE_TYPE[ stateSize ];
+
+    reset();
+    store();
+}
+
+Biquad::~Biquad()
+{
+    delete[] _coeffs;
+    delete[] _targets;
+    delete[] _increments;
+    delete[] _z1;
+    delete[] _z2;
+    delete[] _storedZ1;
+    delete[] _storedZ2;
+}
+
+/* public methods */
+
+int Biquad::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
+int Biquad::getAmountOfSections()
+{
+    return _amountOfSections;
+}
+
+void Biquad::setCoefficients( SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2,
+                              SAMPLE_TYPE a1, SAMPLE_TYPE a2, int section )
+{
+    if ( section < 0 || section >= _amountOfSections )
+        return;
+
+    _targets[ section ] = { b0, b1, b2, a1, a2 };
+
+    if ( _smoothing == 0 ) {
+        _coeffs[ section ] = _targets[ section ];
+        return;
+    }
+
+    // (re)start the glide of all sections towards their targets
+
+    SAMPLE_TYPE step = 1.0 / ( SAMPLE_TYPE ) _smoothing;
+
+    for ( int s = 0; s < _amountOfSections; ++s ) {
+        const Coefficients& c = _coeffs[ s ];
+        const Coefficients& t = _targets[ s ];
+
+        _increments[ s ] = {
+            ( t.b0 - c.b0 ) * step, ( t.b1 - c.b1 ) * step, ( t.b2 - c.b2 ) * step,
+            ( t.a1 - c.a1 ) * step, ( t.a2 - c.a2 ) * step
+        };
+    }
+    _smoothingRemaining = _smoothing;
+}
+
+void Biquad::setLowPass( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section )
+{
+    SAMPLE_TYPE w0    = TWO_PI * frequency / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
+    SAMPLE_TYPE cosw0 = cos( w0 );
+    SAMPLE_TYPE alpha = sin( w0 ) / ( 2.0 * q );
+    SAMPLE_TYPE a0    = 1.0 + alpha;
+
+    setCoefficients(
+        (( 1.0 - cosw0 ) / 2.0 ) / a0, ( 1.0 - cosw0 ) / a0, (( 1.0 - cosw0 ) / 2.0 ) / a0,
+        ( -2.0 * cosw0 ) / a0, ( 1.0 - alpha ) / a0, section
+    );
+}
+
+void Biquad::setHighPass( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section )
+{
+    SAMPLE_TYPE w0    = TWO_PI * frequency / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
+    SAMPLE_TYPE cosw0 = cos( w0 );
+    SAMPLE_TYPE alpha = sin( w0 ) / ( 2.0 * q );
+    SAMPLE_TYPE a0    = 1.0 + alpha;
+
+    setCoefficients(
+        (( 1.0 + cosw0 ) / 2.0 ) / a0, -( 1.0 + cosw0 ) / a0, (( 1.0 + cosw0 ) / 2.0 ) / a0,
+        ( -2.0 * cosw0 ) / a0, ( 1.0 - alpha ) / a0, section
+    );
+}
+
+void Biquad::setBandPass( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section )
+{
+    // constant 0 dB peak gain
+
+    SAMPLE_TYPE w0    = TWO_PI * frequency / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
+    SAMPLE_TYPE alpha = sin( w0 ) / ( 2.0 * q );
+    SAMPLE_TYPE a0    = 1.0 + alpha;
+
+    setCoefficients(
+        alpha / a0, 0.0, -alpha / a0,
+        ( -2.0 * cos( w0 )) / a0, ( 1.0 - alpha ) / a0, section
+    );
+}
+
+void Biquad::setSmoothing( int samples )
+{
+    _smoothing = std::max( 0, samples );
+
+    if ( _smoothing == 0 && _smoothingRemaining > 0 ) {
+        for ( int s = 0; s < _amountOfSections; ++s )
+            _coeffs[ s ] = _targets[ s ];
+
+        _smoothingRemaining = 0;
+    }
+}
+
+int Biquad::getSmoothing()
+{
+    return _smoothing;
+}
+
+void Biquad::reset()
+{
+    int stateSize = _amountOfChannels * _amountOfSections;
+
+    memset( _z1, 0, stateSize * sizeof( SAMPLE_TYPE ));
+    memset( _z2, 0, stateSize * sizeof( SAMPLE_TYPE ));
+}
+
+void Biquad::store()
+{
+    int stateSize = _amountOfChannels * _amountOfSections;
+
+    memcpy( _storedZ1, _z1, stateSize * sizeof( SAMPLE_TYPE ));
+    memcpy( _storedZ2, _z2, stateSize * sizeof( SAMPLE_TYPE ));
+}
+
+void Biquad::restore()
+{
+    int stateSize = _amountOfChannels * _amountOfSections;
+
+    memcpy( _z1, _storedZ1, stateSize * sizeof( SAMPLE_TYPE ));
+    memcpy( _z2, _storedZ2, stateSize * sizeof( SAMPLE_TYPE ));
+}
+
+void Biquad::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int bufferSize = sampleBuffer->bufferSize;
+
+    // filter has less channels than the buffer ? process the first channel only
+
+    if ( _amountOfChannels < sampleBuffer->amountOfChannels )
+        isMonoSource = true;
+
+    int amountOfChannels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
+    int rampLength       = std::min( _smoothingRemaining, bufferSize );
+
+    for ( int s = 0; s < _amountOfSections; ++s )
+    {
+        // process channels in pairs
+
+        for ( int c = 0; c < amountOfChannels; c += 2 )
+        {
+            SAMPLE_TYPE* left  = sampleBuffer->getBufferForChannel( c );
+            SAMPLE_TYPE* right = ( c + 1 < amountOfChannels ) ? sampleBuffer->getBufferForChannel( c + 1 ) : nullptr;
+
+            processSection( s, left, right, c, bufferSize, rampLength );
+        }
+    }
+
+    // advance the coefficient glide (all channels have been processed from the same starting values)
+
+    if ( rampLength > 0 )
+    {
+        _smoothingRemaining -= rampLength;
+
+        for ( int s = 0; s < _amountOfSections; ++s )
+        {
+            Coefficients& c = _coeffs[ s ];
+
+            if ( _smoothingRemaining == 0 ) {
+                c = _targets[ s ];
+                continue;
+            }
+            const Coefficients& i = _increments[ s ];
+
+            c.b0 += i.b0 * rampLength;
+            c.b1 += i.b1 * rampLength;
+            c.b2 += i.b2 * rampLength;
+            c.a1 += i.a1 * rampLength;
+            c.a2 += i.a2 * rampLength;
+        }
+    }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+void Biquad::process( SAMPLE_TYPE* channelBuffer, int bufferSize, int channel )
+{
+    for ( int s = 0; s < _amountOfSections; ++s )
+        processSection( s, channelBuffer, nullptr, channel, bufferSize, 0 );
+}
+
+/* protected methods */
+
+/**
+ * processes a single section for a pair of channels (or a single channel when right is null)
+ * for the first rampLength samples, the coefficients glide towards their target values
+ */
+void Biquad::processSection( int section, SAMPLE_TYPE* left, SAMPLE_TYPE* right,
+                             int channel, int bufferSize, int rampLength )
+{
+    const Coefficients& inc = _increments[ section ];
+
+    SAMPLE_TYPE b0 = _coeffs[ section ].b0;
+    SAMPLE_TYPE b1 = _coeffs[ section ].b1;
+    SAMPLE_TYPE b2 = _coeffs[ section ].b2;
+    SAMPLE_TYPE a1 = _coeffs[ section ].a1;
+    SAMPLE_TYPE a2 = _coeffs[ section ].a2;
+
+    int index = section * _amountOfChannels + channel;
+    int i     = 0;
+
+    if ( right != nullptr )
+    {
+        SAMPLE_TYPE lz1 = _z1[ index ],     lz2 = _z2[ index ];
+        SAMPLE_TYPE rz1 = _z1[ index + 1 ], rz2 = _z2[ index + 1 ];
+
+        for ( ; i < rampLength; ++i )
+        {
+            b0 += inc.b0; b1 += inc.b1; b2 += inc.b2; a1 += inc.a1; a2 += inc.a2;
+
+            SAMPLE_TYPE l = left[ i ];
+            SAMPLE_TYPE r = right[ i ];
+            SAMPLE_TYPE lOut = b0 * l + lz1;
+            SAMPLE_TYPE rOut = b0 * r + rz1;
+
+            lz1 = b1 * l - a1 * lOut + lz2;
+            rz1 = b1 * r - a1 * rOut + rz2;
+            lz2 = b2 * l - a2 * lOut;
+            rz2 = b2 * r - a2 * rOut;
+
+            left [ i ] = lOut;
+            right[ i ] = rOut;
+        }
+
+        for ( ; i < bufferSize; ++i )
+        {
+            SAMPLE_TYPE l = left[ i ];
+            SAMPLE_TYPE r = right[ i ];
+            SAMPLE_TYPE lOut = b0 * l + lz1;
+            SAMPLE_TYPE rOut = b0 * r + rz1;
+
+            lz1 = b1 * l - a1 * lOut + lz2;
+            rz1 = b1 * r - a1 * rOut + rz2;
+            lz2 = b2 * l - a2 * lOut;
+            rz2 = b2 * r - a2 * rOut;
+
+            left [ i ] = lOut;
+            right[ i ] = rOut;
+        }
+
+        _z1[ index ]     = lz1; _z2[ index ]     = lz2;
+        _z1[ index + 1 ] = rz1; _z2[ index + 1 ] = rz2;
+        return;
+    }
+
+    SAMPLE_TYPE z1 = _z1[ index ], z2 = _z2[ index ];
+
+    for ( ; i < rampLength; ++i )
+    {
+        b0 += inc.b0; b1 += inc.b1; b2 += inc.b2; a1 += inc.a1; a2 += inc.a2;
+
+        SAMPLE_TYPE in  = left[ i ];
+        SAMPLE_TYPE out = b0 * in + z1;
+
+        z1 = b1 * in - a1 * out + z2;
+        z2 = b2 * in - a2 * out;
+
+        left[ i ] = out;
+    }
+
+    for ( ; i < bufferSize; ++i )
+    {
+        SAMPLE_TYPE in  = left[ i ];
+        SAMPLE_TYPE out = b0 * in + z1;
+
+        z1 = b1 * in - a1 * out + z2;
+        z2 = b2 * in - a2 * out;
+
+        left[ i ] = out;
+    }
+    _z1[ index ] = z1;
+    _z2[ index ] = z2;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,139 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__BIQUAD_H_INCLUDED__
+#define __MWENGINE__BIQUAD_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+
+/**
+ * Biquad is the shared second order filter kernel used by the filtering processors.
+ * It implements a cascade of transposed direct form II (TDF-II) sections where
+ * each section maintains separate state for all channels. Channels are processed
+ * in (stereo) pairs within the same loop, allowing the compiler to pack both channels
+ * into the lanes of a single SIMD register.
+ *
+ * Coefficient changes can be smoothed (see setSmoothing()) to prevent zipper noise
+ * when parameters are automated.
+ */
+namespace MWEngine {
+class Biquad
+{
+    public:
+        Biquad( int amountOfChannels, int amountOfSections = 1 );
+        ~Biquad();
+
+        int getAmountOfChannels();
+        int getAmountOfSections();
+
+        // set the normalized coefficients (e.g. where a0 == 1) of given section
+        // when the coefficients for a first order section are set, b2 and a2 should equal 0
+
+        void setCoefficients( SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2,
+                              SAMPLE_TYPE a1, SAMPLE_TYPE a2, int section = 0 );
+
+        // convenience methods to calculate coefficients for common filter types
+        // (see Robert Bristow-Johnson's "Cookbook formulae for audio EQ biquad filter coefficients")
+
+        void setLowPass ( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section = 0 );
+        void setHighPass( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section = 0 );
+        void setBandPass( SAMPLE_TYPE frequency, SAMPLE_TYPE q, int section = 0 );
+
+        // the amount of samples over which a coefficient change is interpolated
+        // (0 applies coefficient changes immediately). Smoothing is applied by process()
+
+        void setSmoothing( int samples );
+        int getSmoothing();
+
+        // clears the filter state (but retains the coefficients)
+
+        void reset();
+
+        // store/restore the filter state, this allows repeated
+        // processing of different signals from the same starting state
+
+        void store();
+        void restore();
+
+        /**
+         * process all channels of given sampleBuffer through all sections
+         * when isMonoSource is true, only the first channel is processed and
+         * its contents copied into the remaining channels
+         */
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        /**
+         * process a single channel buffer against the state of given channel
+         * note: this does not advance the coefficient smoothing
+         */
+        void process( SAMPLE_TYPE* channelBuffer, int bufferSize, int channel );
+
+        /**
+         * process a single sample of given channel through all sections
+         * useful when coefficients are modulated on a per sample basis (smoothing is not applied)
+         */
+        inline SAMPLE_TYPE processSingle( SAMPLE_TYPE sample, int channel )
+        {
+            for ( int s = 0, i = channel; s < _amountOfSections; ++s, i += _amountOfChannels )
+            {
+                const Coefficients& c = _coeffs[ s ];
+
+                SAMPLE_TYPE out = c.b0 * sample + _z1[ i ];
+                _z1[ i ] = c.b1 * sample - c.a1 * out + _z2[ i ];
+                _z2[ i ] = c.b2 * sample - c.a2 * out;
+
+                sample = out;
+            }
+            return sample;
+        }
+
+    protected:
+
+        struct Coefficients {
+            SAMPLE_TYPE b0, b1, b2, a1, a2;
+        };
+
+        int _amountOfChannels;
+        int _amountOfSections;
+
+        Coefficients* _coeffs;     // current coefficients, one per section
+        Coefficients* _targets;    // coefficients to glide towards when smoothing
+        Coefficients* _increments; // per sample increment during smoothing
+
+        int _smoothing;
+        int _smoothingRemaining;
+
+        // filter state, stored as [ section * _amountOfChannels + channel ]
+        // so the state of all channels in a section is contiguous
+
+        SAMPLE_TYPE* _z1;
+        SAMPLE_TYPE* _z2;
+        SAMPLE_TYPE* _storedZ1;
+        SAMPLE_TYPE* _storedZ2;
+
+        void processSection( int section, SAMPLE_TYPE* left, SAMPLE_TYPE* right,
+                             int channel, int bufferSize, int rampLength );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "delayline.h"
+#include <cstring>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+/**
+ * @param maxDelay {int} the maximum delay time (in samples) that will be read
+ */
+DelayLine::DelayLine( int maxDelay )
+{
+    // the extra sample allows interpolated reads at the maximum delay time
+
+    _size = 1;
+    while ( _size < maxDelay + 2 )
+        _size <<= 1;
+
+    _mask       = _size - 1;
+    _writeIndex = 0;
+    _buffer     = new SAMPLE_TYPE[ _size ]();
+}
+
+DelayLine::~DelayLine()
+{
+    delete[] _buffer;
+}
+
+/* public methods */
+
+int DelayLine::getMaxDelay()
+{
+    return _size - 2;
+}
+
+void DelayLine::clear()
+{
+    memset( _buffer, 0, _size * sizeof( SAMPLE_TYPE ));
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,81 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__DELAYLINE_H_INCLUDED__
+#define __MWENGINE__DELAYLINE_H_INCLUDED__
+
+#include "global.h"
+
+/**
+ * DelayLine is the shared single channel delay line used by the time based
+ * processors (e.g. Delay, Flanger and Reverb). Its ring buffer is sized to a
+ * power of two so the read and write positions wrap using a bit mask instead
+ * of bounds checks.
+ *
+ * Delay times are relative to the next write: reading a delay of n samples
+ * before writing the current sample returns the sample written n samples ago.
+ * Fractional delay times are read using linear interpolation, allowing smooth
+ * modulation of the delay time.
+ */
+namespace MWEngine {
+class DelayLine
+{
+    public:
+        DelayLine( int maxDelay );
+        ~DelayLine();
+
+        // the maximum delay (in samples) that can be read from this line
+        int getMaxDelay();
+
+        // clears the buffer contents
+        void clear();
+
+        inline void write( SAMPLE_TYPE sample )
+        {
+            _buffer[ _writeIndex ] = sample;
+            _writeIndex = ( _writeIndex + 1 ) & _mask;
+        }
+
+        inline SAMPLE_TYPE read( int delay )
+        {
+            return _buffer[( _writeIndex - delay ) & _mask ];
+        }
+
+        inline SAMPLE_TYPE readInterpolated( SAMPLE_TYPE delay )
+        {
+            int whole         = ( int ) delay;
+            SAMPLE_TYPE frac  = delay - ( SAMPLE_TYPE ) whole;
+            SAMPLE_TYPE newer = _buffer[( _writeIndex - whole ) & _mask ];
+            SAMPLE_TYPE older = _buffer[( _writeIndex - whole - 1 ) & _mask ];
+
+            return newer + ( older - newer ) * frac;
+        }
+
+    protected:
+        SAMPLE_TYPE* _buffer;
+        int _size;
+        int _mask;
+        int _writeIndex;
+};
+} // E.O namespace MWEngine
+
+#endif
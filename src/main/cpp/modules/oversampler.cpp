@@ -0,0 +1,353 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "oversampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MWEngine {
+
+const int Oversampler::MAX_FACTOR;
+
+/* constructor / destructor */
+
+/**
+ * @param amountOfChannels {int} the amount of channels to maintain filter histories for
+ * @param factor {int} the oversampling factor, either 2, 4 or 8
+ */
+Oversampler::Oversampler( int amountOfChannels, int factor )
+{
+    _factor            = std::max( 2, std::min( factor, MAX_FACTOR ));
+    _amountOfChannels  = 0;
+    _oversampledBuffer = nullptr;
+    _scratch           = nullptr;
+    _scratchSize       = 0;
+
+    ensureCapacity( amountOfChannels, AudioEngineProps::BUFFER_SIZE );
+}
+
+Oversampler::~Oversampler()
+{
+    while ( !_stages.empty() ) {
+        delete _stages.back();
+        _stages.pop_back();
+    }
+    delete _oversampledBuffer;
+    delete[] _scratch;
+}
+
+/* public methods */
+
+int Oversampler::getFactor()
+{
+    return _factor;
+}
+
+float Oversampler::getLatency()
+{
+    // each stage adds its latency twice (up- and downsampling) at twice the rate of its input
+
+    float latency = 0.f;
+    int rate      = 1;
+
+    for ( Stage* stage : _stages ) {
+        latency += ( float ) stage->getLatency() / ( float ) rate;
+        rate    *= 2;
+    }
+    return latency;
+}
+
+AudioBuffer* Oversampler::upsample( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
+    int amountOfStages   = _stages.size();
+
+    ensureCapacity( sampleBuffer->amountOfChannels, bufferSize );
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* in = sampleBuffer->getBufferForChannel( c );
+        int length      = bufferSize;
+        int offset      = 0;
+
+        // intermediate rates are written into the scratch buffer, the last stage writes
+        // directly into the oversampled buffer
+
+        for ( int s = 0; s < amountOfStages; ++s )
+        {
+            SAMPLE_TYPE* out = ( s == amountOfStages - 1 ) ? _oversampledBuffer->getBufferForChannel( c ) : _scratch + offset;
+
+            _stages[ s ]->upsample( in, out, length, c );
+
+            in      = out;
+            offset += length * 2;
+            length *= 2;
+        }
+    }
+    return _oversampledBuffer;
+}
+
+void Oversampler::downsample( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
+    int amountOfStages   = _stages.size();
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* in = _oversampledBuffer->getBufferForChannel( c );
+        int length      = bufferSize * _factor / 2;
+        int offset      = 0;
+
+        for ( int s = amountOfStages - 1; s >= 0; --s )
+        {
+            SAMPLE_TYPE* out = ( s == 0 ) ? sampleBuffer->getBufferForChannel( c ) : _scratch + offset;
+
+            _stages[ s ]->downsample( in, out, length, c );
+
+            in      = out;
+            offset += length;
+            length /= 2;
+        }
+    }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+void Oversampler::reset()
+{
+    for ( Stage* stage : _stages )
+        stage->reset();
+}
+
+/* protected methods */
+
+void Oversampler::ensureCapacity( int amountOfChannels, int bufferSize )
+{
+    // (re)create the filter stages when the amount of channels grows
+
+    if ( amountOfChannels > _amountOfChannels )
+    {
+        _amountOfChannels = amountOfChannels;
+
+        while ( !_stages.empty() ) {
+            delete _stages.back();
+            _stages.pop_back();
+        }
+
+        // the first stage determines the quality of the anti-aliasing filter,
+        // the remaining stages have a wide transition band and can be much shorter
+
+        for ( int factor = _factor, s = 0; factor > 1; factor /= 2, ++s )
+            _stages.push_back( new Stage( _amountOfChannels, s == 0 ? 12 : 4 ));
+    }
+
+    int oversampledSize = bufferSize * _factor;
+
+    if ( _oversampledBuffer == nullptr ||
+         _oversampledBuffer->bufferSize != oversampledSize ||
+         _oversampledBuffer->amountOfChannels != amountOfChannels )
+    {
+        delete _oversampledBuffer;
+        _oversampledBuffer = new AudioBuffer( amountOfChannels, oversampledSize );
+    }
+
+    if ( _scratchSize < oversampledSize )
+    {
+        delete[] _scratch;
+        _scratchSize = oversampledSize;
+        _scratch     = new SAMPLE_TYPE[ _scratchSize ];
+    }
+}
+
+/* Stage */
+
+/**
+ * @param amountOfChannels {int} amount of channels to maintain histories for
+ * @param halfLength {int} the amount of folded coefficients, the filter
+ *                   length in taps equals ( 4 * halfLength ) - 1
+ */
+Oversampler::Stage::Stage( int amountOfChannels, int halfLength )
+{
+    _halfLength   = halfLength;
+    _coefficients = new SAMPLE_TYPE[ halfLength ];
+    _historySize  = 2 * halfLength - 1;
+    _workSize     = 0;
+
+    // windowed sinc design (Kaiser window), only the even taps are nonzero
+    // (aside from the center tap which equals 0.5 and is applied as a delay)
+
+    int length      = 4 * halfLength - 1;
+    int center      = ( length - 1 ) / 2;
+    SAMPLE_TYPE beta = 8.0;
+
+    auto bessel = []( SAMPLE_TYPE x ) {
+        SAMPLE_TYPE sum = 1.0, term = 1.0;
+        for ( int k = 1; k < 32; ++k ) {
+            term *= ( x / ( 2.0 * k )) * ( x / ( 2.0 * k ));
+            sum  += term;
+        }
+        return sum;
+    };
+
+    SAMPLE_TYPE sum = 0.0;
+
+    for ( int m = 0; m < halfLength; ++m )
+    {
+        int tap          = 2 * m;
+        SAMPLE_TYPE t    = ( SAMPLE_TYPE )( tap - center ) / 2.0;
+        SAMPLE_TYPE sinc = sin( PI * t ) / ( PI * t );
+        SAMPLE_TYPE r    = 2.0 * tap / ( SAMPLE_TYPE )( length - 1 ) - 1.0;
+
+        _coefficients[ m ] = 0.5 * sinc * bessel( beta * sqrt( 1.0 - r * r )) / bessel( beta );
+        sum += 2.0 * _coefficients[ m ]; // coefficient occurs twice (symmetry)
+    }
+
+    // normalize so the even phase has a gain of 0.5 (and the filter unity gain at DC)
+
+    for ( int m = 0; m < halfLength; ++m )
+        _coefficients[ m ] *= 0.5 / sum;
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        _upWork.push_back( nullptr );
+        _downEvenWork.push_back( nullptr );
+        _downOddWork.push_back( nullptr );
+    }
+    ensureWorkSize( AudioEngineProps::BUFFER_SIZE * MAX_FACTOR );
+}
+
+Oversampler::Stage::~Stage()
+{
+    for ( size_t c = 0; c < _upWork.size(); ++c ) {
+        delete[] _upWork[ c ];
+        delete[] _downEvenWork[ c ];
+        delete[] _downOddWork[ c ];
+    }
+    delete[] _coefficients;
+}
+
+int Oversampler::Stage::getLatency()
+{
+    return 2 * _halfLength - 1;
+}
+
+void Oversampler::Stage::upsample( SAMPLE_TYPE* in, SAMPLE_TYPE* out, int length, int channel )
+{
+    ensureWorkSize( length );
+
+    int M = _halfLength;
+    int H = _historySize;
+    SAMPLE_TYPE* work = _upWork[ channel ];
+
+    memcpy( work + H, in, length * sizeof( SAMPLE_TYPE ));
+
+    for ( int n = 0; n < length; ++n )
+    {
+        const SAMPLE_TYPE* x = work + H + n; // x[ -m ] is the m-th previous input sample
+        SAMPLE_TYPE sum = 0.0;
+
+        for ( int m = 0; m < M; ++m )
+            sum += _coefficients[ m ] * ( x[ -m ] + x[ m - H ]);
+
+        out[ 2 * n ]     = 2.0 * sum;
+        out[ 2 * n + 1 ] = x[ 1 - M ];  // center tap (2 * 0.5) is a plain delay
+    }
+
+    // store history for the next iteration
+    memmove( work, work + length, H * sizeof( SAMPLE_TYPE ));
+}
+
+void Oversampler::Stage::downsample( SAMPLE_TYPE* in, SAMPLE_TYPE* out, int length, int channel )
+{
+    ensureWorkSize( length );
+
+    int M = _halfLength;
+    int H = _historySize;
+    SAMPLE_TYPE* even = _downEvenWork[ channel ];
+    SAMPLE_TYPE* odd  = _downOddWork[ channel ];
+
+    // split into the polyphase components
+
+    for ( int n = 0; n < length; ++n ) {
+        even[ H + n ] = in[ 2 * n ];
+        odd [ M + n ] = in[ 2 * n + 1 ];
+    }
+
+    for ( int n = 0; n < length; ++n )
+    {
+        const SAMPLE_TYPE* x = even + H + n;
+        SAMPLE_TYPE sum = 0.0;
+
+        for ( int m = 0; m < M; ++m )
+            sum += _coefficients[ m ] * ( x[ -m ] + x[ m - H ]);
+
+        out[ n ] = sum + 0.5 * odd[ n ];  // odd[ n ] is o[ n - M ] as the odd history is M samples long
+    }
+
+    memmove( even, even + length, H * sizeof( SAMPLE_TYPE ));
+    memmove( odd,  odd  + length, M * sizeof( SAMPLE_TYPE ));
+}
+
+void Oversampler::Stage::reset()
+{
+    for ( size_t c = 0; c < _upWork.size(); ++c ) {
+        memset( _upWork[ c ],       0, _historySize * sizeof( SAMPLE_TYPE ));
+        memset( _downEvenWork[ c ], 0, _historySize * sizeof( SAMPLE_TYPE ));
+        memset( _downOddWork[ c ],  0, _halfLength  * sizeof( SAMPLE_TYPE ));
+    }
+}
+
+void Oversampler::Stage::ensureWorkSize( int length )
+{
+    if ( length <= _workSize )
+        return;
+
+    int size = _historySize + length;
+
+    for ( size_t c = 0; c < _upWork.size(); ++c )
+    {
+        SAMPLE_TYPE* up   = new SAMPLE_TYPE[ size ]();
+        SAMPLE_TYPE* even = new SAMPLE_TYPE[ size ]();
+        SAMPLE_TYPE* odd  = new SAMPLE_TYPE[ _halfLength + length ]();
+
+        // retain existing histories
+
+        if ( _upWork[ c ] != nullptr ) {
+            memcpy( up,   _upWork[ c ],       _historySize * sizeof( SAMPLE_TYPE ));
+            memcpy( even, _downEvenWork[ c ], _historySize * sizeof( SAMPLE_TYPE ));
+            memcpy( odd,  _downOddWork[ c ],  _halfLength  * sizeof( SAMPLE_TYPE ));
+        }
+        delete[] _upWork[ c ];
+        delete[] _downEvenWork[ c ];
+        delete[] _downOddWork[ c ];
+
+        _upWork[ c ]       = up;
+        _downEvenWork[ c ] = even;
+        _downOddWork[ c ]  = odd;
+    }
+    _workSize = length;
+}
+
+} // E.O namespace MWEngine
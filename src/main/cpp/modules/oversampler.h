@@ -0,0 +1,121 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__OVERSAMPLER_H_INCLUDED__
+#define __MWENGINE__OVERSAMPLER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include <vector>
+
+/**
+ * Oversampler raises the sample rate of a signal by a factor of 2, 4 or 8 so
+ * nonlinear processing can take place without its harmonics folding back into
+ * the audible range (aliasing), after which the signal is filtered and decimated
+ * back to the engine rate.
+ *
+ * Each doubling of the rate is a polyphase half-band FIR stage. As every other
+ * coefficient of a half-band filter equals zero and the remaining coefficients
+ * are symmetrical, only a quarter of the taps needs to be multiplied per sample.
+ * The filters are linear phase, the introduced latency is reported by getLatency().
+ */
+namespace MWEngine {
+class Oversampler
+{
+    public:
+        Oversampler( int amountOfChannels, int factor );
+        ~Oversampler();
+
+        static const int MAX_FACTOR = 8;
+
+        int getFactor();
+
+        // latency (in samples at the engine rate) introduced by a full up- and downsampling pass
+
+        float getLatency();
+
+        /**
+         * upsamples the contents of given sampleBuffer into the oversampled buffer (which
+         * is returned). When isMonoSource is true, only the first channel is upsampled.
+         */
+        AudioBuffer* upsample( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        /**
+         * downsamples the contents of the oversampled buffer back into
+         * given sampleBuffer (which should be the buffer passed to upsample())
+         */
+        void downsample( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        // clears the filter histories
+
+        void reset();
+
+#ifndef SWIG
+        // internal to the engine, the half-band filter for a single rate doubling
+
+        class Stage
+        {
+            public:
+                Stage( int amountOfChannels, int halfLength );
+                ~Stage();
+
+                // latency (in samples at the higher rate) of a single up- or downsampling pass
+                int getLatency();
+
+                void upsample  ( SAMPLE_TYPE* in, SAMPLE_TYPE* out, int length, int channel );
+                void downsample( SAMPLE_TYPE* in, SAMPLE_TYPE* out, int length, int channel );
+                void reset();
+
+            protected:
+                int _halfLength;             // amount of unique (folded) coefficients
+                SAMPLE_TYPE* _coefficients;  // the even (nonzero) coefficients, first half only
+
+                int _historySize;
+                int _workSize;
+
+                // per channel history of the up- and downsampling passes (histories are
+                // stored in front of the work buffers so the kernels operate on a contiguous range)
+
+                std::vector<SAMPLE_TYPE*> _upWork;
+                std::vector<SAMPLE_TYPE*> _downEvenWork;
+                std::vector<SAMPLE_TYPE*> _downOddWork;
+
+                void ensureWorkSize( int length );
+        };
+#endif
+
+    protected:
+        int _factor;
+        int _amountOfChannels;
+
+        std::vector<Stage*> _stages;
+        AudioBuffer* _oversampledBuffer;
+
+        // scratch buffer for intermediate rates when cascading stages
+        SAMPLE_TYPE* _scratch;
+        int _scratchSize;
+
+        void ensureCapacity( int amountOfChannels, int bufferSize );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace MWEngine {
+
+const int Resampler::TAPS;
+const int Resampler::PHASES;
+
+/* public methods */
+
+AudioBuffer* Resampler::resample( AudioBuffer* buffer, unsigned int inputRate, unsigned int outputRate )
+{
+    if ( inputRate == outputRate || inputRate == 0 || outputRate == 0 )
+        return buffer->clone();
+
+    int inputLength  = buffer->bufferSize;
+    int outputLength = getOutputLength( inputLength, inputRate, outputRate );
+
+    AudioBuffer* output = new AudioBuffer( buffer->amountOfChannels, outputLength );
+    output->loopeable   = buffer->loopeable;
+
+    // when downsampling the cutoff is lowered to the target Nyquist frequency, widening
+    // the filter (in input samples) by the same factor. The cutoff is placed slightly below
+    // Nyquist so the transition band of the filter doesn't extend beyond it
+
+    SAMPLE_TYPE scale = std::min(( SAMPLE_TYPE ) 1.0, ( SAMPLE_TYPE ) outputRate / ( SAMPLE_TYPE ) inputRate ) * 0.95;
+    int halfWidth     = ( int ) ceil(( TAPS / 2 ) / scale );
+    int width         = 2 * halfWidth;
+    SAMPLE_TYPE beta  = 8.0;
+
+    auto bessel = []( SAMPLE_TYPE x ) {
+        SAMPLE_TYPE sum = 1.0, term = 1.0;
+        for ( int k = 1; k < 32; ++k ) {
+            term *= ( x / ( 2.0 * k )) * ( x / ( 2.0 * k ));
+            sum  += term;
+        }
+        return sum;
+    };
+
+    // build the polyphase table, phase p holds the taps for a read position of p / PHASES
+    // past an input sample (the additional phase equals the first phase shifted by one sample
+    // and is used for interpolation). Each phase is normalized to unity gain at DC
+
+    std::vector<SAMPLE_TYPE> table(( PHASES + 1 ) * width );
+
+    for ( int p = 0; p <= PHASES; ++p )
+    {
+        SAMPLE_TYPE* taps = &table[ p * width ];
+        SAMPLE_TYPE sum   = 0.0;
+
+        for ( int k = 0; k < width; ++k )
+        {
+            SAMPLE_TYPE x = ( SAMPLE_TYPE )( k - halfWidth + 1 ) - ( SAMPLE_TYPE ) p / PHASES;
+            SAMPLE_TYPE t = scale * x;
+            SAMPLE_TYPE r = x / halfWidth;
+
+            SAMPLE_TYPE sinc   = ( t == 0.0 ) ? 1.0 : sin( PI * t ) / ( PI * t );
+            SAMPLE_TYPE window = ( fabs( r ) < 1.0 ) ? bessel( beta * sqrt( 1.0 - r * r )) / bessel( beta ) : 0.0;
+
+            taps[ k ] = sinc * window;
+            sum += taps[ k ];
+        }
+        for ( int k = 0; k < width; ++k )
+            taps[ k ] /= sum;
+    }
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* in  = buffer->getBufferForChannel( c );
+        SAMPLE_TYPE* out = output->getBufferForChannel( c );
+
+        for ( int i = 0; i < outputLength; ++i )
+        {
+            // read position in the input equals i * inputRate / outputRate
+
+            int64_t position   = ( int64_t ) i * inputRate;
+            int index          = ( int )( position / outputRate );
+            SAMPLE_TYPE phase  = ( SAMPLE_TYPE )( position % outputRate ) / outputRate * PHASES;
+            int p              = std::min(( int ) phase, PHASES - 1 );
+            SAMPLE_TYPE frac   = phase - p;
+
+            const SAMPLE_TYPE* taps1 = &table[ p * width ];
+            const SAMPLE_TYPE* taps2 = taps1 + width;
+
+            int first = index - halfWidth + 1;
+            int start = std::max( 0, -first );
+            int end   = std::min( width, inputLength - first );
+
+            SAMPLE_TYPE sample = 0.0;
+
+            for ( int k = start; k < end; ++k )
+                sample += in[ first + k ] * ( taps1[ k ] + ( taps2[ k ] - taps1[ k ]) * frac );
+
+            out[ i ] = sample;
+        }
+    }
+    return output;
+}
+
+int Resampler::getOutputLength( int inputLength, unsigned int inputRate, unsigned int outputRate )
+{
+    if ( inputRate == 0 || outputRate == 0 )
+        return inputLength;
+
+    return ( int )((( int64_t ) inputLength * outputRate + inputRate - 1 ) / inputRate );
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,58 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__RESAMPLER_H_INCLUDED__
+#define __MWENGINE__RESAMPLER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+
+/**
+ * Resampler converts the contents of an AudioBuffer to a different sample rate using
+ * a windowed sinc (Kaiser window) interpolation filter. The filter is stored as a
+ * polyphase table, the coefficients for the fractional positions in between the
+ * phases are interpolated linearly, allowing conversion between arbitrary rates.
+ *
+ * The read positions are derived from the ratio of the rates using integer math, so
+ * no drift accumulates over long samples. When downsampling, the filter cutoff is
+ * lowered to the Nyquist frequency of the target rate to prevent aliasing.
+ *
+ * Resampling is intended to take place once when loading samples (see SampleManager)
+ * so playback can take place at the engine rate without interpolation.
+ */
+namespace MWEngine {
+class Resampler
+{
+    public:
+        static const int TAPS   = 32;  // amount of filter taps per phase (at unity ratio)
+        static const int PHASES = 256; // amount of phases in the filter table
+
+        // returns a new AudioBuffer holding the contents of given buffer converted
+        // from given input rate to given output rate
+        static AudioBuffer* resample( AudioBuffer* buffer, unsigned int inputRate, unsigned int outputRate );
+
+        // the length (in samples) of a buffer of given length after conversion
+        static int getOutputLength( int inputLength, unsigned int inputRate, unsigned int outputRate );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,268 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "statevariablefilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+/**
+ * @param amountOfChannels {int} the amount of channels to maintain filter state for
+ * @param type {int} filter response, see StateVariableFilter::types
+ */
+StateVariableFilter::StateVariableFilter( int amountOfChannels, int type )
+{
+    _amountOfChannels   = amountOfChannels;
+    _type               = type;
+    _cutoff             = AudioEngineProps::SAMPLE_RATE / 4;
+    _damping            = sqrt( 2.0 ); // Butterworth response
+    _smoothing          = 0;
+    _smoothingRemaining = 0;
+    _incrementG         = 0.0;
+    _incrementK         = 0.0;
+
+    _ic1eq       = new SAMPLE_TYPE[ amountOfChannels ];
+    _ic2eq       = new SAMPLE_TYPE[ amountOfChannels ];
+    _storedIc1eq = new SAMPLE_TYPE[ amountOfChannels ];
+    _storedIc2eq = new SAMPLE_TYPE[ amountOfChannels ];
+
+    reset();
+    store();
+    updateTargets();
+}
+
+StateVariableFilter::~StateVariableFilter()
+{
+    delete[] _ic1eq;
+    delete[] _ic2eq;
+    delete[] _storedIc1eq;
+    delete[] _storedIc2eq;
+}
+
+/* public methods */
+
+int StateVariableFilter::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
+int StateVariableFilter::getType()
+{
+    return _type;
+}
+
+void StateVariableFilter::setType( int type )
+{
+    _type = type;
+    calculateCoefficients( _coeffs, _coeffs.g, _coeffs.k );
+}
+
+SAMPLE_TYPE StateVariableFilter::getCutoff()
+{
+    return _cutoff;
+}
+
+void StateVariableFilter::setCutoff( SAMPLE_TYPE frequency )
+{
+    // keep the cutoff below the Nyquist frequency as the prewarping would otherwise explode
+
+    _cutoff = std::max(( SAMPLE_TYPE ) 1.0, std::min( frequency, ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE * 0.49 ));
+    updateTargets();
+}
+
+SAMPLE_TYPE StateVariableFilter::getDamping()
+{
+    return _damping;
+}
+
+void StateVariableFilter::setDamping( SAMPLE_TYPE damping )
+{
+    _damping = std::max(( SAMPLE_TYPE ) 0.0, damping );
+    updateTargets();
+}
+
+void StateVariableFilter::setParameters( SAMPLE_TYPE frequency, SAMPLE_TYPE damping )
+{
+    _cutoff  = std::max(( SAMPLE_TYPE ) 1.0, std::min( frequency, ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE * 0.49 ));
+    _damping = std::max(( SAMPLE_TYPE ) 0.0, damping );
+    updateTargets();
+}
+
+void StateVariableFilter::setSmoothing( int samples )
+{
+    _smoothing = std::max( 0, samples );
+
+    if ( _smoothing == 0 && _smoothingRemaining > 0 ) {
+        _smoothingRemaining = 0;
+        calculateCoefficients( _coeffs, _targetG, _targetK );
+    }
+}
+
+int StateVariableFilter::getSmoothing()
+{
+    return _smoothing;
+}
+
+void StateVariableFilter::reset()
+{
+    memset( _ic1eq, 0, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+    memset( _ic2eq, 0, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+}
+
+void StateVariableFilter::store()
+{
+    memcpy( _storedIc1eq, _ic1eq, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+    memcpy( _storedIc2eq, _ic2eq, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+}
+
+void StateVariableFilter::restore()
+{
+    memcpy( _ic1eq, _storedIc1eq, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+    memcpy( _ic2eq, _storedIc2eq, _amountOfChannels * sizeof( SAMPLE_TYPE ));
+}
+
+void StateVariableFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int bufferSize = sampleBuffer->bufferSize;
+
+    // filter has less channels than the buffer ? process the first channel only
+
+    if ( _amountOfChannels < sampleBuffer->amountOfChannels )
+        isMonoSource = true;
+
+    int amountOfChannels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
+    int rampLength       = std::min( _smoothingRemaining, bufferSize );
+
+    for ( int c = 0; c < amountOfChannels; c += 2 )
+    {
+        SAMPLE_TYPE* left  = sampleBuffer->getBufferForChannel( c );
+        SAMPLE_TYPE* right = ( c + 1 < amountOfChannels ) ? sampleBuffer->getBufferForChannel( c + 1 ) : nullptr;
+
+        processPair( left, right, c, bufferSize, rampLength );
+    }
+
+    // advance the glide (all channels have been processed from the same starting values)
+
+    if ( rampLength > 0 )
+    {
+        _smoothingRemaining -= rampLength;
+
+        if ( _smoothingRemaining == 0 )
+            calculateCoefficients( _coeffs, _targetG, _targetK );
+        else
+            calculateCoefficients( _coeffs, _coeffs.g + _incrementG * rampLength, _coeffs.k + _incrementK * rampLength );
+    }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+/* protected methods */
+
+void StateVariableFilter::updateTargets()
+{
+    _targetG = tan( PI * _cutoff / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE );
+    _targetK = _damping;
+
+    if ( _smoothing == 0 ) {
+        calculateCoefficients( _coeffs, _targetG, _targetK );
+        return;
+    }
+    _incrementG         = ( _targetG - _coeffs.g ) / ( SAMPLE_TYPE ) _smoothing;
+    _incrementK         = ( _targetK - _coeffs.k ) / ( SAMPLE_TYPE ) _smoothing;
+    _smoothingRemaining = _smoothing;
+}
+
+void StateVariableFilter::calculateCoefficients( Coefficients& coeffs, SAMPLE_TYPE g, SAMPLE_TYPE k )
+{
+    coeffs.g  = g;
+    coeffs.k  = k;
+    coeffs.a1 = 1.0 / ( 1.0 + g * ( g + k ));
+    coeffs.a2 = g * coeffs.a1;
+    coeffs.a3 = g * coeffs.a2;
+
+    switch ( _type )
+    {
+        default:
+        case LOW_PASS:
+            coeffs.m0 = 0.0; coeffs.m1 = 0.0; coeffs.m2 = 1.0;
+            break;
+        case HIGH_PASS:
+            coeffs.m0 = 1.0; coeffs.m1 = -k;  coeffs.m2 = -1.0;
+            break;
+        case BAND_PASS:
+            coeffs.m0 = 0.0; coeffs.m1 = 1.0; coeffs.m2 = 0.0;
+            break;
+        case NOTCH:
+            coeffs.m0 = 1.0; coeffs.m1 = -k;  coeffs.m2 = 0.0;
+            break;
+    }
+}
+
+/**
+ * processes a pair of channels (or a single channel when right is null)
+ * for the first rampLength samples, the coefficients glide towards their target values
+ */
+void StateVariableFilter::processPair( SAMPLE_TYPE* left, SAMPLE_TYPE* right, int channel, int bufferSize, int rampLength )
+{
+    Coefficients c = _coeffs;
+
+    SAMPLE_TYPE lic1 = _ic1eq[ channel ], lic2 = _ic2eq[ channel ];
+    SAMPLE_TYPE ric1 = 0.0, ric2 = 0.0;
+
+    if ( right != nullptr ) {
+        ric1 = _ic1eq[ channel + 1 ];
+        ric2 = _ic2eq[ channel + 1 ];
+    }
+    int i = 0;
+
+    for ( ; i < rampLength; ++i )
+    {
+        calculateCoefficients( c, c.g + _incrementG, c.k + _incrementK );
+
+        left[ i ] = tick( left[ i ], lic1, lic2, c );
+
+        if ( right != nullptr )
+            right[ i ] = tick( right[ i ], ric1, ric2, c );
+    }
+
+    if ( right != nullptr ) {
+        for ( ; i < bufferSize; ++i ) {
+            left [ i ] = tick( left [ i ], lic1, lic2, c );
+            right[ i ] = tick( right[ i ], ric1, ric2, c );
+        }
+        _ic1eq[ channel + 1 ] = ric1;
+        _ic2eq[ channel + 1 ] = ric2;
+    }
+    else {
+        for ( ; i < bufferSize; ++i )
+            left[ i ] = tick( left[ i ], lic1, lic2, c );
+    }
+    _ic1eq[ channel ] = lic1;
+    _ic2eq[ channel ] = lic2;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,148 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__STATEVARIABLEFILTER_H_INCLUDED__
+#define __MWENGINE__STATEVARIABLEFILTER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+
+/**
+ * StateVariableFilter is a topology-preserving transform (TPT) state variable
+ * filter (see Vadim Zavalishin's "The Art of VA Filter Design" and Andrew Simper's
+ * "Linear Trapezoidal Integrated SVF"). Unlike direct form biquads, its response
+ * remains stable when its cutoff is modulated at audio rate, making it the kernel
+ * of choice for swept filters.
+ *
+ * Like Biquad, channels are processed in (stereo) pairs within a single loop.
+ */
+namespace MWEngine {
+class StateVariableFilter
+{
+    public:
+        enum types {
+            LOW_PASS,
+            HIGH_PASS,
+            BAND_PASS,
+            NOTCH
+        };
+
+        StateVariableFilter( int amountOfChannels, int type = LOW_PASS );
+        ~StateVariableFilter();
+
+        int getAmountOfChannels();
+        int getType();
+        void setType( int type );
+
+        // cutoff frequency in Hz
+
+        SAMPLE_TYPE getCutoff();
+        void setCutoff( SAMPLE_TYPE frequency );
+
+        // damping is the inverse of the filter Q (e.g. 2 == no resonance, 0 == self oscillation)
+
+        SAMPLE_TYPE getDamping();
+        void setDamping( SAMPLE_TYPE damping );
+
+        // sets both cutoff and damping at once (saves calculations when modulating)
+
+        void setParameters( SAMPLE_TYPE frequency, SAMPLE_TYPE damping );
+
+        // the amount of samples over which a cutoff/damping change is interpolated
+        // (0 applies changes immediately). Smoothing is applied by process()
+
+        void setSmoothing( int samples );
+        int getSmoothing();
+
+        // clears the filter state (but retains the coefficients)
+
+        void reset();
+
+        // store/restore the filter state, this allows repeated
+        // processing of different signals from the same starting state
+
+        void store();
+        void restore();
+
+        /**
+         * process all channels of given sampleBuffer
+         * when isMonoSource is true, only the first channel is processed and
+         * its contents copied into the remaining channels
+         */
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        /**
+         * process a single sample of given channel, smoothing is not applied
+         */
+        inline SAMPLE_TYPE processSingle( SAMPLE_TYPE sample, int channel )
+        {
+            return tick( sample, _ic1eq[ channel ], _ic2eq[ channel ], _coeffs );
+        }
+
+    protected:
+
+        struct Coefficients {
+            SAMPLE_TYPE g, k;          // prewarped cutoff and damping
+            SAMPLE_TYPE a1, a2, a3;    // integrator coefficients
+            SAMPLE_TYPE m0, m1, m2;    // output mix of the input, band pass and low pass signals
+        };
+
+        int _amountOfChannels;
+        int _type;
+        SAMPLE_TYPE _cutoff;
+        SAMPLE_TYPE _damping;
+
+        Coefficients _coeffs;
+        SAMPLE_TYPE _targetG;
+        SAMPLE_TYPE _targetK;
+        SAMPLE_TYPE _incrementG;
+        SAMPLE_TYPE _incrementK;
+
+        int _smoothing;
+        int _smoothingRemaining;
+
+        // integrator state for each channel
+
+        SAMPLE_TYPE* _ic1eq;
+        SAMPLE_TYPE* _ic2eq;
+        SAMPLE_TYPE* _storedIc1eq;
+        SAMPLE_TYPE* _storedIc2eq;
+
+        void updateTargets();
+        void calculateCoefficients( Coefficients& coeffs, SAMPLE_TYPE g, SAMPLE_TYPE k );
+        void processPair( SAMPLE_TYPE* left, SAMPLE_TYPE* right, int channel, int bufferSize, int rampLength );
+
+        static inline SAMPLE_TYPE tick( SAMPLE_TYPE v0, SAMPLE_TYPE& ic1eq, SAMPLE_TYPE& ic2eq, const Coefficients& c )
+        {
+            SAMPLE_TYPE v3 = v0 - ic2eq;
+            SAMPLE_TYPE v1 = c.a1 * ic1eq + c.a2 * v3;
+            SAMPLE_TYPE v2 = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+
+            ic1eq = 2.0 * v1 - ic1eq;
+            ic2eq = 2.0 * v2 - ic2eq;
+
+            return c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+        }
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -20,6 +20,7 @@ using namespace MWEngine;
 #include "definitions/notifications.h"
 #include "definitions/pitch.h"
 #include "definitions/waveforms.h"
+#include "definitions/sampleformats.h"
 #include "audiochannel.h"
 #include "channelgroup.h"
 #include "processingchain.h"
@@ -30,6 +31,7 @@ using namespace MWEngine;
 #include "processors/filter.h"
 #include "processors/flanger.h"
 #include "processors/limiter.h"
+#include "processors/lookaheadlimiter.h"
 #include "processors/fm.h"
 #include "processors/formantfilter.h"
 #include "processors/glitcher.h"
@@ -49,7 +51,11 @@ using namespace MWEngine;
 #include "modules/arpeggiator.h"
 #include "modules/lfo.h"
 #include "modules/routeableoscillator.h"
+#include "utilities/samplecache.h"
+#include "utilities/sampleloader.h"
+#include "utilities/stemexporter.h"
 #include "utilities/samplemanager.h"
+#include "utilities/samplestream.h"
 #include "utilities/sampleutility.h"
 #include "instruments/baseinstrument.h"
 #include "instruments/druminstrument.h"
@@ -62,6 +68,7 @@ using namespace MWEngine;
 #include "events/basesynthevent.h"
 #include "events/synthevent.h"
 #include "audioengine.h"
+#include "tempomap.h"
 #include "sequencercontroller.h"
 %}
 
@@ -90,6 +97,7 @@ using namespace MWEngine;
 %include "definitions/notifications.h"
 %include "definitions/pitch.h"
 %include "definitions/waveforms.h"
+%include "definitions/sampleformats.h"
 %include "audiochannel.h"
 %include "channelgroup.h"
 %include "modules/adsr.h"
@@ -104,6 +112,7 @@ using namespace MWEngine;
 %include "processors/filter.h"
 %include "processors/flanger.h"
 %include "processors/limiter.h"
+%include "processors/lookaheadlimiter.h"
 %include "processors/lowpassfilter.h"
 %include "processors/lpfhpfilter.h"
 %include "processors/fm.h"
@@ -120,7 +129,11 @@ using namespace MWEngine;
 %include "utilities/levelutility.h"
 %include "utilities/sampleutility.h"
 %include "drumpattern.h"
+%include "utilities/samplecache.h"
+%include "utilities/sampleloader.h"
+%include "utilities/stemexporter.h"
 %include "utilities/samplemanager.h"
+%include "utilities/samplestream.h"
 %include "instruments/baseinstrument.h"
 %include "instruments/druminstrument.h"
 %include "instruments/sampledinstrument.h"
@@ -133,4 +146,5 @@ using namespace MWEngine;
 %include "events/drumevent.h"
 %include "events/synthevent.h"
 %include "audioengine.h"
+%include "tempomap.h"
 %include "sequencercontroller.h"
@@ -22,6 +22,7 @@
  */
 #include "baseprocessor.h"
 #include "../processingchain.h"
+#include <math.h>
 
 namespace MWEngine {
 
@@ -36,6 +37,9 @@ BaseProcessor::~BaseProcessor()
 {
     if ( chain != nullptr )
         chain->removeProcessor( this );
+
+    delete _oversampler.load();
+    disposeRetiredOversamplers( true );
 }
 
 /* public methods */
@@ -45,6 +49,52 @@ void BaseProcessor::setChain( ProcessingChain* processingChain )
     chain = processingChain;
 }
 
+void BaseProcessor::setOversampling( int factor )
+{
+    // the render thread could be applying the current Oversampler, its successor is swapped
+    // in and the current Oversampler is retired until the render thread has moved on
+
+    Oversampler* oversampler = ( factor > 1 ) ? new Oversampler( AudioEngineProps::OUTPUT_CHANNELS, factor ) : nullptr;
+    Oversampler* previous    = _oversampler.exchange( oversampler );
+
+    unsigned int version = ++_oversamplerVersion;
+
+    if ( previous != nullptr )
+        _retiredOversamplers.push_back({ version, previous });
+
+    disposeRetiredOversamplers( false );
+}
+
+int BaseProcessor::getOversampling()
+{
+    Oversampler* oversampler = _oversampler.load();
+    return ( oversampler != nullptr ) ? oversampler->getFactor() : 1;
+}
+
+int BaseProcessor::getLatency()
+{
+    Oversampler* oversampler = _oversampler.load();
+    return ( oversampler != nullptr ) ? ( int ) round( oversampler->getLatency() ) : 0;
+}
+
+void BaseProcessor::apply( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    // the version is read prior to the Oversampler, upon completion all Oversamplers
+    // replaced up until this version are no longer in use
+
+    unsigned int version     = _oversamplerVersion.load();
+    Oversampler* oversampler = _oversampler.load();
+
+    if ( oversampler == nullptr ) {
+        process( sampleBuffer, isMonoSource );
+    } else {
+        AudioBuffer* oversampledBuffer = oversampler->upsample( sampleBuffer, isMonoSource );
+        process( oversampledBuffer, isMonoSource );
+        oversampler->downsample( sampleBuffer, isMonoSource );
+    }
+    _appliedVersion.store( version, std::memory_order_release );
+}
+
 void BaseProcessor::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
     // override in subclass
@@ -55,4 +105,24 @@ bool BaseProcessor::isCacheable()
     return false;   // override in subclass
 }
 
+/* protected methods */
+
+void BaseProcessor::disposeRetiredOversamplers( bool force )
+{
+    // Oversamplers can be disposed once apply() has completed with the version replacing them
+    // (those retired while the processor isn't rendering are disposed on destruction)
+
+    unsigned int appliedVersion = _appliedVersion.load( std::memory_order_acquire );
+
+    for ( auto it = _retiredOversamplers.begin(); it != _retiredOversamplers.end(); )
+    {
+        if ( force || it->first <= appliedVersion ) {
+            delete it->second;
+            it = _retiredOversamplers.erase( it );
+        } else {
+            ++it;
+        }
+    }
+}
+
 } // E.O namespace MWEngine
@@ -25,7 +25,11 @@
 
 #include <global.h>
 #include <audiobuffer.h>
+#include <modules/oversampler.h>
+#include <atomic>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace MWEngine {
 
@@ -43,6 +47,25 @@ class BaseProcessor
             return std::string( "BaseProcessor" ); // override in subclass
         }
 
+        /**
+         * Nonlinear processors (e.g. waveshaping, bit crushing, frequency modulation)
+         * generate harmonics above the Nyquist frequency which fold back into the
+         * audible range. When oversampling, process() operates on a signal at
+         * factor times the engine rate, which is filtered and decimated afterwards.
+         *
+         * @param {int} factor oversampling factor, either 1 (disabled), 2, 4 or 8
+         *
+         * Can be invoked while the processor is rendering, the replaced Oversampler
+         * is deleted once the render thread has completed an apply() using its successor
+         */
+        void setOversampling( int factor );
+        int getOversampling();
+
+        /**
+         * the latency (in samples at the engine rate) introduced by this processor
+         */
+        virtual int getLatency();
+
 #ifndef SWIG
         // internal to the engine
 
@@ -54,6 +77,12 @@ class BaseProcessor
          */
         virtual void process( AudioBuffer* sampleBuffer, bool isMonoSource );
 
+        /**
+         * invoked by the engine to process given sampleBuffer, when oversampling
+         * is enabled this wraps process() within the up- and downsampling pass
+         */
+        void apply( AudioBuffer* sampleBuffer, bool isMonoSource );
+
         /**
          * if this processors effect is non-dynamic its output
          * can be cached to omit unnecessary repeated calculations
@@ -73,6 +102,13 @@ class BaseProcessor
 
     protected:
         ProcessingChain* chain = nullptr;
+
+        std::atomic<Oversampler*> _oversampler { nullptr };
+        std::atomic<unsigned int> _oversamplerVersion { 0 }; // increments whenever the Oversampler is replaced
+        std::atomic<unsigned int> _appliedVersion { 0 };     // version of the Oversampler the last apply() completed with
+        std::vector<std::pair<unsigned int, Oversampler*>> _retiredOversamplers; // replaced Oversamplers (and the version replacing them)
+
+        void disposeRetiredOversamplers( bool force );
 };
 } // E.O namespace MWEngine
 
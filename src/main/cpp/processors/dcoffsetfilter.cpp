@@ -31,22 +31,18 @@ namespace MWEngine {
 
 DCOffsetFilter::DCOffsetFilter( int amountOfChannels )
 {
-    _lastInSamples  = new SAMPLE_TYPE[ amountOfChannels ];
-    _lastOutSamples = new SAMPLE_TYPE[ amountOfChannels ];
-
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        _lastInSamples [ i ] = 0.0;
-        _lastOutSamples[ i ] = 0.0;
-    }
     SAMPLE_TYPE baseFrequency = 65.41; // is a C2 note
     R = 1.0 - ( TWO_PI * baseFrequency / AudioEngineProps::SAMPLE_RATE );
+
+    // y(n) = x(n) - x(n-1) + R * y(n-1) as a first order section
+
+    _filter = new Biquad( amountOfChannels );
+    _filter->setCoefficients( 1.0, -1.0, 0.0, -R, 0.0 );
 }
 
 DCOffsetFilter::~DCOffsetFilter()
 {
-    delete[] _lastInSamples;
-    delete[] _lastOutSamples;
+    delete _filter;
 }
 
 /* public methods */
@@ -77,32 +73,7 @@ void DCOffsetFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
      * How to calculate "R" for a given (-3dB) low frequency point?
      * R = 1 - (pi*2 * frequency /samplerate)
      */
-    int bufferSize = sampleBuffer->bufferSize;
-
-    for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-        SAMPLE_TYPE lastInSample   = _lastInSamples [ c ];
-        SAMPLE_TYPE lastOutSample  = _lastOutSamples[ c ];
-
-        for ( int i = 0; i < bufferSize; ++i )
-        {
-            SAMPLE_TYPE outSample = channelBuffer[ i ] - lastInSample + R * lastOutSample;
-            lastInSample          = channelBuffer[ i ]; // cache last input sample
-            lastOutSample         =                     // cache last output sample
-            channelBuffer[ i ]    = outSample;          // write filtered sample into output buffer
-        }
-
-        _lastInSamples [ c ] = lastInSample;
-        _lastOutSamples[ c ] = lastOutSample;
-
-        // save CPU cycles when source is mono
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
-    }
+    _filter->process( sampleBuffer, isMonoSource );
 }
 
 } // E.O namespace MWEngine
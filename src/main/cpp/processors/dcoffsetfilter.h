@@ -26,6 +26,7 @@
 #define __MWENGINE__DCOFFSETFILTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <modules/biquad.h>
 
 namespace MWEngine {
 class DCOffsetFilter : public BaseProcessor
@@ -44,9 +45,8 @@ class DCOffsetFilter : public BaseProcessor
 #endif
 
     private:
-        SAMPLE_TYPE* _lastInSamples;
-        SAMPLE_TYPE* _lastOutSamples;
-        SAMPLE_TYPE  R;
+        Biquad* _filter;
+        SAMPLE_TYPE R;
 };
 } // E.O namespace MWEngine
 
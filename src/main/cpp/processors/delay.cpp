@@ -22,7 +22,10 @@
  */
 #include "delay.h"
 #include "../global.h"
+#include "../audioengine.h"
+#include "../audioenginecontext.h"
 #include <utilities/utils.h>
+#include <algorithm>
 #include <math.h>
 
 namespace MWEngine {
@@ -39,75 +42,124 @@ namespace MWEngine {
  */
 Delay::Delay( int aDelayTime, int aMaxDelayTime, float aMix, float aFeedback, int amountOfChannels )
 {
-    _time        = ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000 ) * aDelayTime );
-    _maxTime     = ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000 ) * aMaxDelayTime );
+    _maxTime          = std::max( 1, ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000.0 ) * aMaxDelayTime ));
+    _mix              = aMix;
+    _feedback         = aFeedback;
+    _amountOfChannels = amountOfChannels;
+    _mode             = NORMAL;
+    _beats            = 0.f;
+    _samplesPerBeat   = 0;
+    _amountOfTaps     = 0;
+
+    // delay time changes glide over approximately 50 ms
 
-    _delayBuffer  = new AudioBuffer( amountOfChannels, _maxTime );
-    _mix          = aMix;
-    _feedback     = aFeedback;
-    _delayIndices = new int[ amountOfChannels ];
+    _glide = 1.0 - exp( -1.0 / ( 0.05 * AudioEngineProps::SAMPLE_RATE ));
 
     for ( int i = 0; i < amountOfChannels; ++i ) {
-        _delayIndices[ i ] = 0;
+        _lines.push_back( new DelayLine( _maxTime ));
     }
-    _amountOfChannels = amountOfChannels;
+
+    _timesSize = AudioEngineProps::BUFFER_SIZE;
+    _times     = new SAMPLE_TYPE[ _timesSize ];
+
+    setDelayTime( aDelayTime );
+    _time = _targetTime;
 }
 
 Delay::~Delay()
 {
-    delete _delayBuffer;
-    delete[] _delayIndices;
-
-    _delayBuffer = nullptr;
-    _delayIndices = nullptr;
+    while ( !_lines.empty() ) {
+        delete _lines.back();
+        _lines.pop_back();
+    }
+    delete[] _times;
+    _times = nullptr;
 }
 
 /* public methods */
 
 void Delay::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    SAMPLE_TYPE delaySample;
-    int readIndex, delayIndex, delayBufferChannel;
-    int amountOfChannels = std::min( _delayBuffer->amountOfChannels, sampleBuffer->amountOfChannels );
+    int amountOfChannels = std::min(( int ) _lines.size(), sampleBuffer->amountOfChannels );
+    int bufferSize       = sampleBuffer->bufferSize;
+
+    syncToTempo();
+
+    if ( bufferSize > _timesSize ) {
+        delete[] _times;
+        _timesSize = bufferSize;
+        _times     = new SAMPLE_TYPE[ _timesSize ];
+    }
 
-    int bufferSize = sampleBuffer->bufferSize;
+    // calculate the (gliding) delay time for the buffer once, it is shared by all channels
 
-    for ( int c = 0; c < amountOfChannels; ++c )
+    for ( int i = 0; i < bufferSize; ++i ) {
+        _time += ( _targetTime - _time ) * _glide;
+        _times[ i ] = _time;
+    }
+
+    if ( fabs( _targetTime - _time ) < 0.001 )
+        _time = _targetTime;
+
+    // higher feedback levels can cause a massive noise-fest, "limit" them!
+    SAMPLE_TYPE wet = ( _feedback > .5f ) ? _mix * ( 1.5f - _feedback ) : _mix;
+
+    int c = 0;
+
+    // ping-pong mode alternates the repeats between the first two channels, the
+    // input is summed into the first channel (mono sources will be output in stereo)
+
+    if ( _mode == PING_PONG && amountOfChannels >= 2 )
     {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-        SAMPLE_TYPE* delayBuffer   = _delayBuffer->getBufferForChannel( c );
-        delayIndex                 = _delayIndices[ c ];
+        SAMPLE_TYPE* leftBuffer  = sampleBuffer->getBufferForChannel( 0 );
+        SAMPLE_TYPE* rightBuffer = sampleBuffer->getBufferForChannel( 1 );
+        DelayLine* leftLine      = _lines[ 0 ];
+        DelayLine* rightLine     = _lines[ 1 ];
 
         for ( int i = 0; i < bufferSize; ++i )
         {
-            readIndex = delayIndex - _time + 1;
+            SAMPLE_TYPE left  = leftLine->readInterpolated ( _times[ i ]);
+            SAMPLE_TYPE right = rightLine->readInterpolated( _times[ i ]);
+            SAMPLE_TYPE input = isMonoSource ? leftBuffer[ i ] : ( leftBuffer[ i ] + rightBuffer[ i ]) * 0.5;
 
-            if ( readIndex < 0 ) {
-                readIndex += _time;
-            }
+            leftLine->write ( input + right * _feedback );
+            rightLine->write( left * _feedback );
 
-            // read the previously delayed samples from the buffer
+            if ( isMonoSource )
+                rightBuffer[ i ] = leftBuffer[ i ];
+
+            leftBuffer[ i ]  += left  * wet;
+            rightBuffer[ i ] += right * wet;
+        }
+        c = 2;
+
+        if ( isMonoSource )
+            return;
+    }
+
+    for ( ; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        DelayLine* line            = _lines[ c ];
+        int amountOfTaps           = ( _mode == MULTI_TAP ) ? _amountOfTaps.load( std::memory_order_acquire ) : 0;
+
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            // read the previously delayed samples from the line
             // ( for feedback purposes ) and append the current sample to it
 
-            delaySample = delayBuffer[ readIndex ];
-            delayBuffer[ delayIndex ] = channelBuffer[ i ] + delaySample * _feedback;
+            SAMPLE_TYPE delaySample = line->readInterpolated( _times[ i ]);
+            SAMPLE_TYPE output      = delaySample;
 
-            if ( ++delayIndex == _time ) {
-                delayIndex = 0;
-            }
+            if ( amountOfTaps > 0 )
+                output += readTaps( line, _times[ i ], amountOfTaps );
 
-            // higher feedback levels can cause a massive noise-fest, "limit" them!
-            if ( _feedback > .5f ) {
-                channelBuffer[ i ] += ( delaySample * _mix * ( 1.5f - _feedback ));
-            }
-            else {
-                channelBuffer[ i ] += ( delaySample * _mix );
-            }
+            line->write( channelBuffer[ i ] + delaySample * _feedback );
+
+            channelBuffer[ i ] += ( output * wet );
         }
-        _delayIndices[ c ] = delayIndex; // update last index
 
         // omit unnecessary cycles by copying the mono content
-        // TODO: make delay stereo multi-tap ! ;)
         if ( isMonoSource )
         {
             sampleBuffer->applyMonoSource();
@@ -121,29 +173,23 @@ void Delay::process( AudioBuffer* sampleBuffer, bool isMonoSource )
  */
 void Delay::reset()
 {
-    if ( _delayBuffer != nullptr )
-        _delayBuffer->silenceBuffers();
+    for ( DelayLine* line : _lines )
+        line->clear();
+
+    _time = _targetTime;
 }
 
 /* getters / setters */
 
 int Delay::getDelayTime()
 {
-    return _time / ( AudioEngineProps::SAMPLE_RATE / 1000 );
+    return ( int ) round( _targetTime / ( AudioEngineProps::SAMPLE_RATE / 1000.0 ));
 }
 
 void Delay::setDelayTime( int aValue )
 {
-    _time = ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000 ) * aValue );
-
-    if ( _time > _maxTime )
-        _time = _maxTime; // keep within defines range
-
-    for ( int i = 0; i < _amountOfChannels; ++i )
-    {
-        if ( _delayIndices[ i ] >= _time )
-            _delayIndices[ i ] = 0;
-    }
+    _beats = 0.f; // disables tempo sync
+    setTargetTime(( AudioEngineProps::SAMPLE_RATE / 1000.0 ) * aValue );
 }
 
 float Delay::getMix()
@@ -166,4 +212,85 @@ void Delay::setFeedback( float aValue )
     _feedback = aValue;
 }
 
+Delay::modes Delay::getMode()
+{
+    return _mode;
+}
+
+void Delay::setMode( Delay::modes aMode )
+{
+    _mode = aMode;
+}
+
+float Delay::getTempoSync()
+{
+    return _beats;
+}
+
+void Delay::setTempoSync( float beats )
+{
+    _beats          = std::max( 0.f, beats );
+    _samplesPerBeat = 0; // forces recalculation
+
+    syncToTempo();
+}
+
+bool Delay::addTap( float position, float gain )
+{
+    int index = _amountOfTaps.load( std::memory_order_relaxed );
+
+    if ( index >= MAX_TAPS )
+        return false;
+
+    // the tap is only read once it has been counted
+
+    _taps[ index ].position = capParam( position );
+    _taps[ index ].gain     = capParam( gain );
+
+    _amountOfTaps.store( index + 1, std::memory_order_release );
+
+    return true;
+}
+
+void Delay::removeTaps()
+{
+    _amountOfTaps.store( 0, std::memory_order_release );
+}
+
+/* protected methods */
+
+void Delay::setTargetTime( SAMPLE_TYPE samples )
+{
+    // keep within defined range (at least a single sample of delay)
+    _targetTime = std::max(( SAMPLE_TYPE ) 1.0, std::min( samples, ( SAMPLE_TYPE ) _maxTime ));
+}
+
+void Delay::syncToTempo()
+{
+    if ( _beats <= 0.f )
+        return;
+
+    // while rendering, the tempo is read from the transport of the context being rendered
+    // (outside of the render cycle the default contexts tempo applies)
+
+    AudioEngineContext* context = AudioEngineContext::getRenderingContext();
+    int samplesPerBeat = ( context != nullptr ) ? context->getTransport().samples_per_beat : AudioEngine::samples_per_beat;
+
+    if ( _samplesPerBeat == samplesPerBeat )
+        return;
+
+    _samplesPerBeat = samplesPerBeat;
+    setTargetTime(( SAMPLE_TYPE ) _beats * _samplesPerBeat );
+}
+
+SAMPLE_TYPE Delay::readTaps( DelayLine* line, SAMPLE_TYPE time, int amountOfTaps )
+{
+    SAMPLE_TYPE output = 0.0;
+
+    for ( int i = 0; i < amountOfTaps; ++i )
+        output += line->readInterpolated( std::max(( SAMPLE_TYPE ) 1.0, _taps[ i ].position * time )) * _taps[ i ].gain;
+
+    return output;
+}
+
 } // E.O namespace MWEngine
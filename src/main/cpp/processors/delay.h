@@ -24,11 +24,20 @@
 #define __MWENGINE__DELAY_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <modules/delayline.h>
+#include <atomic>
+#include <vector>
 
 namespace MWEngine {
 class Delay : public BaseProcessor
 {
     public:
+        enum modes {
+            NORMAL,     // each channel repeats onto itself
+            PING_PONG,  // repeats alternate between the first two channels
+            MULTI_TAP   // additional taps (see addTap()) are read within the delay time
+        };
+
         Delay( int aDelayTime, int aMaxDelayTime, float aMix, float aFeedback, int amountOfChannels );
         ~Delay();
 
@@ -44,19 +53,67 @@ class Delay : public BaseProcessor
         void setFeedback( float aValue );
         void reset();
 
+        modes getMode();
+        void setMode( modes aMode );
+
+        /**
+         * synchronize the delay time to the sequencer tempo, the delay time
+         * is expressed in beats (e.g. 0.5 for an eighth note and 0.75 for a dotted
+         * eighth note in 4/4 time) and follows subsequent tempo changes.
+         * A value of 0 disables tempo sync (as does invoking setDelayTime())
+         */
+        float getTempoSync();
+        void setTempoSync( float beats );
+
+        /**
+         * add a tap for MULTI_TAP mode, up to MAX_TAPS taps can be added
+         * returns false when the maximum amount of taps has been reached
+         *
+         * @param {float} position of the tap relative to the delay time (0 - 1)
+         * @param {float} gain of the tap (0 - 1)
+         */
+        bool addTap( float position, float gain );
+        void removeTaps();
+
+        static const int MAX_TAPS = 16;
+
 #ifndef SWIG
         // internal to the engine
         void process( AudioBuffer* sampleBuffer, bool isMonoSource );
 #endif
 
     protected:
-        AudioBuffer* _delayBuffer;
-        int* _delayIndices;
-        int _time;
+        std::vector<DelayLine*> _lines;
+        SAMPLE_TYPE _time;          // current delay time in samples (glides towards _targetTime)
+        SAMPLE_TYPE _targetTime;    // requested delay time in samples
+        SAMPLE_TYPE _glide;
         int _maxTime;
         float _mix;
         float _feedback;
         int _amountOfChannels;
+        modes _mode;
+
+        float _beats;
+        int _samplesPerBeat;        // tempo the synced delay time was calculated for
+
+        // taps are read by the render thread while they can be added from another thread, as
+        // such these are stored in a fixed size list, where a tap is written before it is counted
+
+        struct Tap {
+            SAMPLE_TYPE position;
+            SAMPLE_TYPE gain;
+        };
+        Tap _taps[ MAX_TAPS ];
+        std::atomic<int> _amountOfTaps;
+
+        // delay time for each sample in the buffer, shared by all channels
+
+        SAMPLE_TYPE* _times;
+        int _timesSize;
+
+        void setTargetTime( SAMPLE_TYPE samples );
+        void syncToTempo();
+        SAMPLE_TYPE readTaps( DelayLine* line, SAMPLE_TYPE time, int amountOfTaps );
 };
 } // E.O namespace MWEngine
 
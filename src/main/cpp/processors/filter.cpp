@@ -22,6 +22,7 @@
  */
 #include "filter.h"
 #include "../global.h"
+#include <utilities/bufferutility.h>
 #include <math.h>
 
 namespace MWEngine {
@@ -58,69 +59,50 @@ Filter::~Filter()
 {
     //delete _lfo; // nope... belongs to routeable oscillator in the instrument
 
-    delete[] in1;
-    delete[] in2;
-    delete[] out1;
-    delete[] out2;
-
-    in1 = in2 = out1 = out2 = nullptr;
+    delete _filter;
+    _filter = nullptr;
 }
 
 /* public methods */
 
 void Filter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize               = sampleBuffer->bufferSize;
-    bool doLFO                   = hasLFO();
-    SAMPLE_TYPE initialLFOOffset = doLFO ? _lfo->getTable()->getAccumulator() : 0.0;
-    float orgCutoff              = _tempCutoff;
+    // without LFO the cutoff is static (changes are smoothed by the filter kernel)
+
+    if ( !hasLFO() ) {
+        _filter->process( sampleBuffer, isMonoSource );
+        return;
+    }
+
+    int bufferSize = sampleBuffer->bufferSize;
 
     if ( amountOfChannels < sampleBuffer->amountOfChannels )
         isMonoSource = true;
 
-    for ( int i = 0, l = sampleBuffer->amountOfChannels; i < l; ++i )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
+    int channelAmount = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
 
-        // each channel needs the same offset to get the same LFO movement ;)
-        if ( doLFO && i > 0 )
-        {
-            _lfo->getTable()->setAccumulator( initialLFOOffset );
-            _tempCutoff = orgCutoff;
-            calculateParameters();
-        }
+    // all channels are processed within the same iteration
+    // as each channel needs the same LFO movement ;)
 
-        for ( int j = 0; j < bufferSize; ++j )
+    for ( int j = 0; j < bufferSize; ++j )
+    {
+        for ( int i = 0; i < channelAmount; ++i )
         {
-            SAMPLE_TYPE input = channelBuffer[ j ];
-            output            = a1 * input + a2 * in1[ i ] + a3 * in2[ i ] - b1 * out1[ i ] - b2 * out2[ i ];
-
-            in2 [ i ] = in1[ i ];
-            in1 [ i ] = input;
-            out2[ i ] = out1[ i ];
-            out1[ i ] = output;
-
-            // oscillator attached to Filter ? travel the cutoff values
-            // between the minimum and maximum frequencies, as
-            // defined by the range in the class constructor
-
-            if ( doLFO )
-            {
-                _tempCutoff = _lfo->sweep();
-                calculateParameters();
-            }
-
-            // commit the effect
-            channelBuffer[ j ] = output;
+            SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
+            channelBuffer[ j ] = _filter->processSingle( channelBuffer[ j ], i );
         }
 
-        // save CPU cycles when source is mono
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
+        // oscillator attached to Filter ? travel the cutoff values
+        // between the minimum and maximum frequencies, as
+        // defined by the range in the class constructor
+
+        _tempCutoff = _lfo->sweep();
+        calculateParameters();
     }
+
+    // save CPU cycles when source is mono
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
 }
 
 bool Filter::isCacheable()
@@ -171,6 +153,9 @@ void Filter::setLFO( LFO *lfo )
 {
     _lfo = lfo;
 
+    // the LFO modulates the cutoff on a per sample basis, glide only when the cutoff is static
+    _filter->setSmoothing( lfo == nullptr ? SMOOTHING_SAMPLES : 0 );
+
     // no LFO ? make sure the filter returns to its default parameters
     if ( lfo == nullptr )
     {
@@ -197,31 +182,22 @@ void Filter::init( float cutoff )
     _cutoff     = _maxFreq;
     _tempCutoff = _cutoff;
 
-    in1  = new SAMPLE_TYPE[ amountOfChannels ];
-    in2  = new SAMPLE_TYPE[ amountOfChannels ];
-    out1 = new SAMPLE_TYPE[ amountOfChannels ];
-    out2 = new SAMPLE_TYPE[ amountOfChannels ];
+    // the resonance acts as the damping of a low pass state variable filter (its bilinear
+    // transform equals the response of the original direct form implementation)
 
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        in1 [ i ] = 0.0;
-        in2 [ i ] = 0.0;
-        out1[ i ] = 0.0;
-        out2[ i ] = 0.0;
-    }
+    _filter = new StateVariableFilter( amountOfChannels, StateVariableFilter::LOW_PASS );
 
     // using this setter caches appropriate values
     setCutoff( cutoff );
+
+    // cutoff changes glide over a few milliseconds to prevent zipper noise
+    SMOOTHING_SAMPLES = BufferUtility::millisecondsToBuffer( 5, AudioEngineProps::SAMPLE_RATE );
+    _filter->setSmoothing( SMOOTHING_SAMPLES );
 }
 
 void Filter::calculateParameters()
 {
-    c  = 1.f / tan( PI * _tempCutoff / SAMPLE_RATE );
-    a1 = 1.f / ( 1.f + _resonance * c + c * c );
-    a2 = 2.f * a1;
-    a3 = a1;
-    b1 = 2.f * ( 1.f - c * c ) * a1;
-    b2 = ( 1.f - _resonance * c + c * c ) * a1;
+    _filter->setParameters( _tempCutoff, _resonance );
 }
 
 } // E.O namespace MWEngine
@@ -25,6 +25,7 @@
 
 #include "baseprocessor.h"
 #include <modules/lfo.h>
+#include <modules/statevariablefilter.h>
 
 namespace MWEngine {
 class Filter : public BaseProcessor
@@ -67,18 +68,8 @@ class Filter : public BaseProcessor
 
         float SAMPLE_RATE;
         int amountOfChannels;
-        SAMPLE_TYPE a1;
-        SAMPLE_TYPE a2;
-        SAMPLE_TYPE a3;
-        SAMPLE_TYPE b1;
-        SAMPLE_TYPE b2;
-        SAMPLE_TYPE c;
-        SAMPLE_TYPE output;
-
-        SAMPLE_TYPE* in1;
-        SAMPLE_TYPE* in2;
-        SAMPLE_TYPE* out1;
-        SAMPLE_TYPE* out2;
+        int SMOOTHING_SAMPLES;
+        StateVariableFilter* _filter;
 
     private:
         void init( float cutoff );
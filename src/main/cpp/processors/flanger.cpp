@@ -24,8 +24,8 @@
 #include "flanger.h"
 #include "../global.h"
 #include <utilities/utils.h>
-#include <utilities/bufferutility.h>
 #include <algorithm>
+#include <cmath>
 
 namespace MWEngine {
 
@@ -43,16 +43,12 @@ Flanger::Flanger()
 
 Flanger::~Flanger()
 {
-    while ( _buffers.size() > 0 ) {
-        delete _buffers.back();
-        _buffers.pop_back();
+    while ( _lines.size() > 0 ) {
+        delete _lines.back();
+        _lines.pop_back();
     }
-    while ( _caches.size() > 0 ) {
-        delete _caches.back();
-        _caches.pop_back();
-    }
-    delete _delayFilter;
-    delete _mixFilter;
+    delete[] _delayTimes;
+    delete[] _mixes;
 }
 
 /* public methods */
@@ -127,107 +123,82 @@ void Flanger::setChannelMix( int channel, float wet )
     wet       = capParam( wet );
     float dry = 1.0f - wet;
 
-    _caches.at( channel )->mixWet = wet;
-    _caches.at( channel )->mixDry = dry;
+    _caches.at( channel ).mixWet = wet;
+    _caches.at( channel ).mixDry = dry;
 }
 
 void Flanger::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int maxWriteIndex = FLANGER_BUFFER_SIZE - 1;
-
-    SAMPLE_TYPE delay, mix, delaySamples, sample, w1, w2, ep;
-    int ep1, ep2;
+    SAMPLE_TYPE sample, lastSample;
 
-    int amountOfChannels = std::min( sampleBuffer->amountOfChannels, ( int ) _buffers.size() );
+    int amountOfChannels = isMonoSource ? 1 : std::min( sampleBuffer->amountOfChannels, ( int ) _lines.size() );
     int bufferSize       = sampleBuffer->bufferSize;
 
-    // store/restore the processor properties
-    // this ensures that multi channel processing for a
-    // single buffer uses all properties across all channels
-    // store() before processing channel 0, restore() every
-    // channel afterwards
-
-    int writePointerStored  = _writePointer;
-    SAMPLE_TYPE sweepStored = _sweep;
-
-    _delayFilter->store();
-    _mixFilter->store();
-
-    for ( int c = 0; c < amountOfChannels; ++c  ) {
-
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-        SAMPLE_TYPE* delayBuffer   = _buffers.at( c );
-        ChannelCache* channelCache = _caches.at( c );
-
-        // when first channel has been processed, restore the stored values
-        // for the next channel iteration
+    if ( bufferSize > _modulationSize ) {
+        delete[] _delayTimes;
+        delete[] _mixes;
+        _modulationSize = bufferSize;
+        _delayTimes     = new SAMPLE_TYPE[ _modulationSize ];
+        _mixes          = new SAMPLE_TYPE[ _modulationSize ];
+    }
 
-        if ( c > 0 ) {
-            _writePointer = writePointerStored;
-            _sweep        = sweepStored;
-            _delayFilter->restore();
-            _mixFilter->restore();
-        }
+    // calculate the modulation for the buffer once, it is shared by all channels
 
-        for ( int i = 0; i < bufferSize; i++ ) {
+    for ( int i = 0; i < bufferSize; ++i ) {
 
-            // filter delay and mix output
+        // filter delay and mix output
 
-            delay = _delayFilter->processSingle( _delay );
-            mix   = _mixFilter->processSingle( _mix );
+        _smoothedDelay += ( _delay - _smoothedDelay ) * _smoothingCoeff;
+        _smoothedMix   += ( _mix   - _smoothedMix )   * _smoothingCoeff;
 
-            if ( ++_writePointer > maxWriteIndex )
-                _writePointer = 0;
+        // delay 0.0-1.0 maps to 0.02ms to 10ms (always have at least 1 sample of delay)
+        _delayTimes[ i ] = ( _smoothedDelay * SAMPLE_MULTIPLIER ) + 1.0 + _sweep;
+        _mixes[ i ]      = _smoothedMix;
 
-            // delay 0.0-1.0 maps to 0.02ms to 10ms (always have at least 1 sample of delay)
-            delaySamples = ( delay * SAMPLE_MULTIPLIER ) + 1.f;
-            delaySamples += _sweep;
+        // process sweep
 
-            // build the two emptying pointers and do linear interpolation
-            ep = ( SAMPLE_TYPE ) _writePointer - delaySamples;
+        if ( _step != 0.0 ) {
+            _sweep += _step;
 
-            if ( ep < 0.0 )
-                ep += ( SAMPLE_TYPE ) FLANGER_BUFFER_SIZE;
+            if ( _sweep <= 0.0 ) {
+                _sweep = 0.0;
+                _step = -_step;
+            }
+            else if ( _sweep >= _maxSweepSamples )
+                _step = -_step;
+        }
+    }
 
-            MODF( ep, ep1, w2 );
-            w1 = 1.0 - w2;
+    for ( int c = 0; c < amountOfChannels; ++c ) {
 
-            if ( ++ep1 > maxWriteIndex )
-                ep1 = 0;
+        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        DelayLine* delayLine       = _lines[ c ];
+        ChannelCache& channelCache = _caches[ c ];
 
-            ep2 = ep1 + 1;
+        lastSample = channelCache.lastSample;
 
-            if ( ep2 > maxWriteIndex )
-                ep2 = 0;
+        for ( int i = 0; i < bufferSize; i++ ) {
 
             // process input channels and write caches
 
             sample = channelBuffer[ i ];
-            delayBuffer[ _writePointer ] =
-                sample + _feedback * _feedbackPhase * channelCache->lastSample;
+            delayLine->write( sample + _feedback * _feedbackPhase * lastSample );
 
-            channelCache->lastSample = delayBuffer[ ep1 ] * w1 + delayBuffer[ ep2 ] * w2;
+            // read the delayed sample (linearly interpolated)
+            lastSample = delayLine->readInterpolated( _delayTimes[ i ]);
 
             // write effected sample into the output buffer
 
             channelBuffer[ i ] = capSample(
-                channelCache->mixDry * sample + channelCache->mixWet * mix * channelCache->lastSample
+                channelCache.mixDry * sample + channelCache.mixWet * _mixes[ i ] * lastSample
             );
-
-            // process sweep
-
-            if ( _step != 0.0 ) {
-                _sweep += _step;
-
-                if ( _sweep <= 0.0 ) {
-                    _sweep = 0.0;
-                    _step = -_step;
-                }
-                else if ( _sweep >= _maxSweepSamples )
-                    _step = -_step;
-            }
         }
+        channelCache.lastSample = lastSample;
     }
+
+    // save CPU cycles when working on a mono source
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
 }
 
 /* protected methods */
@@ -245,25 +216,31 @@ void Flanger::init( float rate, float width, float feedback, float delay, float
     FLANGER_BUFFER_SIZE = ( int ) (( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE / 5.0f );
     SAMPLE_MULTIPLIER   = ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE * 0.01f;
 
-    _writePointer    = 0;
     _feedbackPhase   = 1.f;
     _sweepSamples    = 0.f;
 
     // create sample buffers and caches for each channel
 
     for ( int i = 0; i < AudioEngineProps::OUTPUT_CHANNELS; ++i ) {
-        _buffers.push_back( BufferUtility::generateSilentBuffer( FLANGER_BUFFER_SIZE ));
-        _caches.push_back( new ChannelCache());
+        _lines.push_back( new DelayLine( FLANGER_BUFFER_SIZE ));
+        _caches.push_back( ChannelCache());
     }
 
-    _delayFilter = new LowPassFilter( 20.0f );
-    _mixFilter   = new LowPassFilter( 20.0f );
+    // one-pole smoothing of the delay and mix parameters at 20 Hz
+
+    _smoothingCoeff = 1.0 - exp( -TWO_PI * 20.0 / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE );
+    _delayTimes     = nullptr;
+    _mixes          = nullptr;
+    _modulationSize = 0;
 
     setRate( rate );
     setWidth( width );
     setFeedback( feedback );
     setDelay( delay );
     setMix( mix );
+
+    _smoothedDelay = _delay;
+    _smoothedMix   = _mix;
 }
 
 } // E.O namespace MWEngine
@@ -25,19 +25,11 @@
 #define __MWENGINE__FLANGER_H_INCLUDED__
 
 #include "baseprocessor.h"
-#include "lowpassfilter.h"
+#include <modules/delayline.h>
+#include <vector>
 
 namespace MWEngine {
 
-// Adaptation of modf() by Dennis Cronin
-// this macro breaks a double into integer and fractional components i and f respectively.
-//
-// n - input number, a sample (e.g. float or double)
-// i - integer portion, an integer (the input number integer portion should fit)
-// f - fractional portion, a sample (e.g. float or double)
-
-#define MODF(n,i,f) ((i) = (int)(n), (f) = (n) - ( SAMPLE_TYPE )(i))
-
 /**
  * a multichannel Flanger effect
  */
@@ -87,13 +79,21 @@ class Flanger : public BaseProcessor
         SAMPLE_TYPE _feedbackPhase;
         SAMPLE_TYPE _sweepSamples;
         SAMPLE_TYPE _maxSweepSamples;
-        int _writePointer;
         SAMPLE_TYPE _step;
         SAMPLE_TYPE _sweep;
-        std::vector<SAMPLE_TYPE*> _buffers;
+        std::vector<DelayLine*> _lines;
+
+        // delay and mix parameters are smoothed to prevent zipper noise
+
+        SAMPLE_TYPE _smoothedDelay;
+        SAMPLE_TYPE _smoothedMix;
+        SAMPLE_TYPE _smoothingCoeff;
+
+        // modulation for each sample in the buffer, calculated once for all channels
 
-        LowPassFilter* _delayFilter;
-        LowPassFilter* _mixFilter;
+        SAMPLE_TYPE* _delayTimes;
+        SAMPLE_TYPE* _mixes;
+        int _modulationSize;
 
         struct ChannelCache {
             SAMPLE_TYPE lastSample;
@@ -107,7 +107,7 @@ class Flanger : public BaseProcessor
             }
         };
 
-        std::vector<ChannelCache*> _caches;
+        std::vector<ChannelCache> _caches;
         SAMPLE_TYPE _sweepRate;
 
         int FLANGER_BUFFER_SIZE;
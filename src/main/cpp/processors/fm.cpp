@@ -48,6 +48,12 @@ void FrequencyModulator::process( AudioBuffer* sampleBuffer, bool isMonoSource )
     int bufferSize       = sampleBuffer->bufferSize;
     int initialLFOOffset = _table->getAccumulator();
 
+    // when oversampling, the modulator and LFO should advance at the engine rate
+
+    int factor            = getOversampling();
+    SAMPLE_TYPE increment = ( TWO_PI_OVER_SR * _rate ) / factor;
+    SAMPLE_TYPE lfo       = 0.0;
+
     for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
     {
         SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
@@ -58,11 +64,14 @@ void FrequencyModulator::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 
         for ( int i = 0; i < bufferSize; ++i )
         {
-            modulator = modulator + ( TWO_PI_OVER_SR * _rate );
+            modulator = modulator + increment;
             modulator = modulator < TWO_PI ? modulator : modulator - TWO_PI;
 
+            if ( i % factor == 0 )
+                lfo = _table->peek();
+
             carrier            = channelBuffer[ i ];
-            channelBuffer[ i ] = ( carrier * _table->peek() ) * cos( carrier + fmamp * cos( modulator ));
+            channelBuffer[ i ] = ( carrier * lfo ) * cos( carrier + fmamp * cos( modulator ));
         }
         // save CPU cycles when source is mono
         if ( isMonoSource )
@@ -23,7 +23,10 @@
  */
 #include "formantfilter.h"
 #include "../utilities/utils.h"
+#include <utilities/bufferutility.h>
+#include <algorithm>
 #include <cmath>
+#include <complex>
 
 namespace MWEngine {
 
@@ -35,20 +38,23 @@ namespace MWEngine {
  */
 FormantFilter::FormantFilter( double aVowel )
 {
-    int i = 0;
-    for ( ; i < 11; i++ )
+    for ( int i = 0; i < 11; i++ )
         _currentCoeffs[ i ] = 0.0;
 
-    for ( i = 0; i < 10; i++ )
-        _memory[ i ] = 0.0;
+    // the 10th order all-pole filter is processed as a cascade of five biquad sections
+
+    _filter = new Biquad( AudioEngineProps::OUTPUT_CHANNELS, 5 );
 
     calculateCoeffs();
     setVowel( aVowel );
+
+    // subsequent vowel changes glide to prevent clicks
+    _filter->setSmoothing( BufferUtility::millisecondsToBuffer( 10, AudioEngineProps::SAMPLE_RATE ));
 }
 
 FormantFilter::~FormantFilter()
 {
-    // _currentCoeffs and _memory weren't allocated with new[], nothing to delete[] ;)
+    delete _filter;
 }
 
 /* public methods */
@@ -96,75 +102,102 @@ void FormantFilter::setVowel( double aVowel )
             _currentCoeffs[ i ] = delta < .5 ? minCoeff : maxCoeff;
         }
     }
+    calculateSections();
 }
 
 void FormantFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
+    _filter->process( sampleBuffer, isMonoSource );
+}
+
+bool FormantFilter::isCacheable()
+{
+    return true;
+}
+
+/* private methods */
+
+/**
+ * factors the denominator of the current all-pole coefficients into second order
+ * sections. The direct form filter has its poles very close to the unit circle, which
+ * is numerically fragile (especially at 32-bit precision), where the cascade is not.
+ */
+void FormantFilter::calculateSections()
+{
+    const int ORDER = 10;
+    typedef std::complex<double> complex;
+
+    // the poles are the roots of z^10 - c1 z^9 - c2 z^8 - ... - c10
+    // solved using the Durand-Kerner method
+
+    double polynomial[ ORDER + 1 ];
+    polynomial[ 0 ] = 1.0;
+    for ( int i = 1; i <= ORDER; ++i )
+        polynomial[ i ] = -_currentCoeffs[ i ];
+
+    complex roots[ ORDER ];
+    for ( int i = 0; i < ORDER; ++i )
+        roots[ i ] = std::polar( 0.9, 0.4 + i * TWO_PI / ORDER );
 
-    for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
+    for ( int iteration = 0; iteration < 500; ++iteration )
     {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        double maxDelta = 0.0;
 
-        for ( int i = 0; i < bufferSize; ++i )
+        for ( int i = 0; i < ORDER; ++i )
         {
-            double res = ( _currentCoeffs[ 0 ]  * channelBuffer[ i ] +
-                           _currentCoeffs[ 1 ]  * _memory[ 0 ] +
-                           _currentCoeffs[ 2 ]  * _memory[ 1 ] +
-                           _currentCoeffs[ 3 ]  * _memory[ 2 ] +
-                           _currentCoeffs[ 4 ]  * _memory[ 3 ] +
-                           _currentCoeffs[ 5 ]  * _memory[ 4 ] +
-                           _currentCoeffs[ 6 ]  * _memory[ 5 ] +
-                           _currentCoeffs[ 7 ]  * _memory[ 6 ] +
-                           _currentCoeffs[ 8 ]  * _memory[ 7 ] +
-                           _currentCoeffs[ 9 ]  * _memory[ 8 ] +
-                           _currentCoeffs[ 10 ] * _memory[ 9 ] );
-
-            _memory[ 9 ] = _memory[ 8 ];
-            _memory[ 8 ] = _memory[ 7 ];
-            _memory[ 7 ] = _memory[ 6 ];
-            _memory[ 6 ] = _memory[ 5 ];
-            _memory[ 5 ] = _memory[ 4 ];
-            _memory[ 4 ] = _memory[ 3 ];
-            _memory[ 3 ] = _memory[ 2 ];
-            _memory[ 2 ] = _memory[ 1 ];
-            _memory[ 1 ] = _memory[ 0 ];
-            _memory[ 0 ] = res;
-
-            // 32-bit float resolution is too low on certain coefficients, below "hack"
-            // cheaply prevents extreme self oscillation to exceed the max. capacity
-
-            #if PRECISION == 1
-                float output;
-
-                if ( res > FLT_MAX )
-                    output = FLT_MAX;
-                else if ( res < -FLT_MAX )
-                    output = -FLT_MAX;
-                else
-                    output = ( float ) res;
-
-                channelBuffer[ i ] = output;
-            #else
-                channelBuffer[ i ] = res;
-            #endif
+            complex numerator = polynomial[ 0 ];
+            for ( int j = 1; j <= ORDER; ++j )
+                numerator = numerator * roots[ i ] + polynomial[ j ];
+
+            complex denominator = 1.0;
+            for ( int j = 0; j < ORDER; ++j ) {
+                if ( j != i )
+                    denominator *= ( roots[ i ] - roots[ j ]);
+            }
+            complex delta = numerator / denominator;
+            roots[ i ]   -= delta;
+            maxDelta      = std::max( maxDelta, std::abs( delta ));
         }
-
-        // omit unnecessary cycles by copying the mono content
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
+        if ( maxDelta < 1e-12 )
             break;
-        }
     }
-}
 
-bool FormantFilter::isCacheable()
-{
-    return true;
-}
+    // pair each root with its complex conjugate, ordered by angle so subsequent
+    // vowel changes glide between matching sections
 
-/* private methods */
+    std::sort( roots, roots + ORDER, []( const complex& a, const complex& b ) {
+        return std::abs( std::arg( a )) < std::abs( std::arg( b ));
+    });
+
+    bool paired[ ORDER ] = { false };
+
+    for ( int i = 0, section = 0; i < ORDER; ++i )
+    {
+        if ( paired[ i ])
+            continue;
+
+        int match       = -1;
+        double distance = 0.0;
+
+        for ( int j = i + 1; j < ORDER; ++j ) {
+            double d = std::abs( roots[ j ] - std::conj( roots[ i ]));
+            if ( !paired[ j ] && ( match == -1 || d < distance )) {
+                match    = j;
+                distance = d;
+            }
+        }
+        paired[ i ] = paired[ match ] = true;
+
+        // the gain is applied by the first section
+
+        _filter->setCoefficients(
+            section == 0 ? _currentCoeffs[ 0 ] : 1.0, 0.0, 0.0,
+            -( roots[ i ] + roots[ match ]).real(), ( roots[ i ] * roots[ match ]).real(),
+            section
+        );
+        ++section;
+    }
+}
 
 // store the vowel coefficients
 
@@ -25,6 +25,7 @@
 #define __MWENGINE__FORMANTFILTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <modules/biquad.h>
 
 namespace MWEngine {
 class FormantFilter : public BaseProcessor
@@ -56,8 +57,9 @@ class FormantFilter : public BaseProcessor
         double  _vowel;
         double _currentCoeffs[ 11 ];
         double _coeffs[ 5 ][ 11 ];
-        double _memory[ 10 ];
+        Biquad* _filter;
         void calculateCoeffs();
+        void calculateSections();
 };
 } // E.O namespace MWEngine
 
@@ -0,0 +1,291 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "lookaheadlimiter.h"
+#include "../global.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MWEngine {
+
+const int LookAheadLimiter::TRUE_PEAK_TAPS;
+const int LookAheadLimiter::TRUE_PEAK_DELAY;
+
+// constructors / destructor
+
+LookAheadLimiter::LookAheadLimiter()
+{
+    // ceiling equals the engine's former hard clipping threshold (MAX_OUTPUT)
+    init( 20.f * log10f( MAX_OUTPUT ), 1.5f, 50.f );
+}
+
+LookAheadLimiter::LookAheadLimiter( float ceilingDb, float lookAheadMs, float releaseMs )
+{
+    init( ceilingDb, lookAheadMs, releaseMs );
+}
+
+LookAheadLimiter::~LookAheadLimiter()
+{
+    deallocate();
+}
+
+/* public methods */
+
+float LookAheadLimiter::getCeiling()
+{
+    return _ceilingDb;
+}
+
+void LookAheadLimiter::setCeiling( float ceilingDb )
+{
+    _ceilingDb = std::min( 0.f, ceilingDb );
+    _ceiling   = ( SAMPLE_TYPE ) pow( 10.0, _ceilingDb / 20.0 );
+}
+
+float LookAheadLimiter::getLookAhead()
+{
+    return _lookAheadMs;
+}
+
+void LookAheadLimiter::setLookAhead( float lookAheadMs )
+{
+    _lookAheadMs = std::max( 0.1f, std::min( lookAheadMs, 20.f ));
+    allocate( _amountOfChannels );
+}
+
+float LookAheadLimiter::getRelease()
+{
+    return _releaseMs;
+}
+
+void LookAheadLimiter::setRelease( float releaseMs )
+{
+    _releaseMs    = std::max( 1.f, releaseMs );
+    _releaseCoeff = 1.0 - exp( -1.0 / ( _releaseMs * 0.001 * _sampleRate ));
+}
+
+float LookAheadLimiter::getLinearGR()
+{
+    return ( float ) ( _averageSum / _lookAhead );
+}
+
+int LookAheadLimiter::getLatency()
+{
+    return BaseProcessor::getLatency() + _lookAhead - 1 + TRUE_PEAK_DELAY;
+}
+
+void LookAheadLimiter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int amountOfChannels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
+
+    if ( _sampleRate != AudioEngineProps::SAMPLE_RATE || amountOfChannels > _amountOfChannels )
+        allocate( std::max( amountOfChannels, _amountOfChannels ));
+
+    // the moving average is summed anew once per block (rather than only adding and subtracting
+    // the sample that enters and leaves the window) so rounding errors do not accumulate
+
+    _averageSum = 0.0;
+    for ( int i = 0; i < _lookAhead; ++i )
+        _averageSum += _averageBuffer[ i ];
+
+    int bufferSize           = sampleBuffer->bufferSize;
+    int latency              = _lookAhead - 1 + TRUE_PEAK_DELAY;
+    SAMPLE_TYPE averageScale = 1.0 / ( SAMPLE_TYPE ) _lookAhead;
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        // write the incoming samples into the delay lines and detect their (linked) peak level
+
+        SAMPLE_TYPE peak = 0.0;
+
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            _delayLines[ c ][ _writeIndex ] = sampleBuffer->getBufferForChannel( c )[ i ];
+            peak = std::max( peak, detectPeak( c ));
+        }
+        SAMPLE_TYPE required = ( peak > _ceiling ) ? _ceiling / peak : 1.0;
+
+        // sliding minimum of the required gain over the look-ahead window
+
+        while ( _dequeTail != _dequeHead && _dequeGains[( _dequeTail - 1 ) & _dequeMask ] >= required )
+            --_dequeTail;
+
+        _dequeGains  [ _dequeTail & _dequeMask ] = required;
+        _dequeIndices[ _dequeTail & _dequeMask ] = _sampleIndex;
+        ++_dequeTail;
+
+        if ( _sampleIndex - _dequeIndices[ _dequeHead & _dequeMask ] >= ( unsigned int ) _lookAhead )
+            ++_dequeHead;
+
+        // release towards unity gain, then smooth the attack over the look-ahead window
+
+        _envelope = std::min( _dequeGains[ _dequeHead & _dequeMask ], _envelope + ( 1.0 - _envelope ) * _releaseCoeff );
+
+        _averageSum += _envelope - _averageBuffer[ _averageIndex ];
+        _averageBuffer[ _averageIndex ] = _envelope;
+
+        if ( ++_averageIndex == _lookAhead )
+            _averageIndex = 0;
+
+        SAMPLE_TYPE gain = _averageSum * averageScale;
+        int readIndex    = ( _writeIndex - latency ) & _delayMask;
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+            sampleBuffer->getBufferForChannel( c )[ i ] = _delayLines[ c ][ readIndex ] * gain;
+
+        _writeIndex = ( _writeIndex + 1 ) & _delayMask;
+        ++_sampleIndex;
+    }
+
+    // save CPU cycles when source is mono
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+void LookAheadLimiter::reset()
+{
+    for ( int c = 0; c < _amountOfChannels; ++c )
+        memset( _delayLines[ c ], 0, ( _delayMask + 1 ) * sizeof( SAMPLE_TYPE ));
+
+    for ( int i = 0; i < _lookAhead; ++i )
+        _averageBuffer[ i ] = 1.0;
+
+    _averageSum   = ( SAMPLE_TYPE ) _lookAhead;
+    _averageIndex = 0;
+    _envelope     = 1.0;
+    _writeIndex   = 0;
+    _dequeHead    = 0;
+    _dequeTail    = 0;
+    _sampleIndex  = 0;
+}
+
+/* protected methods */
+
+void LookAheadLimiter::init( float ceilingDb, float lookAheadMs, float releaseMs )
+{
+    _amountOfChannels = 0;
+    _sampleRate       = AudioEngineProps::SAMPLE_RATE;
+    _lookAhead        = 0;
+    _dequeGains       = nullptr;
+    _dequeIndices     = nullptr;
+    _averageBuffer    = nullptr;
+    _lookAheadMs      = std::max( 0.1f, std::min( lookAheadMs, 20.f ));
+
+    // windowed sinc interpolators for the fractional positions between
+    // the sample at TRUE_PEAK_DELAY and its successor
+
+    for ( int p = 0; p < 3; ++p )
+    {
+        SAMPLE_TYPE fraction = ( p + 1 ) * 0.25;
+        SAMPLE_TYPE sum      = 0.0;
+
+        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+        {
+            SAMPLE_TYPE t = ( j - ( TRUE_PEAK_TAPS - 1 - TRUE_PEAK_DELAY )) - fraction;
+            SAMPLE_TYPE w = 0.5 + 0.5 * cos( PI * t / TRUE_PEAK_DELAY );
+
+            _phases[ p ][ j ] = ( sin( PI * t ) / ( PI * t )) * w;
+            sum += _phases[ p ][ j ];
+        }
+        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+            _phases[ p ][ j ] /= sum;
+    }
+    setCeiling( ceilingDb );
+    setRelease( releaseMs );
+    allocate( AudioEngineProps::OUTPUT_CHANNELS );
+}
+
+void LookAheadLimiter::allocate( int amountOfChannels )
+{
+    deallocate();
+
+    _amountOfChannels = amountOfChannels;
+    _sampleRate       = AudioEngineProps::SAMPLE_RATE;
+    _lookAhead        = std::max( 1, ( int ) round( _lookAheadMs * 0.001 * _sampleRate ));
+
+    setRelease( _releaseMs ); // sample rate might have changed
+
+    // the delay lines must hold the latency as well as the history of the peak detector
+
+    int delaySize = 1;
+    while ( delaySize < _lookAhead + TRUE_PEAK_DELAY + TRUE_PEAK_TAPS )
+        delaySize <<= 1;
+
+    for ( int c = 0; c < _amountOfChannels; ++c )
+        _delayLines.push_back( new SAMPLE_TYPE[ delaySize ]());
+
+    _delayMask = delaySize - 1;
+
+    // the deque holds at most the look-ahead window plus the newly added gain
+
+    unsigned int dequeSize = 1;
+    while ( dequeSize < ( unsigned int ) _lookAhead + 1 )
+        dequeSize <<= 1;
+
+    _dequeGains    = new SAMPLE_TYPE[ dequeSize ]();
+    _dequeIndices  = new unsigned int[ dequeSize ]();
+    _dequeMask     = dequeSize - 1;
+    _averageBuffer = new SAMPLE_TYPE[ _lookAhead ];
+
+    reset();
+}
+
+void LookAheadLimiter::deallocate()
+{
+    while ( !_delayLines.empty() ) {
+        delete[] _delayLines.back();
+        _delayLines.pop_back();
+    }
+    delete[] _dequeGains;
+    delete[] _dequeIndices;
+    delete[] _averageBuffer;
+
+    _dequeGains    = nullptr;
+    _dequeIndices  = nullptr;
+    _averageBuffer = nullptr;
+}
+
+SAMPLE_TYPE LookAheadLimiter::detectPeak( int channel )
+{
+    SAMPLE_TYPE* delayLine = _delayLines[ channel ];
+    SAMPLE_TYPE history[ TRUE_PEAK_TAPS ];
+
+    for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+        history[ j ] = delayLine[( _writeIndex - ( TRUE_PEAK_TAPS - 1 ) + j ) & _delayMask ];
+
+    // the sample at TRUE_PEAK_DELAY samples ago and the interpolated values up until its successor
+
+    SAMPLE_TYPE peak = fabs( history[ TRUE_PEAK_TAPS - 1 - TRUE_PEAK_DELAY ]);
+
+    for ( int p = 0; p < 3; ++p )
+    {
+        SAMPLE_TYPE value = 0.0;
+
+        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+            value += _phases[ p ][ j ] * history[ j ];
+
+        peak = std::max( peak, fabs( value ));
+    }
+    return peak;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,119 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__LOOKAHEADLIMITER_H_INCLUDED__
+#define __MWENGINE__LOOKAHEADLIMITER_H_INCLUDED__
+
+#include "baseprocessor.h"
+#include "../audiobuffer.h"
+#include <vector>
+
+/**
+ * LookAheadLimiter is a brickwall limiter that keeps the (true) peak level of
+ * a signal below a ceiling. The signal is delayed by the look-ahead time so
+ * gain reduction can be applied before a peak occurs rather than after the fact.
+ *
+ * Peaks are detected on a 4x interpolated signal to catch inter-sample peaks.
+ * The required gain is held over the look-ahead window using a sliding minimum
+ * (monotonic deque, constant cost per sample) and smoothed by a moving average of
+ * the same length, which guarantees the gain has fully ramped down by the time the
+ * peak leaves the delay line. All channels share the same gain (stereo linked).
+ */
+namespace MWEngine {
+class LookAheadLimiter : public BaseProcessor
+{
+    public:
+        LookAheadLimiter();
+        LookAheadLimiter( float ceilingDb, float lookAheadMs, float releaseMs );
+        ~LookAheadLimiter();
+
+        std::string getType() {
+            return std::string( "LookAheadLimiter" );
+        }
+
+        float getCeiling();
+        void setCeiling( float ceilingDb );     // in dBFS, e.g. -0.3
+        float getLookAhead();
+        void setLookAhead( float lookAheadMs ); // in ms, range between 0.1 and 20
+        float getRelease();
+        void setRelease( float releaseMs );     // in ms
+
+        float getLinearGR();
+
+        // latency (in samples) introduced by the look-ahead and peak detection
+
+        int getLatency();
+
+#ifndef SWIG
+        // internal to the engine
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+        void reset();
+#endif
+
+        static const int TRUE_PEAK_TAPS  = 8; // length of the interpolation filter per phase
+        static const int TRUE_PEAK_DELAY = TRUE_PEAK_TAPS / 2;
+
+    protected:
+        void init( float ceilingDb, float lookAheadMs, float releaseMs );
+        void allocate( int amountOfChannels );
+        void deallocate();
+
+        SAMPLE_TYPE detectPeak( int channel );
+
+        float _ceilingDb;
+        float _lookAheadMs;
+        float _releaseMs;
+        int   _sampleRate;  // sample rate the time based properties were calculated for
+
+        SAMPLE_TYPE _ceiling;
+        SAMPLE_TYPE _releaseCoeff;
+        SAMPLE_TYPE _envelope;
+        int _lookAhead;     // in samples
+
+        // interpolation coefficients for the fractional positions 0.25, 0.5 and 0.75
+        SAMPLE_TYPE _phases[ 3 ][ TRUE_PEAK_TAPS ];
+
+        // per channel delay lines (power of two sized for cheap wrapping)
+
+        int _amountOfChannels;
+        std::vector<SAMPLE_TYPE*> _delayLines;
+        int _delayMask;
+        int _writeIndex;
+
+        // monotonic deque of required gains for the sliding minimum
+
+        SAMPLE_TYPE* _dequeGains;
+        unsigned int* _dequeIndices;
+        unsigned int _dequeMask;
+        unsigned int _dequeHead;
+        unsigned int _dequeTail;
+        unsigned int _sampleIndex;
+
+        // moving average of the held gain
+
+        SAMPLE_TYPE* _averageBuffer;
+        SAMPLE_TYPE _averageSum;
+        int _averageIndex;
+};
+} // E.O namespace MWEngine
+
+#endif
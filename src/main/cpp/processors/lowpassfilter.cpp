@@ -29,12 +29,13 @@ namespace MWEngine {
 
 LowPassFilter::LowPassFilter( float cutoff )
 {
+    _filter = new Biquad( AudioEngineProps::OUTPUT_CHANNELS );
     setCutoff( cutoff );
 }
 
 LowPassFilter::~LowPassFilter()
 {
-
+    delete _filter;
 }
 
 /* public methods */
@@ -47,66 +48,22 @@ float LowPassFilter::getCutoff()
 void LowPassFilter::setCutoff( float value )
 {
     _cutoff = value;
-
-    SAMPLE_TYPE Q = 1.1f;
-    w0 = TWO_PI * _cutoff / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
-    alpha = sin(w0) / (2.0 * Q);
-    b0 =  (1.0 - cos(w0))/2;
-    b1 =   1.0 - cos(w0);
-    b2 =  (1.0 - cos(w0))/2;
-    a0 =   1.0 + alpha;
-    a1 =  -2.0 * cos(w0);
-    a2 = 1.0 - alpha;
-    x1 = x2 = y1 = y2 = 0;
+    _filter->setLowPass( _cutoff, 1.1 );
 }
 
 void LowPassFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
-
-    for ( int i = 0, l = sampleBuffer->amountOfChannels; i < l; ++i )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
-
-        // store current values for this channel
-        SAMPLE_TYPE orgx1 = x1,
-                    orgx2 = x2,
-                    orgy1 = y1,
-                    orgy2 = y2;
-
-        for ( int j = 0; j < bufferSize; ++j )
-            channelBuffer[ j ] = processSingle( channelBuffer[ j ] );
-
-        // omit unnecessary cycles by copying the mono content
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
-
-        // restore values for next channel
-
-        x1 = orgx1;
-        x2 = orgx2;
-        y1 = orgy1;
-        y2 = orgy2;
-    }
+    _filter->process( sampleBuffer, isMonoSource );
 }
 
 void LowPassFilter::store()
 {
-    orgx1 = x1;
-    orgx2 = x2;
-    orgy1 = y1;
-    orgy2 = y2;
+    _filter->store();
 }
 
 void LowPassFilter::restore()
 {
-    x1 = orgx1;
-    x2 = orgx2;
-    y1 = orgy1;
-    y2 = orgy2;
+    _filter->restore();
 }
 
 } // E.O namespace MWEngine
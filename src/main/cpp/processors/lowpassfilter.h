@@ -24,6 +24,7 @@
 #define __MWENGINE__LOWPASSFILTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <modules/biquad.h>
 
 /**
  * a simple two pole low-pass filter
@@ -47,16 +48,11 @@ class LowPassFilter : public BaseProcessor
 
         void process( AudioBuffer* sampleBuffer, bool isMonoSource );
 
+        // processes a single sample against the state of the first channel
+
         inline SAMPLE_TYPE processSingle( SAMPLE_TYPE sample )
         {
-            SAMPLE_TYPE sampleOut = (b0/a0) * sample + (b1/a0) * x1 + (b2/a0) * x2 - (a1/a0) * y1 - (a2/a0) * y2;
-
-            x2 = x1;
-            x1 = sample;
-            y2 = y1;
-            y1 = sampleOut;
-
-            return sampleOut;
+            return _filter->processSingle( sample, 0 );
         }
 
         // store/restore the processor properties
@@ -70,10 +66,7 @@ class LowPassFilter : public BaseProcessor
 #endif
 
     protected:
-        SAMPLE_TYPE x1, x2, y1, y2;
-        SAMPLE_TYPE orgx1, orgx2, orgy1, orgy2;
-        SAMPLE_TYPE a0, a1, a2, b0, b1, b2, w0, alpha;
-
+        Biquad* _filter;
         float _cutoff;
 };
 } // E.O namespace MWEngine
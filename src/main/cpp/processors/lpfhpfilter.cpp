@@ -32,23 +32,15 @@ namespace MWEngine {
 
 LPFHPFilter::LPFHPFilter( float aLPCutoff, float aHPCutoff, int amountOfChannels )
 {
+    _filter = new Biquad( amountOfChannels );
+
     setLPF( aLPCutoff, AudioEngineProps::SAMPLE_RATE );
     setHPF( aHPCutoff, AudioEngineProps::SAMPLE_RATE );
-
-    outSamples = new SAMPLE_TYPE[ amountOfChannels ];
-    inSamples  = new SAMPLE_TYPE[ amountOfChannels ];
-
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        outSamples[ i ] = 0.0;
-        inSamples[ i ]  = 0.0;
-    }
 }
 
 LPFHPFilter::~LPFHPFilter()
 {
-    delete[] outSamples;
-    delete[] inSamples;
+    delete _filter;
 }
 
 /* public methods */
@@ -60,8 +52,11 @@ void LPFHPFilter::setLPF( float aCutOffFrequency, int aSampleRate )
 
     aCutOffFrequency *= TWO_PI;
     Norm              = 1.0 / ( aCutOffFrequency + w );
-    b1                = ( w - aCutOffFrequency ) * Norm;
-    a0                = a1 = aCutOffFrequency * Norm;
+
+    SAMPLE_TYPE a0 = aCutOffFrequency * Norm;
+    SAMPLE_TYPE b1 = ( w - aCutOffFrequency ) * Norm;
+
+    _filter->setCoefficients( a0, a0, 0.0, -b1, 0.0 );
 }
 
 void LPFHPFilter::setHPF( float aCutOffFrequency, int aSampleRate )
@@ -71,35 +66,16 @@ void LPFHPFilter::setHPF( float aCutOffFrequency, int aSampleRate )
 
     aCutOffFrequency *= TWO_PI;
     Norm              = 1.0 / ( aCutOffFrequency + w );
-    a0                = w * Norm;
-    a1                = -a0;
-    b1                = ( w - aCutOffFrequency ) * Norm;
+
+    SAMPLE_TYPE a0 = w * Norm;
+    SAMPLE_TYPE b1 = ( w - aCutOffFrequency ) * Norm;
+
+    _filter->setCoefficients( a0, -a0, 0.0, -b1, 0.0 );
 }
 
 void LPFHPFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
-
-    for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-
-        for ( int i = 0; i < bufferSize; ++i )
-        {
-            SAMPLE_TYPE sample = channelBuffer[ i ];
-
-            channelBuffer[ i ] = sample * a0 + inSamples[ c ] * a1 + outSamples[ c ] * b1;
-            inSamples[ c ]     = sample; // store this unprocessed sample for next iteration
-            outSamples[ c ]    = channelBuffer[ i ]; // and the processed sample too
-        }
-
-        // save CPU cycles when source is mono
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
-    }
+    _filter->process( sampleBuffer, isMonoSource );
 }
 
 } // E.O namespace MWEngine
@@ -25,6 +25,7 @@
 
 #include "baseprocessor.h"
 #include "../audiobuffer.h"
+#include <modules/biquad.h>
 
 namespace MWEngine {
 class LPFHPFilter : public BaseProcessor
@@ -46,13 +47,8 @@ class LPFHPFilter : public BaseProcessor
 #endif
 
     private:
-        SAMPLE_TYPE a0;
-        SAMPLE_TYPE a1;
-        SAMPLE_TYPE b1;
-
-        // for each channel we store the previous in- and output samples
-        SAMPLE_TYPE* outSamples;
-        SAMPLE_TYPE* inSamples;
+        // first order section (maintains the previous in- and output samples for each channel)
+        Biquad* _filter;
 };
 } // E.O namespace MWEngine
 
@@ -22,10 +22,13 @@
  */
 #include "phaser.h"
 #include "../global.h"
+#include <algorithm>
 #include <cmath>
 
 namespace MWEngine {
 
+const int Phaser::CONTROL_RATE;
+
 /* constructor / destructor */
 
 /**
@@ -55,14 +58,9 @@ Phaser::Phaser( float aRate, float aFeedback, float aDepth, float aMinFreq, floa
 
 Phaser::~Phaser()
 {
-    for ( size_t i = 0; i < _amountOfChannels; ++i ) {
-        for ( size_t j = 0; j < STAGES; ++j ) {
-            delete _alps->at( i ).at( j );
-        }
-        _alps->erase( _alps->begin() + i );
-    }
-    delete _alps;
-    _alps = nullptr;
+    delete[] _states;
+    delete[] _feedbackStates;
+    delete[] _coefficients;
 }
 
 /* public methods */
@@ -114,73 +112,71 @@ void Phaser::setDepth( float depth )
 
 void Phaser::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
-    int amountOfChannels = std::min( _amountOfChannels, sampleBuffer->amountOfChannels );
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = isMonoSource ? 1 : std::min( _amountOfChannels, sampleBuffer->amountOfChannels );
 
-    SAMPLE_TYPE initialLfoPhase = _lfoPhase;
-    SAMPLE_TYPE initialZm1      = _zm1;
+    if ( bufferSize > _coefficientsSize ) {
+        delete[] _coefficients;
+        _coefficientsSize = bufferSize;
+        _coefficients     = new SAMPLE_TYPE[ _coefficientsSize ];
+    }
 
-    size_t c, i, j;
+    // calculate and update phaser sweep LFO at control rate, interpolating
+    // the all-pass coefficient linearly in between (the modulation is shared by all channels)
 
-    for ( c = 0; c < amountOfChannels; ++c )
+    for ( int i = 0; i < bufferSize; i += CONTROL_RATE )
     {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-
-        auto delays = _alps->at( c );
+        int length = std::min( CONTROL_RATE, bufferSize - i );
 
-        // when first channel has been processed, restore the stored values
-        // for the next channel iteration
+        _lfoPhase += _lfoInc * length;
 
-        if ( c > 0 ) {
-            _lfoPhase = initialLfoPhase;
-            _zm1      = initialZm1;
-        }
+        while ( _lfoPhase >= TWO_PI )
+            _lfoPhase -= TWO_PI;
 
-        for ( i = 0; i < bufferSize; ++i )
-        {
-            // calculate and update phaser sweep LFO...
+        SAMPLE_TYPE target = calculateCoefficient();
+        SAMPLE_TYPE step   = ( target - _coefficient ) / ( SAMPLE_TYPE ) length;
 
-            SAMPLE_TYPE d = _dmin + ( _dmax - _dmin ) * (( sin( _lfoPhase ) + 1.0 ) / 2.0 );
-            _lfoPhase    += _lfoInc;
+        for ( int j = 0; j < length; ++j )
+            _coefficients[ i + j ] = ( _coefficient += step );
 
-            if ( _lfoPhase >= TWO_PI ) {
-                _lfoPhase -= TWO_PI;
-            }
+        _coefficient = target;
+    }
 
-            // update the filter coefficients
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        SAMPLE_TYPE* states        = &_states[ c * STAGES ];
+        SAMPLE_TYPE feedback       = _feedbackStates[ c ];
 
-            for ( j = 0; j < STAGES; ++j ) {
-                delays[ j ]->delay( d );
-            }
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            SAMPLE_TYPE a1 = _coefficients[ i ];
 
-            // filter the current sample and feed it to all allpass
-            // delays applying their output in reverse series
+            // filter the current sample (and feedback) through the all-pass stages in series
 
-            SAMPLE_TYPE y = channelBuffer[ i ] + _zm1 * _fb;
+            SAMPLE_TYPE y = channelBuffer[ i ] + feedback * _fb;
 
-            j = STAGES;
-            while ( --j > 0 ) {
-                y = delays[ j ]->update( y );
+            for ( int s = 0; s < STAGES; ++s )
+            {
+                SAMPLE_TYPE out = y * -a1 + states[ s ];
+                states[ s ]     = out * a1 + y;
+                y               = out;
             }
-
-            _zm1 = y;
+            feedback = y;
 
             channelBuffer[ i ] += ( y * _depth );
         }
-
-        // save CPU cycles when working on a mono source
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
+        _feedbackStates[ c ] = feedback;
     }
+
+    // save CPU cycles when working on a mono source
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
 }
 
 void Phaser::init( float aRate, float aFeedback, float aDepth, float aMinFreq, float aMaxFreq, int amountOfChannels )
 {
     _lfoPhase         = 0.0;
-    _zm1              = 0.0;
     _amountOfChannels = amountOfChannels;
 
     setRange( aMinFreq, aMaxFreq );
@@ -189,38 +185,17 @@ void Phaser::init( float aRate, float aFeedback, float aDepth, float aMinFreq, f
     _fb       = aFeedback;
     _depth    = aDepth;
 
-    _alps = new std::vector<std::vector<AllPassDelay*>>(( unsigned long ) amountOfChannels );
-
-    for ( size_t i = 0; i < _amountOfChannels; ++i ) {
-        _alps->at( i ) = std::vector<AllPassDelay*>( STAGES );
-
-        for ( size_t j = 0; j < STAGES; ++j )
-            _alps->at( i ).at( j ) = new AllPassDelay();
-    }
-}
-
-/* "private" class */
-
-AllPassDelay::AllPassDelay()
-{
-    _a1  = 0.0;
-    _zm1 = 0.0;
-}
-
-/* public methods */
-
-// sample delay time
-void AllPassDelay::delay( SAMPLE_TYPE aDelay )
-{
-    _a1 = ( 1.0 - aDelay ) / ( 1.0 + aDelay );
+    _states           = new SAMPLE_TYPE[ _amountOfChannels * STAGES ]();
+    _feedbackStates   = new SAMPLE_TYPE[ _amountOfChannels ]();
+    _coefficientsSize = AudioEngineProps::BUFFER_SIZE;
+    _coefficients     = new SAMPLE_TYPE[ _coefficientsSize ];
+    _coefficient      = calculateCoefficient();
 }
 
-SAMPLE_TYPE AllPassDelay::update( SAMPLE_TYPE aSample )
+SAMPLE_TYPE Phaser::calculateCoefficient()
 {
-    SAMPLE_TYPE y = aSample * - _a1 + _zm1;
-    _zm1          = y * _a1 + aSample;
-
-    return y;
+    SAMPLE_TYPE d = _dmin + ( _dmax - _dmin ) * (( sin( _lfoPhase ) + 1.0 ) / 2.0 );
+    return ( 1.0 - d ) / ( 1.0 + d );
 }
 
 } // E.O namespace MWEngine
@@ -24,24 +24,12 @@
 #define __MWENGINE__PHASER_H_INCLUDED__
 
 #include "baseprocessor.h"
-#include <vector>
 
 namespace MWEngine {
-class AllPassDelay
-{
-    public:
-        AllPassDelay();
-        void delay( SAMPLE_TYPE aDelay );
-        SAMPLE_TYPE update( SAMPLE_TYPE aSample );
-
-    private:
-        SAMPLE_TYPE _a1;
-        SAMPLE_TYPE _zm1;
-};
-
 class Phaser : public BaseProcessor
 {
-    static const int STAGES = 6;
+    static const int STAGES       = 6;
+    static const int CONTROL_RATE = 16; // the LFO is evaluated once every CONTROL_RATE samples
 
     public:
         Phaser( float aRate, float aFeedback, float aDepth, float aMinFreq, float aMaxFreq );
@@ -71,14 +59,21 @@ class Phaser : public BaseProcessor
         SAMPLE_TYPE _dmax;
         SAMPLE_TYPE _fb;
         SAMPLE_TYPE _depth;
-        SAMPLE_TYPE _zm1;
         SAMPLE_TYPE _lfoPhase;
         SAMPLE_TYPE _lfoInc;
         SAMPLE_TYPE _rate;
 
-        std::vector<std::vector<AllPassDelay*>>* _alps;
+        // all-pass stage state, stored contiguously per channel ( [ channel * STAGES + stage ] )
+        // all stages share a single coefficient, determined by the LFO
+
+        SAMPLE_TYPE* _states;
+        SAMPLE_TYPE* _feedbackStates;   // last output per channel
+        SAMPLE_TYPE* _coefficients;     // all-pass coefficient for each sample in the buffer
+        SAMPLE_TYPE  _coefficient;      // coefficient at the end of the last buffer
+        int _coefficientsSize;
 
         void init( float aRate, float aFeedback, float aDepth, float aMinFreq, float aMaxFreq, int amountOfChannels );
+        SAMPLE_TYPE calculateCoefficient();
 };
 } // E.O namespace MWEngine
 
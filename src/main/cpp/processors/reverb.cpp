@@ -33,32 +33,25 @@ Reverb::Reverb( float size, float hfDamp, float mix, float output )
     _mix    = mix;
     _output = output;
 
-    buf1 = new SAMPLE_TYPE[ 1024 ];
-    buf2 = new SAMPLE_TYPE[ 1024 ];
-    buf3 = new SAMPLE_TYPE[ 1024 ];
-    buf4 = new SAMPLE_TYPE[ 1024 ];
+    line1 = new DelayLine( MAX_DELAY );
+    line2 = new DelayLine( MAX_DELAY );
+    line3 = new DelayLine( MAX_DELAY );
+    line4 = new DelayLine( MAX_DELAY );
 
     fil = 0.0f;
-    den = pos = 0;
+    den = 0;
 
     recalculate();
 }
 
 Reverb::~Reverb()
 {
-    if ( buf1 )
-        delete[] buf1;
+    delete line1;
+    delete line2;
+    delete line3;
+    delete line4;
 
-    if ( buf2 )
-        delete[] buf2;
-
-    if ( buf3 )
-        delete[] buf3;
-
-    if ( buf4 )
-        delete[] buf4;
-
-    buf1 = buf2 = buf3 = buf4 = nullptr;
+    line1 = line2 = line3 = line4 = nullptr;
 }
 
 /* public methods */
@@ -134,61 +127,49 @@ void Reverb::process( AudioBuffer* audioBuffer, bool isMonosource )
 
     SAMPLE_TYPE a, b, r;
     SAMPLE_TYPE t, f = fil, fb = fbak, dmp = damp, y = dry, w = wet;
-    int  p = pos, d1, d2, d3, d4;
+    int d1, d2, d3, d4;
 
     if ( rdy == 0 )
         clearBuffers();
 
-    d1 = ( p + ( int )( 107 * size )) & 1023;
-    d2 = ( p + ( int )( 142 * size )) & 1023;
-    d3 = ( p + ( int )( 277 * size )) & 1023;
-    d4 = ( p + ( int )( 379 * size )) & 1023;
+    d1 = ( int )( 107 * size );
+    d2 = ( int )( 142 * size );
+    d3 = ( int )( 277 * size );
+    d4 = ( int )( 379 * size );
 
-    --in1;
-    --in2;
-    --out1;
-    --out2;
-
-    while ( --sampleFrames >= 0 )
+    for ( int i = 0; i < sampleFrames; ++i )
     {
-        a = *++in1;
-        b = *++in2;
+        a = in1[ i ];
+        b = in2[ i ];
 
         f += dmp * (w * (a + b) - f); // HF damping
         r = f;
 
-        t = *(buf1 + p);
+        t = line1->read( d1 );
         r -= fb * t;
-        *(buf1 + d1) = r; // allpass
+        line1->write( r ); // allpass
         r += t;
 
-        t = *(buf2 + p);
+        t = line2->read( d2 );
         r -= fb * t;
-        *(buf2 + d2) = r; // allpass
+        line2->write( r ); // allpass
         r += t;
 
-        t = *(buf3 + p);
+        t = line3->read( d3 );
         r -= fb * t;
-        *(buf3 + d3) = r; // allpass
+        line3->write( r ); // allpass
         r += t;
         a = y * a + r - f; // left output
 
-        t = *(buf4 + p);
+        t = line4->read( d4 );
         r -= fb * t;
-        *(buf4 + d4) = r; // allpass
+        line4->write( r ); // allpass
         r += t;
         b = y * b + r - f; // right output
 
-        ++p  &= 1023;
-        ++d1 &= 1023;
-        ++d2 &= 1023;
-        ++d3 &= 1023;
-        ++d4 &= 1023;
-
-        *++out1 = a;
-        *++out2 = b;
+        out1[ i ] = a;
+        out2[ i ] = b;
     }
-    pos = p;
 
     // catch denormals
 
@@ -209,10 +190,10 @@ void Reverb::process( AudioBuffer* audioBuffer, bool isMonosource )
 
 void Reverb::clearBuffers()
 {
-    memset( buf1, 0, 1024 * sizeof( SAMPLE_TYPE ));
-    memset( buf2, 0, 1024 * sizeof( SAMPLE_TYPE ));
-    memset( buf3, 0, 1024 * sizeof( SAMPLE_TYPE ));
-    memset( buf4, 0, 1024 * sizeof( SAMPLE_TYPE ));
+    line1->clear();
+    line2->clear();
+    line3->clear();
+    line4->clear();
 
     rdy = 1;
 }
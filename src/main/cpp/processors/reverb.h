@@ -19,6 +19,7 @@
  */
 #include "baseprocessor.h"
 #include "../audiobuffer.h"
+#include <modules/delayline.h>
 
 #ifndef __MWENGINE__REVERB_H_INCLUDED__
 #define __MWENGINE__REVERB_H_INCLUDED__
@@ -60,9 +61,13 @@ class Reverb : public BaseProcessor {
         float _mix;
         float _output;
 
-        SAMPLE_TYPE *buf1, *buf2, *buf3, *buf4;
+        // all-pass delay lines (longest delay is 379 samples at the maximum size multiplier of 2.69)
+
+        static const int MAX_DELAY = 1020;
+        DelayLine *line1, *line2, *line3, *line4;
+
         SAMPLE_TYPE fil, fbak, damp, wet, dry, size;
-        int pos, den, rdy;
+        int den, rdy;
 };
 } // E.O namespace MWEngine
 
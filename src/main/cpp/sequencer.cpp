@@ -23,59 +23,69 @@
 #include "sequencer.h"
 #include "audioengine.h"
 #include <utilities/utils.h>
+#include <utilities/bufferutility.h>
 #include <vector>
 #include <utilities/eventutility.h>
+#include <utilities/eventpool.h>
+#include <utilities/bufferpool.h>
 
 namespace MWEngine {
 
+// conversion between buffer samples and musical ticks at given tempo
+
+inline double toTicks( int samples, int samplesPerBar, TempoMap* tempoMap )
+{
+    return ( tempoMap != nullptr ) ? tempoMap->samplesToTicks( samples ) : BufferUtility::samplesToTicks( samples, samplesPerBar );
+}
+
+inline int toSamples( double ticks, int samplesPerBar, TempoMap* tempoMap )
+{
+    return ( tempoMap != nullptr ) ? tempoMap->ticksToSamples( ticks ) : BufferUtility::ticksToSamples( ticks, samplesPerBar );
+}
+
 /* static member intialization */
 
-bool Sequencer::playing           = false;
+bool& Sequencer::playing          = AudioEngine::defaultContext.playing;
 BulkCacher* Sequencer::bulkCacher = new BulkCacher( true );
-std::vector<BaseInstrument*> Sequencer::instruments;
-std::vector<BaseAudioEvent*> Sequencer::removes;
+std::vector<BaseInstrument*>& Sequencer::instruments = AudioEngine::defaultContext.instruments;
+thread_local std::vector<BaseAudioEvent*> Sequencer::removes;
 
 /* public methods */
 
 int Sequencer::registerInstrument( BaseInstrument* instrument )
 {
-    int index       = -1;
-    bool wasPresent = false; // prevent double addition
-
-    for ( int i = 0; i < instruments.size(); i++ )
-    {
-        if ( instruments.at( i ) == instrument )
-            wasPresent = true;
-    }
-
-    if ( !wasPresent ) {
-        instruments.push_back( instrument );
-        index = ( int ) instruments.size() - 1;
-    }
-    return index; // the index this instrument is registered at
+    return AudioEngine::defaultContext.registerInstrument( instrument );
 }
 
 bool Sequencer::unregisterInstrument( BaseInstrument* instrument )
 {
-    for ( int i = 0; i < instruments.size(); i++ )
-    {
-        if ( instruments.at( i ) == instrument )
-        {
-            instruments.erase( instruments.begin() + i );
-            return true;
-        }
-    }
-    return false;
+    return AudioEngine::defaultContext.unregisterInstrument( instrument );
 }
 
 bool Sequencer::getAudioEvents( std::vector<AudioChannel*>* channels, int bufferPosition,
                                 int bufferSize, bool addLiveInstruments, bool flushChannels )
 {
-    int bufferEnd    = bufferPosition + ( bufferSize - 1 );          // the highest SampleEnd value we'll query
-    bool loopStarted = bufferEnd > AudioEngine::max_buffer_position; // whether this request exceeds the min_buffer_position - max_buffer_position range
+    return collectAudioEvents( instruments, playing, AudioEngine::max_buffer_position, AudioEngine::samples_per_bar,
+                               AudioEngine::defaultContext.getTempoMap(), channels, bufferPosition, bufferSize, addLiveInstruments, flushChannels );
+}
 
-    size_t total = instruments.size();
+bool Sequencer::getAudioEvents( AudioEngineContext* context, std::vector<AudioChannel*>* channels, int bufferPosition,
+                                int bufferSize, bool addLiveInstruments, bool flushChannels )
+{
+    const transportState& transport = context->getTransport();
+
+    return collectAudioEvents( context->instruments, context->playing, transport.max_buffer_position, transport.samples_per_bar,
+                               transport.tempoMap, channels, bufferPosition, bufferSize, addLiveInstruments, flushChannels );
+}
 
+bool Sequencer::collectAudioEvents( std::vector<BaseInstrument*>& instruments, bool isPlaying, int maxBufferPosition, int samplesPerBar,
+                                    TempoMap* tempoMap, std::vector<AudioChannel*>* channels, int bufferPosition, int bufferSize,
+                                    bool addLiveInstruments, bool flushChannels )
+{
+    int bufferEnd    = bufferPosition + ( bufferSize - 1 ); // the highest SampleEnd value we'll query
+    bool loopStarted = bufferEnd > maxBufferPosition;       // whether this request exceeds the min_buffer_position - max_buffer_position range
+
+    size_t total = instruments.size();
     if ( flushChannels ) {
         // clears the audio events gathered in a previous iteration
         channels->clear();
@@ -95,20 +105,30 @@ bool Sequencer::getAudioEvents( std::vector<AudioChannel*>* channels, int buffer
 
         if ( !instrumentChannel->muted )
         {
-            if ( playing )
+            if ( isPlaying )
             {
-                int firstMeasure = ( int ) floor(( float ) bufferPosition / ( float ) AudioEngine::samples_per_bar );
-                int lastMeasure  = ( int ) floor(( float ) bufferEnd / ( float ) AudioEngine::samples_per_bar );
+                // note the instruments measure caches are indexed by the musical position of the events,
+                // which are positioned relative to the tempo (map) of the context sequencing them
+
+                int firstMeasure, lastMeasure;
+
+                if ( tempoMap != nullptr ) {
+                    firstMeasure = ( int ) floor( tempoMap->samplesToTicks( bufferPosition ) / TICKS_PER_MEASURE );
+                    lastMeasure  = ( int ) floor( tempoMap->samplesToTicks( bufferEnd ) / TICKS_PER_MEASURE );
+                } else {
+                    firstMeasure = ( int ) floor(( float ) bufferPosition / ( float ) samplesPerBar );
+                    lastMeasure  = ( int ) floor(( float ) bufferEnd / ( float ) samplesPerBar );
+                }
 
                 // note we deduplicate eligible events if flushChannels is false
 
-                collectSequencedEvents( instrument, bufferPosition, bufferEnd, firstMeasure, !flushChannels );
+                collectSequencedEvents( instrument, bufferPosition, bufferEnd, firstMeasure, !flushChannels, samplesPerBar, tempoMap );
 
-                // when the current range spans 2 measures, collect for the second measure as well
+                // when the current range spans multiple measures, collect for the following measures as well
                 // here we always deduplicate as events can overlap from first to last measure
 
-                if ( lastMeasure != firstMeasure ) {
-                    collectSequencedEvents( instrument, bufferPosition, bufferEnd, lastMeasure, true );
+                for ( int measure = firstMeasure + 1; measure <= lastMeasure; ++measure ) {
+                    collectSequencedEvents( instrument, bufferPosition, bufferEnd, measure, true, samplesPerBar, tempoMap );
                 }
             }
 
@@ -123,9 +143,7 @@ bool Sequencer::getAudioEvents( std::vector<AudioChannel*>* channels, int buffer
 
 void Sequencer::updateEvents()
 {
-    for ( size_t i = 0, l = instruments.size(); i < l; ++i ) {
-        instruments.at( i )->updateEvents();
-    }
+    AudioEngine::defaultContext.updateEvents();
 }
 
 void Sequencer::clearEvents()
@@ -133,9 +151,16 @@ void Sequencer::clearEvents()
     for ( size_t i = 0, l = instruments.size(); i < l; ++i ) {
         instruments.at( i )->clearEvents();
     }
+
+    // release the pooled memory of events (and their buffers) that have been deleted
+    // (memory of events that are still allocated remains pooled for reuse)
+
+    EventPool::trim();
+    BufferPool::trimBuffers();
 }
 
-void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPosition, int bufferEnd, int measure, bool checkForDuplicates )
+void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPosition, int bufferEnd, int measure,
+                                        bool checkForDuplicates, int samplesPerBar, TempoMap* tempoMap )
 {
     if ( !instrument->hasEvents() ) {
         return;
@@ -145,43 +170,87 @@ void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPo
 
     instrument->toggleReadLock( true ); // lock the events vector while sequencing
 
-    auto audioEvents = instrument->getEventsForMeasure( measure );
+    // scan the compact event headers, the events themselves are only
+    // dereferenced when they are eligible for playback
+
+    auto eventHeaders = instrument->getEventHeadersForMeasure( measure );
 
-    if ( audioEvents == nullptr ) {
+    if ( eventHeaders == nullptr ) {
         instrument->toggleReadLock( false ); // release the mutex !
         return;
     }
 
     // channel has an internal loop (e.g. drum machine) ? recalculate requested
-    // buffer position by subtracting all measures above the first
+    // buffer position by subtracting all measures above the first (measures
+    // vary in length when the tempo map changes tempo or time signature)
 
     if ( channel->maxBufferPosition > 0 )
     {
-        int samplesPerBar = AudioEngine::samples_per_bar;
-
         while ( bufferPosition >= channel->maxBufferPosition )
         {
-            bufferPosition -= samplesPerBar;
-            bufferEnd      -= samplesPerBar;
+            int measureLength = samplesPerBar;
+
+            if ( tempoMap != nullptr )
+                measureLength = tempoMap->getMeasureLength( std::max( 0, tempoMap->getMeasureAt( bufferPosition ) - 1 ));
+
+            bufferPosition -= measureLength;
+            bufferEnd      -= measureLength;
         }
     }
 
+    // the headers describe musical positions, convert the requested range to ticks once. Events
+    // sounding at the start of the range have a musical end beyond its start (for synthesized events
+    // extended by the release of the instrument) or when of a fixed duration, an end offset in samples
+    // beyond the start of the range (derived only for the events starting before the range)
+
+    int releaseDuration = instrument->getReleaseDuration();
+
+    double rangeStart   = toTicks( bufferPosition, samplesPerBar, tempoMap );
+    double rangeEnd     = toTicks( bufferEnd + 1, samplesPerBar, tempoMap );
+    double releaseStart = toTicks( std::max( 0, bufferPosition - releaseDuration ), samplesPerBar, tempoMap );
+
     size_t i = 0;
-    size_t total = audioEvents->size();
+    size_t total = eventHeaders->size();
 
     for ( ; i < total; i++ )
     {
-        BaseAudioEvent* audioEvent = audioEvents->at( i );
+        const eventHeader& header  = ( *eventHeaders )[ i ];
+        BaseAudioEvent* audioEvent = header.event;
+
+        bool enabled   = ( header.flags & EVENT_HEADER_ENABLED ) != 0;
+        bool deletable = ( header.flags & EVENT_HEADER_DELETABLE ) != 0;
+        bool eligible;
+
+        if ( header.type == EventTypes::CUSTOM ) {
+            // event types unknown to the engine might override the base implementations
+            enabled   = audioEvent->isEnabled();
+            deletable = audioEvent->isDeletable();
 
-        if ( audioEvent->isEnabled() )
-        {
             int eventStart = audioEvent->getEventStart();
             int eventEnd   = audioEvent->getEventEnd();
 
-            if (( eventStart >= bufferPosition && eventStart <= bufferEnd ) ||
-                ( eventStart <  bufferPosition && eventEnd >= bufferPosition ))
+            eligible = ( eventStart >= bufferPosition && eventStart <= bufferEnd ) ||
+                       ( eventStart <  bufferPosition && eventEnd >= bufferPosition );
+        }
+        else if ( header.start >= rangeEnd ) {
+            eligible = false;
+        }
+        else if ( header.start >= rangeStart ) {
+            eligible = true;
+        }
+        else if (( header.flags & EVENT_HEADER_FIXED_DURATION ) != 0 ) {
+            int release = ( header.type == EventTypes::SYNTH ) ? releaseDuration : 0;
+            eligible    = toSamples( header.start, samplesPerBar, tempoMap ) + header.span + release >= bufferPosition;
+        }
+        else {
+            eligible = header.end > (( header.type == EventTypes::SYNTH ) ? releaseStart : rangeStart );
+        }
+
+        if ( enabled )
+        {
+            if ( eligible )
             {
-                if ( !audioEvent->isDeletable()) {
+                if ( !deletable ) {
                     if ( checkForDuplicates && EventUtility::vectorContainsEvent( channel->audioEvents, audioEvent )) {
                         continue;
                     }
@@ -262,7 +331,7 @@ std::vector<BaseCacheableAudioEvent*>* Sequencer::collectCacheableSequencerEvent
             BaseAudioEvent* audioEvent = audioEvents->at( j );
 
             // if event is an instance of BaseCacheableAudioEvent add it to the list
-            if ( dynamic_cast<BaseCacheableAudioEvent*>( audioEvent ) != nullptr )
+            if ( audioEvent->isCacheable() )
             {
                 int eventStart = audioEvent->getEventStart();
                 int eventEnd   = audioEvent->getEventEnd();
@@ -24,6 +24,7 @@
 #define __MWENGINE__SEQUENCER_H_INCLUDED__
 
 #include "audiochannel.h"
+#include "audioenginecontext.h"
 #include <instruments/baseinstrument.h>
 #include <events/basecacheableaudioevent.h>
 #include <events/baseaudioevent.h>
@@ -42,9 +43,11 @@ class Sequencer
 {
     public:
 
-        static bool playing;
-        static std::vector<BaseInstrument*> instruments;
-        static std::vector<BaseAudioEvent*> removes;
+        // playing state and instruments of the default AudioEngineContext
+
+        static bool& playing;
+        static std::vector<BaseInstrument*>& instruments;
+        static thread_local std::vector<BaseAudioEvent*> removes;
         static BulkCacher* bulkCacher;
 
         static int registerInstrument   ( BaseInstrument* instrument );
@@ -55,8 +58,18 @@ class Sequencer
         static bool getAudioEvents( std::vector<AudioChannel*>* channels, int bufferPosition,
                                     int bufferSize, bool addLiveInstruments, bool flushChannels );
 
+        // collect all audio events of the instruments registered to given context, using
+        // the transport snapshot of the contexts current render cycle
+
+        static bool getAudioEvents( AudioEngineContext* context, std::vector<AudioChannel*>* channels, int bufferPosition,
+                                    int bufferSize, bool addLiveInstruments, bool flushChannels );
+
+        static bool collectAudioEvents( std::vector<BaseInstrument*>& instruments, bool isPlaying, int maxBufferPosition,
+                                        int samplesPerBar, TempoMap* tempoMap, std::vector<AudioChannel*>* channels,
+                                        int bufferPosition, int bufferSize, bool addLiveInstruments, bool flushChannels );
+
         static void updateEvents();
-        static void clearEvents();
+        static void clearEvents(); // removes all events from all instruments and releases unused pooled event memory
 
         /**
          * used by the getAudioEvents()-method of the sequencer, this validates
@@ -70,8 +83,11 @@ class Sequencer
          * @param checkForDuplicates {bool} whether to check whether eligible events are already
          *                           added to the given instruments channel (as this method can be
          *                           invoked recursively when the current buffer range overlaps 2 measures
+         * @param samplesPerBar      {int} the amount of samples in a measure for the rendering context
+         * @param tempoMap           {TempoMap*} the tempo map of the rendering context (nullptr at a constant tempo)
          */
-        static void collectSequencedEvents( BaseInstrument* aInstrument, int bufferPosition, int bufferEnd, int measure, bool checkForDuplicates );
+        static void collectSequencedEvents( BaseInstrument* aInstrument, int bufferPosition, int bufferEnd, int measure,
+                                            bool checkForDuplicates, int samplesPerBar, TempoMap* tempoMap );
         static void collectLiveEvents     ( BaseInstrument* aInstrument );
 
 
@@ -27,6 +27,7 @@
 #include <messaging/notifier.h>
 #include <utilities/utils.h>
 #include <utilities/diskwriter.h>
+#include <utilities/stemexporter.h>
 #include <utilities/volumeutil.h>
 
 namespace MWEngine {
@@ -59,7 +60,7 @@ void SequencerController::prepare( float aQueuedTempo, int aTimeSigBeatAmount, i
     {
         setTempo( aQueuedTempo, aTimeSigBeatAmount, aTimeSigBeatUnit );
         AudioEngine::handleTempoUpdate( aQueuedTempo, false );   // just to initialize all buffer sizes
-        setLoopRange( 0, ( AudioEngine::amount_of_bars * AudioEngine::samples_per_bar ) - 1, AudioEngine::steps_per_bar );
+        setLoopRange( 0, AudioEngine::defaultContext.getMeasureStart( AudioEngine::amount_of_bars ) - 1, AudioEngine::steps_per_bar );
     }
 };
 
@@ -74,12 +75,31 @@ void SequencerController::setTempo( float aTempo, int aTimeSigBeatAmount, int aT
 
     AudioEngine::queuedTime_sig_beat_amount = aTimeSigBeatAmount;
     AudioEngine::queuedTime_sig_beat_unit   = aTimeSigBeatUnit;
+
+    // the tempo is applied onto the transport by the calling thread, the
+    // render thread moves to the new tempo at the start of its next render cycle
+
+    AudioEngine::handleTempoUpdate( AudioEngine::queuedTempo, true );
 }
 
 void SequencerController::setTempoNow( float aTempo, int aTimeSigBeatAmount, int aTimeSigBeatUnit )
 {
+    // equal to setTempo(), tempo changes take effect from the next render cycle onwards
     setTempo( aTempo, aTimeSigBeatAmount, aTimeSigBeatUnit );
-    AudioEngine::handleTempoUpdate( AudioEngine::queuedTempo, true );
+}
+
+/**
+ * sequence according to given TempoMap, describing tempo ramps and time signature changes
+ * over the course of the sequence (a copy of the map is kept by the engine, as such
+ * changes to the map require invoking this method again). nullptr returns to sequencing
+ * at the constant tempo provided to setTempo()
+ */
+void SequencerController::setTempoMap( TempoMap* aTempoMap )
+{
+    AudioEngine::defaultContext.setTempoMap( aTempoMap );
+
+    // update the sequencer range to span the measures at the tempo of the map
+    updateMeasures( AudioEngine::amount_of_bars, AudioEngine::steps_per_bar );
 }
 
 void SequencerController::setVolume( float aVolume )
@@ -115,6 +135,7 @@ void SequencerController::setLoopRange( int aStartPosition, int aEndPosition, in
          AudioEngine::bufferPosition > AudioEngine::max_buffer_position )
     {
         AudioEngine::bufferPosition = AudioEngine::min_buffer_position;
+        AudioEngine::defaultContext.seek( AudioEngine::bufferPosition );
     }
 
     AudioEngine::min_step_position = ( int ) round(( aStartPosition / AudioEngine::samples_per_bar ) * aStepsPerBar );
@@ -152,6 +173,8 @@ void SequencerController::setBufferPosition( int aPosition )
     AudioEngine::bufferPosition = aPosition;
     AudioEngine::stepPosition   = ( aPosition / AudioEngine::samples_per_bar ) * AudioEngine::steps_per_bar;
 
+    AudioEngine::defaultContext.seek( aPosition );
+
     Notifier::broadcast( Notifications::SEQUENCER_POSITION_UPDATED );
 }
 
@@ -197,7 +220,9 @@ void SequencerController::updateMeasures( int aValue, int aStepsPerBar )
 {
     AudioEngine::amount_of_bars = aValue;
     updateStepsPerBar( aStepsPerBar );
-    AudioEngine::max_buffer_position = ( AudioEngine::samples_per_bar * AudioEngine::amount_of_bars ) - 1;
+    AudioEngine::max_buffer_position = AudioEngine::defaultContext.getMeasureStart( AudioEngine::amount_of_bars ) - 1;
+
+    AudioEngine::defaultContext.publishTransport();
 }
 
 void SequencerController::rewind()
@@ -208,6 +233,7 @@ void SequencerController::rewind()
 void SequencerController::setNotificationMarker( int aPosition )
 {
     AudioEngine::marked_buffer_position = aPosition;
+    AudioEngine::defaultContext.publishTransport();
 }
 
 /**
@@ -218,8 +244,8 @@ void SequencerController::setNotificationMarker( int aPosition )
  */
 void SequencerController::cacheAudioEventsForMeasure( int aMeasure )
 {
-    int startBufferPos = AudioEngine::samples_per_bar * aMeasure;
-    int endBufferPos   = ( startBufferPos + AudioEngine::samples_per_bar ) - 1;
+    int startBufferPos = AudioEngine::defaultContext.getMeasureStart( aMeasure );
+    int endBufferPos   = AudioEngine::defaultContext.getMeasureStart( aMeasure + 1 ) - 1;
 
     std::vector<BaseCacheableAudioEvent*>* list = Sequencer::collectCacheableSequencerEvents( startBufferPos, endBufferPos );
     getBulkCacher()->addToQueue( list );
@@ -238,6 +264,7 @@ BulkCacher* SequencerController::getBulkCacher()
 /**
  * when bouncing, the writing of buffers into the hardware is omitted
  * for an increase in bouncing speed (otherwise its real time)
+ * the stems registered in the StemExporter are written in the same pass
  */
 void SequencerController::setBounceState( bool aIsBouncing, int aMaxBuffers, char* aOutputFile, int rangeStart, int rangeEnd )
 {
@@ -249,9 +276,18 @@ void SequencerController::setBounceState( bool aIsBouncing, int aMaxBuffers, cha
         AudioEngine::bounceRangeEnd   = rangeEnd;
         AudioEngine::bufferPosition   = rangeStart;
         AudioEngine::stepPosition     = 0;
+
+        AudioEngine::defaultContext.seek( rangeStart );
     }
     setRecordingState( aIsBouncing, aMaxBuffers, aOutputFile );
 
+    // export the registered stems (if any) in the same pass
+
+    if ( aIsBouncing )
+        StemExporter::prepare( roundTo( aMaxBuffers, AudioEngineProps::BUFFER_SIZE ));
+    else
+        StemExporter::finish();
+
     // triggering bounce state should instantly toggle the playback state of the engine
 
     setPlaying( aIsBouncing );
@@ -261,11 +297,9 @@ void SequencerController::setBounceState( bool aIsBouncing, int aMaxBuffers, cha
  * Record the output of the sequencer onto storage
  *
  * aRecording        {bool} toggles the recording state
- * aMaxBuffers        {int} the total recorded buffer size to store in memory
- *                          before writing the recorded snippet as .WAV file into
- *                          the given output file's directory.
- * aOutputDirectory {char*} name of the output WAV file to generate when recording completes
- *                          (when recording state is disabled), this will concatenate all snippets.
+ * aMaxBuffers        {int} the size (in samples) of the buffer holding the recorded audio in
+ *                          memory until it has been appended to the output file
+ * aOutputFile      {char*} name of the output WAV file to write the recording into
  */
 void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, char* aOutputFile )
 {
@@ -285,13 +319,10 @@ void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, c
     }
     else if ( wasRecording )
     {
-        // recording halted, write currently recording snippet into file
-        // and concatenate all recorded snippets into the requested output file name
+        // recording halted, write the remaining recorded audio into the output file
         // we can do this synchronously as this method is called from outside the
         // rendering thread and thus won't lead to buffer under runs
 
-        DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-
         if ( DiskWriter::finish())
             Notifier::broadcast( Notifications::RECORDING_COMPLETED );
     }
@@ -302,10 +333,9 @@ void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, c
  * not the remaining audio processed / generated by the engine
  *
  * aRecording        {bool} toggles the recording state
- * aMaxBuffers        {int} the total recorded buffer size to store in memory
- *                          before writing the recorded contents as .WAV file into
- *                          the given output directory.
- * aOutputDirectory {char*} name of the folder to write each snippet into
+ * aMaxBuffers        {int} the size (in samples) of the buffer holding the recorded audio in
+ *                          memory until it has been appended to the output file
+ * aOutputFile      {char*} name of the output WAV file to write the recording into
  */
 void SequencerController::setRecordingFromDeviceState( bool aRecording, int aMaxBuffers, char* aOutputFile )
 {
@@ -325,26 +355,22 @@ void SequencerController::setRecordingFromDeviceState( bool aRecording, int aMax
     }
     else if ( wasRecording )
     {
-        // recording halted, write currently recording snippet into file
-        // and concatenate all recorded snippets into the requested output file name
+        // recording halted, write the remaining recorded audio into the output file
         // we can do this synchronously as this method is called from outside the
         // rendering thread and thus won't lead to buffer under runs
 
-        DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-
         if ( DiskWriter::finish())
             Notifier::broadcast( Notifications::RECORDING_COMPLETED );
     }
 }
 
 /**
- * Save the contents of the snippet at given buffer index
- * onto storage. This should be invoked from a thread separate to the
- * audio rendering thread to prevent buffer under runs from happening
+ * Recordings are streamed onto storage by the DiskWriter's
+ * writer thread, as such there are no snippets left to save
  */
 void SequencerController::saveRecordedSnippet( int snippetBufferIndex )
 {
-    DiskWriter::writeBufferToFile( snippetBufferIndex, true );
+    // nowt...
 }
 
 } // E.O namespace MWEngine
@@ -24,6 +24,7 @@
 #define __MWENGINE__SEQUENCERCONTROLLER_H_INCLUDED__
 
 #include "sequencer.h"
+#include "tempomap.h"
 #include <utilities/bulkcacher.h>
 
 /**
@@ -43,6 +44,7 @@ class SequencerController
         float getTempo  ();
         void setTempo   ( float aTempo, int aTimeSigBeatAmount, int aTimeSigBeatUnit );
         void setTempoNow( float aTempo, int aTimeSigBeatAmount, int aTimeSigBeatUnit );
+        void setTempoMap( TempoMap* aTempoMap );
         void setVolume  ( float aVolume );
         void setPlaying ( bool aPlaying );
 
@@ -68,6 +70,7 @@ class SequencerController
         void setRecordingState          ( bool aRecording,  int aMaxBuffers, char* aOutputFile );
         void setRecordingFromDeviceState( bool aRecording,  int aMaxBuffers, char* aOutputFile );
 
+        [[deprecated("recordings are streamed onto storage, no snippets require saving")]]
         void saveRecordedSnippet( int snippetBufferIndex );
 };
 } // E.O namespace MWEngine
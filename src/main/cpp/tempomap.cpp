@@ -0,0 +1,291 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "tempomap.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace MWEngine {
+
+static std::atomic<unsigned int> VERSION_COUNT( 0 );
+
+/* constructor / destructor */
+
+TempoMap::TempoMap( float tempo, int beatAmount, int beatUnit )
+{
+    clear( tempo, beatAmount, beatUnit );
+}
+
+TempoMap::~TempoMap()
+{
+    // nowt...
+}
+
+/* public methods */
+
+void TempoMap::clear( float tempo, int beatAmount, int beatUnit )
+{
+    _tempoChanges.clear();
+    _timeSignatureChanges.clear();
+
+    _tempoChanges.push_back({ 0.0, std::max( 1.F, tempo ), false });
+    _timeSignatureChanges.push_back({ 0, beatAmount, beatUnit });
+
+    invalidate();
+}
+
+void TempoMap::addTempoChange( double ticks, float tempo, bool ramp )
+{
+    if ( tempo <= 0.F )
+        return;
+
+    ticks = std::max( 0.0, ticks );
+
+    // keep the changes sorted by position, replacing an existing change at the same position
+
+    auto it = std::lower_bound( _tempoChanges.begin(), _tempoChanges.end(), ticks,
+        []( const tempoChange& change, double value ) { return change.ticks < value; });
+
+    if ( it != _tempoChanges.end() && it->ticks == ticks )
+        *it = { ticks, tempo, ramp };
+    else
+        _tempoChanges.insert( it, { ticks, tempo, ramp });
+
+    invalidate();
+}
+
+void TempoMap::addTimeSignatureChange( int measure, int beatAmount, int beatUnit )
+{
+    if ( beatAmount <= 0 || beatUnit <= 0 )
+        return;
+
+    measure = std::max( 0, measure );
+
+    auto it = std::lower_bound( _timeSignatureChanges.begin(), _timeSignatureChanges.end(), measure,
+        []( const timeSignatureChange& change, int value ) { return change.measure < value; });
+
+    if ( it != _timeSignatureChanges.end() && it->measure == measure )
+        *it = { measure, beatAmount, beatUnit };
+    else
+        _timeSignatureChanges.insert( it, { measure, beatAmount, beatUnit });
+
+    invalidate();
+}
+
+float TempoMap::getTempo( double ticks )
+{
+    const tempoSegment& segment = getSegmentForTicks( ticks );
+    return ( float )( segment.startTempo + segment.tempoSlope * ( ticks - segment.startTicks ));
+}
+
+int TempoMap::getTimeSigBeatAmount( int measure )
+{
+    return getSegmentForTicks(( double ) measure * TICKS_PER_MEASURE ).beatAmount;
+}
+
+int TempoMap::getTimeSigBeatUnit( int measure )
+{
+    return getSegmentForTicks(( double ) measure * TICKS_PER_MEASURE ).beatUnit;
+}
+
+double TempoMap::samplesToTicks( int samples )
+{
+    double ticks = secondsToTicks(( double ) samples / AudioEngineProps::SAMPLE_RATE );
+    int measure  = ( int ) floor( ticks / TICKS_PER_MEASURE );
+
+    // measures start at whole samples (see getMeasureStart()), correct
+    // positions that round into a neighbouring measure
+
+    if ( samples < getMeasureStart( measure ))
+        --measure;
+    else if ( samples >= getMeasureStart( measure + 1 ))
+        ++measure;
+
+    double measureStart = ( double ) measure * TICKS_PER_MEASURE;
+    double measureEnd   = std::nextafter( measureStart + TICKS_PER_MEASURE, measureStart );
+
+    return std::min( measureEnd, std::max( measureStart, ticks ));
+}
+
+int TempoMap::ticksToSamples( double ticks )
+{
+    int measure = ( int ) floor( ticks / TICKS_PER_MEASURE );
+    int samples = ( int ) round( ticksToSeconds( ticks ) * AudioEngineProps::SAMPLE_RATE );
+
+    return std::max( getMeasureStart( measure ), std::min( samples, getMeasureStart( measure + 1 ) - 1 ));
+}
+
+int TempoMap::getMeasureStart( int measure )
+{
+    return ( int ) round( ticksToSeconds(( double ) measure * TICKS_PER_MEASURE ) * AudioEngineProps::SAMPLE_RATE );
+}
+
+int TempoMap::getMeasureLength( int measure )
+{
+    return getMeasureStart( measure + 1 ) - getMeasureStart( measure );
+}
+
+int TempoMap::getMeasureAt( int samples )
+{
+    return ( int ) floor( samplesToTicks( samples ) / TICKS_PER_MEASURE );
+}
+
+int TempoMap::getShortestBarLength()
+{
+    return std::max( 1, ( int ) floor( _shortestBarSeconds * AudioEngineProps::SAMPLE_RATE ));
+}
+
+unsigned int TempoMap::getVersion()
+{
+    return _version;
+}
+
+/* protected methods */
+
+void TempoMap::invalidate()
+{
+    _segments.clear();
+
+    // a segment starts at each tempo and time signature change
+
+    std::vector<double> segmentStarts;
+
+    for ( auto& change : _tempoChanges )
+        segmentStarts.push_back( change.ticks );
+
+    for ( auto& change : _timeSignatureChanges )
+        segmentStarts.push_back(( double ) change.measure * TICKS_PER_MEASURE );
+
+    std::sort( segmentStarts.begin(), segmentStarts.end() );
+    segmentStarts.erase( std::unique( segmentStarts.begin(), segmentStarts.end() ), segmentStarts.end() );
+
+    size_t tempoIndex = 0, timeSigIndex = 0;
+
+    for ( size_t i = 0; i < segmentStarts.size(); ++i )
+    {
+        double ticks = segmentStarts[ i ];
+
+        // find the changes in effect at the start of this segment
+
+        while ( tempoIndex + 1 < _tempoChanges.size() && _tempoChanges[ tempoIndex + 1 ].ticks <= ticks )
+            ++tempoIndex;
+
+        while ( timeSigIndex + 1 < _timeSignatureChanges.size() &&
+                (( double ) _timeSignatureChanges[ timeSigIndex + 1 ].measure * TICKS_PER_MEASURE ) <= ticks )
+            ++timeSigIndex;
+
+        const tempoChange& tempo           = _tempoChanges[ tempoIndex ];
+        const timeSignatureChange& timeSig = _timeSignatureChanges[ timeSigIndex ];
+
+        // when the next tempo change is a ramp, the tempo moves linearly towards it
+
+        double slope = 0.0;
+
+        if ( tempoIndex + 1 < _tempoChanges.size() && _tempoChanges[ tempoIndex + 1 ].ramp ) {
+            const tempoChange& next = _tempoChanges[ tempoIndex + 1 ];
+            slope = ( next.tempo - tempo.tempo ) / ( next.ticks - tempo.ticks );
+        }
+
+        tempoSegment segment;
+
+        segment.startTicks        = ticks;
+        segment.startSeconds      = 0.0;
+        segment.startTempo        = tempo.tempo + slope * ( ticks - tempo.ticks );
+        segment.tempoSlope        = slope;
+        segment.secondsPerTickBPM = ( 240.0 * timeSig.beatAmount ) / ( timeSig.beatUnit * TICKS_PER_MEASURE );
+        segment.beatAmount        = timeSig.beatAmount;
+        segment.beatUnit          = timeSig.beatUnit;
+
+        if ( i > 0 ) {
+            const tempoSegment& previous = _segments.back();
+            segment.startSeconds = previous.startSeconds + getSegmentDuration( previous, ticks - previous.startTicks );
+        }
+        _segments.push_back( segment );
+    }
+
+    // cache the shortest measure (at the highest tempo within each segment)
+
+    _shortestBarSeconds = INT_MAX;
+
+    for ( size_t i = 0; i < _segments.size(); ++i )
+    {
+        const tempoSegment& segment = _segments[ i ];
+        double endTempo = segment.startTempo;
+
+        if ( i + 1 < _segments.size() )
+            endTempo += segment.tempoSlope * ( _segments[ i + 1 ].startTicks - segment.startTicks );
+
+        double barSeconds   = segment.secondsPerTickBPM * TICKS_PER_MEASURE / std::max( segment.startTempo, endTempo );
+        _shortestBarSeconds = std::min( _shortestBarSeconds, barSeconds );
+    }
+    _version = ++VERSION_COUNT;
+}
+
+const TempoMap::tempoSegment& TempoMap::getSegmentForTicks( double ticks )
+{
+    auto it = std::upper_bound( _segments.begin(), _segments.end(), ticks,
+        []( double value, const tempoSegment& segment ) { return value < segment.startTicks; });
+
+    return ( it == _segments.begin() ) ? *it : *( it - 1 );
+}
+
+const TempoMap::tempoSegment& TempoMap::getSegmentForSeconds( double seconds )
+{
+    auto it = std::upper_bound( _segments.begin(), _segments.end(), seconds,
+        []( double value, const tempoSegment& segment ) { return value < segment.startSeconds; });
+
+    return ( it == _segments.begin() ) ? *it : *( it - 1 );
+}
+
+double TempoMap::getSegmentDuration( const tempoSegment& segment, double ticks )
+{
+    // integrates the duration of each tick over the (linearly changing) tempo
+
+    if ( segment.tempoSlope == 0.0 )
+        return ticks * segment.secondsPerTickBPM / segment.startTempo;
+
+    return ( segment.secondsPerTickBPM / segment.tempoSlope ) *
+           log(( segment.startTempo + segment.tempoSlope * ticks ) / segment.startTempo );
+}
+
+double TempoMap::ticksToSeconds( double ticks )
+{
+    const tempoSegment& segment = getSegmentForTicks( ticks );
+    return segment.startSeconds + getSegmentDuration( segment, ticks - segment.startTicks );
+}
+
+double TempoMap::secondsToTicks( double seconds )
+{
+    const tempoSegment& segment = getSegmentForSeconds( seconds );
+    double duration = seconds - segment.startSeconds;
+
+    // inverse of getSegmentDuration()
+
+    if ( segment.tempoSlope == 0.0 )
+        return segment.startTicks + duration * segment.startTempo / segment.secondsPerTickBPM;
+
+    return segment.startTicks + segment.startTempo *
+           ( exp( duration * segment.tempoSlope / segment.secondsPerTickBPM ) - 1.0 ) / segment.tempoSlope;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,125 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__TEMPOMAP_H_INCLUDED__
+#define __MWENGINE__TEMPOMAP_H_INCLUDED__
+
+#include "global.h"
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * TempoMap describes the tempo and time signature over the course of a sequence. The tempo
+ * can change instantly or ramp linearly towards a new value while the time signature
+ * changes at the start of a measure.
+ *
+ * Positions are expressed in musical ticks (where a single measure spans TICKS_PER_MEASURE
+ * ticks, regardless of its time signature) and in buffer samples. A cumulative index of
+ * the segments between consecutive changes is maintained upon each change, allowing
+ * conversion between ticks and samples in O(log n) time.
+ *
+ * A TempoMap can be handed to an AudioEngineContext (see setTempoMap()) after which the
+ * sequencer transport and the sequenced events follow its tempo changes.
+ */
+class TempoMap
+{
+    public:
+        TempoMap( float tempo, int beatAmount, int beatUnit );
+        ~TempoMap();
+
+        // removes all changes, leaving the map at given tempo and time signature
+
+        void clear( float tempo, int beatAmount, int beatUnit );
+
+        // changes the tempo at given position in ticks. When ramp is true, the tempo moves
+        // linearly from the previous tempo change onto given tempo, reaching it at given position
+
+        void addTempoChange( double ticks, float tempo, bool ramp );
+
+        // changes the time signature at the start of given measure (first measure starts at 0)
+
+        void addTimeSignatureChange( int measure, int beatAmount, int beatUnit );
+
+        float getTempo( double ticks );
+        int getTimeSigBeatAmount( int measure );
+        int getTimeSigBeatUnit( int measure );
+
+        // conversion between musical ticks and buffer samples, both positions resolve to the same measure
+
+        double samplesToTicks( int samples );
+        int ticksToSamples( double ticks );
+
+        int getMeasureStart( int measure );  // offset in samples at which given measure starts
+        int getMeasureLength( int measure ); // length in samples of given measure
+        int getMeasureAt( int samples );     // the measure containing given offset in samples
+        int getShortestBarLength();         // length in samples of the shortest measure in the map
+
+        // uniquely identifies the current state of the map, changes whenever the map is altered
+
+        unsigned int getVersion();
+
+    protected:
+
+        typedef struct {
+            double ticks;
+            float tempo;
+            bool ramp;
+        } tempoChange;
+
+        typedef struct {
+            int measure;
+            int beatAmount;
+            int beatUnit;
+        } timeSignatureChange;
+
+        // the range between two consecutive changes, where the tempo is either constant
+        // or ramps linearly (by tempoSlope per tick) and the time signature is constant
+
+        typedef struct {
+            double startTicks;
+            double startSeconds;      // cumulative duration of all preceding segments
+            double startTempo;
+            double tempoSlope;        // change in tempo per tick (0 for a constant tempo)
+            double secondsPerTickBPM; // duration of a single tick at a tempo of 1 BPM
+            int    beatAmount;
+            int    beatUnit;
+        } tempoSegment;
+
+        std::vector<tempoChange> _tempoChanges;
+        std::vector<timeSignatureChange> _timeSignatureChanges;
+        std::vector<tempoSegment> _segments;
+        unsigned int _version;
+        double _shortestBarSeconds;
+
+        void invalidate(); // rebuilds the segments and their cumulative index
+
+        const tempoSegment& getSegmentForTicks( double ticks );
+        const tempoSegment& getSegmentForSeconds( double seconds );
+
+        double getSegmentDuration( const tempoSegment& segment, double ticks );
+        double ticksToSeconds( double ticks );
+        double secondsToTicks( double seconds );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -1,4 +1,5 @@
 #include "../audiobuffer.h"
+#include <cstdint>
 
 TEST( AudioBuffer, Construction )
 {
@@ -282,3 +283,83 @@ TEST( AudioBuffer, Clone )
     delete audioBuffer;
     delete clone;
 }
+
+TEST( AudioBuffer, ContiguousAlignedStorage )
+{
+    int amountOfChannels = randomInt( 1, 5 );
+    int bufferSize       = randomInt( 1, 1024 );
+
+    AudioBuffer* audioBuffer = new AudioBuffer( amountOfChannels, bufferSize );
+    int stride = audioBuffer->getChannelStride();
+
+    EXPECT_GE( stride, bufferSize ) << "expected channel stride to hold the channel contents";
+    EXPECT_EQ( 0, ( stride * sizeof( SAMPLE_TYPE )) % AudioBuffer::MEMORY_ALIGNMENT )
+        << "expected channel stride to be padded to the memory alignment";
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channel = audioBuffer->getBufferForChannel( c );
+
+        EXPECT_EQ( 0, reinterpret_cast<uintptr_t>( channel ) % AudioBuffer::MEMORY_ALIGNMENT )
+            << "expected channel to be aligned";
+
+        EXPECT_EQ( audioBuffer->getBufferForChannel( 0 ) + c * stride, channel )
+            << "expected channels to be stored contiguously";
+    }
+    delete audioBuffer;
+}
+
+TEST( AudioBuffer, View )
+{
+    int amountOfChannels     = randomInt( 1, 5 );
+    int bufferSize           = 64;
+    AudioBuffer* audioBuffer = new AudioBuffer( amountOfChannels, bufferSize );
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        SAMPLE_TYPE* buffer = audioBuffer->getBufferForChannel( c );
+        for ( int i = 0; i < bufferSize; ++i )
+            buffer[ i ] = 1.0;
+    }
+
+    AudioBufferView view( audioBuffer, 16, 32 );
+
+    EXPECT_EQ( amountOfChannels, view.amountOfChannels );
+    EXPECT_EQ( 32, view.bufferSize );
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        EXPECT_EQ( audioBuffer->getBufferForChannel( c ) + 16, view.getBufferForChannel( c ))
+            << "expected view to point into the viewed buffer at its offset";
+    }
+
+    // slices are relative to the view
+
+    AudioBufferView slice = view.slice( 8, 8 );
+
+    EXPECT_EQ( 8, slice.bufferSize );
+    EXPECT_EQ( audioBuffer->getBufferForChannel( 0 ) + 24, slice.getBufferForChannel( 0 ));
+
+    // operations only affect the viewed range
+
+    view.adjustBufferVolumes( .5 );
+    slice.silenceBuffers();
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* buffer = audioBuffer->getBufferForChannel( c );
+
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            SAMPLE_TYPE expected = ( i >= 24 && i < 32 ) ? 0.0 : ( i >= 16 && i < 48 ) ? .5 : 1.0;
+            EXPECT_EQ( expected, buffer[ i ] ) << "expected only the viewed range to have been altered";
+        }
+    }
+
+    // views are clamped to the buffers range
+
+    AudioBufferView clamped( audioBuffer, 48, 32 );
+    EXPECT_EQ( 16, clamped.bufferSize ) << "expected view to be clamped to the end of the buffer";
+
+    EXPECT_EQ( 0, view.slice( 40, 8 ).bufferSize ) << "expected slice outside of the view to be empty";
+
+    delete audioBuffer;
+}
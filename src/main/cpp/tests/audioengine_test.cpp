@@ -7,6 +7,8 @@
 #include <drivers/mock_io.h>
 #include <events/baseaudioevent.h>
 #include <instruments/baseinstrument.h>
+#include <utilities/audiosink.h>
+#include <utilities/wavereader.h>
 
 TEST( AudioEngine, Start )
 {
@@ -77,15 +79,6 @@ TEST( AudioEngine, TempoUpdate )
 
     controller->setTempo( newTempo, 12, 8 );
 
-    EXPECT_EQ( oldTempo, controller->getTempo() )
-        << "expected tempo at the old value to be set prior to engine start";
-
-    EXPECT_EQ( 4, controller->getTimeSigBeatAmount() )
-        << "expected time signature to be at the old value prior to the engine start";
-
-    EXPECT_EQ( 4, controller->getTimeSigBeatUnit() )
-        << "expected time signature to be at the old value prior to the engine start";
-
     AudioEngine::start( Drivers::types::MOCKED );
     //usleep( 50 ); // tempo update is executed after the engine is halted by the OpenSL mock
 
@@ -94,6 +87,9 @@ TEST( AudioEngine, TempoUpdate )
     EXPECT_EQ( newTempo, controller->getTempo() )
         << "expected engine to have updated the tempo during a single iteration of its render cycle";
 
+    EXPECT_EQ( newTempo, AudioEngine::defaultContext.getTransport().tempo )
+        << "expected the render cycle to have operated at the updated tempo";
+
     EXPECT_EQ( 12, controller->getTimeSigBeatAmount() )
         << "expected engine to have updated the time signature during a single iteration of its render cycle";
 
@@ -197,6 +193,11 @@ TEST( AudioEngine, Output )
     AudioEngine::min_buffer_position = 0;
     AudioEngine::max_buffer_position = event3->getEventStart() + event3->getEventLength();
 
+    // the mocked IO evaluates the sample accurate (hard clipped) output, bypass
+    // the master limiter as it delays the signal by its look-ahead time
+
+    AudioEngine::limitOutput = false;
+
     // start the engine
 
     controller->setPlaying( true );
@@ -214,6 +215,7 @@ TEST( AudioEngine, Output )
 
     controller->setPlaying( false );
     MockData::render_iterations = 0;
+    AudioEngine::limitOutput    = true;
 
     delete controller;
     delete instrument;
@@ -291,6 +293,7 @@ TEST( AudioEngine, OutputAtLoopStart )
 
     AudioEngine::bufferPosition = 88100;
     AudioEngine::volume         = 1;
+    AudioEngine::limitOutput    = false; // see Output test
     controller->setPlaying( true );
     AudioEngine::start( Drivers::types::MOCKED );
 
@@ -306,6 +309,7 @@ TEST( AudioEngine, OutputAtLoopStart )
 
     controller->setPlaying( false );
     MockData::render_iterations = 0;
+    AudioEngine::limitOutput    = true;
 
     delete channels;
     delete controller;
@@ -335,4 +339,118 @@ TEST( AudioEngine, AddRemoveChannelGroups )
     ASSERT_TRUE( it == AudioEngine::groups.end() ) << "expected channel group to have been unregistered from engine";
 
     delete channelGroup;
-}
\ No newline at end of file
+}
+
+// collects the output of an offline render
+
+class TestAudioSink : public AudioSink
+{
+    public:
+        std::vector<float> samples;
+        int iterations = 0;
+
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels )
+        {
+            for ( int i = 0; i < aBufferSize * amountOfChannels; ++i )
+                samples.push_back( aBuffer[ i ]);
+
+            ++iterations;
+        }
+};
+
+TEST( AudioEngine, RenderOffline )
+{
+    // store the engine properties as subsequent tests rely on them
+
+    int bufferSize     = AudioEngineProps::BUFFER_SIZE;
+    int sampleRate     = AudioEngineProps::SAMPLE_RATE;
+    int outputChannels = AudioEngineProps::OUTPUT_CHANNELS;
+
+    SequencerController* controller = new SequencerController();
+
+    controller->prepare( 120, 4, 4 );
+
+    // mono output at 48 kHz sample rate and buffer size of 16 samples
+    AudioEngine::setup( 16, 48000, 1 );
+
+    controller->setTempoNow( 120.0f, 4, 4 );
+    controller->rewind();
+
+    AudioEngine::volume      = 1;
+    AudioEngine::limitOutput = false; // see Output test
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+    AudioBuffer* buffer        = new AudioBuffer( 1, 32 );
+
+    // first half of the event is positive, second half negative
+
+    for ( int i = 0; i < 32; ++i )
+        buffer->getBufferForChannel( 0 )[ i ] = ( i < 16 ) ? .5 : -.5;
+
+    event->setBuffer( buffer, false );
+    event->setEventLength( buffer->bufferSize );
+    event->setEventStart( 8 );
+    event->addToSequencer();
+
+    AudioEngine::min_buffer_position = 0;
+    AudioEngine::max_buffer_position = AudioEngine::samples_per_bar - 1;
+
+    TestAudioSink* sink = new TestAudioSink();
+
+    // range does not align with the buffer size to validate the last render iteration is truncated
+
+    int rangeStart = 4;
+    int rangeEnd   = 44;
+
+    ASSERT_TRUE( AudioEngine::renderOffline( rangeStart, rangeEnd, sink ))
+        << "expected offline render to succeed while the engine is stopped";
+
+    EXPECT_EQ( rangeEnd - rangeStart, sink->samples.size() ) << "expected the full range to have been rendered";
+    EXPECT_EQ( 3, sink->iterations ) << "expected range to have been rendered in buffer size sized iterations";
+    EXPECT_EQ( 0, AudioEngine::bufferPosition ) << "expected buffer position to have been restored";
+    EXPECT_FALSE( Sequencer::playing ) << "expected playback state to have been restored";
+
+    for ( int i = 0; i < rangeEnd - rangeStart; ++i ) {
+        int position = rangeStart + i;
+        float sample = sink->samples[ i ];
+
+        if ( position < 8 || position >= 40 )
+            EXPECT_FLOAT_EQ( 0.f, sample ) << "expected silence outside of the event at position " << position;
+        else if ( position < 24 )
+            EXPECT_GT( sample, 0.f ) << "expected positive event contents at position " << position;
+        else
+            EXPECT_LT( sample, 0.f ) << "expected negative event contents at position " << position;
+    }
+
+    EXPECT_FALSE( AudioEngine::renderOffline( rangeEnd, rangeStart, sink ))
+        << "expected no render to occur for an invalid range";
+
+    // render into a file
+
+    std::string file = "mwengine_offline_render_test.wav";
+    ASSERT_TRUE( AudioEngine::renderOffline( rangeStart, rangeEnd, file ));
+
+    waveFile result = WaveReader::fileToBuffer( file );
+
+    ASSERT_FALSE( result.buffer == nullptr ) << "expected output file to have been written";
+    EXPECT_EQ( rangeEnd - rangeStart, result.buffer->bufferSize );
+
+    for ( int i = 0; i < result.buffer->bufferSize; ++i ) {
+        EXPECT_NEAR( sink->samples[ i ], result.buffer->getBufferForChannel( 0 )[ i ], 1.0 / 32767 )
+            << "expected file render to equal the sink render";
+    }
+
+    // clean up
+
+    AudioEngine::limitOutput = true;
+    AudioEngine::setup( bufferSize, sampleRate, outputChannels );
+    remove( file.c_str() );
+
+    delete result.buffer;
+    delete sink;
+    delete controller;
+    delete instrument;
+    delete event;
+    delete buffer;
+}
@@ -0,0 +1,487 @@
+#include <audioenginecontext.h>
+#include <audioengine.h>
+#include <sequencer.h>
+#include <events/baseaudioevent.h>
+#include <instruments/baseinstrument.h>
+#include <utilities/audiosink.h>
+#include <thread>
+
+TEST( AudioEngineContext, RegisterInstrument )
+{
+    AudioEngineContext* context = new AudioEngineContext();
+    BaseInstrument* instrument  = new BaseInstrument();
+
+    ASSERT_TRUE( std::find( Sequencer::instruments.begin(), Sequencer::instruments.end(), instrument ) != Sequencer::instruments.end() )
+        << "expected instrument to be registered in the default context upon construction";
+
+    instrument->unregisterFromSequencer();
+
+    EXPECT_EQ( 0, context->registerInstrument( instrument ));
+    EXPECT_EQ( -1, context->registerInstrument( instrument )) << "expected instrument not to be registered twice";
+    EXPECT_EQ( 1, context->instruments.size() );
+    EXPECT_TRUE( std::find( Sequencer::instruments.begin(), Sequencer::instruments.end(), instrument ) == Sequencer::instruments.end() )
+        << "expected instrument not to be registered in the default context";
+
+    EXPECT_TRUE( context->unregisterInstrument( instrument ));
+    EXPECT_FALSE( context->unregisterInstrument( instrument ));
+    EXPECT_EQ( 0, context->instruments.size() );
+
+    delete instrument;
+    delete context;
+}
+
+TEST( AudioEngineContext, EventTempo )
+{
+    AudioEngineContext* context = new AudioEngineContext();
+    BaseInstrument* instrument  = new BaseInstrument();
+
+    instrument->unregisterFromSequencer();
+    context->registerInstrument( instrument );
+
+    // the context runs at a different tempo than the default context
+
+    context->samples_per_bar = AudioEngine::samples_per_bar * 2;
+
+    EXPECT_EQ( context, instrument->getContext() );
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent( instrument );
+    audioEvent->setEventLength( 16 );
+    audioEvent->setEventStartTicks( TICKS_PER_MEASURE );
+
+    EXPECT_EQ( context->samples_per_bar, audioEvent->getEventStart() )
+        << "expected the event to be positioned at the tempo of the context sequencing it";
+
+    context->unregisterInstrument( instrument );
+
+    EXPECT_EQ( &AudioEngine::defaultContext, instrument->getContext() )
+        << "expected unregistered instruments to fall back to the default context";
+
+    delete audioEvent;
+    delete instrument;
+    delete context;
+}
+
+// collects the output of an offline render
+
+class TestContextSink : public AudioSink
+{
+    public:
+        std::vector<float> samples;
+
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels )
+        {
+            for ( int i = 0; i < aBufferSize * amountOfChannels; ++i )
+                samples.push_back( aBuffer[ i ]);
+        }
+};
+
+TEST( AudioEngineContext, ConcurrentRenderOffline )
+{
+    int defaultPosition = AudioEngine::bufferPosition;
+    bool defaultPlaying = Sequencer::playing;
+
+    const int amountOfContexts = 2;
+    const int rangeEnd         = AudioEngineProps::BUFFER_SIZE * 8;
+
+    AudioEngineContext* contexts[ amountOfContexts ];
+    BaseInstrument* instruments[ amountOfContexts ];
+    BaseAudioEvent* events[ amountOfContexts ];
+    AudioBuffer* buffers[ amountOfContexts ];
+    TestContextSink* sinks[ amountOfContexts ];
+
+    for ( int i = 0; i < amountOfContexts; ++i )
+    {
+        AudioEngineContext* context = new AudioEngineContext();
+
+        // transport mirrors the default context, but loops over the render range
+
+        context->tempo       = AudioEngine::tempo;
+        context->queuedTempo = AudioEngine::tempo;
+        context->handleTempoUpdate( context->tempo, false );
+
+        context->min_buffer_position = 0;
+        context->max_buffer_position = rangeEnd - 1;
+        context->limitOutput         = false;
+
+        // each context renders an event of different amplitude
+
+        BaseInstrument* instrument = new BaseInstrument();
+        instrument->unregisterFromSequencer();
+        context->registerInstrument( instrument );
+
+        AudioBuffer* buffer = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, AudioEngineProps::BUFFER_SIZE );
+
+        for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+            for ( int j = 0; j < buffer->bufferSize; ++j )
+                buffer->getBufferForChannel( c )[ j ] = 0.25 * ( i + 1 );
+        }
+
+        BaseAudioEvent* event = new BaseAudioEvent( instrument );
+        event->setBuffer( buffer, false );
+        event->setEventLength( buffer->bufferSize );
+        event->setEventStart( AudioEngineProps::BUFFER_SIZE * 2 );
+        event->addToSequencer();
+
+        contexts[ i ]    = context;
+        instruments[ i ] = instrument;
+        events[ i ]      = event;
+        buffers[ i ]     = buffer;
+        sinks[ i ]       = new TestContextSink();
+    }
+
+    std::thread threads[ amountOfContexts ];
+    bool results[ amountOfContexts ];
+
+    for ( int i = 0; i < amountOfContexts; ++i ) {
+        threads[ i ] = std::thread([ &, i ]() {
+            results[ i ] = contexts[ i ]->renderOffline( 0, rangeEnd, sinks[ i ]);
+        });
+    }
+
+    for ( int i = 0; i < amountOfContexts; ++i )
+        threads[ i ].join();
+
+    EXPECT_EQ( defaultPosition, AudioEngine::bufferPosition ) << "expected default context transport to be unaffected";
+    EXPECT_EQ( defaultPlaying, Sequencer::playing ) << "expected default context playback state to be unaffected";
+
+    for ( int i = 0; i < amountOfContexts; ++i )
+    {
+        ASSERT_TRUE( results[ i ]) << "expected render of context " << i << " to succeed";
+        ASSERT_EQ( rangeEnd * AudioEngineProps::OUTPUT_CHANNELS, sinks[ i ]->samples.size() );
+
+        EXPECT_FALSE( contexts[ i ]->playing ) << "expected playback state to have been restored";
+
+        int eventStart = AudioEngineProps::BUFFER_SIZE * 2 * AudioEngineProps::OUTPUT_CHANNELS;
+        int eventEnd   = eventStart + AudioEngineProps::BUFFER_SIZE * AudioEngineProps::OUTPUT_CHANNELS;
+
+        for ( int j = 0; j < sinks[ i ]->samples.size(); ++j )
+        {
+            float sample = sinks[ i ]->samples[ j ];
+
+            if ( j < eventStart || j >= eventEnd )
+                EXPECT_FLOAT_EQ( 0.f, sample ) << "expected silence outside of the event";
+            else
+                EXPECT_FLOAT_EQ( 0.25f * ( i + 1 ), sample ) << "expected the contents of the contexts own event";
+        }
+    }
+
+    // clean up
+
+    for ( int i = 0; i < amountOfContexts; ++i )
+    {
+        contexts[ i ]->unregisterInstrument( instruments[ i ]);
+
+        delete events[ i ];
+        delete instruments[ i ];
+        delete buffers[ i ];
+        delete sinks[ i ];
+        delete contexts[ i ];
+    }
+}
+
+TEST( AudioEngineContext, RenderOfflineBeyondLoop )
+{
+    AudioEngineContext* context = new AudioEngineContext();
+    BaseInstrument* instrument  = new BaseInstrument();
+    TestContextSink* sink       = new TestContextSink();
+
+    instrument->unregisterFromSequencer();
+    context->registerInstrument( instrument );
+
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+    int channels   = AudioEngineProps::OUTPUT_CHANNELS;
+
+    context->queuedTempo = context->tempo;
+    context->handleTempoUpdate( context->tempo, false );
+
+    context->min_buffer_position = 0;
+    context->max_buffer_position = bufferSize * 2 - 1;
+    context->bufferPosition      = bufferSize;
+    context->limitOutput         = false;
+
+    // event is positioned beyond the end of the loop
+
+    AudioBuffer* buffer = new AudioBuffer( channels, bufferSize );
+
+    for ( int c = 0; c < channels; ++c ) {
+        for ( int i = 0; i < bufferSize; ++i )
+            buffer->getBufferForChannel( c )[ i ] = 0.5;
+    }
+
+    BaseAudioEvent* event = new BaseAudioEvent( instrument );
+    event->setBuffer( buffer, false );
+    event->setEventLength( bufferSize );
+    event->setEventStart( bufferSize * 3 );
+    event->addToSequencer();
+
+    ASSERT_TRUE( context->renderOffline( 0, bufferSize * 4, sink ));
+    ASSERT_EQ( bufferSize * 4 * channels, sink->samples.size() );
+
+    for ( int i = 0; i < sink->samples.size(); ++i )
+    {
+        if ( i < bufferSize * 3 * channels )
+            EXPECT_FLOAT_EQ( 0.f, sink->samples[ i ]) << "expected silence up until the event";
+        else
+            EXPECT_FLOAT_EQ( 0.5f, sink->samples[ i ]) << "expected the range not to wrap at the end of the loop";
+    }
+
+    EXPECT_EQ( 0, context->min_buffer_position );
+    EXPECT_EQ( bufferSize * 2 - 1, context->max_buffer_position ) << "expected the loop range to have been restored";
+    EXPECT_EQ( bufferSize, context->bufferPosition ) << "expected the playback head to have been restored";
+
+    context->unregisterInstrument( instrument );
+
+    delete event;
+    delete instrument;
+    delete buffer;
+    delete sink;
+    delete context;
+}
+
+// updates the transport of a context in between its render cycles
+
+class TransportUpdatingSink : public AudioSink
+{
+    public:
+        AudioEngineContext* context;
+        std::vector<int> maxBufferPositions;
+        std::vector<int> bufferPositions;
+
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels )
+        {
+            maxBufferPositions.push_back( context->getTransport().max_buffer_position );
+            bufferPositions.push_back( context->bufferPosition );
+
+            switch ( maxBufferPositions.size())
+            {
+                case 1:
+                    context->max_buffer_position *= 2; // unpublished
+                    break;
+                case 2:
+                    context->publishTransport();
+                    break;
+                case 3:
+                    context->seek( 5 );
+                    break;
+            }
+        }
+};
+
+TEST( AudioEngineContext, PublishTransport )
+{
+    AudioEngineContext* context  = new AudioEngineContext();
+    TransportUpdatingSink* sink = new TransportUpdatingSink();
+
+    sink->context = context;
+
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+
+    context->queuedTempo         = context->tempo; // no tempo change
+    context->min_buffer_position = 0;
+    context->max_buffer_position = bufferSize * 10;
+
+    ASSERT_TRUE( context->renderOffline( 0, bufferSize * 5, sink ));
+    ASSERT_EQ( 5, sink->maxBufferPositions.size() );
+
+    EXPECT_EQ( bufferSize * 10, sink->maxBufferPositions[ 0 ]);
+    EXPECT_EQ( bufferSize * 10, sink->maxBufferPositions[ 1 ]) << "expected unpublished changes not to be applied by the render thread";
+    EXPECT_EQ( bufferSize * 20, sink->maxBufferPositions[ 2 ]) << "expected published changes to be applied on the next render cycle";
+    EXPECT_EQ( bufferSize * 20, sink->maxBufferPositions[ 4 ]) << "expected published changes to remain applied";
+
+    EXPECT_EQ( bufferSize * 3, sink->bufferPositions[ 2 ]);
+    EXPECT_EQ( 5 + bufferSize, sink->bufferPositions[ 3 ]) << "expected seek to be applied at the start of the next render cycle";
+    EXPECT_EQ( 5 + bufferSize * 2, sink->bufferPositions[ 4 ]);
+
+    delete sink;
+    delete context;
+}
+
+// changes the tempo of a context in between its render cycles
+
+class TempoUpdatingSink : public AudioSink
+{
+    public:
+        AudioEngineContext* context;
+        std::vector<float> tempos;
+        std::vector<int> bufferPositions;
+
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels )
+        {
+            tempos.push_back( context->getTransport().tempo );
+            bufferPositions.push_back( context->bufferPosition );
+
+            if ( tempos.size() == 1 )
+                context->handleTempoUpdate( context->tempo * 2, true );
+        }
+};
+
+TEST( AudioEngineContext, TempoUpdate )
+{
+    AudioEngineContext* context = new AudioEngineContext();
+    TempoUpdatingSink* sink     = new TempoUpdatingSink();
+
+    sink->context = context;
+
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+    float tempo    = 120.F;
+
+    context->queuedTempo = tempo;
+    context->handleTempoUpdate( tempo, true );
+
+    context->min_buffer_position = 0;
+    context->max_buffer_position = bufferSize * 10;
+
+    ASSERT_TRUE( context->renderOffline( 0, bufferSize * 2, sink ));
+    ASSERT_EQ( 2, sink->tempos.size() );
+
+    EXPECT_EQ( tempo * 2, context->tempo ) << "expected the tempo to have been applied by the controlling thread";
+    EXPECT_EQ( bufferSize * 5, context->max_buffer_position ) << "expected the loop range to have been scaled to the new tempo";
+
+    EXPECT_EQ( tempo, sink->tempos[ 0 ]);
+    EXPECT_EQ( tempo * 2, sink->tempos[ 1 ]) << "expected the render thread to have applied the tempo on the next render cycle";
+
+    EXPECT_EQ( bufferSize, sink->bufferPositions[ 0 ]);
+    EXPECT_EQ( bufferSize / 2 + bufferSize, sink->bufferPositions[ 1 ])
+        << "expected the render thread to have scaled the playback head to the new tempo";
+
+    delete sink;
+    delete context;
+}
+
+// records the sequencer position of a context after each of its render cycles
+
+class StepRecordingSink : public AudioSink
+{
+    public:
+        AudioEngineContext* context;
+        std::vector<int> stepPositions;
+        std::vector<int> bufferPositions;
+
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels )
+        {
+            stepPositions.push_back( context->stepPosition );
+            bufferPositions.push_back( context->bufferPosition );
+        }
+};
+
+TEST( AudioEngineContext, StepsFollowTempoMap )
+{
+    unsigned int orgSampleRate = AudioEngineProps::SAMPLE_RATE;
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    AudioEngineContext* context = new AudioEngineContext();
+    StepRecordingSink* sink     = new StepRecordingSink();
+
+    sink->context = context;
+
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+
+    // 2nd measure is in 3/4 time and ramps down to 60 BPM
+
+    TempoMap* tempoMap = new TempoMap( 120.F, 4, 4 );
+    tempoMap->addTimeSignatureChange( 1, 3, 4 );
+    tempoMap->addTempoChange( TICKS_PER_MEASURE * 2, 60.F, true );
+
+    // subdivide the measures into steps shorter than a single buffer
+
+    context->queuedTempo         = context->tempo;
+    context->steps_per_bar       = 1024;
+    context->min_step_position   = 0;
+    context->max_step_position   = 1024 * 16;
+    context->min_buffer_position = 0;
+    context->max_buffer_position = tempoMap->getMeasureStart( 4 );
+
+    context->setTempoMap( tempoMap );
+
+    int rangeStart = tempoMap->getMeasureStart( 1 ) - bufferSize * 2;
+    int rangeEnd   = tempoMap->getMeasureStart( 3 );
+
+    ASSERT_TRUE( context->renderOffline( rangeStart, rangeEnd, sink ));
+
+    double ticksPerStep = ( double ) TICKS_PER_MEASURE / 1024;
+
+    for ( size_t i = 0; i < sink->stepPositions.size(); ++i )
+    {
+        int lastPosition = sink->bufferPositions[ i ] - 1;
+        int step         = sink->stepPositions[ i ];
+
+        // expect the last rendered position to lie within the reported step
+
+        EXPECT_LE( tempoMap->ticksToSamples( step * ticksPerStep ), lastPosition )
+            << "expected the step to follow the tempo map at position " << lastPosition;
+        EXPECT_GT( tempoMap->ticksToSamples(( step + 1 ) * ticksPerStep ), lastPosition )
+            << "expected the step to follow the tempo map at position " << lastPosition;
+    }
+
+    context->setTempoMap( nullptr );
+
+    delete tempoMap;
+    delete sink;
+    delete context;
+
+    AudioEngineProps::SAMPLE_RATE = orgSampleRate;
+}
+
+TEST( AudioEngineContext, EventsFollowTempoSnapshot )
+{
+    AudioEngineContext* context = new AudioEngineContext();
+    BaseInstrument* instrument  = new BaseInstrument();
+    TestContextSink* sink       = new TestContextSink();
+
+    instrument->unregisterFromSequencer();
+    context->registerInstrument( instrument );
+
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+    int channels   = AudioEngineProps::OUTPUT_CHANNELS;
+
+    context->queuedTempo = context->tempo;
+    context->handleTempoUpdate( 120.F, true );
+
+    int samplesPerBar = context->samples_per_bar;
+
+    AudioBuffer* buffer = new AudioBuffer( channels, bufferSize );
+
+    for ( int c = 0; c < channels; ++c ) {
+        for ( int i = 0; i < bufferSize; ++i )
+            buffer->getBufferForChannel( c )[ i ] = 0.5;
+    }
+
+    // event is positioned at the start of the second measure
+
+    BaseAudioEvent* event = new BaseAudioEvent( instrument );
+    event->setBuffer( buffer, false );
+    event->setEventLength( bufferSize );
+    event->setEventStartTicks( TICKS_PER_MEASURE );
+    event->addToSequencer();
+
+    ASSERT_EQ( samplesPerBar, event->getEventStart() );
+
+    // doubling the tempo does not update the event, the render thread
+    // derives its position at the tempo of the snapshot it renders
+
+    context->handleTempoUpdate( 240.F, true );
+
+    int eventStart = samplesPerBar / 2;
+
+    context->min_buffer_position = 0;
+    context->max_buffer_position = samplesPerBar * 2;
+    context->limitOutput         = false;
+
+    ASSERT_TRUE( context->renderOffline( 0, eventStart + bufferSize * 2, sink ));
+
+    EXPECT_FLOAT_EQ( 0.f,  sink->samples[( eventStart - 1 ) * channels ]) << "expected silence up until the event";
+    EXPECT_FLOAT_EQ( 0.5f, sink->samples[ eventStart * channels ]) << "expected the event to start at the new tempo";
+    EXPECT_FLOAT_EQ( 0.5f, sink->samples[( eventStart + bufferSize - 1 ) * channels ]);
+    EXPECT_FLOAT_EQ( 0.f,  sink->samples[( eventStart + bufferSize ) * channels ]) << "expected the event to maintain its duration";
+
+    EXPECT_EQ( eventStart, event->getEventStart() ) << "expected the event position to follow the tempo upon access";
+    EXPECT_EQ( bufferSize, event->getEventLength() );
+
+    context->unregisterInstrument( instrument );
+
+    delete event;
+    delete instrument;
+    delete buffer;
+    delete sink;
+    delete context;
+}
@@ -0,0 +1,172 @@
+#include "../compactaudiobuffer.h"
+
+TEST( CompactAudioBuffer, Construction )
+{
+    AudioBuffer* source = randomAudioBuffer();
+    source->loopeable   = true;
+
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::PCM16 );
+
+    EXPECT_EQ( source->amountOfChannels, buffer->amountOfChannels ) << "expected channel amount to equal the source";
+    EXPECT_EQ( source->bufferSize, buffer->bufferSize )             << "expected buffer size to equal the source";
+    EXPECT_EQ( SampleFormats::PCM16, buffer->getFormat() )           << "expected format to equal the requested format";
+    ASSERT_TRUE( buffer->loopeable )                                  << "expected loopeable state to equal the source";
+
+    delete buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, Pcm16Conversion )
+{
+    AudioBuffer* source = randomAudioBuffer();
+
+    // 16-bit quantized content (as read from a 16-bit WAV file) is stored losslessly
+
+    for ( int c = 0; c < source->amountOfChannels; ++c ) {
+        SAMPLE_TYPE* channelBuffer = source->getBufferForChannel( c );
+        for ( int i = 0; i < source->bufferSize; ++i )
+            channelBuffer[ i ] = ( SAMPLE_TYPE ) randomInt( -32767, 32767 ) / 32767.0;
+    }
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::PCM16 );
+
+    for ( int c = 0; c < source->amountOfChannels; ++c ) {
+        SAMPLE_TYPE* channelBuffer = source->getBufferForChannel( c );
+        const int16_t* compactBuffer = buffer->getChannel<int16_t>( c );
+
+        for ( int i = 0; i < source->bufferSize; ++i ) {
+            EXPECT_DOUBLE_EQ( channelBuffer[ i ], ( SAMPLE_TYPE ) compactBuffer[ i ] * buffer->getScale() )
+                << "expected sample value to be retained at index " << i << " for channel " << c;
+        }
+    }
+    delete buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, Pcm16ConversionClipping )
+{
+    AudioBuffer* source = new AudioBuffer( 1, 4 );
+    SAMPLE_TYPE* channelBuffer = source->getBufferForChannel( 0 );
+
+    channelBuffer[ 0 ] = 1.5;
+    channelBuffer[ 1 ] = -1.5;
+    channelBuffer[ 2 ] = 0.5;
+    channelBuffer[ 3 ] = 0.0;
+
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::PCM16 );
+    const int16_t* compactBuffer = buffer->getChannel<int16_t>( 0 );
+
+    EXPECT_EQ( 32767,  compactBuffer[ 0 ] ) << "expected out of range positive value to be clipped";
+    EXPECT_EQ( -32767, compactBuffer[ 1 ] ) << "expected out of range negative value to be clipped";
+    EXPECT_EQ( 16384,  compactBuffer[ 2 ] ) << "expected value to be rounded to nearest integer";
+    EXPECT_EQ( 0,      compactBuffer[ 3 ] ) << "expected silence to be retained";
+
+    delete buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, Float32Conversion )
+{
+    AudioBuffer* source = randomAudioBuffer();
+    fillAudioBuffer( source );
+
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::FLOAT32 );
+
+    EXPECT_EQ(( SAMPLE_TYPE ) 1.0, buffer->getScale() ) << "expected no scaling for floating point format";
+
+    for ( int c = 0; c < source->amountOfChannels; ++c ) {
+        SAMPLE_TYPE* channelBuffer = source->getBufferForChannel( c );
+        const float* compactBuffer = buffer->getChannel<float>( c );
+
+        for ( int i = 0; i < source->bufferSize; ++i ) {
+            EXPECT_EQ(( float ) channelBuffer[ i ], compactBuffer[ i ] )
+                << "expected sample value to be retained at index " << i << " for channel " << c;
+        }
+    }
+    delete buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, Clone )
+{
+    AudioBuffer* source = randomAudioBuffer();
+    fillAudioBuffer( source );
+
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::PCM16 );
+    CompactAudioBuffer* clone  = dynamic_cast<CompactAudioBuffer*>( buffer->clone() );
+
+    ASSERT_FALSE( clone == nullptr ) << "expected clone to be a CompactAudioBuffer";
+    EXPECT_EQ( buffer->getFormat(), clone->getFormat() ) << "expected clone to be in the same format";
+
+    for ( int c = 0; c < source->amountOfChannels; ++c ) {
+        ASSERT_FALSE( buffer->getChannel<int16_t>( c ) == clone->getChannel<int16_t>( c ))
+            << "expected clone to hold its own copy of the data";
+
+        for ( int i = 0; i < source->bufferSize; ++i ) {
+            EXPECT_EQ( buffer->getChannel<int16_t>( c )[ i ], clone->getChannel<int16_t>( c )[ i ] )
+                << "expected cloned sample value to equal the original at index " << i;
+        }
+    }
+    delete clone;
+    delete buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, GetMemoryUsage )
+{
+    AudioBuffer* source = randomAudioBuffer();
+    size_t amountOfSamples = source->amountOfChannels * source->bufferSize;
+
+    CompactAudioBuffer* int16Buffer = new CompactAudioBuffer( source, SampleFormats::PCM16 );
+    CompactAudioBuffer* floatBuffer = new CompactAudioBuffer( source, SampleFormats::FLOAT32 );
+
+    EXPECT_EQ( amountOfSamples * sizeof( SAMPLE_TYPE ), source->getMemoryUsage() );
+    EXPECT_EQ( amountOfSamples * sizeof( int16_t ), int16Buffer->getMemoryUsage() );
+    EXPECT_EQ( amountOfSamples * sizeof( float ), floatBuffer->getMemoryUsage() );
+
+    delete floatBuffer;
+    delete int16Buffer;
+    delete source;
+}
+
+TEST( CompactAudioBuffer, AudioBufferMethods )
+{
+    AudioBuffer* source = new AudioBuffer( 2, 8 );
+
+    for ( int i = 0; i < source->bufferSize; ++i ) {
+        source->getBufferForChannel( 0 )[ i ] = 0.5;
+        source->getBufferForChannel( 1 )[ i ] = -0.25;
+    }
+    CompactAudioBuffer* buffer = new CompactAudioBuffer( source, SampleFormats::FLOAT32 );
+
+    EXPECT_TRUE( buffer->getBufferForChannel( 0 ) == nullptr )
+        << "expected no SAMPLE_TYPE buffer to be returned for compact contents";
+
+    // mixing the compact contents into a native buffer
+
+    AudioBuffer* output = new AudioBuffer( 2, 8 );
+    EXPECT_EQ( 8, output->mergeBuffers( buffer, 0, 0, 1.f )) << "expected all samples to have been merged";
+
+    for ( int i = 0; i < output->bufferSize; ++i ) {
+        EXPECT_EQ(( SAMPLE_TYPE ) 0.5,   output->getBufferForChannel( 0 )[ i ] ) << "expected merged value at index " << i;
+        EXPECT_EQ(( SAMPLE_TYPE ) -0.25, output->getBufferForChannel( 1 )[ i ] ) << "expected merged value at index " << i;
+    }
+
+    // operations on the compact contents
+
+    buffer->adjustBufferVolumes( 0.5 );
+    EXPECT_EQ(( SAMPLE_TYPE ) 0.25, buffer->readSample( 0, 0 )) << "expected volume to have been adjusted";
+
+    buffer->mergeBuffers( source, 0, 0, 1.f );
+    EXPECT_EQ(( SAMPLE_TYPE ) 0.75, buffer->readSample( 0, 0 )) << "expected source to have been merged";
+
+    buffer->applyMonoSource();
+    EXPECT_EQ( buffer->readSample( 0, 7 ), buffer->readSample( 1, 7 )) << "expected channels to be equal";
+
+    EXPECT_FALSE( buffer->isSilent() ) << "expected buffer not to be silent";
+    buffer->silenceBuffers();
+    EXPECT_TRUE( buffer->isSilent() ) << "expected buffer to be silent after silencing";
+
+    delete output;
+    delete buffer;
+    delete source;
+}
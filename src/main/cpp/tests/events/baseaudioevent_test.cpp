@@ -1,6 +1,7 @@
 #include "../../events/baseaudioevent.h"
 #include "../../utilities/bufferutility.h"
 #include "../../utilities/eventutility.h"
+#include "../../utilities/eventpool.h"
 #include "../../utilities/volumeutil.h"
 #include "../../instruments/baseinstrument.h"
 #include "../../audioengine.h"
@@ -372,6 +373,58 @@ TEST( BaseAudioEvent, PositionEvent )
     delete audioEvent;
 }
 
+TEST( BaseAudioEvent, MusicalPosition )
+{
+    int orgSamplesPerBar = AudioEngine::samples_per_bar;
+    AudioEngine::samples_per_bar = 88200;
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* audioEvent = new BaseAudioEvent( instrument );
+
+    int eventLength = randomInt( 24, 8192 );
+    audioEvent->setEventLength( eventLength );
+    audioEvent->addToSequencer();
+
+    // position event at the second beat of the third measure
+
+    audioEvent->setEventStartTicks( TICKS_PER_MEASURE * 2.25 );
+
+    EXPECT_EQ( 198450, audioEvent->getEventStart() )
+        << "expected sampleStart to match the musical position";
+
+    EXPECT_FLOAT_EQ( TICKS_PER_MEASURE * 2.25, audioEvent->getEventStartTicks() )
+        << "expected musical position to match the given value";
+
+    // halve the bar length (e.g. doubling the tempo), the event derives
+    // its position from the musical position upon access
+
+    AudioEngine::samples_per_bar = 44100;
+
+    EXPECT_EQ( 99225, audioEvent->getEventStart() )
+        << "expected sampleStart to have followed the tempo change";
+
+    EXPECT_EQ( 99225 + eventLength - 1, audioEvent->getEventEnd() )
+        << "expected sampleEnd to have followed the tempo change";
+
+    EXPECT_EQ( eventLength, audioEvent->getEventLength() )
+        << "expected event length to remain unchanged";
+
+    EXPECT_FLOAT_EQ( TICKS_PER_MEASURE * 2.25, audioEvent->getEventStartTicks() )
+        << "expected musical position to remain unchanged";
+
+    // positioning in samples should update the musical position
+
+    audioEvent->setEventStart( 11025 );
+
+    EXPECT_FLOAT_EQ( TICKS_PER_MEASURE * 0.25, audioEvent->getEventStartTicks() )
+        << "expected musical position to match the sampleStart";
+
+    AudioEngine::samples_per_bar = orgSamplesPerBar;
+
+    delete audioEvent;
+    delete instrument;
+}
+
 TEST( BaseAudioEvent, Buffers )
 {
     BaseAudioEvent* audioEvent = new BaseAudioEvent();
@@ -659,4 +712,33 @@ TEST( BaseAudioEvent, RepositionToTempoChange )
     
     delete instrument;
     delete event;
-}
\ No newline at end of file
+}
+TEST( BaseAudioEvent, PooledAllocation )
+{
+    int allocatedEvents = EventPool::getAmountOfEvents();
+
+    std::vector<BaseAudioEvent*> audioEvents;
+    for ( int i = 0; i < 100; ++i ) {
+        audioEvents.push_back( new BaseAudioEvent());
+    }
+    EXPECT_EQ( allocatedEvents + 100, EventPool::getAmountOfEvents() )
+        << "expected events to have been allocated from the pool";
+
+    for ( auto audioEvent : audioEvents ) {
+        delete audioEvent;
+    }
+    EXPECT_EQ( allocatedEvents, EventPool::getAmountOfEvents() )
+        << "expected deleted events to have been returned to the pool";
+
+    EventPool::trim();
+
+    // events can be allocated after the unused memory has been released
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent();
+    EXPECT_EQ( allocatedEvents + 1, EventPool::getAmountOfEvents() );
+
+    audioEvent->setEventLength( 512 );
+    EXPECT_EQ( 512, audioEvent->getEventLength() );
+
+    delete audioEvent;
+}
@@ -1517,3 +1517,86 @@ TEST( SampleEvent, MixBufferCustomLoopStartAndEndOffsetWithCrossfade )
     delete sourceBuffer;
     delete sampleEvent;
 }
+
+TEST( SampleEvent, CompactSamplePlayback )
+{
+    int length = randomInt( 512, 2048 );
+
+    // 16-bit quantized content (as read from a 16-bit WAV file)
+
+    AudioBuffer* sample = new AudioBuffer( 2, length );
+    for ( int c = 0; c < sample->amountOfChannels; ++c ) {
+        for ( int i = 0; i < length; ++i )
+            sample->getBufferForChannel( c )[ i ] = ( SAMPLE_TYPE ) randomInt( -32767, 32767 ) / 32767.0;
+    }
+
+    SampledInstrument* instrument = new SampledInstrument();
+    AudioBuffer* expectedBuffer   = new AudioBuffer( 2, 64 );
+    AudioBuffer* compactBuffer    = new AudioBuffer( 2, 64 );
+
+    // play back the same sample held as SAMPLE_TYPE and in a compact format, using ranges,
+    // loops and custom playback rates. Both should give the same output
+
+    for ( SampleFormats::types format : { SampleFormats::PCM16, SampleFormats::FLOAT32 })
+    {
+        CompactAudioBuffer* compactSample = new CompactAudioBuffer( sample, format );
+        SAMPLE_TYPE tolerance = ( format == SampleFormats::PCM16 ) ? 1e-12 : 1e-6;
+
+        for ( int scenario = 0; scenario < 4; ++scenario )
+        {
+            SampleEvent* nativeEvent  = new SampleEvent( instrument );
+            SampleEvent* compactEvent = new SampleEvent( instrument );
+
+            nativeEvent->setSample ( sample );
+            compactEvent->setSample( compactSample );
+
+            for ( SampleEvent* event : { nativeEvent, compactEvent })
+            {
+                switch ( scenario )
+                {
+                    case 1:
+                        event->setLoopeable( true, 5 );
+                        event->setLoopStartOffset( length / 3 );
+                        event->setEventLength( length * 3 );
+                        break;
+                    case 2:
+                        event->setBufferRangeStart( length / 4 );
+                        event->setBufferRangeEnd( length / 2 );
+                        break;
+                    case 3:
+                        event->setLoopeable( true, 0 );
+                        event->setPlaybackRate( 1.5f );
+                        event->setEventLength( length * 2 );
+                        break;
+                }
+            }
+
+            int maxBufferPosition = nativeEvent->getEventEnd() + expectedBuffer->bufferSize;
+
+            for ( int position = 0; position < maxBufferPosition; position += expectedBuffer->bufferSize )
+            {
+                expectedBuffer->silenceBuffers();
+                compactBuffer->silenceBuffers();
+
+                nativeEvent->mixBuffer ( expectedBuffer, position, 0, maxBufferPosition, false, 0, false );
+                compactEvent->mixBuffer( compactBuffer,  position, 0, maxBufferPosition, false, 0, false );
+
+                for ( int c = 0; c < 2; ++c ) {
+                    for ( int i = 0; i < expectedBuffer->bufferSize; ++i ) {
+                        if ( std::abs( expectedBuffer->getBufferForChannel( c )[ i ] - compactBuffer->getBufferForChannel( c )[ i ]) > tolerance ) {
+                            FAIL() << "expected compact output to equal native output for format " << format
+                                   << " in scenario " << scenario << " at position " << ( position + i );
+                        }
+                    }
+                }
+            }
+            delete nativeEvent;
+            delete compactEvent;
+        }
+        delete compactSample;
+    }
+    delete expectedBuffer;
+    delete compactBuffer;
+    delete instrument;
+    delete sample;
+}
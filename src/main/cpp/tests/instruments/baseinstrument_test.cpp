@@ -1,5 +1,6 @@
 #include "../../instruments/baseinstrument.h"
 #include "../../events/baseaudioevent.h"
+#include "../../events/sampleevent.h"
 #include "../../utilities/eventutility.h"
 #include "../../sequencer.h"
 #include "../../audioengine.h"
@@ -217,9 +218,11 @@ TEST( BaseInstrument, Events )
 
 TEST( BaseInstrument, UpdateEvents )
 {
-    // test for tempo change updates
+    // test for tempo change updates, events follow the tempo through their musical
+    // position, as such a change in bar length should reposition the events
 
-    AudioEngine::tempo = 120.0f;
+    int orgSamplesPerBar = AudioEngine::samples_per_bar;
+    AudioEngine::samples_per_bar = 88200;
 
     BaseInstrument* instrument = new BaseInstrument();
     BaseAudioEvent* event      = new BaseAudioEvent( instrument );
@@ -233,13 +236,14 @@ TEST( BaseInstrument, UpdateEvents )
     event->setEventLength( eventLength );
     event->addToSequencer();
 
-    // increase tempo by given factor
+    // increase tempo by given factor (shortens the bar length by the same factor)
 
     float factor = 2.0f;
 
-    AudioEngine::tempo *= factor;
+    AudioEngine::samples_per_bar = ( int )( AudioEngine::samples_per_bar / factor );
 
     // invoke updateEvents() (would have been executed by the Sequencer when running)
+    // repositioning does not depend on it, but it keeps the measure cache in sync
 
     instrument->updateEvents();
 
@@ -247,29 +251,31 @@ TEST( BaseInstrument, UpdateEvents )
     int expectedEventEnd   = expectedEventStart + ( eventLength - 1 );
 
     EXPECT_EQ( expectedEventStart, event->getEventStart() )
-        << "expected event start offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event start offset to have updated after tempo change";
 
     EXPECT_EQ( expectedEventEnd, event->getEventEnd() )
-        << "expected event end offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event end offset to have updated after tempo change";
 
     EXPECT_EQ( eventLength, event->getEventLength() )
-        << "expected event length not to have updated after tempo change and invocation of updateEvents()";
+        << "expected event length not to have updated after tempo change";
 
     // decrease tempo again by given factor
 
     factor = 0.5f;  // restores to original
-    AudioEngine::tempo *= factor;
+    AudioEngine::samples_per_bar = ( int )( AudioEngine::samples_per_bar / factor );
 
     instrument->updateEvents();
 
     EXPECT_EQ( eventStart, event->getEventStart() )
-        << "expected event start offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event start offset to have updated after tempo change";
 
     EXPECT_EQ(( eventEnd - 1 ), event->getEventEnd() )
-        << "expected event end offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event end offset to have updated after tempo change";
 
     EXPECT_EQ( eventLength, event->getEventLength() )
-        << "expected event length not to have updated after tempo change and invocation of updateEvents()";
+        << "expected event length not to have updated after tempo change";
+
+    AudioEngine::samples_per_bar = orgSamplesPerBar;
 
     delete event;
     delete instrument;
@@ -352,4 +358,196 @@ TEST( BaseInstrument, MeasureCache )
     delete audioEvent2;
     delete audioEvent3;
     delete instrument;
-}
\ No newline at end of file
+}
+TEST( BaseInstrument, BulkEvents )
+{
+    AudioEngine::samples_per_bar = 512;
+    BaseInstrument* instrument = new BaseInstrument();
+
+    std::vector<BaseAudioEvent*> audioEvents;
+    std::vector<BaseAudioEvent*> liveEvents;
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        BaseAudioEvent* audioEvent = new BaseAudioEvent( instrument );
+        audioEvent->setEventStart( i * 256 );
+        audioEvent->setEventLength( 512 );
+        audioEvents.push_back( audioEvent );
+
+        BaseAudioEvent* liveEvent = new BaseAudioEvent( instrument );
+        liveEvent->isSequenced    = false;
+        liveEvents.push_back( liveEvent );
+    }
+
+    // add events (including a duplicate entry)
+
+    audioEvents.push_back( audioEvents.at( 0 ));
+    instrument->addEvents( &audioEvents, false );
+    audioEvents.pop_back();
+
+    EXPECT_EQ( instrument->getEvents()->size(), 8 )
+        << "expected duplicate events to have been added only once";
+
+    ASSERT_FALSE( instrument->hasLiveEvents() )
+        << "expected instrument to contain no live events after addition of sequenced events";
+
+    // adding events that are present already should have no effect
+
+    instrument->addEvents( &audioEvents, false );
+
+    EXPECT_EQ( instrument->getEvents()->size(), 8 )
+        << "expected existing events not to have been added again";
+
+    // events are indexed by measure (each event spans 512 samples, starting every 256 samples)
+
+    EXPECT_EQ( instrument->getEventsForMeasure( 0 )->size(), 2 );
+    EXPECT_EQ( instrument->getEventsForMeasure( 1 )->size(), 3 );
+    EXPECT_EQ( instrument->getEventsForMeasure( 2 )->size(), 3 );
+    EXPECT_EQ( instrument->getEventsForMeasure( 3 )->size(), 3 );
+    EXPECT_EQ( instrument->getEventsForMeasure( 4 )->size(), 1 );
+
+    instrument->addEvents( &liveEvents, true );
+
+    EXPECT_EQ( instrument->getLiveEvents()->size(), 8 )
+        << "expected live events to have been added";
+
+    // remove a subset of the events
+
+    std::vector<BaseAudioEvent*> removals = { audioEvents.at( 1 ), audioEvents.at( 6 ), liveEvents.at( 0 ) };
+
+    EXPECT_EQ( instrument->removeEvents( &removals, false ), 2 )
+        << "expected only the events present in the event list to have been removed";
+
+    EXPECT_EQ( instrument->getEvents()->size(), 6 );
+
+    for ( int i = 0; i < 8; ++i ) {
+        EXPECT_EQ( EventUtility::vectorContainsEvent( instrument->getEvents(), audioEvents.at( i )), i != 1 && i != 6 )
+            << "expected only removed events to be absent from the event list";
+    }
+
+    for ( int measure = 0; measure < 5; ++measure )
+    {
+        auto measureEvents = instrument->getEventsForMeasure( measure );
+        ASSERT_FALSE( EventUtility::vectorContainsEvent( measureEvents, audioEvents.at( 1 )));
+        ASSERT_FALSE( EventUtility::vectorContainsEvent( measureEvents, audioEvents.at( 6 )));
+    }
+    EXPECT_EQ( instrument->getEventsForMeasure( 0 )->size(), 1 );
+    EXPECT_EQ( instrument->getEventsForMeasure( 3 )->size(), 2 );
+
+    EXPECT_EQ( instrument->removeEvents( &removals, true ), 1 )
+        << "expected live event to have been removed";
+
+    EXPECT_EQ( instrument->getLiveEvents()->size(), 7 );
+
+    // clear events
+
+    instrument->clearEvents();
+
+    ASSERT_FALSE( instrument->hasEvents() )
+        << "expected instrument to contain no events after clearing";
+
+    ASSERT_FALSE( instrument->hasLiveEvents() )
+        << "expected instrument to contain no live events after clearing";
+
+    for ( int measure = 0; measure < 5; ++measure ) {
+        EXPECT_EQ( instrument->getEventsForMeasure( measure )->size(), 0 )
+            << "expected measure cache to be empty after clearing";
+    }
+
+    for ( int i = 0; i < 8; ++i ) {
+        delete audioEvents.at( i );
+        delete liveEvents.at( i );
+    }
+    delete instrument;
+}
+
+TEST( BaseInstrument, EventHeaders )
+{
+    int orgSamplesPerBar = AudioEngine::samples_per_bar;
+    AudioEngine::samples_per_bar = 512;
+
+    BaseInstrument* instrument = new BaseInstrument();
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent( instrument );
+    audioEvent->setEventStart( 128 );
+    audioEvent->setEventLength( 256 );
+
+    SampleEvent* sampleEvent = new SampleEvent( instrument );
+    sampleEvent->setEventStart( 640 );
+    sampleEvent->setEventLength( 128 );
+
+    EXPECT_EQ( EventTypes::BASE,   audioEvent->getEventType() );
+    EXPECT_EQ( EventTypes::SAMPLE, sampleEvent->getEventType() );
+
+    ASSERT_TRUE( instrument->getEventHeadersForMeasure( 0 ) == nullptr )
+        << "expected no headers for a measure without events";
+
+    audioEvent->addToSequencer();
+    sampleEvent->addToSequencer();
+
+    std::vector<eventHeader>* headers = instrument->getEventHeadersForMeasure( 0 );
+
+    ASSERT_EQ( 1, headers->size() );
+
+    eventHeader header = headers->at( 0 );
+
+    EXPECT_EQ( audioEvent, header.event );
+    EXPECT_EQ( EventTypes::BASE, header.type );
+    EXPECT_DOUBLE_EQ( audioEvent->getEventStartTicks(), header.start );
+    EXPECT_EQ( audioEvent->getEventEnd() - audioEvent->getEventStart(), header.span );
+    EXPECT_EQ( EVENT_HEADER_ENABLED | EVENT_HEADER_FIXED_DURATION, header.flags )
+        << "expected header to describe the event as enabled, not deletable and of a fixed duration";
+
+    header = instrument->getEventHeadersForMeasure( 1 )->at( 0 );
+
+    EXPECT_EQ( sampleEvent, header.event );
+    EXPECT_EQ( EventTypes::SAMPLE, header.type );
+    EXPECT_DOUBLE_EQ( sampleEvent->getEventStartTicks(), header.start );
+    EXPECT_EQ( sampleEvent->getEventEnd() - sampleEvent->getEventStart(), header.span );
+
+    // changes to the events should be reflected in the headers
+
+    audioEvent->setEnabled( false );
+    audioEvent->setDeletable( true );
+
+    header = instrument->getEventHeadersForMeasure( 0 )->at( 0 );
+
+    EXPECT_EQ( EVENT_HEADER_DELETABLE | EVENT_HEADER_FIXED_DURATION, header.flags )
+        << "expected header to describe the event as disabled and deletable";
+
+    audioEvent->setEventStart( 64 );
+
+    header = instrument->getEventHeadersForMeasure( 0 )->at( 0 );
+
+    EXPECT_DOUBLE_EQ( TICKS_PER_MEASURE / 8.0, header.start );
+    EXPECT_EQ( audioEvent->getEventEnd() - audioEvent->getEventStart(), header.span );
+
+    // changes in tempo leave the headers untouched (events retain their musical position)
+
+    AudioEngine::samples_per_bar = 1024;
+
+    audioEvent->setDeletable( false );
+    audioEvent->setEnabled( true );
+
+    header = instrument->getEventHeadersForMeasure( 0 )->at( 0 );
+
+    EXPECT_DOUBLE_EQ( TICKS_PER_MEASURE / 8.0, header.start )
+        << "expected header position to remain unchanged at the new bar length";
+    EXPECT_EQ( 128, audioEvent->getEventStart() )
+        << "expected event position to have been derived at the new bar length";
+    EXPECT_EQ( EVENT_HEADER_ENABLED | EVENT_HEADER_FIXED_DURATION, header.flags );
+
+    for ( int measure = 0; measure < 2; ++measure )
+    {
+        for ( auto& eventHeader : *instrument->getEventHeadersForMeasure( measure )) {
+            EXPECT_DOUBLE_EQ( eventHeader.event->getEventStartTicks(), eventHeader.start );
+            EXPECT_EQ( eventHeader.event->getEventEnd() - eventHeader.event->getEventStart(), eventHeader.span );
+        }
+    }
+
+    delete audioEvent;
+    delete sampleEvent;
+    delete instrument;
+
+    AudioEngine::samples_per_bar = orgSamplesPerBar;
+}
@@ -4,11 +4,13 @@
 
 TEST( SynthInstrument, UpdateEvents )
 {
-    // test for tempo change updates
-    // this differs from the BaseInstrument as the SynthInstrument invocation of
-    // the method will also adjust the event length values to match the sequencer tempo
+    // test for tempo change updates, events follow the tempo through their musical
+    // position, as such a change in bar length should reposition the events
+    // this differs from the BaseInstrument as the synthesized events will also
+    // adjust their event length values to match the sequencer tempo
 
-    AudioEngine::tempo = 120.F;
+    int orgSamplesPerBar = AudioEngine::samples_per_bar;
+    AudioEngine::samples_per_bar = 88200;
 
     SynthInstrument* instrument = new SynthInstrument();
     BaseSynthEvent* event       = new BaseSynthEvent( 440.F, instrument );
@@ -25,13 +27,14 @@ TEST( SynthInstrument, UpdateEvents )
     event->setEventLength( eventLength );
     event->addToSequencer();
 
-    // increase tempo by given factor
+    // increase tempo by given factor (shortens the bar length by the same factor)
 
     float factor = 2.0F;
 
-    AudioEngine::tempo *= factor;
+    AudioEngine::samples_per_bar = ( int )( AudioEngine::samples_per_bar / factor );
 
     // invoke updateEvents() (would have been executed by the Sequencer when running)
+    // repositioning does not depend on it, but it keeps the measure cache in sync
 
     instrument->updateEvents();
 
@@ -40,29 +43,31 @@ TEST( SynthInstrument, UpdateEvents )
     int expectedEnd    = expectedStart + ( expectedLength - 1 );
 
     EXPECT_EQ( expectedStart, event->getEventStart() )
-        << "expected event start offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event start offset to have updated after tempo change";
 
     EXPECT_EQ( expectedEnd, event->getEventEnd() )
-        << "expected event end offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event end offset to have updated after tempo change";
 
     EXPECT_EQ( expectedLength, event->getEventLength() )
-        << "expected event length to have updated after tempo change and invocation of updateEvents()";
+        << "expected event length to have updated after tempo change";
 
     // decrease tempo again by given factor
 
     factor = 0.5f;  // restores to original
-    AudioEngine::tempo *= factor;
+    AudioEngine::samples_per_bar = ( int )( AudioEngine::samples_per_bar / factor );
 
     instrument->updateEvents();
 
     EXPECT_EQ( eventStart, event->getEventStart() )
-        << "expected event start offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event start offset to have updated after tempo change";
 
     EXPECT_EQ( eventEnd, event->getEventEnd() )
-        << "expected event end offset to have updated after tempo change and invocation of updateEvents()";
+        << "expected event end offset to have updated after tempo change";
 
     EXPECT_EQ( eventLength, event->getEventLength() )
-        << "expected event length not to have updated after tempo change and invocation of updateEvents()";
+        << "expected event length not to have updated after tempo change";
+
+    AudioEngine::samples_per_bar = orgSamplesPerBar;
 
     delete event;
     delete instrument;
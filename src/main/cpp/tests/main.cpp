@@ -31,9 +31,12 @@ using namespace MWEngine;
 
 // NOTE: the audioengine test also sets up the Mocked audio driver
 #include "audioengine_test.cpp"
+#include "audioenginecontext_test.cpp"
+#include "tempomap_test.cpp"
 
 // Unit tests for individual actors
 #include "audiobuffer_test.cpp"
+#include "compactaudiobuffer_test.cpp"
 #include "audiochannel_test.cpp"
 #include "channelgroup_test.cpp"
 #include "processingchain_test.cpp"
@@ -49,7 +52,12 @@ using namespace MWEngine;
 #include "instruments/baseinstrument_test.cpp"
 #include "instruments/synthinstrument_test.cpp"
 #include "modules/adsr_test.cpp"
+#include "modules/biquad_test.cpp"
+#include "modules/delayline_test.cpp"
 #include "modules/lfo_test.cpp"
+#include "modules/oversampler_test.cpp"
+#include "modules/resampler_test.cpp"
+#include "modules/statevariablefilter_test.cpp"
 #include "processors/baseprocessor_test.cpp"
 #include "processors/bitcrusher_test.cpp"
 #include "processors/dcoffsetfilter_test.cpp"
@@ -61,6 +69,7 @@ using namespace MWEngine;
 #include "processors/formantfilter_test.cpp"
 #include "processors/glitcher_test.cpp"
 #include "processors/limiter_test.cpp"
+#include "processors/lookaheadlimiter_test.cpp"
 #include "processors/lowpassfilter_test.cpp"
 #include "processors/lpfhpfilter_test.cpp"
 #include "processors/phaser_test.cpp"
@@ -70,11 +79,19 @@ using namespace MWEngine;
 #include "processors/tremolo_test.cpp"
 #include "processors/waveshaper_test.cpp"
 #include "utilities/eventutility_test.cpp"
+#include "utilities/blockallocator_test.cpp"
 #include "utilities/tablepool_test.cpp"
+#include "utilities/samplecache_test.cpp"
+#include "utilities/sampleloader_test.cpp"
 #include "utilities/samplemanager_test.cpp"
+#include "utilities/samplestream_test.cpp"
 #include "utilities/sampleutility_test.cpp"
+#include "utilities/diskwriter_test.cpp"
+#include "utilities/stemexporter_test.cpp"
+#include "utilities/wavereader_test.cpp"
 #include "utilities/waveutil_test.cpp"
 #include "utilities/volumeutil_test.cpp"
+#include "utilities/perfutility_test.cpp"
 #include "deprecation_test.cpp"
 
 // the following aren't unit tests to spot regressions, but benchmarks to test certain performance assumptions
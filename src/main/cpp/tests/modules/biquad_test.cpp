@@ -0,0 +1,134 @@
+#include <modules/biquad.h>
+
+TEST( Biquad, Construction )
+{
+    int channels = randomInt( 1, 4 );
+    int sections = randomInt( 1, 5 );
+
+    Biquad* biquad = new Biquad( channels, sections );
+
+    EXPECT_EQ( channels, biquad->getAmountOfChannels() )
+        << "expected amount of channels to equal the value given to the constructor";
+
+    EXPECT_EQ( sections, biquad->getAmountOfSections() )
+        << "expected amount of sections to equal the value given to the constructor";
+
+    EXPECT_EQ( 0, biquad->getSmoothing() )
+        << "expected coefficient smoothing to be disabled by default";
+
+    delete biquad;
+}
+
+TEST( Biquad, PassThroughByDefault )
+{
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, 64 ));
+    AudioBuffer* source = buffer->clone();
+
+    Biquad* biquad = new Biquad( 2, randomInt( 1, 3 ));
+    biquad->process( buffer, false );
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            EXPECT_FLOAT_EQ( source->getBufferForChannel( c )[ i ], buffer->getBufferForChannel( c )[ i ])
+                << "expected unaltered signal for a filter without coefficients";
+        }
+    }
+    delete biquad;
+    delete buffer;
+    delete source;
+}
+
+TEST( Biquad, ChannelPairsEqualSingleChannelProcessing )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    int bufferSize      = 128;
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 3, bufferSize ));
+    AudioBuffer* source = buffer->clone();
+
+    Biquad* multi  = new Biquad( 3, 2 );
+    Biquad* single = new Biquad( 3, 2 );
+
+    multi->setLowPass ( 880.f, 0.707f, 0 );
+    multi->setHighPass( 110.f, 0.707f, 1 );
+    single->setLowPass ( 880.f, 0.707f, 0 );
+    single->setHighPass( 110.f, 0.707f, 1 );
+
+    multi->process( buffer, false );
+
+    for ( int c = 0; c < source->amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* expected = source->getBufferForChannel( c );
+        single->process( expected, bufferSize, c );
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            EXPECT_FLOAT_EQ( expected[ i ], buffer->getBufferForChannel( c )[ i ])
+                << "expected paired processing to equal processing of the individual channel";
+        }
+    }
+    delete multi;
+    delete single;
+    delete buffer;
+    delete source;
+}
+
+TEST( Biquad, StoreRestore )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    Biquad* biquad = new Biquad( 1 );
+    biquad->setLowPass( 440.f, 1.1f );
+
+    for ( int i = 0; i < 16; ++i )
+        biquad->processSingle( randomSample( -1.0, 1.0 ), 0 );
+
+    biquad->store();
+
+    SAMPLE_TYPE input   = randomSample( -1.0, 1.0 );
+    SAMPLE_TYPE output1 = biquad->processSingle( input, 0 );
+
+    biquad->restore();
+
+    SAMPLE_TYPE output2 = biquad->processSingle( input, 0 );
+
+    EXPECT_FLOAT_EQ( output1, output2 )
+        << "expected the same output after restoring the stored state";
+
+    delete biquad;
+}
+
+TEST( Biquad, Smoothing )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    int smoothing = 32;
+    Biquad* biquad = new Biquad( 1 );
+    biquad->setSmoothing( smoothing );
+
+    EXPECT_EQ( smoothing, biquad->getSmoothing() )
+        << "expected smoothing to equal the set value";
+
+    // a gain change glides from unity towards the target over the smoothing period
+
+    biquad->setCoefficients( 0.5, 0.0, 0.0, 0.0, 0.0 );
+
+    AudioBuffer* buffer = new AudioBuffer( 1, smoothing * 2 );
+    for ( int i = 0; i < buffer->bufferSize; ++i )
+        buffer->getBufferForChannel( 0 )[ i ] = 1.0;
+
+    biquad->process( buffer, false );
+
+    SAMPLE_TYPE* samples = buffer->getBufferForChannel( 0 );
+
+    EXPECT_TRUE( samples[ 0 ] < 1.0 && samples[ 0 ] > 0.5 )
+        << "expected first sample to be in between the old and new gain";
+
+    EXPECT_FLOAT_EQ( 0.5, samples[ smoothing - 1 ] )
+        << "expected gain to have reached its target at the end of the smoothing period";
+
+    EXPECT_FLOAT_EQ( 0.5, samples[ buffer->bufferSize - 1 ] )
+        << "expected gain to remain at its target after the smoothing period";
+
+    delete buffer;
+    delete biquad;
+}
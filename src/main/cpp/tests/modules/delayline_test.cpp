@@ -0,0 +1,50 @@
+#include <modules/delayline.h>
+
+TEST( DelayLine, PowerOfTwoSize )
+{
+    DelayLine* line = new DelayLine( 1000 );
+
+    EXPECT_GE( line->getMaxDelay(), 1000 ) << "expected line to be able to hold the requested delay";
+    EXPECT_EQ( 0, ( line->getMaxDelay() + 2 ) & ( line->getMaxDelay() + 1 ))
+        << "expected buffer size to be a power of two";
+
+    delete line;
+}
+
+TEST( DelayLine, ReadWrite )
+{
+    DelayLine* line = new DelayLine( 64 );
+    int delay       = randomInt( 1, 64 );
+
+    // write more samples than the line holds to ensure wrapping
+
+    for ( int i = 0; i < 200; ++i )
+    {
+        SAMPLE_TYPE expected = ( i >= delay ) ? ( SAMPLE_TYPE )( i - delay ) : 0.0;
+
+        EXPECT_EQ( expected, line->read( delay )) << "expected sample written " << delay << " samples ago";
+
+        line->write(( SAMPLE_TYPE ) i );
+    }
+    delete line;
+}
+
+TEST( DelayLine, ReadInterpolated )
+{
+    DelayLine* line = new DelayLine( 16 );
+
+    for ( int i = 0; i < 8; ++i )
+        line->write(( SAMPLE_TYPE ) i );
+
+    // last written sample (7) is at a delay of 1, a ramp thus interpolates linearly
+
+    EXPECT_DOUBLE_EQ( 7.0, line->readInterpolated( 1.0 ));
+    EXPECT_DOUBLE_EQ( 6.5, line->readInterpolated( 1.5 ));
+    EXPECT_DOUBLE_EQ( 4.25, line->readInterpolated( 3.75 ));
+
+    line->clear();
+
+    EXPECT_EQ( 0.0, line->readInterpolated( 2.5 )) << "expected line to have been cleared";
+
+    delete line;
+}
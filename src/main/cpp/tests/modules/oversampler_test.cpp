@@ -0,0 +1,96 @@
+#include <modules/oversampler.h>
+
+TEST( Oversampler, Construction )
+{
+    Oversampler* oversampler = new Oversampler( 2, 4 );
+    EXPECT_EQ( 4, oversampler->getFactor() ) << "expected factor to equal the constructor argument";
+    delete oversampler;
+
+    oversampler = new Oversampler( 2, 16 );
+    EXPECT_EQ( Oversampler::MAX_FACTOR, oversampler->getFactor() ) << "expected factor to be clamped to the maximum";
+    delete oversampler;
+}
+
+TEST( Oversampler, Latency )
+{
+    Oversampler* oversampler2x = new Oversampler( 1, 2 );
+    Oversampler* oversampler8x = new Oversampler( 1, 8 );
+
+    EXPECT_GT( oversampler2x->getLatency(), 0.f ) << "expected latency to be reported";
+    EXPECT_GT( oversampler8x->getLatency(), oversampler2x->getLatency() ) << "expected latency to increase with each stage";
+
+    delete oversampler2x;
+    delete oversampler8x;
+}
+
+TEST( Oversampler, UpsampledBufferSize )
+{
+    int bufferSize           = 64;
+    int factor               = 4;
+    AudioBuffer* buffer      = new AudioBuffer( 2, bufferSize );
+    Oversampler* oversampler = new Oversampler( 2, factor );
+
+    AudioBuffer* oversampled = oversampler->upsample( buffer, false );
+
+    EXPECT_EQ( bufferSize * factor, oversampled->bufferSize ) << "expected oversampled buffer to be factor times the size";
+    EXPECT_EQ( buffer->amountOfChannels, oversampled->amountOfChannels ) << "expected equal amount of channels";
+
+    delete oversampler;
+    delete buffer;
+}
+
+TEST( Oversampler, RoundTripDelaysSignal )
+{
+    int bufferSize           = 64;
+    int amountOfBuffers      = 4;
+    Oversampler* oversampler = new Oversampler( 2, 2 );
+    int latency              = ( int ) oversampler->getLatency();
+
+    // a sine well below the filters cutoff should pass unaltered (albeit delayed)
+
+    SAMPLE_TYPE frequency = 1000.0 / 48000.0;
+    std::vector<SAMPLE_TYPE> input;
+    std::vector<SAMPLE_TYPE> output;
+
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    for ( int b = 0; b < amountOfBuffers; ++b )
+    {
+        for ( int i = 0; i < bufferSize; ++i ) {
+            SAMPLE_TYPE sample = sin( TWO_PI * frequency * ( b * bufferSize + i ));
+            input.push_back( sample );
+            buffer->getBufferForChannel( 0 )[ i ] = sample;
+            buffer->getBufferForChannel( 1 )[ i ] = sample;
+        }
+        oversampler->upsample( buffer, false );
+        oversampler->downsample( buffer, false );
+
+        for ( int i = 0; i < bufferSize; ++i )
+            output.push_back( buffer->getBufferForChannel( 1 )[ i ]);
+    }
+
+    // skip the onset transient (the length of the filters)
+
+    for ( size_t i = latency * 2; i < output.size(); ++i ) {
+        EXPECT_NEAR( input[ i - latency ], output[ i ], 0.001 )
+            << "expected output to equal the input delayed by the reported latency";
+    }
+    delete oversampler;
+    delete buffer;
+}
+
+TEST( Oversampler, MonoSource )
+{
+    AudioBuffer* buffer      = fillAudioBuffer( new AudioBuffer( 2, 64 ));
+    Oversampler* oversampler = new Oversampler( 2, 4 );
+
+    oversampler->upsample( buffer, true );
+    oversampler->downsample( buffer, true );
+
+    for ( int i = 0; i < buffer->bufferSize; ++i ) {
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+            << "expected mono source to be copied into the remaining channels";
+    }
+    delete oversampler;
+    delete buffer;
+}
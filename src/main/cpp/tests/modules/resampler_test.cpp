@@ -0,0 +1,104 @@
+#include <modules/resampler.h>
+
+// fills given buffer with a sine of given frequency (in Hz) at given sample rate
+
+void fillSine( AudioBuffer* buffer, SAMPLE_TYPE frequency, unsigned int sampleRate )
+{
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer->bufferSize; ++i )
+            buffer->getBufferForChannel( c )[ i ] = sin( TWO_PI * frequency * i / sampleRate );
+    }
+}
+
+TEST( Resampler, OutputLength )
+{
+    EXPECT_EQ( 48000, Resampler::getOutputLength( 44100, 44100, 48000 ));
+    EXPECT_EQ( 22050, Resampler::getOutputLength( 48000, 48000, 22050 ));
+    EXPECT_EQ( 1000,  Resampler::getOutputLength( 1000, 48000, 48000 ));
+    EXPECT_EQ( 2,     Resampler::getOutputLength( 1, 44100, 48000 )) << "expected length to be rounded up";
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 44100 );
+    AudioBuffer* output = Resampler::resample( buffer, 44100, 48000 );
+
+    EXPECT_EQ( 48000, output->bufferSize );
+    EXPECT_EQ( 2, output->amountOfChannels );
+
+    delete output;
+    delete buffer;
+}
+
+TEST( Resampler, EqualRatesCopy )
+{
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, 512 ));
+    AudioBuffer* output = Resampler::resample( buffer, 48000, 48000 );
+
+    ASSERT_FALSE( output == buffer ) << "expected a new buffer to be returned";
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < 512; ++i )
+            EXPECT_EQ( buffer->getBufferForChannel( c )[ i ], output->getBufferForChannel( c )[ i ]);
+    }
+    delete output;
+    delete buffer;
+}
+
+TEST( Resampler, Upsample )
+{
+    // a sine resampled from 44.1 kHz to 48 kHz should equal the same sine generated at 48 kHz
+
+    SAMPLE_TYPE frequency = randomInt( 100, 10000 );
+
+    AudioBuffer* buffer   = new AudioBuffer( 1, 44100 );
+    AudioBuffer* expected = new AudioBuffer( 1, 48000 );
+
+    fillSine( buffer, frequency, 44100 );
+    fillSine( expected, frequency, 48000 );
+
+    AudioBuffer* output = Resampler::resample( buffer, 44100, 48000 );
+
+    // skip the edges of the buffer, where the filter reads beyond the input
+
+    SAMPLE_TYPE maxError = 0.0;
+
+    for ( int i = Resampler::TAPS; i < output->bufferSize - Resampler::TAPS * 2; ++i )
+        maxError = std::max( maxError, fabs( output->getBufferForChannel( 0 )[ i ] - expected->getBufferForChannel( 0 )[ i ]));
+
+    EXPECT_LT( maxError, 1e-3 ) << "expected resampled sine of " << frequency << " Hz to equal the reference";
+
+    delete output;
+    delete expected;
+    delete buffer;
+}
+
+TEST( Resampler, DownsampleFiltersAliasing )
+{
+    // a sine above the Nyquist frequency of the target rate should be filtered out
+
+    AudioBuffer* buffer = new AudioBuffer( 1, 48000 );
+    fillSine( buffer, 18000, 48000 );
+
+    AudioBuffer* output = Resampler::resample( buffer, 48000, 22050 );
+
+    SAMPLE_TYPE peak = 0.0;
+
+    for ( int i = Resampler::TAPS * 2; i < output->bufferSize - Resampler::TAPS * 2; ++i )
+        peak = std::max( peak, fabs( output->getBufferForChannel( 0 )[ i ]));
+
+    EXPECT_LT( peak, 1e-2 ) << "expected content above the target Nyquist frequency to be attenuated";
+
+    // while content below the target Nyquist frequency passes
+
+    fillSine( buffer, 1000, 48000 );
+    delete output;
+    output = Resampler::resample( buffer, 48000, 22050 );
+
+    peak = 0.0;
+
+    for ( int i = Resampler::TAPS * 2; i < output->bufferSize - Resampler::TAPS * 2; ++i )
+        peak = std::max( peak, fabs( output->getBufferForChannel( 0 )[ i ]));
+
+    EXPECT_NEAR( 1.0, peak, 1e-2 ) << "expected content below the target Nyquist frequency to pass";
+
+    delete output;
+    delete buffer;
+}
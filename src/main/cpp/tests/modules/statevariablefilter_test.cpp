@@ -0,0 +1,86 @@
+#include <modules/statevariablefilter.h>
+
+TEST( StateVariableFilter, GettersSetters )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    StateVariableFilter* filter = new StateVariableFilter( 2 );
+
+    EXPECT_EQ( 2, filter->getAmountOfChannels() )
+        << "expected amount of channels to equal the value given to the constructor";
+
+    EXPECT_EQ( StateVariableFilter::LOW_PASS, filter->getType() )
+        << "expected filter to be a low pass filter by default";
+
+    float cutoff  = randomFloat( 40.f, 8000.f );
+    float damping = randomFloat( 0.1f, 2.f );
+
+    filter->setCutoff( cutoff );
+    filter->setDamping( damping );
+    filter->setType( StateVariableFilter::HIGH_PASS );
+
+    EXPECT_FLOAT_EQ( cutoff, filter->getCutoff() );
+    EXPECT_FLOAT_EQ( damping, filter->getDamping() );
+    EXPECT_EQ( StateVariableFilter::HIGH_PASS, filter->getType() );
+
+    filter->setCutoff( AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_TRUE( filter->getCutoff() < AudioEngineProps::SAMPLE_RATE / 2 )
+        << "expected cutoff to be kept below the Nyquist frequency";
+
+    delete filter;
+}
+
+TEST( StateVariableFilter, Response )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    int bufferSize = 4096;
+
+    StateVariableFilter* lowPass  = new StateVariableFilter( 1, StateVariableFilter::LOW_PASS );
+    StateVariableFilter* highPass = new StateVariableFilter( 1, StateVariableFilter::HIGH_PASS );
+
+    lowPass->setCutoff( 200.f );
+    highPass->setCutoff( 200.f );
+
+    // feed DC signal
+
+    AudioBuffer* lowBuffer  = new AudioBuffer( 1, bufferSize );
+    AudioBuffer* highBuffer = new AudioBuffer( 1, bufferSize );
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        lowBuffer->getBufferForChannel( 0 )[ i ]  = 1.0;
+        highBuffer->getBufferForChannel( 0 )[ i ] = 1.0;
+    }
+    lowPass->process( lowBuffer, false );
+    highPass->process( highBuffer, false );
+
+    EXPECT_NEAR( 1.0, lowBuffer->getBufferForChannel( 0 )[ bufferSize - 1 ], 0.001 )
+        << "expected low pass filter to pass DC";
+
+    EXPECT_NEAR( 0.0, highBuffer->getBufferForChannel( 0 )[ bufferSize - 1 ], 0.001 )
+        << "expected high pass filter to block DC";
+
+    delete lowPass;
+    delete highPass;
+    delete lowBuffer;
+    delete highBuffer;
+}
+
+TEST( StateVariableFilter, MonoSource )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, 64 ));
+    StateVariableFilter* filter = new StateVariableFilter( 2 );
+
+    filter->setCutoff( 1000.f );
+    filter->process( buffer, true );
+
+    for ( int i = 0; i < buffer->bufferSize; ++i ) {
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+            << "expected mono source to have its processed contents copied into the remaining channels";
+    }
+    delete filter;
+    delete buffer;
+}
@@ -28,3 +28,69 @@ TEST( BaseProcessor, getType )
 
     delete processor;
 }
+
+TEST( BaseProcessor, Oversampling )
+{
+    BaseProcessor* processor = new BaseProcessor();
+
+    EXPECT_EQ( 1, processor->getOversampling() ) << "expected oversampling to be disabled by default";
+    EXPECT_EQ( 0, processor->getLatency() )      << "expected no latency by default";
+
+    processor->setOversampling( 4 );
+
+    EXPECT_EQ( 4, processor->getOversampling() ) << "expected oversampling factor to have been applied";
+    EXPECT_GT( processor->getLatency(), 0 )      << "expected oversampling to introduce latency";
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 64 );
+    buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+
+    processor->apply( buffer, false );
+
+    EXPECT_EQ( 64, buffer->bufferSize ) << "expected buffer size to remain unchanged";
+
+    processor->setOversampling( 1 );
+
+    EXPECT_EQ( 1, processor->getOversampling() ) << "expected oversampling to have been disabled";
+    EXPECT_EQ( 0, processor->getLatency() )      << "expected no latency when oversampling is disabled";
+
+    delete buffer;
+    delete processor;
+}
+
+// exposes the Oversamplers retired by setOversampling()
+
+class RetiringProcessor : public BaseProcessor
+{
+    public:
+        size_t getRetiredOversamplers() {
+            return _retiredOversamplers.size();
+        }
+};
+
+TEST( BaseProcessor, OversamplingRetirement )
+{
+    RetiringProcessor* processor = new RetiringProcessor();
+    AudioBuffer* buffer          = new AudioBuffer( 2, 64 );
+
+    processor->setOversampling( 2 );
+    processor->apply( buffer, false );
+    processor->setOversampling( 4 );
+
+    EXPECT_EQ( 1, processor->getRetiredOversamplers() )
+        << "expected replaced Oversampler to be retained as it could be in use by the render thread";
+
+    processor->setOversampling( 8 );
+
+    EXPECT_EQ( 2, processor->getRetiredOversamplers() )
+        << "expected replaced Oversamplers to be retained while the render thread hasn't applied their successor";
+
+    processor->apply( buffer, false );
+    processor->setOversampling( 1 );
+
+    EXPECT_EQ( 1, processor->getRetiredOversamplers() )
+        << "expected replaced Oversamplers to be disposed once the render thread has applied their successor";
+    EXPECT_EQ( 1, processor->getOversampling() );
+
+    delete buffer;
+    delete processor;
+}
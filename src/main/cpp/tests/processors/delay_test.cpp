@@ -86,4 +86,114 @@ TEST( Delay, getType )
     ASSERT_TRUE( 0 == expectedType.compare( processor->getType() ));
 
     delete processor;
-}
\ No newline at end of file
+}
+
+TEST( Delay, DelaysSignal )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    // 2 ms at 48 kHz equals 96 samples, full wet mix without feedback
+
+    Delay* delay        = new Delay( 2, 10, 1.f, 0.f, 1 );
+    AudioBuffer* buffer = new AudioBuffer( 1, 128 );
+
+    buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+
+    delay->process( buffer, false );
+
+    for ( int i = 1; i < buffer->bufferSize; ++i ) {
+        EXPECT_EQ(( i == 96 ) ? 1.0 : 0.0, buffer->getBufferForChannel( 0 )[ i ])
+            << "expected impulse to be repeated after the delay time only";
+    }
+    delete delay;
+    delete buffer;
+}
+
+TEST( Delay, TempoSync )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    int samplesPerBeat = AudioEngine::samples_per_beat;
+    AudioEngine::samples_per_beat = 24000; // 120 BPM at 48 kHz
+
+    Delay* delay = new Delay( 100, 1000, 0.5f, 0.5f, 1 );
+
+    delay->setTempoSync( 0.5f );
+
+    EXPECT_EQ( 0.5f, delay->getTempoSync() );
+    EXPECT_EQ( 250, delay->getDelayTime() ) << "expected an eighth note at 120 BPM";
+
+    // tempo change is applied upon next process() invocation
+
+    AudioEngine::samples_per_beat = 48000; // 60 BPM
+    AudioBuffer* buffer = new AudioBuffer( 1, 16 );
+    delay->process( buffer, false );
+
+    EXPECT_EQ( 500, delay->getDelayTime() ) << "expected delay time to follow the tempo change";
+
+    delay->setDelayTime( 100 );
+
+    EXPECT_EQ( 0.f, delay->getTempoSync() ) << "expected setting an explicit time to disable tempo sync";
+
+    AudioEngine::samples_per_beat = samplesPerBeat;
+
+    delete delay;
+    delete buffer;
+}
+
+TEST( Delay, PingPong )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    // 1 ms at 48 kHz equals 48 samples
+
+    Delay* delay        = new Delay( 1, 10, 1.f, 1.f, 2 );
+    AudioBuffer* buffer = new AudioBuffer( 2, 160 );
+
+    delay->setMode( Delay::PING_PONG );
+    EXPECT_EQ( Delay::PING_PONG, delay->getMode() );
+
+    buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+
+    delay->process( buffer, true );
+
+    SAMPLE_TYPE* left  = buffer->getBufferForChannel( 0 );
+    SAMPLE_TYPE* right = buffer->getBufferForChannel( 1 );
+
+    EXPECT_EQ( 0.0, right[ 48 ] ) << "expected first repeat in the left channel only";
+    EXPECT_GT( left[ 48 ], 0.0 )  << "expected first repeat in the left channel";
+    EXPECT_EQ( 0.0, left[ 96 ] )  << "expected second repeat in the right channel only";
+    EXPECT_GT( right[ 96 ], 0.0 ) << "expected second repeat in the right channel";
+    EXPECT_GT( left[ 144 ], 0.0 ) << "expected third repeat in the left channel";
+
+    delete delay;
+    delete buffer;
+}
+
+TEST( Delay, MultiTap )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    Delay* delay        = new Delay( 2, 10, 1.f, 0.f, 1 );
+    AudioBuffer* buffer = new AudioBuffer( 1, 128 );
+
+    delay->setMode( Delay::MULTI_TAP );
+    EXPECT_TRUE( delay->addTap( 0.25f, 0.5f ));
+
+    buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+
+    delay->process( buffer, false );
+
+    EXPECT_EQ( 0.5, buffer->getBufferForChannel( 0 )[ 24 ]) << "expected tap at a quarter of the delay time";
+    EXPECT_EQ( 1.0, buffer->getBufferForChannel( 0 )[ 96 ]) << "expected repeat at the delay time";
+
+    delay->removeTaps();
+
+    for ( int i = 0; i < Delay::MAX_TAPS; ++i )
+        EXPECT_TRUE( delay->addTap( 0.5f, 0.5f ));
+
+    EXPECT_FALSE( delay->addTap( 0.5f, 0.5f )) << "expected taps to be capped at MAX_TAPS";
+
+    delete delay;
+    delete buffer;
+}
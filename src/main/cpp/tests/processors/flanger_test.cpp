@@ -85,4 +85,28 @@ TEST( Flanger, getType )
     ASSERT_TRUE( 0 == expectedType.compare( processor->getType() ));
 
     delete processor;
-}
\ No newline at end of file
+}
+
+TEST( Flanger, ChannelsProcessedIdentically )
+{
+    AudioEngineProps::SAMPLE_RATE     = 48000;
+    AudioEngineProps::OUTPUT_CHANNELS = 2;
+
+    Flanger* flanger    = new Flanger( 0.5f, 0.8f, 0.6f, 0.3f, 1.f );
+    AudioBuffer* buffer = new AudioBuffer( 2, 256 );
+
+    for ( int iteration = 0; iteration < 3; ++iteration )
+    {
+        fillAudioBuffer( buffer );
+        memcpy( buffer->getBufferForChannel( 1 ), buffer->getBufferForChannel( 0 ), buffer->bufferSize * sizeof( SAMPLE_TYPE ));
+
+        flanger->process( buffer, false );
+
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+                << "expected equal input on both channels to result in equal output";
+        }
+    }
+    delete flanger;
+    delete buffer;
+}
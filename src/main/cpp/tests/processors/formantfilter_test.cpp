@@ -9,3 +9,25 @@ TEST( FormantFilter, getType )
 
     delete processor;
 }
+
+TEST( FormantFilter, Process )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    FormantFilter* processor = new FormantFilter( randomFloat( 0.f, 4.f ));
+    AudioBuffer* buffer      = fillAudioBuffer( new AudioBuffer( 2, 2048 ));
+
+    processor->process( buffer, false );
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            ASSERT_TRUE( std::isfinite( buffer->getBufferForChannel( c )[ i ] ))
+                << "expected the filter cascade to remain stable";
+        }
+    }
+    ASSERT_TRUE( bufferHasContent( buffer ))
+        << "expected filtered buffer to have content";
+
+    delete buffer;
+    delete processor;
+}
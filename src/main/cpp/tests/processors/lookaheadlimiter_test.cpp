@@ -0,0 +1,86 @@
+#include <processors/lookaheadlimiter.h>
+
+TEST( LookAheadLimiter, getType )
+{
+    LookAheadLimiter* processor = new LookAheadLimiter();
+
+    std::string expectedType( "LookAheadLimiter" );
+    ASSERT_TRUE( 0 == expectedType.compare( processor->getType() ));
+
+    delete processor;
+}
+
+TEST( LookAheadLimiter, Latency )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    LookAheadLimiter* processor = new LookAheadLimiter( -1.f, 2.f, 50.f );
+
+    // 2 ms at 48 kHz equals 96 samples of look-ahead
+    EXPECT_EQ( 96 - 1 + LookAheadLimiter::TRUE_PEAK_DELAY, processor->getLatency() )
+        << "expected latency to equal the look-ahead and peak detection delay";
+
+    processor->setLookAhead( 1.f );
+
+    EXPECT_EQ( 48 - 1 + LookAheadLimiter::TRUE_PEAK_DELAY, processor->getLatency() )
+        << "expected latency to have been updated";
+
+    delete processor;
+}
+
+TEST( LookAheadLimiter, QuietSignalPassesUnaltered )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    LookAheadLimiter* processor = new LookAheadLimiter( -0.3f, 1.f, 50.f );
+    int latency = processor->getLatency();
+
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, 256 ));
+    buffer->adjustBufferVolumes( 0.5 ); // well below the ceiling
+    AudioBuffer* source = buffer->clone();
+
+    processor->process( buffer, false );
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            SAMPLE_TYPE expected = ( i < latency ) ? 0.0 : source->getBufferForChannel( c )[ i - latency ];
+            EXPECT_FLOAT_EQ( expected, buffer->getBufferForChannel( c )[ i ])
+                << "expected signal below the ceiling to be delayed by the latency only";
+        }
+    }
+    EXPECT_FLOAT_EQ( 1.f, processor->getLinearGR() ) << "expected no gain reduction";
+
+    delete processor;
+    delete buffer;
+    delete source;
+}
+
+TEST( LookAheadLimiter, OutputDoesNotExceedCeiling )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    float ceilingDb             = -3.f;
+    SAMPLE_TYPE ceiling         = pow( 10.0, ceilingDb / 20.0 );
+    LookAheadLimiter* processor = new LookAheadLimiter( ceilingDb, 1.5f, 20.f );
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 512 );
+
+    for ( int iteration = 0; iteration < 8; ++iteration )
+    {
+        fillAudioBuffer( buffer );
+        buffer->adjustBufferVolumes( randomFloat( 1.f, 8.f )); // hot signal
+
+        processor->process( buffer, false );
+
+        for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+            for ( int i = 0; i < buffer->bufferSize; ++i ) {
+                EXPECT_LE( fabs( buffer->getBufferForChannel( c )[ i ]), ceiling + 1e-9 )
+                    << "expected output not to exceed the ceiling";
+            }
+        }
+    }
+    EXPECT_LT( processor->getLinearGR(), 1.f ) << "expected gain to have been reduced";
+
+    delete processor;
+    delete buffer;
+}
@@ -9,3 +9,46 @@ TEST( Phaser, getType )
 
     delete processor;
 }
+
+TEST( Phaser, ChannelsProcessedIdentically )
+{
+    AudioEngineProps::SAMPLE_RATE = 48000;
+
+    Phaser* processor   = new Phaser( 2.F, 0.7F, 1.F, 200.F, 1760.F, 2 );
+    AudioBuffer* buffer = new AudioBuffer( 2, 500 ); // not a multiple of the control rate
+
+    for ( int iteration = 0; iteration < 3; ++iteration )
+    {
+        fillAudioBuffer( buffer );
+        memcpy( buffer->getBufferForChannel( 1 ), buffer->getBufferForChannel( 0 ), buffer->bufferSize * sizeof( SAMPLE_TYPE ));
+
+        processor->process( buffer, false );
+
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+                << "expected equal input on both channels to result in equal output";
+        }
+    }
+    delete processor;
+    delete buffer;
+}
+
+TEST( Phaser, MonoSource )
+{
+    Phaser* processor   = new Phaser( 1.F, 0.5F, 0.5F, 40.F, 880.F, 2 );
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, 64 ));
+    AudioBuffer* source = buffer->clone();
+
+    processor->process( buffer, true );
+
+    EXPECT_FALSE( buffer->getBufferForChannel( 0 )[ 63 ] == source->getBufferForChannel( 0 )[ 63 ])
+        << "expected signal to have been processed";
+
+    for ( int i = 0; i < buffer->bufferSize; ++i ) {
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+            << "expected mono source to be copied into the remaining channels";
+    }
+    delete processor;
+    delete buffer;
+    delete source;
+}
@@ -60,17 +60,20 @@ TEST( SequencerController, GetSetTempo )
 
     controller->setTempo( newTempo, 12, 8 );
 
-    EXPECT_EQ( orgTempo, controller->getTempo() )
-        << "expected SequencerController to not have updated the tempo to the new value immediately";
+    // the tempo is applied onto the transport right away, the render
+    // thread moves to the new tempo at the start of its next render cycle
+
+    EXPECT_EQ( newTempo, controller->getTempo() )
+        << "expected SequencerController to have applied the tempo onto the transport";
 
     EXPECT_EQ( newTempo, AudioEngine::queuedTempo )
         << "expected SequencerController to have enqueued the requested tempo into the AudioEngine";
 
-    EXPECT_EQ( 3, AudioEngine::time_sig_beat_amount )
-        << "expected SequencerController to not have updated the time signature immediately";
+    EXPECT_EQ( 12, AudioEngine::time_sig_beat_amount )
+        << "expected SequencerController to have applied the time signature onto the transport";
 
-    EXPECT_EQ( 4, AudioEngine::time_sig_beat_unit )
-        << "expected SequencerController to not have updated the time signature immediately";
+    EXPECT_EQ( 8, AudioEngine::time_sig_beat_unit )
+        << "expected SequencerController to have applied the time signature onto the transport";
 
     EXPECT_EQ( 12, AudioEngine::queuedTime_sig_beat_amount )
         << "expected SequencerController to have enqueued the requested time signature";
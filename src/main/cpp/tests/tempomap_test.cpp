@@ -0,0 +1,169 @@
+#include <tempomap.h>
+#include <audioengine.h>
+#include <sequencer.h>
+#include <events/baseaudioevent.h>
+#include <instruments/baseinstrument.h>
+
+TEST( TempoMap, ConstantTempo )
+{
+    unsigned int orgSampleRate = AudioEngineProps::SAMPLE_RATE;
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    // at 120 BPM in 4/4 time a single measure lasts for 2 seconds
+
+    TempoMap* tempoMap = new TempoMap( 120.F, 4, 4 );
+
+    EXPECT_EQ( 0,      tempoMap->getMeasureStart( 0 ));
+    EXPECT_EQ( 88200,  tempoMap->getMeasureStart( 1 ));
+    EXPECT_EQ( 176400, tempoMap->getMeasureStart( 2 ));
+    EXPECT_EQ( 88200,  tempoMap->getShortestBarLength() );
+
+    EXPECT_EQ( 132300, tempoMap->ticksToSamples( TICKS_PER_MEASURE * 1.5 ));
+    EXPECT_DOUBLE_EQ( TICKS_PER_MEASURE * 1.5, tempoMap->samplesToTicks( 132300 ));
+
+    EXPECT_FLOAT_EQ( 120.F, tempoMap->getTempo( randomInt( 0, TICKS_PER_MEASURE * 16 )));
+    EXPECT_EQ( 4, tempoMap->getTimeSigBeatAmount( randomInt( 0, 16 )));
+    EXPECT_EQ( 4, tempoMap->getTimeSigBeatUnit( randomInt( 0, 16 )));
+
+    delete tempoMap;
+
+    AudioEngineProps::SAMPLE_RATE = orgSampleRate;
+}
+
+TEST( TempoMap, TempoAndTimeSignatureChanges )
+{
+    unsigned int orgSampleRate = AudioEngineProps::SAMPLE_RATE;
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    TempoMap* tempoMap = new TempoMap( 120.F, 4, 4 );
+    unsigned int version = tempoMap->getVersion();
+
+    // 2nd measure is in 3/4 time, 3rd measure is at 60 BPM
+
+    tempoMap->addTimeSignatureChange( 1, 3, 4 );
+    tempoMap->addTempoChange( TICKS_PER_MEASURE * 2, 60.F, false );
+
+    EXPECT_NE( version, tempoMap->getVersion() ) << "expected version to have changed after altering the map";
+
+    EXPECT_EQ( 3, tempoMap->getTimeSigBeatAmount( 1 ));
+    EXPECT_EQ( 3, tempoMap->getTimeSigBeatAmount( 2 ));
+    EXPECT_FLOAT_EQ( 120.F, tempoMap->getTempo( TICKS_PER_MEASURE * 1.5 ));
+    EXPECT_FLOAT_EQ( 60.F,  tempoMap->getTempo( TICKS_PER_MEASURE * 2.5 ));
+
+    EXPECT_EQ( 88200,  tempoMap->getMeasureStart( 1 ));
+    EXPECT_EQ( 154350, tempoMap->getMeasureStart( 2 )) << "expected 2nd measure to last for 3 beats";
+    EXPECT_EQ( 286650, tempoMap->getMeasureStart( 3 )) << "expected 3rd measure to last for 3 beats at half the tempo";
+    EXPECT_EQ( 66150,  tempoMap->getShortestBarLength() );
+
+    EXPECT_EQ( 88200,  tempoMap->getMeasureLength( 0 ));
+    EXPECT_EQ( 66150,  tempoMap->getMeasureLength( 1 ));
+    EXPECT_EQ( 132300, tempoMap->getMeasureLength( 2 ));
+
+    EXPECT_EQ( 0, tempoMap->getMeasureAt( 88199 ));
+    EXPECT_EQ( 1, tempoMap->getMeasureAt( 88200 ));
+    EXPECT_EQ( 1, tempoMap->getMeasureAt( 154349 ));
+    EXPECT_EQ( 2, tempoMap->getMeasureAt( 154350 ));
+    EXPECT_EQ( 3, tempoMap->getMeasureAt( 286650 ));
+
+    delete tempoMap;
+
+    AudioEngineProps::SAMPLE_RATE = orgSampleRate;
+}
+
+TEST( TempoMap, TempoRamp )
+{
+    unsigned int orgSampleRate = AudioEngineProps::SAMPLE_RATE;
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    // ramp from 60 BPM to 120 BPM over the course of the first measure
+
+    TempoMap* tempoMap = new TempoMap( 60.F, 4, 4 );
+    tempoMap->addTempoChange( TICKS_PER_MEASURE, 120.F, true );
+
+    EXPECT_FLOAT_EQ( 90.F,  tempoMap->getTempo( TICKS_PER_MEASURE / 2 ));
+    EXPECT_FLOAT_EQ( 120.F, tempoMap->getTempo( TICKS_PER_MEASURE * 2 )) << "expected tempo to remain constant after the ramp";
+
+    // the duration of the ramp is the integral of the beat length over the changing tempo
+
+    int expectedRampLength = ( int ) round( 4.0 * log( 2.0 ) * 44100 );
+
+    EXPECT_EQ( expectedRampLength, tempoMap->getMeasureStart( 1 ));
+    EXPECT_EQ( expectedRampLength + 88200, tempoMap->getMeasureStart( 2 ));
+    EXPECT_EQ( 88200, tempoMap->getShortestBarLength() );
+
+    // expect conversions to be reversible throughout
+
+    for ( int i = 0; i < 100; ++i ) {
+        int samples = randomInt( 0, 441000 );
+        EXPECT_EQ( samples, tempoMap->ticksToSamples( tempoMap->samplesToTicks( samples )));
+    }
+
+    // expect positions to resolve to the same measure
+
+    int measureStart = tempoMap->getMeasureStart( 1 );
+
+    EXPECT_LT( tempoMap->samplesToTicks( measureStart - 1 ), TICKS_PER_MEASURE );
+    EXPECT_GE( tempoMap->samplesToTicks( measureStart ), TICKS_PER_MEASURE );
+    EXPECT_EQ( measureStart - 1, tempoMap->ticksToSamples( TICKS_PER_MEASURE - 0.0001 ));
+
+    delete tempoMap;
+
+    AudioEngineProps::SAMPLE_RATE = orgSampleRate;
+}
+
+TEST( TempoMap, SequencedEvents )
+{
+    unsigned int orgSampleRate = AudioEngineProps::SAMPLE_RATE;
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    Sequencer::playing = true;
+
+    std::vector<AudioChannel*>* channels = new std::vector<AudioChannel*>();
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* audioEvent = new BaseAudioEvent( instrument );
+
+    audioEvent->setEventLength( 512 );
+    audioEvent->setEventStartTicks( TICKS_PER_MEASURE * 2 );
+    audioEvent->addToSequencer();
+
+    // expect the event to move along with the tempo map
+
+    TempoMap* tempoMap = new TempoMap( 60.F, 4, 4 );
+    tempoMap->addTempoChange( TICKS_PER_MEASURE, 120.F, true );
+
+    AudioEngine::defaultContext.setTempoMap( tempoMap );
+
+    int measureStart = tempoMap->getMeasureStart( 2 );
+
+    EXPECT_EQ( measureStart, audioEvent->getEventStart() )
+        << "expected event to start at the beginning of the third measure";
+
+    EXPECT_EQ( measureStart + 511, audioEvent->getEventEnd() )
+        << "expected event to maintain its duration";
+
+    Sequencer::getAudioEvents( channels, measureStart - 256, 512, true, true );
+
+    EXPECT_EQ( 1, instrument->audioChannel->audioEvents.size() )
+        << "expected event to have been collected for the range starting in the previous measure";
+
+    Sequencer::getAudioEvents( channels, measureStart - 1024, 512, true, true );
+
+    EXPECT_EQ( 0, instrument->audioChannel->audioEvents.size() )
+        << "expected event not to have been collected for a range preceding the event";
+
+    // expect the event to return to its position at a constant tempo
+
+    AudioEngine::defaultContext.setTempoMap( nullptr );
+
+    EXPECT_EQ( AudioEngine::samples_per_bar * 2, audioEvent->getEventStart() );
+
+    Sequencer::playing = false;
+
+    delete audioEvent;
+    delete instrument;
+    delete tempoMap;
+    delete channels;
+
+    AudioEngineProps::SAMPLE_RATE = orgSampleRate;
+}
@@ -0,0 +1,178 @@
+#include "../../utilities/blockallocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+TEST( BlockAllocator, Allocation )
+{
+    int blocksPerChunk = randomInt( 2, 8 );
+    BlockAllocator* allocator = new BlockAllocator( randomInt( 1, 256 ), blocksPerChunk );
+
+    EXPECT_EQ( 0, allocator->getBlockSize() % BlockAllocator::BLOCK_ALIGNMENT )
+        << "expected block size to be padded to the block alignment";
+
+    EXPECT_EQ( 0, allocator->getAmountOfChunks() ) << "expected no chunks to be allocated on construction";
+
+    // allocate more blocks than fit in a single chunk
+
+    std::vector<void*> blocks;
+    for ( int i = 0; i < blocksPerChunk + 1; ++i ) {
+        void* block = allocator->allocate();
+
+        EXPECT_EQ( 0, reinterpret_cast<uintptr_t>( block ) % BlockAllocator::BLOCK_ALIGNMENT )
+            << "expected block to be aligned";
+
+        ASSERT_FALSE( std::find( blocks.begin(), blocks.end(), block ) != blocks.end() )
+            << "expected unique block to be allocated";
+
+        ASSERT_TRUE( allocator->owns( block ));
+        blocks.push_back( block );
+    }
+    EXPECT_EQ( 2, allocator->getAmountOfChunks() ) << "expected a second chunk to have been allocated";
+    EXPECT_EQ( blocksPerChunk + 1, allocator->getBlocksInUse() );
+
+    // blocks of the first chunk are contiguous
+
+    for ( int i = 1; i < blocksPerChunk; ++i ) {
+        EXPECT_EQ( static_cast<char*>( blocks.at( i - 1 )) + allocator->getBlockSize(), blocks.at( i ));
+    }
+
+    int foreignValue = 0;
+    ASSERT_FALSE( allocator->owns( &foreignValue ));
+    ASSERT_FALSE( allocator->release( &foreignValue )) << "expected foreign memory not to be released";
+
+    // released blocks are reused
+
+    void* released = blocks.at( 1 );
+    ASSERT_TRUE( allocator->release( released ));
+    EXPECT_EQ( blocksPerChunk, allocator->getBlocksInUse() );
+    EXPECT_EQ( released, allocator->allocate() ) << "expected released block to be reused";
+
+    delete allocator;
+}
+
+TEST( BlockAllocator, Trim )
+{
+    int blocksPerChunk = 4;
+    BlockAllocator* allocator = new BlockAllocator( sizeof( double ), blocksPerChunk );
+
+    std::vector<void*> blocks;
+    for ( int i = 0; i < blocksPerChunk * 3; ++i ) {
+        blocks.push_back( allocator->allocate() );
+    }
+    EXPECT_EQ( 3, allocator->getAmountOfChunks() );
+    EXPECT_EQ( 0, allocator->trim() ) << "expected no chunks to be freed while all blocks are in use";
+
+    // release all blocks of the first and last chunk and a single block of the second
+
+    for ( int i = 0; i < blocksPerChunk; ++i ) {
+        allocator->release( blocks.at( i ));
+        allocator->release( blocks.at( blocksPerChunk * 2 + i ));
+    }
+    allocator->release( blocks.at( blocksPerChunk ));
+
+    EXPECT_EQ( 2, allocator->trim() ) << "expected unused chunks to be freed";
+    EXPECT_EQ( 1, allocator->getAmountOfChunks() );
+    EXPECT_EQ( blocksPerChunk - 1, allocator->getBlocksInUse() );
+
+    ASSERT_FALSE( allocator->owns( blocks.at( 0 ))) << "expected memory of freed chunk not to be owned anymore";
+    ASSERT_TRUE( allocator->owns( blocks.at( blocksPerChunk + 1 )));
+
+    // the remaining free block of the second chunk is reused before a new chunk is allocated
+
+    EXPECT_EQ( blocks.at( blocksPerChunk ), allocator->allocate() );
+    EXPECT_EQ( 1, allocator->getAmountOfChunks() );
+
+    allocator->allocate();
+    EXPECT_EQ( 2, allocator->getAmountOfChunks() );
+
+    delete allocator;
+}
+
+TEST( BlockAllocator, Reserve )
+{
+    int blocksPerChunk = 4;
+    BlockAllocator* allocator = new BlockAllocator( sizeof( double ), blocksPerChunk );
+
+    allocator->reserve( blocksPerChunk + 1 );
+
+    EXPECT_EQ( 2, allocator->getAmountOfChunks() ) << "expected chunks to be allocated to hold the reserved blocks";
+    EXPECT_EQ( 0, allocator->getBlocksInUse() );
+
+    for ( int i = 0; i < blocksPerChunk + 1; ++i ) {
+        ASSERT_TRUE( allocator->owns( allocator->allocate() ));
+    }
+    EXPECT_EQ( 2, allocator->getAmountOfChunks() ) << "expected reserved blocks to be allocated without allocating chunks";
+
+    allocator->reserve( blocksPerChunk );
+    EXPECT_EQ( 3, allocator->getAmountOfChunks() ) << "expected reservation to take blocks in use into account";
+
+    delete allocator;
+}
+
+TEST( BlockAllocator, TryAllocate )
+{
+    int blocksPerChunk = 2;
+    BlockAllocator* allocator = new BlockAllocator( sizeof( double ), blocksPerChunk );
+
+    EXPECT_TRUE( allocator->tryAllocate() == nullptr ) << "expected no block to be available without reservation";
+    EXPECT_EQ( 0, allocator->getAmountOfChunks() ) << "expected no chunk to be allocated";
+
+    allocator->reserve( blocksPerChunk );
+
+    EXPECT_TRUE( allocator->tryAllocate() != nullptr );
+    EXPECT_TRUE( allocator->tryAllocate() != nullptr );
+    EXPECT_TRUE( allocator->tryAllocate() == nullptr ) << "expected no block to be available once reserved blocks are in use";
+    EXPECT_EQ( 1, allocator->getAmountOfChunks() );
+
+    // the next allocation replenishes the exhausted allocator ahead of time
+
+    EXPECT_TRUE( allocator->allocate() != nullptr );
+    EXPECT_EQ( 2, allocator->getAmountOfChunks() ) << "expected the allocator to have been replenished";
+    EXPECT_TRUE( allocator->tryAllocate() != nullptr );
+
+    delete allocator;
+}
+
+TEST( BlockAllocator, ConcurrentAllocation )
+{
+    int blocksPerChunk = 8;
+    BlockAllocator* allocator = new BlockAllocator( sizeof( int ), blocksPerChunk );
+    allocator->reserve( blocksPerChunk );
+
+    // threads repeatedly allocate blocks (writing into them to detect blocks handed out twice) and release them
+
+    std::vector<std::thread> threads;
+    std::atomic<int> collisions( 0 );
+
+    for ( int t = 0; t < 4; ++t ) {
+        threads.emplace_back( [ allocator, &collisions, t ]()
+        {
+            for ( int i = 0; i < 10000; ++i ) {
+                int* blocks[ 3 ];
+                for ( auto& block : blocks ) {
+                    block  = static_cast<int*>( allocator->allocate() );
+                    *block = t;
+                }
+                for ( auto& block : blocks ) {
+                    if ( *block != t ) {
+                        ++collisions;
+                    }
+                    allocator->release( block );
+                }
+            }
+        });
+    }
+
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+    EXPECT_EQ( 0, collisions.load() ) << "expected blocks not to be handed out to multiple threads";
+    EXPECT_EQ( 0, allocator->getBlocksInUse() );
+
+    int amountOfChunks = allocator->getAmountOfChunks();
+    EXPECT_EQ( amountOfChunks, allocator->trim() ) << "expected all chunks to be freed";
+
+    delete allocator;
+}
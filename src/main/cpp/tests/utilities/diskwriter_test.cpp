@@ -0,0 +1,110 @@
+#include "../../utilities/diskwriter.h"
+#include "../../utilities/wavereader.h"
+#include "../../audioengine.h"
+#include <cstdio>
+
+TEST( DiskWriter, StreamsRecordingIntoSingleFile )
+{
+    std::string file     = "mwengine_diskwriter_test.wav";
+    int amountOfChannels = 2;
+    int bufferSize       = 64;
+    int iterations       = randomInt( 50, 100 );
+    int ringSize         = bufferSize * 4; // much smaller than the recording to exercise ring wrapping
+
+    // bounce to ensure the render thread waits for the writer thread rather than dropping audio
+
+    AudioEngine::bouncing = true;
+    DiskWriter::prepare( file, ringSize, amountOfChannels );
+
+    float* buffer = new float[ bufferSize * amountOfChannels ];
+    std::vector<float> recorded;
+
+    for ( int i = 0; i < iterations; ++i ) {
+        for ( int j = 0; j < bufferSize * amountOfChannels; ++j ) {
+            buffer[ j ] = randomFloat();
+            recorded.push_back( buffer[ j ]);
+        }
+        DiskWriter::appendBuffer( buffer, bufferSize, amountOfChannels );
+    }
+    ASSERT_TRUE( DiskWriter::finish() ) << "expected recording to finish";
+    AudioEngine::bouncing = false;
+
+    EXPECT_FALSE( DiskWriter::finish() ) << "expected recording not to finish twice";
+    EXPECT_EQ( 0, DiskWriter::getDroppedFrames() ) << "expected no audio to have been dropped while bouncing";
+
+    waveFile result = WaveReader::fileToBuffer( file );
+
+    ASSERT_FALSE( result.buffer == nullptr ) << "expected recording to be readable as a WAV file";
+    ASSERT_EQ( amountOfChannels, result.buffer->amountOfChannels );
+    ASSERT_EQ( bufferSize * iterations, result.buffer->bufferSize ) << "expected header to describe the full recording";
+
+    for ( int i = 0; i < result.buffer->bufferSize; ++i ) {
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            EXPECT_NEAR( recorded[ i * amountOfChannels + c ], result.buffer->getBufferForChannel( c )[ i ], 1.0 / 32767 )
+                << "expected recorded sample to have been written in order";
+        }
+    }
+
+    delete result.buffer;
+    delete[] buffer;
+    remove( file.c_str() );
+}
+
+TEST( DiskWriter, AppendAudioBuffer )
+{
+    std::string file = "mwengine_diskwriter_test.wav";
+    int bufferSize   = 128;
+
+    // mono input recorded into a stereo output file
+
+    AudioBuffer* input = fillAudioBuffer( new AudioBuffer( 1, bufferSize ));
+
+    DiskWriter::prepare( file, bufferSize * 2, 2 );
+    DiskWriter::appendBuffer( input );
+    DiskWriter::finish();
+
+    waveFile result = WaveReader::fileToBuffer( file );
+
+    ASSERT_FALSE( result.buffer == nullptr );
+    ASSERT_EQ( 2, result.buffer->amountOfChannels );
+    ASSERT_EQ( bufferSize, result.buffer->bufferSize );
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        for ( int c = 0; c < 2; ++c ) {
+            EXPECT_NEAR( input->getBufferForChannel( 0 )[ i ], result.buffer->getBufferForChannel( c )[ i ], 1.0 / 32767 )
+                << "expected mono input to have been written into all output channels";
+        }
+    }
+
+    delete result.buffer;
+    delete input;
+    remove( file.c_str() );
+}
+
+TEST( DiskWriter, DropsAudioExceedingRingBuffer )
+{
+    std::string file = "mwengine_diskwriter_test.wav";
+    int ringSize     = ( int ) AudioEngineProps::BUFFER_SIZE;
+    int bufferSize   = ringSize * 2;
+
+    float* buffer = new float[ bufferSize ];
+    for ( int i = 0; i < bufferSize; ++i )
+        buffer[ i ] = randomFloat();
+
+    DiskWriter::prepare( file, ringSize, 1 );
+    DiskWriter::appendBuffer( buffer, bufferSize, 1 );
+    DiskWriter::finish();
+
+    EXPECT_EQ( bufferSize, DiskWriter::getDroppedFrames() )
+        << "expected audio that cannot fit in the ring buffer to be dropped rather than block the render thread";
+
+    waveFile result = WaveReader::fileToBuffer( file );
+
+    // a recording without content has no sample buffer
+
+    EXPECT_TRUE( result.buffer == nullptr || result.buffer->bufferSize == 0 );
+
+    delete result.buffer;
+    delete[] buffer;
+    remove( file.c_str() );
+}
@@ -0,0 +1,37 @@
+#include "../../utilities/perfutility.h"
+#include <cfloat>
+
+TEST( PerfUtility, DisableDenormals )
+{
+    if ( PerfUtility::DENORMALS_FLUSH_MASK == 0 ) {
+        return; // architecture without denormal control
+    }
+    unsigned int orgState = PerfUtility::getFloatingPointState();
+
+    PerfUtility::setFloatingPointState( orgState & ~PerfUtility::DENORMALS_FLUSH_MASK );
+
+    ASSERT_FALSE( PerfUtility::hasDenormalsDisabled() );
+
+    volatile double value = DBL_MIN;
+
+    EXPECT_GT( value / 4.0, 0.0 )
+        << "expected denormal result when denormals are enabled";
+
+    {
+        PerfUtility::DenormalGuard guard;
+
+        ASSERT_TRUE( PerfUtility::hasDenormalsDisabled() );
+
+        EXPECT_EQ( value / 4.0, 0.0 )
+            << "expected denormal result to have been flushed to zero";
+    }
+
+    ASSERT_FALSE( PerfUtility::hasDenormalsDisabled() )
+        << "expected guard to have restored the floating point state";
+
+    PerfUtility::disableDenormals();
+
+    ASSERT_TRUE( PerfUtility::hasDenormalsDisabled() );
+
+    PerfUtility::setFloatingPointState( orgState );
+}
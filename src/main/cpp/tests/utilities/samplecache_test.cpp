@@ -0,0 +1,195 @@
+#include "../../utilities/samplecache.h"
+#include "../../utilities/samplemanager.h"
+#include "../../utilities/wavewriter.h"
+#include "../../mappedaudiobuffer.h"
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// writes a WAV file and returns its contents as read by the WaveReader
+
+waveFile createCacheSourceFile( std::string fileName, int amountOfChannels, int length )
+{
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( amountOfChannels, length ));
+    WaveWriter::bufferToWAV( fileName, buffer, 44100 );
+    delete buffer;
+
+    return WaveReader::fileToBuffer( fileName );
+}
+
+bool buffersEqual( AudioBuffer* buffer1, AudioBuffer* buffer2 )
+{
+    if ( buffer1->amountOfChannels != buffer2->amountOfChannels || buffer1->bufferSize != buffer2->bufferSize )
+        return false;
+
+    for ( int c = 0; c < buffer1->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer1->bufferSize; ++i ) {
+            if ( buffer1->getBufferForChannel( c )[ i ] != buffer2->getBufferForChannel( c )[ i ])
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST( SampleCache, DisabledByDefault )
+{
+    std::string file = "mwengine_cache_test.wav";
+    waveFile source  = createCacheSourceFile( file, 2, 1000 );
+
+    ASSERT_FALSE( SampleCache::isEnabled() ) << "expected cache to be disabled by default";
+
+    waveFile WAV = SampleCache::load( file );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected file to be read when the cache is disabled";
+    EXPECT_TRUE( dynamic_cast<MappedAudioBuffer*>( WAV.buffer ) == nullptr ) << "expected buffer not to be read from cache";
+    EXPECT_TRUE( buffersEqual( source.buffer, WAV.buffer ));
+    EXPECT_TRUE( SampleCache::read( file ).buffer == nullptr ) << "expected no cache to be read when disabled";
+
+    delete WAV.buffer;
+    delete source.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleCache, LoadAndRead )
+{
+    std::string file = "mwengine_cache_test.wav";
+    waveFile source  = createCacheSourceFile( file, randomInt( 1, 2 ), randomInt( 1000, 10000 ));
+
+    SampleCache::setCacheDirectory( "." );
+    SampleCache::invalidate( file );
+
+    EXPECT_TRUE( SampleCache::read( file ).buffer == nullptr ) << "expected no cache to exist for the file yet";
+
+    // first load reads the WAV file and writes the cache
+
+    waveFile WAV = SampleCache::load( file );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_TRUE( dynamic_cast<MappedAudioBuffer*>( WAV.buffer ) == nullptr ) << "expected first load to read the WAV file";
+    EXPECT_EQ( 0, access( SampleCache::getCachePath( file ).c_str(), F_OK )) << "expected cache file to have been written";
+    delete WAV.buffer;
+
+    // subsequent loads map the cache
+
+    WAV = SampleCache::load( file );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_FALSE( dynamic_cast<MappedAudioBuffer*>( WAV.buffer ) == nullptr ) << "expected subsequent load to map the cache";
+    EXPECT_EQ( source.sampleRate, WAV.sampleRate );
+    EXPECT_TRUE( buffersEqual( source.buffer, WAV.buffer )) << "expected cached contents to equal the WAV file contents";
+
+    for ( int c = 0; c < WAV.buffer->amountOfChannels; ++c ) {
+        EXPECT_EQ( 0, ( size_t ) WAV.buffer->getBufferForChannel( c ) % SampleCache::ALIGNMENT )
+            << "expected channel data to be page aligned";
+    }
+
+    // altering the mapped buffer does not alter the cache
+
+    WAV.buffer->silenceBuffers();
+    waveFile cached = SampleCache::read( file );
+
+    ASSERT_FALSE( cached.buffer == nullptr );
+    EXPECT_TRUE( buffersEqual( source.buffer, cached.buffer )) << "expected cache to be unaltered";
+
+    delete cached.buffer;
+    delete WAV.buffer;
+    delete source.buffer;
+
+    SampleCache::invalidate( file );
+    SampleCache::setCacheDirectory( "" );
+    std::remove( file.c_str() );
+}
+
+TEST( SampleCache, Invalidation )
+{
+    std::string file = "mwengine_cache_test.wav";
+    waveFile source  = createCacheSourceFile( file, 2, 1000 );
+
+    SampleCache::setCacheDirectory( "." );
+    SampleCache::invalidate( file );
+
+    ASSERT_TRUE( SampleCache::write( file, source.buffer, source.sampleRate ));
+    waveFile cached = SampleCache::read( file );
+    ASSERT_FALSE( cached.buffer == nullptr ) << "expected cache to be valid after writing";
+    delete cached.buffer;
+
+    // replacing the source file (altering its size and modification time) invalidates the cache
+
+    delete source.buffer;
+    source = createCacheSourceFile( file, 2, 2000 );
+
+    EXPECT_TRUE( SampleCache::read( file ).buffer == nullptr ) << "expected cache to be invalid after source has changed";
+
+    waveFile WAV = SampleCache::load( file );
+    EXPECT_TRUE( buffersEqual( source.buffer, WAV.buffer )) << "expected load to read the changed file";
+    delete WAV.buffer;
+
+    WAV = SampleCache::load( file );
+    EXPECT_FALSE( dynamic_cast<MappedAudioBuffer*>( WAV.buffer ) == nullptr ) << "expected the cache to have been rewritten";
+    EXPECT_TRUE( buffersEqual( source.buffer, WAV.buffer ));
+    delete WAV.buffer;
+
+    // invalidating removes the cache file
+
+    SampleCache::invalidate( file );
+    EXPECT_TRUE( SampleCache::read( file ).buffer == nullptr ) << "expected cache to have been removed";
+
+    delete source.buffer;
+    SampleCache::setCacheDirectory( "" );
+    std::remove( file.c_str() );
+}
+
+TEST( SampleCache, SampleManager )
+{
+    std::string file = "mwengine_cache_test.wav";
+    waveFile source  = createCacheSourceFile( file, 2, 1000 );
+
+    SampleCache::setCacheDirectory( "." );
+    SampleCache::invalidate( file );
+
+    SampleManager::loadSample( "foo", file ); // writes the cache
+    SampleManager::removeSample( "foo", true );
+    SampleManager::loadSample( "foo", file ); // maps the cache
+
+    AudioBuffer* sample = SampleManager::getSample( "foo" );
+
+    ASSERT_FALSE( sample == nullptr );
+    EXPECT_FALSE( dynamic_cast<MappedAudioBuffer*>( sample ) == nullptr ) << "expected the sample to have been read from cache";
+    EXPECT_TRUE( buffersEqual( source.buffer, sample )) << "expected sample to equal the WAV file contents";
+
+    SampleManager::removeSample( "foo", true );
+
+    delete source.buffer;
+    SampleCache::invalidate( file );
+    SampleCache::setCacheDirectory( "" );
+    std::remove( file.c_str() );
+}
+
+TEST( SampleCache, Resampled )
+{
+    std::string file = "mwengine_cache_test.wav";
+    waveFile source  = createCacheSourceFile( file, 2, 4410 ); // at 44.1 kHz
+
+    SampleCache::setCacheDirectory( "." );
+    SampleCache::invalidate( file );
+
+    waveFile WAV = SampleCache::load( file, 48000 );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_EQ( 48000, ( int ) WAV.sampleRate ) << "expected contents to have been resampled";
+    EXPECT_EQ( 4800, WAV.buffer->bufferSize );
+    delete WAV.buffer;
+
+    WAV = SampleCache::read( file, 48000 );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected resampled contents to have been cached";
+    EXPECT_EQ( 4800, WAV.buffer->bufferSize );
+    delete WAV.buffer;
+
+    EXPECT_TRUE( SampleCache::read( file, 44100 ).buffer == nullptr ) << "expected no cache at a different rate";
+
+    delete source.buffer;
+    SampleCache::invalidate( file );
+    SampleCache::setCacheDirectory( "" );
+    std::remove( file.c_str() );
+}
@@ -0,0 +1,124 @@
+#include "../../utilities/sampleloader.h"
+#include "../../utilities/samplemanager.h"
+#include "../../utilities/wavereader.h"
+#include "../../utilities/wavewriter.h"
+#include "../../definitions/notifications.h"
+#include "../../messaging/notifier.h"
+#include "../../messaging/observer.h"
+#include <cstdio>
+
+class SampleLoaderObserver : public Observer
+{
+    public:
+        std::vector<int> progress;
+        std::vector<int> errors;
+        int completed  = -1;
+        int registered = 0;
+
+        void handleNotification( int aNotificationType, int aValue )
+        {
+            switch ( aNotificationType )
+            {
+                case Notifications::SAMPLE_LOAD_PROGRESS:
+                    progress.push_back( aValue );
+                    break;
+                case Notifications::SAMPLE_LOAD_ERROR:
+                    errors.push_back( aValue );
+                    break;
+                case Notifications::SAMPLE_LOAD_COMPLETE:
+                    completed = aValue;
+                    break;
+            }
+        }
+};
+
+TEST( SampleLoader, LoadSamples )
+{
+    int amountOfFiles = randomInt( 8, 24 );
+    int invalidFile   = randomInt( 0, amountOfFiles - 1 );
+
+    SampleLoader* loader = new SampleLoader();
+    std::vector<std::string> files;
+
+    for ( int i = 0; i < amountOfFiles; ++i )
+    {
+        std::string file = "mwengine_loader_test" + std::to_string( i ) + ".wav";
+        files.push_back( file );
+
+        if ( i != invalidFile ) {
+            AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( randomInt( 1, 2 ), 1000 + i ));
+            WaveWriter::bufferToWAV( file, buffer, AudioEngineProps::SAMPLE_RATE );
+            delete buffer;
+        }
+        loader->addSample( "loader" + std::to_string( i ), file );
+    }
+
+    EXPECT_EQ( amountOfFiles, loader->getAmountOfSamples() );
+
+    SampleLoaderObserver* observer = new SampleLoaderObserver();
+
+    Notifier::registerObserver( Notifications::SAMPLE_LOAD_PROGRESS, observer );
+    Notifier::registerObserver( Notifications::SAMPLE_LOAD_ERROR,    observer );
+    Notifier::registerObserver( Notifications::SAMPLE_LOAD_COMPLETE, observer );
+
+    int registered = loader->load( 4 );
+
+    EXPECT_EQ( amountOfFiles - 1, registered ) << "expected all valid files to have been registered";
+    EXPECT_EQ( 1, loader->getAmountOfErrors() ) << "expected the invalid file to have been reported";
+
+    // validate notifications
+
+    ASSERT_EQ( amountOfFiles, ( int ) observer->progress.size() ) << "expected progress to be broadcast for each file";
+
+    for ( int i = 0; i < amountOfFiles; ++i )
+        EXPECT_EQ( i + 1, observer->progress[ i ] ) << "expected progress to report the amount of processed files";
+
+    ASSERT_EQ( 1, ( int ) observer->errors.size() );
+    EXPECT_EQ( invalidFile, observer->errors[ 0 ] ) << "expected error to report the index of the invalid file";
+    EXPECT_EQ( registered, observer->completed ) << "expected completion to report the amount of registered samples";
+
+    // validate registered samples equal the file contents
+
+    for ( int i = 0; i < amountOfFiles; ++i )
+    {
+        std::string id = "loader" + std::to_string( i );
+
+        if ( i == invalidFile ) {
+            EXPECT_FALSE( SampleManager::hasSample( id ));
+            continue;
+        }
+        waveFile WAV        = WaveReader::fileToBuffer( files[ i ]);
+        AudioBuffer* sample = SampleManager::getSample( id );
+
+        ASSERT_FALSE( sample == nullptr ) << "expected sample " << i << " to have been registered";
+        EXPECT_EQ( WAV.buffer->bufferSize, sample->bufferSize );
+        EXPECT_EQ( WAV.buffer->amountOfChannels, sample->amountOfChannels );
+
+        for ( int c = 0; c < sample->amountOfChannels; ++c ) {
+            for ( int j = 0; j < sample->bufferSize; ++j ) {
+                if ( WAV.buffer->getBufferForChannel( c )[ j ] != sample->getBufferForChannel( c )[ j ])
+                    FAIL() << "expected sample " << i << " to equal the file contents at index " << j;
+            }
+        }
+        delete WAV.buffer;
+    }
+
+    // reloading the batch does not overwrite existing samples
+
+    observer->completed = -1;
+
+    EXPECT_EQ( 0, loader->load()) << "expected no samples to have been registered";
+    EXPECT_EQ( 0, observer->completed );
+
+    Notifier::unregisterObserver( Notifications::SAMPLE_LOAD_PROGRESS, observer );
+    Notifier::unregisterObserver( Notifications::SAMPLE_LOAD_ERROR,    observer );
+    Notifier::unregisterObserver( Notifications::SAMPLE_LOAD_COMPLETE, observer );
+
+    SampleManager::flushSamples();
+
+    for ( std::string file : files )
+        std::remove( file.c_str() );
+
+    delete observer;
+    delete loader;
+}
@@ -1,5 +1,9 @@
 #include "../../utilities/samplemanager.h"
 #include "../../audiobuffer.h"
+#include "../../compactaudiobuffer.h"
+#include "../../events/sampleevent.h"
+#include "../../utilities/wavewriter.h"
+#include <cstdio>
 
 TEST( SampleManager, EmptyByDefault )
 {
@@ -128,3 +132,310 @@ TEST( SampleManager, Flush )
 
     // buffers deleted by SampleManager.flushSamples()
 }
+
+TEST( SampleManager, SampleFormat )
+{
+    EXPECT_EQ( SampleFormats::NATIVE, SampleManager::getSampleFormat() )
+        << "expected samples to be stored as SAMPLE_TYPE by default";
+
+    SampleManager::setSampleFormat( SampleFormats::PCM16 );
+
+    EXPECT_EQ( SampleFormats::PCM16, SampleManager::getSampleFormat() )
+        << "expected sample format to have been updated";
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 16 );
+    SampleManager::setSample( "foo", buffer, AudioEngineProps::SAMPLE_RATE );
+
+    CompactAudioBuffer* storedBuffer = dynamic_cast<CompactAudioBuffer*>( SampleManager::getSample( "foo" ));
+
+    ASSERT_FALSE( storedBuffer == nullptr ) << "expected sample to have been stored in a compact format";
+    EXPECT_EQ( SampleFormats::PCM16, storedBuffer->getFormat() ) << "expected sample to be stored in the specified format";
+    EXPECT_EQ( 16, SampleManager::getSampleLength( "foo" )) << "expected sample length to be unchanged";
+
+    SampleManager::setSampleFormat( SampleFormats::NATIVE );
+    SampleManager::removeSample( "foo", true );
+
+    // buffer deleted by SampleManager.setSample()
+}
+
+TEST( SampleManager, SetSampleOwnership )
+{
+    AudioBuffer* buffer1 = new AudioBuffer( 1, 16 );
+    AudioBuffer* buffer2 = new AudioBuffer( 1, 16 );
+
+    EXPECT_TRUE( SampleManager::setSample( "foo", buffer1, AudioEngineProps::SAMPLE_RATE ))
+        << "expected buffer to have been stored";
+
+    EXPECT_FALSE( SampleManager::setSample( "foo", buffer2, AudioEngineProps::SAMPLE_RATE ))
+        << "expected buffer not to be stored as a sample is registered under the same identifier";
+
+    EXPECT_TRUE( SampleManager::getSample( "foo" ) == buffer1 ) << "expected existing sample to be retained";
+
+    SampleManager::removeSample( "foo", true );
+
+    // buffer1 deleted by SampleManager, buffer2 is still owned by this test
+
+    delete buffer2;
+}
+
+TEST( SampleManager, SetSampleInFormat )
+{
+    AudioBuffer* buffer = new AudioBuffer( 1, 16 );
+    SampleManager::setSample( "foo", buffer, AudioEngineProps::SAMPLE_RATE, SampleFormats::FLOAT32 );
+
+    CompactAudioBuffer* storedBuffer = dynamic_cast<CompactAudioBuffer*>( SampleManager::getSample( "foo" ));
+
+    ASSERT_FALSE( storedBuffer == nullptr ) << "expected sample to have been stored in a compact format";
+    EXPECT_EQ( SampleFormats::FLOAT32, storedBuffer->getFormat() ) << "expected sample to be stored in the specified format";
+
+    EXPECT_EQ( SampleFormats::NATIVE, SampleManager::getSampleFormat() )
+        << "expected default sample format to be unchanged";
+
+    SampleManager::removeSample( "foo", true );
+}
+
+TEST( SampleManager, GetMemoryUsage )
+{
+    int bufferSize = randomInt( 64, 512 );
+
+    SampleManager::setSample( "foo", new AudioBuffer( 2, bufferSize ), AudioEngineProps::SAMPLE_RATE );
+    SampleManager::setSample( "bar", new AudioBuffer( 2, bufferSize ), AudioEngineProps::SAMPLE_RATE, SampleFormats::PCM16 );
+
+    size_t nativeSize = 2 * bufferSize * sizeof( SAMPLE_TYPE );
+    size_t int16Size  = 2 * bufferSize * sizeof( int16_t );
+
+    EXPECT_EQ( nativeSize, SampleManager::getMemoryUsage( "foo" )) << "expected native sample memory usage to be reported";
+    EXPECT_EQ( int16Size,  SampleManager::getMemoryUsage( "bar" )) << "expected compact sample memory usage to be reported";
+    EXPECT_EQ(( size_t ) 0, SampleManager::getMemoryUsage( "baz" )) << "expected no memory usage for unregistered sample";
+
+    EXPECT_EQ( nativeSize + int16Size, SampleManager::getTotalMemoryUsage() )
+        << "expected total memory usage to equal the sum of all registered samples";
+
+    SampleManager::flushSamples();
+
+    EXPECT_EQ(( size_t ) 0, SampleManager::getTotalMemoryUsage() ) << "expected no memory usage after flushing all samples";
+}
+
+// writes a WAV file of given length (in sample frames) to load into the SampleManager
+
+std::string createSampleFile( const char* fileName, int length )
+{
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 1, length ));
+    WaveWriter::bufferToWAV( fileName, buffer, AudioEngineProps::SAMPLE_RATE );
+    delete buffer;
+
+    return fileName;
+}
+
+TEST( SampleManager, LoadSample )
+{
+    std::string file = createSampleFile( "mwengine_sample_test.wav", 1000 );
+
+    ASSERT_TRUE( SampleManager::loadSample( "foo", file )) << "expected sample to have been loaded from file";
+    ASSERT_FALSE( SampleManager::loadSample( "bar", "nonexistent.wav" )) << "expected non-existing file not to load";
+
+    EXPECT_TRUE( SampleManager::hasSample( "foo" ));
+    EXPECT_TRUE( SampleManager::isSampleLoaded( "foo" ));
+    EXPECT_FALSE( SampleManager::hasSample( "bar" ));
+    EXPECT_EQ( 1000, SampleManager::getSampleLength( "foo" ));
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE, SampleManager::getSampleRateForSample( "foo" ));
+
+    SampleManager::removeSample( "foo", true );
+    std::remove( file.c_str() );
+}
+
+TEST( SampleManager, ReferenceCounting )
+{
+    SampleManager::setSample( "foo", new AudioBuffer( 1, 10 ), AudioEngineProps::SAMPLE_RATE );
+    SampleManager::setSample( "bar", new AudioBuffer( 1, 10 ), AudioEngineProps::SAMPLE_RATE );
+
+    AudioBuffer* buffer = SampleManager::getSample( "foo" );
+
+    EXPECT_EQ( 0, SampleManager::getReferenceCount( "foo" )) << "expected no references after registration";
+
+    SampleEvent* event1 = new SampleEvent();
+    SampleEvent* event2 = new SampleEvent();
+
+    event1->setSample( buffer );
+    event2->setSample( buffer );
+
+    EXPECT_EQ( 2, SampleManager::getReferenceCount( "foo" )) << "expected events to retain the sample";
+
+    event2->setSample( SampleManager::getSample( "bar" ));
+
+    EXPECT_EQ( 1, SampleManager::getReferenceCount( "foo" )) << "expected event to have released the previous sample";
+    EXPECT_EQ( 1, SampleManager::getReferenceCount( "bar" )) << "expected event to have retained the new sample";
+
+    AudioBuffer* unmanagedBuffer = new AudioBuffer( 1, 10 );
+    EXPECT_FALSE( SampleManager::retainSample( unmanagedBuffer )) << "expected unmanaged buffer not to be retained";
+    delete unmanagedBuffer;
+
+    // removing a referenced sample defers its deletion until the last reference is released
+
+    SampleManager::removeSample( "foo", true );
+
+    EXPECT_FALSE( SampleManager::hasSample( "foo" )) << "expected sample to have been removed";
+    EXPECT_EQ( 10, event1->getBuffer()->bufferSize ) << "expected referenced buffer to remain valid";
+
+    delete event1; // releases (and deletes) "foo"
+
+    SampleManager::flushSamples();
+
+    EXPECT_FALSE( SampleManager::hasSample( "bar" )) << "expected sample to have been flushed";
+    EXPECT_EQ( 10, event2->getBuffer()->bufferSize ) << "expected referenced buffer to remain valid";
+
+    delete event2; // releases (and deletes) "bar"
+
+    EXPECT_EQ(( size_t ) 0, SampleManager::getTotalMemoryUsage() ) << "expected all samples to have been deleted";
+}
+
+TEST( SampleManager, MemoryBudget )
+{
+    int length = 1000;
+    size_t sampleSize = length * sizeof( SAMPLE_TYPE );
+
+    std::string file1 = createSampleFile( "mwengine_sample_test1.wav", length );
+    std::string file2 = createSampleFile( "mwengine_sample_test2.wav", length );
+    std::string file3 = createSampleFile( "mwengine_sample_test3.wav", length );
+
+    SampleManager::loadSample( "foo", file1 );
+    SampleManager::loadSample( "bar", file2 );
+    SampleManager::setSample( "baz", new AudioBuffer( 1, length ), AudioEngineProps::SAMPLE_RATE ); // not reloadable
+
+    SampleEvent* event = new SampleEvent();
+    event->setSample( SampleManager::getSample( "foo" )); // "foo" is now referenced, "bar" is least recently used
+
+    // apply a budget that only fits two samples
+
+    SampleManager::setMemoryBudget( sampleSize * 2 );
+
+    EXPECT_TRUE( SampleManager::isSampleLoaded( "foo" ))  << "expected referenced sample not to be evicted";
+    EXPECT_FALSE( SampleManager::isSampleLoaded( "bar" )) << "expected unreferenced sample loaded from file to be evicted";
+    EXPECT_TRUE( SampleManager::isSampleLoaded( "baz" ))  << "expected sample registered from memory not to be evicted";
+    EXPECT_TRUE( SampleManager::hasSample( "bar" ))       << "expected evicted sample to remain registered";
+    EXPECT_EQ( length, SampleManager::getSampleLength( "bar" ));
+    EXPECT_EQ( sampleSize * 2, SampleManager::getTotalMemoryUsage() );
+
+    // when no sample can be evicted, the budget is exceeded (newly loaded samples are never evicted immediately)
+
+    SampleManager::loadSample( "qux", file3 );
+
+    EXPECT_TRUE( SampleManager::isSampleLoaded( "qux" )) << "expected newly loaded sample to be kept in memory";
+    EXPECT_EQ( sampleSize * 3, SampleManager::getTotalMemoryUsage() );
+
+    // requesting an evicted sample reloads it from disk
+
+    AudioBuffer* buffer = SampleManager::getSample( "bar" );
+
+    ASSERT_FALSE( buffer == nullptr ) << "expected evicted sample to have been reloaded";
+    EXPECT_EQ( length, buffer->bufferSize );
+    EXPECT_FALSE( SampleManager::isSampleLoaded( "qux" )) << "expected least recently used sample to have been evicted";
+
+    // releasing the reference makes the sample eligible for eviction
+
+    delete event;
+
+    EXPECT_FALSE( SampleManager::isSampleLoaded( "foo" )) << "expected released sample to have been evicted";
+
+    sampleManagerStats stats = SampleManager::getStats();
+
+    EXPECT_EQ( 4, stats.samples );
+    EXPECT_EQ( 2, stats.loadedSamples );
+    EXPECT_EQ( 0, stats.referencedSamples );
+    EXPECT_EQ( sampleSize * 2, stats.memoryUsage );
+    EXPECT_EQ( sampleSize * 2, stats.memoryBudget );
+    EXPECT_EQ( 3, stats.evictions );
+    EXPECT_EQ( 1, stats.reloads );
+
+    SampleManager::setMemoryBudget( 0 );
+    SampleManager::flushSamples();
+
+    std::remove( file1.c_str() );
+    std::remove( file2.c_str() );
+    std::remove( file3.c_str() );
+}
+
+TEST( SampleManager, SampleId )
+{
+    SampleId id = SampleManager::getSampleId( "foo" );
+
+    EXPECT_FALSE( id == SampleManager::NO_SAMPLE ) << "expected identifier to have been interned";
+    EXPECT_EQ( id, SampleManager::getSampleId( "foo" )) << "expected the same SampleId for the same identifier";
+    EXPECT_FALSE( id == SampleManager::getSampleId( "bar" )) << "expected a different SampleId for a different identifier";
+    EXPECT_FALSE( SampleManager::hasSample( id )) << "expected no Sample to be found as it hasn't been registered yet";
+
+    AudioBuffer* buffer = new AudioBuffer( 1, 10 );
+    SampleManager::setSample( "foo", buffer, AudioEngineProps::SAMPLE_RATE / 2 );
+
+    ASSERT_TRUE( SampleManager::hasSample( id )) << "expected Sample to be found by its SampleId";
+    EXPECT_EQ( buffer, SampleManager::getSample( id ));
+    EXPECT_EQ( 10, SampleManager::getSampleLength( id ));
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE / 2, SampleManager::getSampleRateForSample( id ));
+
+    // SampleIds remain valid when a sample is removed and registered again
+
+    SampleManager::removeSample( id, true );
+
+    EXPECT_FALSE( SampleManager::hasSample( "foo" )) << "expected Sample to have been removed by its SampleId";
+
+    buffer = new AudioBuffer( 1, 20 );
+    SampleManager::setSample( "foo", buffer, AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_EQ( id, SampleManager::getSampleId( "foo" ));
+    EXPECT_EQ( buffer, SampleManager::getSample( id ));
+
+    SampleManager::flushSamples();
+
+    EXPECT_FALSE( SampleManager::hasSample( id ));
+    EXPECT_EQ( id, SampleManager::getSampleId( "foo" )) << "expected SampleId to remain interned after flush";
+
+    EXPECT_TRUE( SampleManager::getSample( SampleManager::NO_SAMPLE ) == nullptr );
+    EXPECT_FALSE( SampleManager::hasSample( "baz" ));
+    EXPECT_FALSE( SampleManager::hasSample( SampleManager::getSampleId( "baz" ) + 1 )) << "expected unknown SampleId not to resolve";
+}
+
+TEST( SampleManager, Resampling )
+{
+    EXPECT_FALSE( SampleManager::getResampling() ) << "expected resampling to be disabled by default";
+
+    int length              = 4410;
+    unsigned int sampleRate = AudioEngineProps::SAMPLE_RATE / 2;
+
+    SampleManager::setResampling( true );
+    SampleManager::setSample( "foo", new AudioBuffer( 2, length ), sampleRate );
+    SampleManager::setSample( "bar", new AudioBuffer( 2, length ), AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE, SampleManager::getSampleRateForSample( "foo" ))
+        << "expected sample to have been resampled to the engine rate";
+    EXPECT_EQ( length * 2, SampleManager::getSampleLength( "foo" ))
+        << "expected sample length to have been adjusted to the engine rate";
+    EXPECT_EQ( length, SampleManager::getSampleLength( "bar" ))
+        << "expected sample at the engine rate to be unaltered";
+
+    // samples loaded from file are resampled on load
+
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 1, length ));
+    WaveWriter::bufferToWAV( "mwengine_sample_test.wav", buffer, sampleRate );
+    delete buffer;
+
+    ASSERT_TRUE( SampleManager::loadSample( "baz", "mwengine_sample_test.wav" ));
+
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE, SampleManager::getSampleRateForSample( "baz" ));
+    EXPECT_EQ( length * 2, SampleManager::getSampleLength( "baz" ));
+
+    // evicted samples are reloaded at the rate they were registered at
+
+    SampleManager::setMemoryBudget( 1 );
+    EXPECT_FALSE( SampleManager::isSampleLoaded( "baz" ));
+    SampleManager::setMemoryBudget( 0 );
+
+    SampleManager::setResampling( false );
+
+    buffer = SampleManager::getSample( "baz" );
+
+    ASSERT_FALSE( buffer == nullptr );
+    EXPECT_EQ( length * 2, buffer->bufferSize );
+
+    SampleManager::flushSamples();
+    std::remove( "mwengine_sample_test.wav" );
+}
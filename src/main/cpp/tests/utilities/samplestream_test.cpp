@@ -0,0 +1,343 @@
+#include "../../utilities/samplestream.h"
+#include "../../utilities/samplestreamreader.h"
+#include "../../utilities/diskstreamer.h"
+#include "../../utilities/wavereader.h"
+#include "../../utilities/wavewriter.h"
+#include "../../events/sampleevent.h"
+#include "../../instruments/sampledinstrument.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// writes a WAV file (relative to the working directory) where each channel holds
+// a ramp with a different offset so reads from the wrong position or channel are easy to spot
+
+std::string createStreamFile( const char* fileName, int amountOfChannels, int length, int sampleRate = 44100 )
+{
+    AudioBuffer* buffer = new AudioBuffer( amountOfChannels, length );
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        SAMPLE_TYPE* channel = buffer->getBufferForChannel( c );
+        for ( int i = 0; i < length; ++i )
+            channel[ i ] = ( SAMPLE_TYPE )((( i + c * 7919 ) % 32000 ) - 16000 ) / 32767.0;
+    }
+    WaveWriter::bufferToWAV( fileName, buffer, sampleRate );
+    delete buffer;
+
+    return fileName;
+}
+
+// reads amount of frames from given position, invoking the disk read prior to each block
+// returns the amount of frames that differ from the in-memory contents of the file
+
+int readStream( SampleStreamReader* reader, AudioBuffer* expected, int position, int amount, bool fill )
+{
+    int mismatches = 0;
+    int blockSize  = 512;
+
+    for ( int i = 0; i < amount; ++i ) {
+        if ( i % blockSize == 0 ) {
+            while ( fill && reader->fill() ) {}
+            reader->sync();
+        }
+        for ( int c = 0; c < expected->amountOfChannels; ++c ) {
+            if ( reader->read( c, position + i ) != expected->getBufferForChannel( c )[ position + i ])
+                ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+TEST( SampleStream, Properties )
+{
+    std::string file = createStreamFile( "mwengine_stream_test.wav", 2, SampleStream::HEAD_SIZE + 1000 );
+    waveFile WAV     = WaveReader::fileToBuffer( file );
+    SampleStream* stream = new SampleStream( file );
+
+    ASSERT_TRUE( stream->isValid() ) << "expected stream to be valid";
+
+    EXPECT_EQ( file, stream->getFilePath() );
+    EXPECT_EQ( WAV.buffer->bufferSize, stream->getLength() );
+    EXPECT_EQ( 2, stream->getAmountOfChannels() );
+    EXPECT_EQ( 44100, stream->getSampleRate() );
+    EXPECT_EQ( SampleStream::HEAD_SIZE, stream->getHeadLength() )
+        << "expected head to be limited to the head size";
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < stream->getHeadLength(); ++i ) {
+            if ( WAV.buffer->getBufferForChannel( c )[ i ] != stream->getHead()->getBufferForChannel( c )[ i ]) {
+                FAIL() << "expected head to equal the file contents at index " << i;
+            }
+        }
+    }
+
+    SampleStream* invalidStream = new SampleStream( "/nonexistent/file.wav" );
+
+    EXPECT_FALSE( invalidStream->isValid() ) << "expected stream for non existing file to be invalid";
+    EXPECT_EQ( 0, invalidStream->getLength() );
+
+    delete invalidStream;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStream, Read )
+{
+    int length           = 50000;
+    std::string file     = createStreamFile( "mwengine_stream_test.wav", 2, length );
+    waveFile WAV         = WaveReader::fileToBuffer( file );
+    SampleStream* stream = new SampleStream( file );
+    AudioBuffer* buffer  = new AudioBuffer( 2, 1024 );
+
+    std::vector<char> scratch;
+
+    int position = randomInt( SampleStream::HEAD_SIZE, length - 2000 );
+
+    EXPECT_EQ( 1000, stream->read( buffer, 24, position, 1000, scratch ));
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < 1000; ++i ) {
+            EXPECT_EQ( WAV.buffer->getBufferForChannel( c )[ position + i ], buffer->getBufferForChannel( c )[ 24 + i ])
+                << "expected read frame to equal the file contents";
+        }
+    }
+
+    EXPECT_EQ( 100, stream->read( buffer, 0, length - 100, 1000, scratch ))
+        << "expected read to be limited to the stream length";
+
+    delete buffer;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStreamReader, ReadAheadOfPlayPosition )
+{
+    int length                 = SampleStream::HEAD_SIZE + SampleStreamReader::RING_SIZE * 3 + 123;
+    std::string file           = createStreamFile( "mwengine_stream_test.wav", 2, length );
+    waveFile WAV               = WaveReader::fileToBuffer( file );
+    SampleStream* stream       = new SampleStream( file );
+    SampleStreamReader* reader = new SampleStreamReader( stream );
+
+    EXPECT_EQ( stream, reader->getStream() );
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, 0, length, true ))
+        << "expected all streamed frames to equal the file contents";
+
+    delete reader;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStreamReader, Underrun )
+{
+    int length                 = SampleStream::HEAD_SIZE * 3;
+    std::string file           = createStreamFile( "mwengine_stream_test.wav", 1, length );
+    SampleStream* stream       = new SampleStream( file );
+    SampleStreamReader* reader = new SampleStreamReader( stream );
+
+    reader->sync();
+
+    EXPECT_EQ( 0.0, reader->read( 0, SampleStream::HEAD_SIZE + 10 ))
+        << "expected frames to be silent when the disk has not been read";
+
+    while ( reader->fill() ) {}
+    reader->sync();
+
+    EXPECT_EQ( length, reader->getAvailable() )
+        << "expected all frames following the head to be available after reading from disk";
+
+    EXPECT_NE( 0.0, reader->read( 0, SampleStream::HEAD_SIZE + 10 ))
+        << "expected frames to be available after reading from disk";
+
+    delete reader;
+    delete stream;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStreamReader, JumpInPlayback )
+{
+    int length                 = SampleStream::HEAD_SIZE + SampleStreamReader::RING_SIZE * 3;
+    std::string file           = createStreamFile( "mwengine_stream_test.wav", 2, length );
+    waveFile WAV               = WaveReader::fileToBuffer( file );
+    SampleStream* stream       = new SampleStream( file );
+    SampleStreamReader* reader = new SampleStreamReader( stream );
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, 0, SampleStreamReader::RING_SIZE * 2, true ));
+
+    // jump back into the head (e.g. loop), the ring buffer should refill from the end of the head
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, 100, SampleStream::HEAD_SIZE + SampleStreamReader::RING_SIZE, true ))
+        << "expected frames to equal the file contents after jumping back in playback";
+
+    // jump forward to a position that isn't held in memory
+
+    int position = length - 5000;
+
+    reader->read( 0, position );
+    EXPECT_EQ( 0.0, reader->read( 0, position + 1 )) << "expected frame to be unavailable right after the jump";
+
+    while ( reader->fill() ) {}
+    reader->sync();
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, position + 1, 4999, true ))
+        << "expected frames to equal the file contents after jumping forward in playback";
+
+    delete reader;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStreamReader, Anchor )
+{
+    int length                 = SampleStream::HEAD_SIZE * 4;
+    std::string file           = createStreamFile( "mwengine_stream_test.wav", 2, length );
+    waveFile WAV               = WaveReader::fileToBuffer( file );
+    SampleStream* stream       = new SampleStream( file );
+    SampleStreamReader* reader = new SampleStreamReader( stream );
+
+    int anchor = randomInt( SampleStream::HEAD_SIZE, length - SampleStream::HEAD_SIZE );
+
+    reader->setAnchor( 1, anchor );
+
+    EXPECT_EQ( 0.0, reader->read( 0, anchor ))
+        << "expected anchor not to be read on the calling thread";
+
+    // the requested anchor is read by the disk thread in a single pass
+
+    EXPECT_TRUE( reader->fill() ) << "expected the disk thread to read the requested anchor";
+
+    // anchored frames should now be readable without reading from the ring buffer
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, anchor, 2048, false ))
+        << "expected anchored frames to be available once read";
+
+    // continuing from the anchor, the ring buffer should provide the frames following it
+
+    EXPECT_EQ( 0, readStream( reader, WAV.buffer, anchor + 2048, length - ( anchor + 2048 ), true ))
+        << "expected ring buffer to continue from the end of the anchor";
+
+    delete reader;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
+
+TEST( DiskStreamer, FillsReadersInBackground )
+{
+    int length                 = SampleStream::HEAD_SIZE + SampleStreamReader::RING_SIZE * 2;
+    std::string file           = createStreamFile( "mwengine_stream_test.wav", 2, length );
+    SampleStream* stream       = new SampleStream( file );
+    SampleStreamReader* reader = new SampleStreamReader( stream );
+
+    EXPECT_FALSE( DiskStreamer::isRunning() );
+
+    DiskStreamer::addReader( reader );
+
+    EXPECT_TRUE( DiskStreamer::isRunning() ) << "expected disk thread to start when adding a reader";
+
+    // the ring buffer should fill up to a full ring size ahead of the read position
+
+    int expected = SampleStream::HEAD_SIZE + SampleStreamReader::RING_SIZE;
+
+    for ( int i = 0; i < 500 && reader->getAvailable() < expected; ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ));
+
+    EXPECT_EQ( expected, reader->getAvailable() )
+        << "expected disk thread to have filled the readers ring buffer";
+
+    DiskStreamer::removeReader( reader );
+
+    EXPECT_FALSE( DiskStreamer::isRunning() ) << "expected disk thread to stop when removing the last reader";
+
+    delete reader;
+    delete stream;
+    std::remove( file.c_str() );
+}
+
+TEST( SampleStream, SampleEventPlayback )
+{
+    // the file fits in the head of the stream so playback doesn't depend on the disk thread timing
+
+    int length           = randomInt( 2048, 8192 );
+    std::string file     = createStreamFile( "mwengine_stream_test.wav", 2, length, AudioEngineProps::SAMPLE_RATE );
+    waveFile WAV         = WaveReader::fileToBuffer( file );
+    SampleStream* stream = new SampleStream( file );
+
+    SampledInstrument* instrument = new SampledInstrument();
+    AudioBuffer* expectedBuffer   = new AudioBuffer( 2, 512 );
+    AudioBuffer* streamedBuffer   = new AudioBuffer( 2, 512 );
+
+    // play back the same sample from memory and from disk, using ranges,
+    // loops and custom playback rates. Both should give the same output
+
+    for ( int scenario = 0; scenario < 5; ++scenario )
+    {
+        SampleEvent* memoryEvent   = new SampleEvent( instrument );
+        SampleEvent* streamedEvent = new SampleEvent( instrument );
+
+        memoryEvent->setSample( WAV.buffer, WAV.sampleRate );
+
+        ASSERT_TRUE( streamedEvent->setSample( stream )) << "expected stream to be set";
+        EXPECT_EQ( stream, streamedEvent->getSampleStream() );
+        EXPECT_EQ( memoryEvent->getEventLength(), streamedEvent->getEventLength() );
+
+        for ( SampleEvent* event : { memoryEvent, streamedEvent })
+        {
+            switch ( scenario )
+            {
+                case 1:
+                    event->setLoopeable( true, 5 );
+                    event->setLoopStartOffset( length / 3 );
+                    event->setEventLength( length * 3 );
+                    break;
+                case 2:
+                    event->setBufferRangeStart( length / 4 );
+                    event->setBufferRangeEnd( length / 2 );
+                    break;
+                case 3:
+                    event->setPlaybackRate( 0.75f );
+                    break;
+                case 4:
+                    event->setLoopeable( true, 0 );
+                    event->setPlaybackRate( 1.5f );
+                    event->setEventLength( length * 2 );
+                    break;
+            }
+        }
+
+        int maxBufferPosition = memoryEvent->getEventEnd() + expectedBuffer->bufferSize;
+
+        for ( int position = 0; position < maxBufferPosition; position += expectedBuffer->bufferSize )
+        {
+            expectedBuffer->silenceBuffers();
+            streamedBuffer->silenceBuffers();
+
+            memoryEvent->mixBuffer  ( expectedBuffer, position, 0, maxBufferPosition, false, 0, false );
+            streamedEvent->mixBuffer( streamedBuffer, position, 0, maxBufferPosition, false, 0, false );
+
+            for ( int c = 0; c < 2; ++c ) {
+                for ( int i = 0; i < expectedBuffer->bufferSize; ++i ) {
+                    if ( expectedBuffer->getBufferForChannel( c )[ i ] != streamedBuffer->getBufferForChannel( c )[ i ]) {
+                        FAIL() << "expected streamed output to equal in-memory output for scenario " << scenario
+                               << " at position " << ( position + i );
+                    }
+                }
+            }
+        }
+        delete memoryEvent;
+        delete streamedEvent;
+    }
+
+    EXPECT_FALSE( DiskStreamer::isRunning() ) << "expected disk thread to stop once the events are deleted";
+
+    delete expectedBuffer;
+    delete streamedBuffer;
+    delete instrument;
+    delete stream;
+    delete WAV.buffer;
+    std::remove( file.c_str() );
+}
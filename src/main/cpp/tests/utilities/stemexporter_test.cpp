@@ -0,0 +1,150 @@
+#include "../../utilities/stemexporter.h"
+#include "../../utilities/wavereader.h"
+#include "../../channelgroup.h"
+#include <cstdio>
+
+TEST( StemExporter, RegisterStems )
+{
+    AudioChannel* channel = new AudioChannel( 1.F );
+    ChannelGroup* group   = new ChannelGroup();
+
+    EXPECT_EQ( 0, StemExporter::getAmountOfStems() ) << "expected no stems to be registered";
+    EXPECT_FALSE( StemExporter::prepare( AudioEngineProps::BUFFER_SIZE )) << "expected no export without stems";
+
+    EXPECT_TRUE( StemExporter::addChannel( channel, "mwengine_stem_pre.wav", true ));
+    EXPECT_TRUE( StemExporter::addChannel( channel, "mwengine_stem_post.wav", false ));
+    EXPECT_TRUE( StemExporter::addGroup( group, "mwengine_stem_group.wav", false ));
+
+    EXPECT_EQ( 3, StemExporter::getAmountOfStems() );
+
+    EXPECT_TRUE( StemExporter::removeChannel( channel )) << "expected both channel stems to be removed";
+    EXPECT_EQ( 1, StemExporter::getAmountOfStems() );
+    EXPECT_FALSE( StemExporter::removeChannel( channel )) << "expected no stems to be removed for unregistered channel";
+
+    StemExporter::clear();
+    EXPECT_EQ( 0, StemExporter::getAmountOfStems() ) << "expected stems to be cleared";
+
+    delete channel;
+    delete group;
+}
+
+TEST( StemExporter, ExportChannelsAndGroupsInSinglePass )
+{
+    int bufferSize = AudioEngineProps::BUFFER_SIZE;
+    int iterations = randomInt( 2, 10 );
+    int amount     = bufferSize / 2; // render less than the full buffer to validate written sample amounts
+
+    AudioChannel* channel1 = new AudioChannel( 1.F );
+    AudioChannel* channel2 = new AudioChannel( .5F );
+    ChannelGroup* group    = new ChannelGroup( .5F );
+
+    group->addAudioChannel( channel1 );
+    group->addAudioChannel( channel2 );
+
+    StemExporter::addChannel( channel1, "mwengine_stem_pre.wav", true );
+    StemExporter::addChannel( channel2, "mwengine_stem_post.wav", false );
+    StemExporter::addGroup( group, "mwengine_stem_group.wav", true );
+
+    ASSERT_TRUE( StemExporter::prepare( bufferSize ));
+    ASSERT_TRUE( StemExporter::isExporting() );
+    EXPECT_FALSE( StemExporter::addChannel( channel1, "mwengine_stem_ignored.wav", true ))
+        << "expected stems not to be registered while exporting";
+
+    AudioBuffer* output = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, bufferSize );
+
+    for ( int i = 0; i < iterations; ++i ) {
+        fillAudioBuffer( channel1->getOutputBuffer() );
+        fillAudioBuffer( channel2->getOutputBuffer() );
+
+        StemExporter::writeChannel( channel1, channel1->getOutputBuffer(), amount, true, 1.0 );
+        StemExporter::writeChannel( channel1, channel1->getOutputBuffer(), amount, false, 1.0 ); // has no post chain stem
+        StemExporter::writeChannel( channel2, channel2->getOutputBuffer(), amount, false, .5 );
+
+        group->applyEffectsToChannels( output, amount );
+    }
+
+    // validate the last written buffer of the channels
+
+    AudioBuffer* dryBuffer  = channel1->getOutputBuffer()->clone();
+    AudioBuffer* postBuffer = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, bufferSize );
+    channel2->mixBuffer( postBuffer, .5F );
+
+    ASSERT_TRUE( StemExporter::finish() );
+    EXPECT_FALSE( StemExporter::isExporting() );
+
+    waveFile pre   = WaveReader::fileToBuffer( "mwengine_stem_pre.wav" );
+    waveFile post  = WaveReader::fileToBuffer( "mwengine_stem_post.wav" );
+    waveFile mixed = WaveReader::fileToBuffer( "mwengine_stem_group.wav" );
+
+    ASSERT_FALSE( pre.buffer == nullptr || post.buffer == nullptr || mixed.buffer == nullptr )
+        << "expected all stems to have been written";
+
+    EXPECT_EQ( amount * iterations, pre.buffer->bufferSize )  << "expected rendered amount of samples to have been written";
+    EXPECT_EQ( amount * iterations, post.buffer->bufferSize ) << "expected rendered amount of samples to have been written";
+    EXPECT_EQ( amount * iterations, mixed.buffer->bufferSize ) << "expected rendered amount of samples to have been written";
+
+    int offset = amount * ( iterations - 1 );
+
+    for ( int c = 0; c < AudioEngineProps::OUTPUT_CHANNELS; ++c ) {
+        for ( int i = 0; i < amount; ++i ) {
+            EXPECT_NEAR( dryBuffer->getBufferForChannel( c )[ i ], pre.buffer->getBufferForChannel( c )[ offset + i ], 1.0 / 32767 )
+                << "expected pre chain stem to contain the dry channel output";
+            EXPECT_NEAR( postBuffer->getBufferForChannel( c )[ i ], post.buffer->getBufferForChannel( c )[ offset + i ], 1.0 / 32767 )
+                << "expected post chain stem to contain the channel output at its mix volume";
+        }
+    }
+
+    StemExporter::clear();
+
+    delete pre.buffer;
+    delete post.buffer;
+    delete mixed.buffer;
+    delete dryBuffer;
+    delete postBuffer;
+    delete output;
+    delete group;
+    delete channel1;
+    delete channel2;
+
+    remove( "mwengine_stem_pre.wav" );
+    remove( "mwengine_stem_post.wav" );
+    remove( "mwengine_stem_group.wav" );
+}
+
+TEST( StemExporter, StopAndFinish )
+{
+    int amount            = AudioEngineProps::BUFFER_SIZE;
+    AudioChannel* channel = new AudioChannel( 1.F );
+
+    StemExporter::addChannel( channel, "mwengine_stem_pre.wav", true );
+
+    ASSERT_TRUE( StemExporter::prepare( amount ));
+
+    fillAudioBuffer( channel->getOutputBuffer() );
+    StemExporter::writeChannel( channel, channel->getOutputBuffer(), amount, true, 1.0 );
+
+    // the render thread stops writing once the bounce completes
+
+    StemExporter::stop();
+
+    EXPECT_FALSE( StemExporter::isExporting() ) << "expected no export after stopping";
+    EXPECT_FALSE( StemExporter::addChannel( channel, "mwengine_stem_ignored.wav", true ))
+        << "expected stems not to be registered until the export has been finished";
+
+    StemExporter::writeChannel( channel, channel->getOutputBuffer(), amount, true, 1.0 ); // ignored
+
+    EXPECT_TRUE( StemExporter::finish() )  << "expected stopped export to be finished";
+    EXPECT_FALSE( StemExporter::finish() ) << "expected finishing to be safe to repeat";
+
+    waveFile pre = WaveReader::fileToBuffer( "mwengine_stem_pre.wav" );
+
+    ASSERT_FALSE( pre.buffer == nullptr ) << "expected stem to have been written";
+    EXPECT_EQ( amount, pre.buffer->bufferSize ) << "expected no samples to have been written after stopping";
+
+    StemExporter::clear();
+
+    delete pre.buffer;
+    delete channel;
+
+    remove( "mwengine_stem_pre.wav" );
+}
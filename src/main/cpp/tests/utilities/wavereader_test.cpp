@@ -0,0 +1,213 @@
+#include "../../utilities/wavereader.h"
+#include <cstdint>
+
+// helpers to generate WAV file contents in memory
+
+void appendBytes( std::vector<char>& bytes, uint32_t value, int amount )
+{
+    for ( int i = 0; i < amount; ++i )
+        bytes.push_back(( char )(( value >> ( i * 8 )) & 0xFF ));
+}
+
+std::vector<char> createWAV( uint16_t format, uint16_t channels, uint16_t bitsPerSample,
+                             const std::vector<char>& sampleData, bool extensible = false, bool metaData = false )
+{
+    std::vector<char> bytes;
+    uint32_t formatLength = extensible ? 40 : 16;
+    uint16_t blockAlign   = channels * bitsPerSample / 8;
+
+    bytes.insert( bytes.end(), { 'R', 'I', 'F', 'F' });
+    appendBytes( bytes, 0, 4 ); // file size, not validated by the reader
+    bytes.insert( bytes.end(), { 'W', 'A', 'V', 'E' });
+
+    if ( metaData ) {
+        // odd sized chunk to validate word alignment
+        bytes.insert( bytes.end(), { 'L', 'I', 'S', 'T' });
+        appendBytes( bytes, 3, 4 );
+        bytes.insert( bytes.end(), { 'a', 'b', 'c', 0 });
+    }
+
+    bytes.insert( bytes.end(), { 'f', 'm', 't', ' ' });
+    appendBytes( bytes, formatLength, 4 );
+    appendBytes( bytes, extensible ? 0xFFFE : format, 2 );
+    appendBytes( bytes, channels, 2 );
+    appendBytes( bytes, 48000, 4 );
+    appendBytes( bytes, 48000 * blockAlign, 4 );
+    appendBytes( bytes, blockAlign, 2 );
+    appendBytes( bytes, bitsPerSample, 2 );
+
+    if ( extensible ) {
+        appendBytes( bytes, 22, 2 );            // extension size
+        appendBytes( bytes, bitsPerSample, 2 ); // valid bits per sample
+        appendBytes( bytes, 0, 4 );             // channel mask
+        appendBytes( bytes, format, 2 );        // SubFormat GUID (first two bytes describe format)
+        for ( int i = 0; i < 14; ++i )
+            bytes.push_back( 0 );
+    }
+
+    bytes.insert( bytes.end(), { 'd', 'a', 't', 'a' });
+    appendBytes( bytes, ( uint32_t ) sampleData.size(), 4 );
+    bytes.insert( bytes.end(), sampleData.begin(), sampleData.end() );
+
+    return bytes;
+}
+
+TEST( WaveReader, PCM16 )
+{
+    std::vector<char> samples;
+    int16_t values[] = { 32767, -32767, 0, 16384, -16384, 1 };
+
+    for ( int16_t value : values )
+        appendBytes( samples, ( uint16_t ) value, 2 );
+
+    waveFile WAV = WaveReader::byteArrayToBuffer( createWAV( 1, 2, 16, samples, false, true ));
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected WAV data to have been parsed";
+
+    EXPECT_EQ( 48000, WAV.sampleRate );
+    EXPECT_EQ( 2, WAV.buffer->amountOfChannels );
+    EXPECT_EQ( 3, WAV.buffer->bufferSize );
+
+    for ( int i = 0; i < 3; ++i ) {
+        EXPECT_DOUBLE_EQ( values[ i * 2 ]     / 32767.0, WAV.buffer->getBufferForChannel( 0 )[ i ]) << "expected deinterleaved left channel";
+        EXPECT_DOUBLE_EQ( values[ i * 2 + 1 ] / 32767.0, WAV.buffer->getBufferForChannel( 1 )[ i ]) << "expected deinterleaved right channel";
+    }
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, PCM24 )
+{
+    std::vector<char> samples;
+    int32_t values[] = { 8388607, -8388607, 0, -1 };
+
+    for ( int32_t value : values )
+        appendBytes( samples, ( uint32_t ) value, 3 );
+
+    waveFile WAV = WaveReader::byteArrayToBuffer( createWAV( 1, 1, 24, samples ));
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected WAV data to have been parsed";
+    EXPECT_EQ( 4, WAV.buffer->bufferSize );
+
+    for ( int i = 0; i < 4; ++i )
+        EXPECT_DOUBLE_EQ( values[ i ] / 8388607.0, WAV.buffer->getBufferForChannel( 0 )[ i ]) << "expected signed 24-bit conversion";
+
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, Float32Extensible )
+{
+    std::vector<char> samples;
+    float values[] = { 0.5f, -0.25f, 1.f, -1.f };
+
+    for ( float value : values ) {
+        uint32_t bits;
+        memcpy( &bits, &value, sizeof( float ));
+        appendBytes( samples, bits, 4 );
+    }
+
+    std::vector<char> bytes = createWAV( 3, 2, 32, samples, true );
+    waveFile WAV = WaveReader::memoryToBuffer( bytes.data(), bytes.size() );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected WAVE_FORMAT_EXTENSIBLE data to have been parsed";
+    EXPECT_EQ( 2, WAV.buffer->bufferSize );
+
+    EXPECT_DOUBLE_EQ( 0.5,   WAV.buffer->getBufferForChannel( 0 )[ 0 ]);
+    EXPECT_DOUBLE_EQ( -0.25, WAV.buffer->getBufferForChannel( 1 )[ 0 ]);
+    EXPECT_DOUBLE_EQ( 1.0,   WAV.buffer->getBufferForChannel( 0 )[ 1 ]);
+    EXPECT_DOUBLE_EQ( -1.0,  WAV.buffer->getBufferForChannel( 1 )[ 1 ]);
+
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, DataBeforeFormat )
+{
+    std::vector<char> samples;
+    int16_t values[] = { 16384, -16384 };
+
+    for ( int16_t value : values )
+        appendBytes( samples, ( uint16_t ) value, 2 );
+
+    // move the data chunk (which is written last) in front of the format chunk
+
+    std::vector<char> wav   = createWAV( 1, 1, 16, samples );
+    size_t dataChunkSize    = 8 + samples.size();
+    std::vector<char> bytes( wav.begin(), wav.begin() + 12 );
+
+    bytes.insert( bytes.end(), wav.end() - dataChunkSize, wav.end() );
+    bytes.insert( bytes.end(), wav.begin() + 12, wav.end() - dataChunkSize );
+
+    waveFile WAV = WaveReader::byteArrayToBuffer( bytes );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected format chunk following the data chunk to have been found";
+    EXPECT_EQ( 2, WAV.buffer->bufferSize );
+
+    for ( int i = 0; i < 2; ++i )
+        EXPECT_DOUBLE_EQ( values[ i ] / 32767.0, WAV.buffer->getBufferForChannel( 0 )[ i ]);
+
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, PaddedBlockAlign )
+{
+    // 16-bit samples stored in 4 byte frames
+
+    std::vector<char> samples;
+    int16_t values[] = { 32767, -16384, 1 };
+
+    for ( int16_t value : values ) {
+        appendBytes( samples, ( uint16_t ) value, 2 );
+        appendBytes( samples, 0xFFFF, 2 ); // padding
+    }
+
+    std::vector<char> bytes = createWAV( 1, 1, 16, samples );
+    bytes[ 32 ] = 4; // block align (follows the RIFF header, chunk header and 12 bytes of format data)
+
+    waveFile WAV = WaveReader::byteArrayToBuffer( bytes );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_EQ( 3, WAV.buffer->bufferSize );
+
+    for ( int i = 0; i < 3; ++i )
+        EXPECT_DOUBLE_EQ( values[ i ] / 32767.0, WAV.buffer->getBufferForChannel( 0 )[ i ]) << "expected frames to be read at the block alignment";
+
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, LargeBuffer )
+{
+    // exceeds a single decode block
+
+    int bufferSize = 10000;
+    std::vector<char> samples;
+
+    for ( int i = 0; i < bufferSize * 2; ++i )
+        appendBytes( samples, ( uint16_t )( int16_t )( i % 1000 ), 2 );
+
+    waveFile WAV = WaveReader::byteArrayToBuffer( createWAV( 1, 2, 16, samples ));
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_EQ( bufferSize, WAV.buffer->bufferSize );
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        EXPECT_DOUBLE_EQ((( i * 2 ) % 1000 ) / 32767.0,     WAV.buffer->getBufferForChannel( 0 )[ i ]);
+        EXPECT_DOUBLE_EQ((( i * 2 + 1 ) % 1000 ) / 32767.0, WAV.buffer->getBufferForChannel( 1 )[ i ]);
+    }
+    delete WAV.buffer;
+}
+
+TEST( WaveReader, InvalidData )
+{
+    std::vector<char> bytes = { 'n', 'o', 't', ' ', 'a', ' ', 'w', 'a', 'v', 'e', '!', '!' };
+
+    EXPECT_TRUE( WaveReader::byteArrayToBuffer( bytes ).buffer == nullptr )
+        << "expected no buffer for invalid data";
+
+    EXPECT_TRUE( WaveReader::fileToBuffer( "/nonexistent/file.wav" ).buffer == nullptr )
+        << "expected no buffer for non existing file";
+
+    // unsupported format (A-law)
+
+    std::vector<char> samples = { 1, 2, 3, 4 };
+    EXPECT_TRUE( WaveReader::byteArrayToBuffer( createWAV( 6, 1, 8, samples )).buffer == nullptr )
+        << "expected no buffer for unsupported format";
+}
@@ -0,0 +1,378 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "blockallocator.h"
+#include <algorithm>
+#include <thread>
+
+namespace MWEngine {
+
+// composes the free list head for given block index, incrementing the tag of given head
+
+inline uint64_t tagHead( uint64_t head, uint32_t index )
+{
+    return ((( head >> 32 ) + 1 ) << 32 ) | index;
+}
+
+/* constructor / destructor */
+
+BlockAllocator::BlockAllocator( size_t blockSize, int blocksPerChunk )
+{
+    // blocks must be able to hold the free list link and are padded to keep successive blocks aligned
+
+    blockSize = std::max( blockSize, sizeof( freeBlock ));
+
+    _blockSize      = (( blockSize + BLOCK_ALIGNMENT - 1 ) / BLOCK_ALIGNMENT ) * BLOCK_ALIGNMENT;
+    _blocksPerChunk = std::max( 1, blocksPerChunk );
+    _chunks         = new std::vector<chunk>();
+
+    for ( auto& page : _pages ) {
+        page = nullptr;
+    }
+}
+
+BlockAllocator::~BlockAllocator()
+{
+    auto chunks = _chunks.load();
+
+    for ( auto& chunk : *chunks ) {
+        delete[] chunk.memory;
+    }
+    delete chunks;
+
+    for ( auto& page : _pages ) {
+        delete[] page.load();
+    }
+}
+
+/* public methods */
+
+void* BlockAllocator::allocate()
+{
+    // replenish the blocks that tryAllocate() found to be exhausted
+
+    if ( _depleted.exchange( false )) {
+        reserve( _blocksPerChunk );
+    }
+    void* block = pop();
+
+    if ( block != nullptr ) {
+        return block;
+    }
+
+    // all blocks are in use, allocate a new chunk (unless another thread did so in the meantime)
+
+    std::lock_guard<std::mutex> guard( _lock );
+
+    while (( block = pop()) == nullptr ) {
+        if ( !addChunk() ) {
+            return nullptr;
+        }
+    }
+    return block;
+}
+
+void* BlockAllocator::tryAllocate()
+{
+    void* block = pop();
+
+    if ( block == nullptr ) {
+        _depleted.store( true );
+    }
+    return block;
+}
+
+bool BlockAllocator::release( void* block )
+{
+    if ( block == nullptr ) {
+        return false;
+    }
+    ++_operations;
+
+    const chunk* owner = getChunk( _chunks.load(), block );
+
+    if ( owner != nullptr )
+    {
+        uint32_t index = owner->id * _blocksPerChunk + ( uint32_t )(( static_cast<char*>( block ) - owner->blocks ) / _blockSize ) + 1;
+        push( index, static_cast<char*>( block ));
+        --_blocksInUse;
+    }
+    --_operations;
+
+    return owner != nullptr;
+}
+
+bool BlockAllocator::owns( void* block )
+{
+    ++_operations;
+    bool owned = getChunk( _chunks.load(), block ) != nullptr;
+    --_operations;
+
+    return owned;
+}
+
+void BlockAllocator::reserve( int amountOfBlocks )
+{
+    std::lock_guard<std::mutex> guard( _lock );
+
+    while (( int ) _chunks.load()->size() * _blocksPerChunk - _blocksInUse.load() < amountOfBlocks ) {
+        if ( !addChunk() ) {
+            break;
+        }
+    }
+}
+
+int BlockAllocator::trim()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+
+    // detach the free list, once the lock free operations that might have read it have completed,
+    // the free blocks are exclusively owned here (blocks released in the meantime form a new list)
+
+    uint64_t head = _freeList.load();
+    while ( !_freeList.compare_exchange_weak( head, tagHead( head, 0 ))) {}
+
+    awaitOperations();
+
+    // count the free blocks of each chunk
+
+    auto chunks = _chunks.load();
+    std::vector<int> freeBlocks( chunks->size(), 0 );
+
+    for ( uint32_t index = ( uint32_t ) head; index != 0; ) {
+        char* block = getBlock( index );
+        ++freeBlocks[ getChunk( chunks, block ) - chunks->data() ];
+        index = reinterpret_cast<freeBlock*>( block )->next.load( std::memory_order_relaxed );
+    }
+
+    // relink the free blocks of the chunks that remain in use (retaining their order)
+
+    uint32_t first = 0;
+    char* last     = nullptr;
+
+    for ( uint32_t index = ( uint32_t ) head; index != 0; ) {
+        char* block = getBlock( index );
+        uint32_t next = reinterpret_cast<freeBlock*>( block )->next.load( std::memory_order_relaxed );
+
+        if ( freeBlocks[ getChunk( chunks, block ) - chunks->data() ] < _blocksPerChunk )
+        {
+            if ( last == nullptr ) {
+                first = index;
+            } else {
+                reinterpret_cast<freeBlock*>( last )->next.store( index, std::memory_order_relaxed );
+            }
+            last = block;
+        }
+        index = next;
+    }
+
+    // unregister the unused chunks and delete their memory
+
+    auto remainingChunks = new std::vector<chunk>();
+    std::vector<char*> freedMemory;
+
+    for ( size_t i = 0; i < chunks->size(); ++i )
+    {
+        const chunk& c = chunks->at( i );
+
+        if ( freeBlocks[ i ] < _blocksPerChunk ) {
+            remainingChunks->push_back( c );
+            continue;
+        }
+        _pages[ c.id / CHUNKS_PER_PAGE ].load()[ c.id % CHUNKS_PER_PAGE ].store( nullptr );
+        _freeIds.push_back( c.id );
+        freedMemory.push_back( c.memory );
+    }
+    publishChunks( remainingChunks );
+
+    for ( auto memory : freedMemory ) {
+        delete[] memory;
+    }
+
+    if ( last != nullptr ) {
+        push( first, last );
+    }
+    return ( int ) freedMemory.size();
+}
+
+size_t BlockAllocator::getBlockSize()
+{
+    return _blockSize;
+}
+
+int BlockAllocator::getBlocksInUse()
+{
+    return _blocksInUse.load();
+}
+
+int BlockAllocator::getAmountOfChunks()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return ( int ) _chunks.load()->size();
+}
+
+/* protected methods */
+
+bool BlockAllocator::addChunk()
+{
+    // invoked while holding the lock
+
+    uint32_t id;
+
+    if ( !_freeIds.empty() ) {
+        id = _freeIds.back();
+        _freeIds.pop_back();
+    } else if ( _nextId < ( uint32_t )( MAX_PAGES * CHUNKS_PER_PAGE )) {
+        id = _nextId++;
+    } else {
+        return false;
+    }
+
+    std::atomic<char*>* page = _pages[ id / CHUNKS_PER_PAGE ].load();
+
+    if ( page == nullptr ) {
+        page = new std::atomic<char*>[ CHUNKS_PER_PAGE ];
+        for ( int i = 0; i < CHUNKS_PER_PAGE; ++i ) {
+            page[ i ] = nullptr;
+        }
+        _pages[ id / CHUNKS_PER_PAGE ].store( page );
+    }
+
+    chunk newChunk;
+
+    newChunk.memory = new char[ _blockSize * _blocksPerChunk + BLOCK_ALIGNMENT ];
+    newChunk.blocks = reinterpret_cast<char*>(
+        (( reinterpret_cast<uintptr_t>( newChunk.memory ) + BLOCK_ALIGNMENT - 1 ) / BLOCK_ALIGNMENT ) * BLOCK_ALIGNMENT
+    );
+    newChunk.id = id;
+
+    // link the blocks of the chunk (in order of address)
+
+    uint32_t first = id * _blocksPerChunk + 1;
+
+    for ( int i = 0; i < _blocksPerChunk - 1; ++i ) {
+        reinterpret_cast<freeBlock*>( newChunk.blocks + i * _blockSize )->next.store( first + i + 1, std::memory_order_relaxed );
+    }
+    page[ id % CHUNKS_PER_PAGE ].store( newChunk.blocks );
+
+    auto chunks   = new std::vector<chunk>( *_chunks.load() );
+    auto position = std::upper_bound( chunks->begin(), chunks->end(), newChunk, []( const chunk& a, const chunk& b ) {
+        return a.blocks < b.blocks;
+    });
+    chunks->insert( position, newChunk );
+    publishChunks( chunks );
+
+    push( first, newChunk.blocks + ( _blocksPerChunk - 1 ) * _blockSize );
+
+    return true;
+}
+
+void BlockAllocator::publishChunks( std::vector<chunk>* chunks )
+{
+    // the replaced vector can be deleted once no lock free operation is reading it
+
+    std::vector<chunk>* replaced = _chunks.exchange( chunks );
+    awaitOperations();
+
+    delete replaced;
+}
+
+void BlockAllocator::awaitOperations()
+{
+    while ( _operations.load() > 0 ) {
+        std::this_thread::yield();
+    }
+}
+
+void* BlockAllocator::pop()
+{
+    ++_operations;
+
+    char* block   = nullptr;
+    uint64_t head = _freeList.load();
+
+    while (( uint32_t ) head != 0 )
+    {
+        block = getBlock(( uint32_t ) head );
+
+        // the link of the block can be outdated when it has been popped concurrently, in
+        // which case the tag of the head has changed and the exchange below is retried
+
+        uint32_t next = reinterpret_cast<freeBlock*>( block )->next.load( std::memory_order_relaxed );
+
+        if ( _freeList.compare_exchange_weak( head, tagHead( head, next ))) {
+            break;
+        }
+        block = nullptr;
+    }
+    --_operations;
+
+    if ( block != nullptr ) {
+        ++_blocksInUse;
+    }
+    return block;
+}
+
+void BlockAllocator::push( uint32_t first, char* last )
+{
+    // prepends the linked blocks first..last onto the free list
+
+    freeBlock* tail = reinterpret_cast<freeBlock*>( last );
+    uint64_t head   = _freeList.load();
+
+    do {
+        tail->next.store(( uint32_t ) head, std::memory_order_relaxed );
+    } while ( !_freeList.compare_exchange_weak( head, tagHead( head, first )));
+}
+
+char* BlockAllocator::getBlock( uint32_t index )
+{
+    uint32_t position = index - 1;
+    uint32_t id       = position / _blocksPerChunk;
+
+    char* blocks = _pages[ id / CHUNKS_PER_PAGE ].load()[ id % CHUNKS_PER_PAGE ].load();
+
+    return blocks + ( position % _blocksPerChunk ) * _blockSize;
+}
+
+const BlockAllocator::chunk* BlockAllocator::getChunk( std::vector<chunk>* chunks, void* block )
+{
+    char* address = static_cast<char*>( block );
+
+    // find the last chunk starting at or before given address
+
+    auto it = std::upper_bound( chunks->begin(), chunks->end(), address, []( char* value, const chunk& c ) {
+        return value < c.blocks;
+    });
+
+    if ( it == chunks->begin() ) {
+        return nullptr;
+    }
+    --it;
+
+    if ( address >= it->blocks + _blockSize * _blocksPerChunk ) {
+        return nullptr;
+    }
+    return &( *it );
+}
+
+} // E.O namespace MWEngine
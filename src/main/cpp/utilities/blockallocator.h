@@ -0,0 +1,137 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__BLOCKALLOCATOR_H_INCLUDED__
+#define __MWENGINE__BLOCKALLOCATOR_H_INCLUDED__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace MWEngine {
+/**
+ * BlockAllocator hands out memory blocks of a fixed size. Blocks are carved from
+ * contiguous chunks (each holding blocksPerChunk blocks) and returned blocks are kept
+ * in a free list for reuse. This keeps objects of the same size close together in memory
+ * and keeps repeated allocations of the same size from hitting the heap. The memory of
+ * a chunk is only returned to the system when all of its blocks are free (see trim()).
+ *
+ * Blocks are aligned to BLOCK_ALIGNMENT bytes. The allocator is thread safe: releasing blocks
+ * and tryAllocate() are lock free and never allocate memory (and as such are suitable for the render
+ * thread). Chunks are allocated (under a lock) by allocate() and reserve() once all blocks are in use.
+ */
+class BlockAllocator
+{
+    public:
+        static const size_t BLOCK_ALIGNMENT = 64;
+
+        BlockAllocator( size_t blockSize, int blocksPerChunk );
+        ~BlockAllocator();
+
+        // retrieves a free block, allocating a new chunk when all blocks are in use
+        // returns nullptr when the maximum amount of chunks has been allocated
+
+        void* allocate();
+
+        // retrieves a free block without locking or allocating memory, returns nullptr when all blocks
+        // are in use (in which case the next allocate() replenishes the allocator ahead of time)
+
+        void* tryAllocate();
+
+        // returns given block to the allocator, returns false when the block
+        // was not allocated by this allocator (in which case nothing happens)
+
+        bool release( void* block );
+
+        // whether given block was allocated by this allocator
+
+        bool owns( void* block );
+
+        // allocates chunks until given amount of blocks can be allocated without allocating memory
+
+        void reserve( int amountOfBlocks );
+
+        // frees the memory of all chunks that have no blocks in use
+        // returns the amount of freed chunks
+
+        int trim();
+
+        size_t getBlockSize();
+        int getBlocksInUse();
+        int getAmountOfChunks();
+
+    protected:
+
+        static const int CHUNKS_PER_PAGE = 256;
+        static const int MAX_PAGES       = 256;
+
+        typedef struct
+        {
+            char* memory;      // the allocated memory
+            char* blocks;      // start of the first block within memory (aligned)
+            uint32_t id;       // index of the chunk in the chunk directory
+        } chunk;
+
+        // free blocks link to the next free block by index (see getBlock()), 0 terminating the list
+
+        typedef struct
+        {
+            std::atomic<uint32_t> next;
+        } freeBlock;
+
+        size_t _blockSize;
+        int _blocksPerChunk;
+        std::atomic<int> _blocksInUse { 0 };
+        std::atomic<bool> _depleted { false }; // whether tryAllocate() found all blocks in use
+
+        // head of the free list, the lower 32 bits hold the index of the first free block while the
+        // upper 32 bits hold a tag that increments on each update (preventing ABA on concurrent updates)
+
+        std::atomic<uint64_t> _freeList { 0 };
+
+        // the blocks of each chunk by chunk id (nullptr for freed chunks), allocated in pages on demand
+
+        std::atomic<std::atomic<char*>*> _pages[ MAX_PAGES ];
+        std::vector<uint32_t> _freeIds;
+        uint32_t _nextId = 0;
+
+        // the chunks sorted by address for lookup in getChunk(). The vector is never mutated, but replaced
+        // under the lock. Replaced vectors and freed chunks are deleted once no lock free operations
+        // (counted by _operations) that might have read them are in progress
+
+        std::atomic<std::vector<chunk>*> _chunks;
+        std::atomic<int> _operations { 0 };
+        std::mutex _lock;
+
+        bool addChunk();
+        void publishChunks( std::vector<chunk>* chunks );
+        void awaitOperations();
+        void* pop();
+        void push( uint32_t first, char* last );
+        char* getBlock( uint32_t index );
+        const chunk* getChunk( std::vector<chunk>* chunks, void* block );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -21,7 +21,12 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "bufferpool.h"
+#include "../audioenginecontext.h"
 #include <utilities/bufferutility.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
 
 namespace MWEngine {
 namespace BufferPool
@@ -29,6 +34,56 @@ namespace BufferPool
     std::map<unsigned int, SAMPLE_TYPE*> _silentBufferMap;
     ringMap                              _eventBufferMap;
 
+    // the buffer allocators by buffer size. Allocators are only appended (under the buffer lock) and
+    // published through their amount, as such existing allocators are retrieved lock free. These are
+    // never destroyed as AudioBuffers can be released during static destruction (e.g. by the
+    // AudioEngine's default context)
+
+    typedef struct {
+        int size;
+        BlockAllocator* allocator;
+    } bufferAllocator;
+
+    bufferAllocator  _bufferAllocators[ MAX_POOLED_SIZES ];
+    std::atomic<int> _amountOfBufferAllocators { 0 };
+
+    std::mutex& getBufferLock()
+    {
+        static auto lock = new std::mutex();
+        return *lock;
+    }
+
+    BlockAllocator* getBufferAllocator( int aBufferSize, bool create )
+    {
+        for ( int i = 0, l = _amountOfBufferAllocators.load(); i < l; ++i ) {
+            if ( _bufferAllocators[ i ].size == aBufferSize ) {
+                return _bufferAllocators[ i ].allocator;
+            }
+        }
+
+        if ( !create ) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> guard( getBufferLock() );
+
+        int amount = _amountOfBufferAllocators.load();
+
+        for ( int i = 0; i < amount; ++i ) {
+            if ( _bufferAllocators[ i ].size == aBufferSize ) {
+                return _bufferAllocators[ i ].allocator;
+            }
+        }
+
+        if ( amount == MAX_POOLED_SIZES ) {
+            return nullptr;
+        }
+        _bufferAllocators[ amount ].size      = aBufferSize;
+        _bufferAllocators[ amount ].allocator = new BlockAllocator( aBufferSize * sizeof( SAMPLE_TYPE ), BUFFERS_PER_CHUNK );
+        _amountOfBufferAllocators.store( amount + 1 );
+
+        return _bufferAllocators[ amount ].allocator;
+    }
+
     SAMPLE_TYPE* getSilentBuffer( int aBufferSize )
     {
         // retrieve buffer from map if existed
@@ -47,6 +102,71 @@ namespace BufferPool
         }
     }
 
+    SAMPLE_TYPE* allocateBuffer( int aBufferSize, bool pooled )
+    {
+        if ( aBufferSize <= 0 ) {
+            return nullptr;
+        }
+        size_t size  = aBufferSize * sizeof( SAMPLE_TYPE );
+        void* buffer = nullptr;
+
+        // the render thread never locks the pool nor grows it, when the reserved buffers are exhausted
+        // (see reserveBuffers()) the pool is replenished by the next allocation of a controlling thread
+
+        if ( pooled ) {
+            bool rendering = AudioEngineContext::getRenderingContext() != nullptr;
+            BlockAllocator* allocator = getBufferAllocator( aBufferSize, !rendering );
+
+            if ( allocator != nullptr ) {
+                buffer = rendering ? allocator->tryAllocate() : allocator->allocate();
+            }
+        }
+
+        // buffers that are not pooled (or exceed the pools capacity) are allocated on the heap
+
+        if ( buffer == nullptr && posix_memalign( &buffer, BlockAllocator::BLOCK_ALIGNMENT, size ) != 0 ) {
+            return nullptr;
+        }
+        memset( buffer, 0, size );
+        return static_cast<SAMPLE_TYPE*>( buffer );
+    }
+
+    void releaseBuffer( SAMPLE_TYPE* aBuffer, int aBufferSize )
+    {
+        if ( aBuffer == nullptr ) {
+            return;
+        }
+
+        // buffers that were not pooled are released to the heap, as such we query for the owner
+
+        BlockAllocator* allocator = getBufferAllocator( aBufferSize, false );
+
+        if ( allocator != nullptr && allocator->release( aBuffer )) {
+            return;
+        }
+        free( aBuffer );
+    }
+
+    void reserveBuffers( int aBufferSize, int amount )
+    {
+        BlockAllocator* allocator = ( aBufferSize > 0 ) ? getBufferAllocator( aBufferSize, true ) : nullptr;
+
+        if ( allocator != nullptr ) {
+            allocator->reserve( amount );
+        }
+    }
+
+    int trimBuffers()
+    {
+        std::lock_guard<std::mutex> guard( getBufferLock() );
+
+        int freedChunks = 0;
+        for ( int i = 0, l = _amountOfBufferAllocators.load(); i < l; ++i ) {
+            freedChunks += _bufferAllocators[ i ].allocator->trim();
+        }
+        return freedChunks;
+    }
+
     RingBuffer* getRingBufferForEvent( BaseSynthEvent* aEvent, float aFrequency )
     {
         // retrieve eventMap from map if existed
@@ -24,6 +24,7 @@
 #define __MWENGINE__BUFFERPOOL_H_INCLUDED__
 
 #include "../ringbuffer.h"
+#include "blockallocator.h"
 #include <events/basesynthevent.h>
 #include <map>
 
@@ -36,6 +37,26 @@ namespace BufferPool
 
     extern SAMPLE_TYPE* getSilentBuffer( int aBufferSize );
 
+    // allocates a silent sample buffer of given size, aligned to BlockAllocator::BLOCK_ALIGNMENT bytes
+    // When pooled, the buffer is served by a fixed-block allocator for buffers of given size (e.g. for the
+    // AudioBuffers of synth events and channels), preventing heap fragmentation and contention when these
+    // are created in bulk. Buffers must be freed using releaseBuffer(). On the render thread, allocating and
+    // releasing pooled buffers never locks the pool nor grows it, once the reserved buffers (see reserveBuffers())
+    // are exhausted, buffers are allocated on the heap until a controlling thread has replenished the pool
+
+    extern SAMPLE_TYPE* allocateBuffer( int aBufferSize, bool pooled );
+    extern void releaseBuffer( SAMPLE_TYPE* aBuffer, int aBufferSize );
+
+    // ensures given amount of pooled buffers of given size can be allocated without allocating
+    // memory, this should be invoked outside of the render thread (e.g. prior to rendering)
+
+    extern void reserveBuffers( int aBufferSize, int amount );
+
+    // frees the memory of all pooled buffers that are no longer in use
+    // returns the amount of freed chunks
+
+    extern int trimBuffers();
+
     // lazily instantiates / retrieves existing RingBuffer for given aEvent
     // as pitch modulators (see arpeggiator) might shift the frequency of the
     // given event, second argument aFrequency ensures multiple buffers for a single event
@@ -53,6 +74,9 @@ namespace BufferPool
 
     extern ringMap                              _eventBufferMap;
     extern std::map<unsigned int, SAMPLE_TYPE*> _silentBufferMap;
+
+    const int BUFFERS_PER_CHUNK = 32;
+    const int MAX_POOLED_SIZES  = 16; // buffers of sizes exceeding this amount are allocated on the heap
 }
 } // E.O namespace MWEngine
 
@@ -21,6 +21,7 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <utilities/bufferutility.h>
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <fstream>
@@ -83,6 +84,27 @@ int BufferUtility::calculateBufferLength( int milliSeconds )
     return milliSeconds * ( AudioEngineProps::SAMPLE_RATE / 1000 );
 }
 
+/* musical time conversion */
+
+double BufferUtility::samplesToTicks( int samples, int samplesPerBar )
+{
+    // translate the whole measures and the offset within the measure separately
+    // so a position never rounds into a neighbouring measure
+
+    int measure = ( int ) floor(( double ) samples / samplesPerBar );
+
+    return ( double ) measure * TICKS_PER_MEASURE +
+           ( double )( samples - measure * samplesPerBar ) * TICKS_PER_MEASURE / samplesPerBar;
+}
+
+int BufferUtility::ticksToSamples( double ticks, int samplesPerBar )
+{
+    int measure = ( int ) floor( ticks / TICKS_PER_MEASURE );
+    int offset  = ( int ) round(( ticks - ( double ) measure * TICKS_PER_MEASURE ) * samplesPerBar / TICKS_PER_MEASURE );
+
+    return measure * samplesPerBar + std::min( offset, samplesPerBar - 1 );
+}
+
 /* beat calculation */
 
 double BufferUtility::getBPMbyLength( double length, int amountOfBars )
@@ -92,6 +92,21 @@ class BufferUtility
          */
         static int getSamplesPerBar( int sampleRate, double tempo, int beatAmount, int beatUnit );
 
+        /* musical time conversion */
+
+        /**
+         * Translates given position in samples to a position in musical ticks (where a single
+         * measure spans TICKS_PER_MEASURE ticks) for a measure of given samplesPerBar in length.
+         * Both positions resolve to the same measure.
+         */
+        static double samplesToTicks( int samples, int samplesPerBar );
+
+        /**
+         * The reverse of samplesToTicks. Calculates the position in samples for given position
+         * in musical ticks, for a measure of given samplesPerBar in length.
+         */
+        static int ticksToSamples( double ticks, int samplesPerBar );
+
         /* beat calculation */
 
         /**
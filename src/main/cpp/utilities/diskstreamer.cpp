@@ -0,0 +1,150 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "diskstreamer.h"
+#include "perfutility.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWEngine {
+
+// the time the disk thread sleeps when none of the readers require data
+
+static const int IDLE_INTERVAL_MS = 2;
+
+namespace DiskStreamerReaders
+{
+    std::vector<SampleStreamReader*> _readers;
+    std::mutex _mutex;
+    std::thread* _thread = nullptr;
+
+    // the reader the disk thread is currently reading for (read outside of the lock)
+
+    std::atomic<SampleStreamReader*> _current( nullptr );
+
+    // identifies the currently active thread, a thread that is being stopped
+    // will exit once it notices it is no longer the active one
+
+    int _threadId = 0;
+}
+
+/* public methods */
+
+void DiskStreamer::addReader( SampleStreamReader* reader )
+{
+    std::lock_guard<std::mutex> lock( DiskStreamerReaders::_mutex );
+
+    std::vector<SampleStreamReader*>& readers = DiskStreamerReaders::_readers;
+
+    if ( std::find( readers.begin(), readers.end(), reader ) == readers.end() )
+        readers.push_back( reader );
+
+    if ( DiskStreamerReaders::_thread == nullptr )
+        DiskStreamerReaders::_thread = new std::thread( &DiskStreamer::run, ++DiskStreamerReaders::_threadId );
+}
+
+void DiskStreamer::removeReader( SampleStreamReader* reader )
+{
+    std::thread* thread = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( DiskStreamerReaders::_mutex );
+
+        std::vector<SampleStreamReader*>& readers = DiskStreamerReaders::_readers;
+        readers.erase( std::remove( readers.begin(), readers.end(), reader ), readers.end() );
+
+        if ( readers.empty() && DiskStreamerReaders::_thread != nullptr ) {
+            thread = DiskStreamerReaders::_thread;
+            DiskStreamerReaders::_thread = nullptr;
+            ++DiskStreamerReaders::_threadId;
+        }
+    }
+
+    // the disk thread could be reading for the reader right now, wait until it has finished
+
+    while ( DiskStreamerReaders::_current.load() == reader )
+        std::this_thread::yield();
+
+    // join outside of the lock as the thread requires it to notice it should stop
+
+    if ( thread != nullptr ) {
+        thread->join();
+        delete thread;
+    }
+}
+
+bool DiskStreamer::isRunning()
+{
+    std::lock_guard<std::mutex> lock( DiskStreamerReaders::_mutex );
+    return DiskStreamerReaders::_thread != nullptr;
+}
+
+/* private methods */
+
+void DiskStreamer::run( int threadId )
+{
+    PerfUtility::disableDenormals();
+
+    std::vector<SampleStreamReader*> readers;
+
+    while ( true )
+    {
+        {
+            std::lock_guard<std::mutex> lock( DiskStreamerReaders::_mutex );
+
+            if ( threadId != DiskStreamerReaders::_threadId )
+                break;
+
+            readers = DiskStreamerReaders::_readers;
+        }
+
+        // disk reads take place outside of the lock so adding and removing readers
+        // is never blocked by I/O, a reader is only read for while it is still registered
+
+        bool busy = false;
+
+        for ( SampleStreamReader* reader : readers )
+        {
+            {
+                std::lock_guard<std::mutex> lock( DiskStreamerReaders::_mutex );
+
+                std::vector<SampleStreamReader*>& registered = DiskStreamerReaders::_readers;
+
+                if ( std::find( registered.begin(), registered.end(), reader ) == registered.end() )
+                    continue;
+
+                DiskStreamerReaders::_current.store( reader );
+            }
+            busy |= reader->fill();
+
+            DiskStreamerReaders::_current.store( nullptr );
+        }
+
+        if ( !busy )
+            std::this_thread::sleep_for( std::chrono::milliseconds( IDLE_INTERVAL_MS ));
+    }
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,53 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__DISKSTREAMER_H_INCLUDED__
+#define __MWENGINE__DISKSTREAMER_H_INCLUDED__
+
+#include "samplestreamreader.h"
+
+/**
+ * DiskStreamer is a static class that manages the background thread reading the
+ * contents of SampleStreams from disk into the ring buffers of the registered
+ * SampleStreamReaders. The thread is started when the first reader is added and
+ * stops when the last reader is removed.
+ *
+ * Readers are serviced in turn, one block at a time, so all voices are read ahead
+ * of their play position equally. When none of the readers require data the thread sleeps briefly.
+ */
+namespace MWEngine {
+class DiskStreamer
+{
+    public:
+        static void addReader( SampleStreamReader* reader );
+
+        // removes given reader, once this returns the reader is no longer accessed by the disk thread
+        static void removeReader( SampleStreamReader* reader );
+
+        static bool isRunning();
+
+    private:
+        static void run( int threadId );
+};
+} // E.O namespace MWEngine
+
+#endif
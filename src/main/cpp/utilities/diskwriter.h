@@ -24,18 +24,17 @@
 #define __MWENGINE__DISKWRITER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "wavestreamwriter.h"
 #include <string>
-#include <vector>
 
 /**
- * DiskWriter is a utility that records audio for a given buffer length
- * (for instance to record a whole measure of live generated music) and
- * appends the AudioBuffer rendered by the engines until the buffer is full,
- * after which the contents can be written onto disk in PCM .WAV format
+ * DiskWriter is a utility that records the audio rendered by the engine
+ * into a single PCM .WAV file on disk.
  *
- * To overcome excessive memory consumption / CPU resources recordings are
- * written in snippets (with a length defined by chunkSize in the prepare()-method).
- * When a full snippet has been recorded, a
+ * The rendered audio is streamed onto storage by a WaveStreamWriter, as such memory
+ * usage is bounded by the size of its ring buffer (defined by chunkSize in the
+ * prepare()-method) regardless of the recording duration and no temporary files
+ * are written.
  */
 namespace MWEngine {
 namespace DiskWriter
@@ -44,65 +43,38 @@ namespace DiskWriter
 
     //namespace
     //{
-        typedef struct
-        {
-            std::string path; // path to written WAV file
-            size_t size;      // total size of the WAV file's sample buffer
-
-        } writtenFile;
-
-        extern std::string               outputFile;         // the file name to write the output to when finished
-        extern std::string               tempDirectory;      // output directory to write temporary files to
-        extern std::vector<writtenFile>  outputFiles;
-        extern std::vector<AudioBuffer*> cachedBuffers;
-
-        extern int recordingChunkSize;
-        extern int outputWriterIndex;
-        extern int savedSnippets;      // amount of snippets within the current recording that have been saved
-        extern int recordingChannelAmount;
-
-        extern bool prepared;
-
-        extern AudioBuffer* getCachedBuffer( int bufferIndex );
-        extern void flushOutput( int bufferIndex );
-
-        extern AudioBuffer* generateOutputBuffer( int bufferIndex, int amountOfChannels );
+        extern WaveStreamWriter* writer;
     //}
 
     /* public properties / methods */
 
-    extern int currentBufferIndex; // index of the cachedBuffer currently being written to
-
     /**
-     * Prepare for a new recording. The recording can consist
-     * of multiple iterations, each of given chunkSize in buffer size.
+     * Prepare for a new recording into given outputFilename. chunkSize describes
+     * the size (in sample frames) of the ring buffer that holds the rendered audio
+     * until it has been appended to the output file.
      */
     extern void prepare( std::string outputFilename, int chunkSize, int amountOfChannels );
 
     /**
-     * Invoked by the engine whenever a snippet has filled its buffer. This method will prepare the
-     * next snippet to continue recording audio into. We allow two snippets to exist at a time.
-     * When this is invoked, the engine will at the same time broadcast RECORDED_SNIPPET_READY
-     * which should be used to save the snippet contents onto storage so it can be unloaded from memory.
-     * This saving should happen in a separate thread to prevent buffer under runs from occurring while
-     * the engine continues to render audio while recording large fragments. Saving should however
-     * complete before the next snippet has filled its complete buffer to prevent data loss!
+     * Complete a recording. This waits for all pending audio to
+     * be appended to the output file and finalizes the WAV header.
+     * Returns false when no recording was prepared.
      */
-    extern void prepareSnippet();
+    extern bool finish();
 
     /**
-     * Complete a recording. This will combine all written files
-     * into a single WAV file defined by outputFile.
-     *
-     * For best performance while keeping the engine rendering audio, execute
-     * this in a separate thread.
+     * Append audio into the recording. These are invoked from the render thread
+     * and do not block (unless bouncing, where no hardware deadline applies and
+     * the engine waits for the writer thread rather than discarding audio).
      */
-    extern bool finish();
-
     extern void appendBuffer( AudioBuffer* aBuffer );
     extern void appendBuffer( float* aBuffer, int aBufferSize, int amountOfChannels );
-    extern bool bufferFull();
-    extern void writeBufferToFile( int bufferIndex, bool broadcastUpdate );
+
+    /**
+     * Amount of sample frames that were discarded during the current recording as the
+     * writer thread could not keep up with the render thread (e.g. due to slow storage)
+     */
+    extern size_t getDroppedFrames();
 }
 } // E.O namespace MWEngine
 
@@ -0,0 +1,122 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "eventpool.h"
+#include "../audioenginecontext.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace MWEngine {
+namespace EventPool
+{
+    // one allocator per size class, lazily created on first use (under the lock, existing allocators
+    // are retrieved lock free). The allocators and lock are never destroyed as events can be deleted
+    // during static destruction
+
+    std::atomic<BlockAllocator*> _allocators[ MAX_SIZE / SIZE_CLASS ];
+
+    std::mutex& getLock()
+    {
+        static auto lock = new std::mutex();
+        return *lock;
+    }
+
+    BlockAllocator* getAllocator( size_t size, bool create )
+    {
+        size_t sizeClass = ( size + SIZE_CLASS - 1 ) / SIZE_CLASS - 1;
+        BlockAllocator* allocator = _allocators[ sizeClass ].load();
+
+        if ( allocator != nullptr || !create ) {
+            return allocator;
+        }
+        std::lock_guard<std::mutex> guard( getLock() );
+
+        if ( _allocators[ sizeClass ].load() == nullptr ) {
+            _allocators[ sizeClass ].store( new BlockAllocator(( sizeClass + 1 ) * SIZE_CLASS, EVENTS_PER_CHUNK ));
+        }
+        return _allocators[ sizeClass ].load();
+    }
+
+    void* allocate( size_t size )
+    {
+        void* event = nullptr;
+
+        // the render thread never locks the pool nor grows it (the next allocation of a
+        // controlling thread replenishes the pool when it was found to be exhausted)
+
+        if ( size > 0 && size <= MAX_SIZE ) {
+            if ( AudioEngineContext::getRenderingContext() == nullptr ) {
+                event = getAllocator( size, true )->allocate();
+            } else {
+                BlockAllocator* allocator = getAllocator( size, false );
+                event = ( allocator != nullptr ) ? allocator->tryAllocate() : nullptr;
+            }
+        }
+        // events exceeding the pools capacity are allocated on the heap (see release())
+        return ( event != nullptr ) ? event : ::operator new( size );
+    }
+
+    void release( void* event, size_t size )
+    {
+        if ( event == nullptr ) {
+            return;
+        }
+
+        if ( size == 0 || size > MAX_SIZE ) {
+            ::operator delete( event );
+            return;
+        }
+        BlockAllocator* allocator = getAllocator( size, false );
+
+        if ( allocator == nullptr || !allocator->release( event )) {
+            ::operator delete( event );
+        }
+    }
+
+    int trim()
+    {
+        std::lock_guard<std::mutex> guard( getLock() );
+
+        int freedChunks = 0;
+        for ( auto& allocator : _allocators ) {
+            if ( allocator.load() != nullptr ) {
+                freedChunks += allocator.load()->trim();
+            }
+        }
+        return freedChunks;
+    }
+
+    int getAmountOfEvents()
+    {
+        std::lock_guard<std::mutex> guard( getLock() );
+
+        int amount = 0;
+        for ( auto& allocator : _allocators ) {
+            if ( allocator.load() != nullptr ) {
+                amount += allocator.load()->getBlocksInUse();
+            }
+        }
+        return amount;
+    }
+}
+} // E.O namespace MWEngine
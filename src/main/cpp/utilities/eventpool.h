@@ -0,0 +1,61 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__EVENTPOOL_H_INCLUDED__
+#define __MWENGINE__EVENTPOOL_H_INCLUDED__
+
+#include "blockallocator.h"
+#include <cstddef>
+
+namespace MWEngine {
+namespace EventPool
+{
+    // allocation granularity (in bytes) of the pooled size classes and the
+    // largest size served by the pool (larger objects are allocated on the heap)
+
+    const size_t SIZE_CLASS       = BlockAllocator::BLOCK_ALIGNMENT;
+    const size_t MAX_SIZE         = 4096;
+    const int    EVENTS_PER_CHUNK = 64;
+
+    // allocates memory for an event of given size (in bytes). Events of the
+    // same size class are stored in contiguous chunks, improving locality
+    // when the sequencer iterates over events. Used by BaseAudioEvent::operator new
+
+    extern void* allocate( size_t size );
+
+    // releases the memory of an event allocated with allocate(), given size
+    // must equal the size requested on allocation
+
+    extern void release( void* event, size_t size );
+
+    // frees the memory of all chunks that no longer hold events
+    // returns the amount of freed chunks
+
+    extern int trim();
+
+    // the amount of pooled events currently allocated
+
+    extern int getAmountOfEvents();
+}
+} // E.O namespace MWEngine
+
+#endif
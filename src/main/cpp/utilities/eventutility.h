@@ -32,7 +32,7 @@ namespace EventUtility
 {
     inline unsigned long getStartMeasureForEvent( BaseAudioEvent* event )
     {
-        return ( unsigned long ) floor( event->getEventStart() / AudioEngine::samples_per_bar );
+        return ( unsigned long ) floor( event->getEventStartTicks() / TICKS_PER_MEASURE );
     }
 
     inline unsigned long getEndMeasureForEvent( BaseAudioEvent* event )
@@ -0,0 +1,225 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "samplecache.h"
+#include "../mappedaudiobuffer.h"
+#include "../modules/resampler.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace MWEngine {
+namespace SampleCacheSettings
+{
+    std::string _directory;
+}
+
+const uint32_t SampleCache::VERSION;
+const size_t SampleCache::ALIGNMENT;
+
+static const char MAGIC[ 4 ] = { 'M', 'W', 'S', 'C' };
+
+static size_t align( size_t value )
+{
+    return ( value + SampleCache::ALIGNMENT - 1 ) & ~( SampleCache::ALIGNMENT - 1 );
+}
+
+/* public methods */
+
+void SampleCache::setCacheDirectory( std::string directory )
+{
+    SampleCacheSettings::_directory = directory;
+}
+
+std::string SampleCache::getCacheDirectory()
+{
+    return SampleCacheSettings::_directory;
+}
+
+bool SampleCache::isEnabled()
+{
+    return !SampleCacheSettings::_directory.empty();
+}
+
+waveFile SampleCache::load( std::string sourcePath, unsigned int sampleRate )
+{
+    waveFile WAV = read( sourcePath, sampleRate );
+
+    if ( WAV.buffer != nullptr )
+        return WAV;
+
+    WAV = WaveReader::fileToBuffer( sourcePath );
+
+    if ( WAV.buffer == nullptr )
+        return WAV;
+
+    if ( sampleRate != 0 && WAV.sampleRate != sampleRate )
+    {
+        AudioBuffer* resampled = Resampler::resample( WAV.buffer, WAV.sampleRate, sampleRate );
+        delete WAV.buffer;
+
+        WAV.buffer     = resampled;
+        WAV.sampleRate = sampleRate;
+    }
+
+    if ( isEnabled())
+        write( sourcePath, WAV.buffer, WAV.sampleRate );
+
+    return WAV;
+}
+
+waveFile SampleCache::read( std::string sourcePath, unsigned int sampleRate )
+{
+    waveFile output = { 0, nullptr };
+    struct stat source, cache;
+
+    if ( !isEnabled() || stat( sourcePath.c_str(), &source ) != 0 )
+        return output;
+
+    int fd = open( getCachePath( sourcePath ).c_str(), O_RDONLY );
+
+    if ( fd < 0 )
+        return output;
+
+    if ( fstat( fd, &cache ) != 0 || ( size_t ) cache.st_size < sizeof( sampleCacheHeader )) {
+        close( fd );
+        return output;
+    }
+
+    size_t length = ( size_t ) cache.st_size;
+
+    // the mapping is writable (but private) so the buffer contents can be altered like any AudioBuffer
+
+    void* mapping = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+
+    if ( mapping == MAP_FAILED )
+        return output;
+
+    const sampleCacheHeader* header = static_cast<const sampleCacheHeader*>( mapping );
+    const char* cachedPath = static_cast<const char*>( mapping ) + sizeof( sampleCacheHeader );
+
+    bool valid = memcmp( header->magic, MAGIC, sizeof( MAGIC )) == 0 &&
+                 header->version    == VERSION &&
+                 header->sampleSize == sizeof( SAMPLE_TYPE ) &&
+                 ( sampleRate == 0 || header->sampleRate == sampleRate ) &&
+                 header->sourceSize == ( uint64_t ) source.st_size &&
+                 header->sourceModified   == ( int64_t ) source.st_mtim.tv_sec &&
+                 header->sourceModifiedNs == ( int64_t ) source.st_mtim.tv_nsec &&
+                 header->amountOfChannels > 0 && header->bufferSize > 0 &&
+                 sizeof( sampleCacheHeader ) + header->sourcePathLength <= header->dataOffset &&
+                 header->dataOffset + header->channelStride * header->amountOfChannels <= length &&
+                 header->bufferSize * sizeof( SAMPLE_TYPE ) <= header->channelStride &&
+                 sourcePath.compare( 0, std::string::npos, cachedPath, header->sourcePathLength ) == 0;
+
+    if ( !valid ) {
+        munmap( mapping, length );
+        return output;
+    }
+
+    output.sampleRate = header->sampleRate;
+    output.buffer     = new MappedAudioBuffer( header->amountOfChannels, header->bufferSize, mapping, length,
+                                               header->dataOffset, header->channelStride );
+    return output;
+}
+
+bool SampleCache::write( std::string sourcePath, AudioBuffer* buffer, unsigned int sampleRate )
+{
+    struct stat source;
+
+    if ( !isEnabled() || buffer == nullptr || stat( sourcePath.c_str(), &source ) != 0 )
+        return false;
+
+    sampleCacheHeader header;
+    memset( &header, 0, sizeof( header ));
+    memcpy( header.magic, MAGIC, sizeof( MAGIC ));
+
+    header.version          = VERSION;
+    header.sampleSize       = sizeof( SAMPLE_TYPE );
+    header.amountOfChannels = ( uint32_t ) buffer->amountOfChannels;
+    header.bufferSize       = ( uint32_t ) buffer->bufferSize;
+    header.sampleRate       = sampleRate;
+    header.sourceSize       = ( uint64_t ) source.st_size;
+    header.sourceModified   = ( int64_t ) source.st_mtim.tv_sec;
+    header.sourceModifiedNs = ( int64_t ) source.st_mtim.tv_nsec;
+    header.sourcePathLength = ( uint32_t ) sourcePath.size();
+    header.dataOffset       = align( sizeof( sampleCacheHeader ) + sourcePath.size());
+    header.channelStride    = align( buffer->bufferSize * sizeof( SAMPLE_TYPE ));
+
+    // write to a temporary file which replaces the existing cache file once complete, so concurrent
+    // writers (or readers) of the cache for the same source file never see a partially written file
+
+    std::string cachePath = getCachePath( sourcePath );
+    std::string tempPath  = cachePath + "." + std::to_string( getpid()) + "." +
+                            std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id())) + ".tmp";
+
+    FILE* file = fopen( tempPath.c_str(), "wb" );
+
+    if ( file == nullptr )
+        return false;
+
+    std::vector<char> padding( ALIGNMENT, 0 );
+
+    bool success = fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+                   fwrite( sourcePath.c_str(), 1, sourcePath.size(), file ) == sourcePath.size() &&
+                   fwrite( padding.data(), 1, header.dataOffset - sizeof( header ) - sourcePath.size(), file ) ==
+                       header.dataOffset - sizeof( header ) - sourcePath.size();
+
+    size_t channelSize = buffer->bufferSize * sizeof( SAMPLE_TYPE );
+
+    for ( int c = 0; c < buffer->amountOfChannels && success; ++c )
+    {
+        success = fwrite( buffer->getBufferForChannel( c ), 1, channelSize, file ) == channelSize &&
+                  fwrite( padding.data(), 1, header.channelStride - channelSize, file ) == header.channelStride - channelSize;
+    }
+    success = ( fclose( file ) == 0 ) && success;
+
+    if ( !success || rename( tempPath.c_str(), cachePath.c_str()) != 0 ) {
+        remove( tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void SampleCache::invalidate( std::string sourcePath )
+{
+    if ( isEnabled())
+        remove( getCachePath( sourcePath ).c_str());
+}
+
+std::string SampleCache::getCachePath( std::string sourcePath )
+{
+    // the source path is stored inside the cache file to resolve hash collisions
+
+    char name[ 32 ];
+    snprintf( name, sizeof( name ), "%016llx.mwcache", ( unsigned long long ) std::hash<std::string>()( sourcePath ));
+
+    return SampleCacheSettings::_directory + "/" + name;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,102 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__SAMPLECACHE_H_INCLUDED__
+#define __MWENGINE__SAMPLECACHE_H_INCLUDED__
+
+#include "wavereader.h"
+#include <cstdint>
+#include <string>
+
+namespace MWEngine {
+
+#ifndef SWIG
+// header of a cache file, the channel data follows at the (page aligned) data offset
+
+typedef struct
+{
+    char magic[ 4 ];
+    uint32_t version;
+    uint32_t sampleSize;       // sizeof( SAMPLE_TYPE ) of the engine that wrote the file
+    uint32_t amountOfChannels;
+    uint32_t bufferSize;
+    uint32_t sampleRate;
+    uint64_t sourceSize;       // size and modification time of the source file at the time of writing
+    int64_t  sourceModified;
+    int64_t  sourceModifiedNs;
+    uint64_t dataOffset;
+    uint64_t channelStride;
+    uint32_t sourcePathLength; // the source path follows the header
+} sampleCacheHeader;
+#endif
+
+/**
+ * SampleCache stores the decoded contents of WAV files in a cache directory, in the
+ * engine's native sample format. Subsequent reads of the same file map the cached
+ * contents directly into memory (see MappedAudioBuffer), skipping the parsing and
+ * conversion of the WAV data. Each channel is stored page aligned. Optionally the
+ * contents are resampled prior to caching (see Resampler) so resampling takes place once.
+ *
+ * A cached file is invalidated when the size or modification time of its source
+ * file changes, or when it was written by an engine using a different SAMPLE_TYPE.
+ * The cache is disabled until a cache directory is set.
+ */
+class SampleCache
+{
+    public:
+        // the directory cache files are written to (must exist), an empty path disables the cache
+        static void setCacheDirectory( std::string directory );
+        static std::string getCacheDirectory();
+        static bool isEnabled();
+
+        // remove the cached contents for the WAV file at given path
+        static void invalidate( std::string sourcePath );
+
+#ifndef SWIG
+        static const uint32_t VERSION   = 1;
+        static const size_t   ALIGNMENT = 4096;
+
+        // read the WAV file at given path, using the cached contents when available. When no valid
+        // cache exists, the WAV file is read and cached. When a sample rate is given, the contents are
+        // resampled to given rate. Returns a null buffer when the file can't be read
+        static waveFile load( std::string sourcePath, unsigned int sampleRate = 0 );
+
+        // read the cached contents for the WAV file at given path (when given, at given sample rate)
+        // returns a null buffer when no valid cache exists
+        static waveFile read( std::string sourcePath, unsigned int sampleRate = 0 );
+
+        // write the contents of given buffer as the cached contents of the WAV file at given path
+        static bool write( std::string sourcePath, AudioBuffer* buffer, unsigned int sampleRate );
+
+        // the path of the cache file for the WAV file at given path
+        static std::string getCachePath( std::string sourcePath );
+#endif
+};
+
+namespace SampleCacheSettings
+{
+    extern std::string _directory;
+}
+
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "sampleloader.h"
+#include "samplemanager.h"
+#include "samplecache.h"
+#include "../compactaudiobuffer.h"
+#include "../definitions/notifications.h"
+#include "../messaging/notifier.h"
+#include "perfutility.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+SampleLoader::SampleLoader()
+{
+    _amountOfErrors = 0;
+}
+
+SampleLoader::~SampleLoader()
+{
+
+}
+
+/* public methods */
+
+void SampleLoader::addSample( std::string aIdentifier, std::string filePath )
+{
+    _identifiers.push_back( aIdentifier );
+    _filePaths.push_back( filePath );
+}
+
+int SampleLoader::getAmountOfSamples()
+{
+    return ( int ) _filePaths.size();
+}
+
+int SampleLoader::load()
+{
+    return load( 0 );
+}
+
+int SampleLoader::load( int amountOfThreads )
+{
+    int amountOfFiles = getAmountOfSamples();
+    _amountOfErrors   = 0;
+
+    if ( amountOfThreads <= 0 )
+        amountOfThreads = std::max( 1, ( int ) std::thread::hardware_concurrency());
+
+    amountOfThreads = std::min( amountOfThreads, amountOfFiles );
+
+    // samples are resampled (when enabled) and converted to the SampleManagers
+    // storage format on the worker threads
+
+    SampleFormats::types format = SampleManager::getSampleFormat();
+    unsigned int sampleRate     = SampleManager::getLoadSampleRate();
+
+    std::vector<waveFile> files( amountOfFiles, { 0, nullptr });
+    std::vector<int> processedFiles; // indices of the decoded files, in order of completion
+    std::atomic<int> nextFile( 0 );
+    std::mutex mutex;
+    std::condition_variable processed;
+
+    std::vector<std::thread> workers;
+
+    for ( int t = 0; t < amountOfThreads; ++t )
+    {
+        workers.push_back( std::thread([ & ]()
+        {
+            PerfUtility::disableDenormals(); // resampling and conversion can decay into the denormal range
+
+            int i;
+            while (( i = nextFile.fetch_add( 1 )) < amountOfFiles )
+            {
+                waveFile WAV = SampleCache::load( _filePaths[ i ], sampleRate );
+
+                if ( WAV.buffer != nullptr && format != SampleFormats::NATIVE )
+                {
+                    AudioBuffer* compactBuffer = new CompactAudioBuffer( WAV.buffer, format );
+                    delete WAV.buffer;
+                    WAV.buffer = compactBuffer;
+                }
+
+                std::lock_guard<std::mutex> guard( mutex );
+                files[ i ] = WAV;
+                processedFiles.push_back( i );
+                processed.notify_one();
+            }
+        }));
+    }
+
+    // broadcast the progress on this thread as the workers complete their files
+
+    int amountProcessed = 0;
+
+    while ( amountProcessed < amountOfFiles )
+    {
+        std::vector<int> completed;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            processed.wait( lock, [ & ]() { return ( int ) processedFiles.size() > amountProcessed; });
+            completed.assign( processedFiles.begin() + amountProcessed, processedFiles.end());
+        }
+
+        for ( int i : completed )
+        {
+            if ( files[ i ].buffer == nullptr ) {
+                ++_amountOfErrors;
+                Notifier::broadcast( Notifications::SAMPLE_LOAD_ERROR, i );
+            }
+            Notifier::broadcast( Notifications::SAMPLE_LOAD_PROGRESS, ++amountProcessed );
+        }
+    }
+
+    for ( std::thread& worker : workers )
+        worker.join();
+
+    // register all decoded samples at once
+
+    int amountRegistered = 0;
+
+    for ( int i = 0; i < amountOfFiles; ++i )
+    {
+        if ( files[ i ].buffer == nullptr )
+            continue;
+
+        SampleId id = SampleManager::getSampleId( _identifiers[ i ]);
+
+        // the SampleManager takes ownership of the buffer, unless the sample was registered in the meantime
+
+        if ( !SampleManager::setSample( id, files[ i ].buffer, files[ i ].sampleRate, format )) {
+            delete files[ i ].buffer;
+            continue;
+        }
+        SampleManager::setSampleSource( id, _filePaths[ i ]);
+
+        ++amountRegistered;
+    }
+    Notifier::broadcast( Notifications::SAMPLE_LOAD_COMPLETE, amountRegistered );
+
+    return amountRegistered;
+}
+
+int SampleLoader::getAmountOfErrors()
+{
+    return _amountOfErrors;
+}
+
+void SampleLoader::clear()
+{
+    _identifiers.clear();
+    _filePaths.clear();
+    _amountOfErrors = 0;
+}
+
+} // E.O namespace MWEngine
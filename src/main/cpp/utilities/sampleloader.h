@@ -0,0 +1,71 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__SAMPLELOADER_H_INCLUDED__
+#define __MWENGINE__SAMPLELOADER_H_INCLUDED__
+
+#include <string>
+#include <vector>
+
+/**
+ * SampleLoader reads a batch of WAV files into the SampleManager. The files are
+ * decoded concurrently on a pool of worker threads, after which the decoded samples
+ * are registered in the SampleManager in a single pass (on the thread invoking load()).
+ * Files are read through the SampleCache when enabled.
+ *
+ * Progress and errors are broadcast through the Notifier while loading, on the thread invoking
+ * load() (see Notifications::SAMPLE_LOAD_PROGRESS, SAMPLE_LOAD_ERROR and SAMPLE_LOAD_COMPLETE)
+ */
+namespace MWEngine {
+class SampleLoader
+{
+    public:
+        SampleLoader();
+        ~SampleLoader();
+
+        // add the WAV file at given path to the batch, its contents will be registered
+        // under given identifier in the SampleManager (existing samples are not overwritten)
+
+        void addSample( std::string aIdentifier, std::string filePath );
+        int getAmountOfSamples();
+
+        // read all files in the batch and register their contents in the SampleManager, blocks until
+        // completion. The amount of threads defaults to the amount of available CPU cores.
+        // Returns the amount of registered samples
+
+        int load();
+        int load( int amountOfThreads );
+
+        // the amount of files that could not be read during the last load()
+
+        int getAmountOfErrors();
+
+        void clear();
+
+    protected:
+        std::vector<std::string> _identifiers;
+        std::vector<std::string> _filePaths;
+        int _amountOfErrors;
+};
+} // E.O namespace MWEngine
+
+#endif
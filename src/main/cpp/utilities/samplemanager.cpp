@@ -21,87 +21,555 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "samplemanager.h"
+#include "samplecache.h"
+#include "../audioenginecontext.h"
+#include "../compactaudiobuffer.h"
+#include "../modules/resampler.h"
 
 namespace MWEngine {
 namespace SampleManagerSamples
 {
-    std::map<std::string, cachedSample> _sampleMap;
+    std::map<std::string, SampleId> _sampleIds;
+    std::vector<cachedSample*> _samples;
+    std::map<AudioBuffer*, cachedSample*> _bufferMap;
+    SampleFormats::types _sampleFormat = SampleFormats::NATIVE;
+    bool _resampling           = false;
+    size_t _memoryBudget       = 0;
+    size_t _memoryUsage        = 0;
+    unsigned long _useCounter  = 0;
+    int _evictions             = 0;
+    int _reloads               = 0;
+    std::recursive_mutex _mutex;
 }
 
+// all SampleManager state is guarded by a single lock. Disk reads and sample conversions
+// take place outside of the lock so a thread releasing a sample (e.g. the render thread
+// disposing a SampleEvent) is never blocked by I/O
+
+typedef std::lock_guard<std::recursive_mutex> SampleLock;
+
+const SampleId SampleManager::NO_SAMPLE;
+
 /* public methods */
 
-void SampleManager::setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate )
+SampleId SampleManager::getSampleId( std::string aIdentifier )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    SampleId id = findSampleId( aIdentifier );
+
+    if ( id != NO_SAMPLE )
+        return id;
+
+    id = ( SampleId ) SampleManagerSamples::_samples.size();
+
+    SampleManagerSamples::_sampleIds.insert( std::pair<std::string, SampleId>( aIdentifier, id ));
+    SampleManagerSamples::_samples.push_back( nullptr );
+
+    return id;
+}
+
+bool SampleManager::setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate )
+{
+    return setSample( getSampleId( aIdentifier ), aBuffer, sampleRate, getSampleFormat() );
+}
+
+bool SampleManager::setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate,
+                               SampleFormats::types format )
+{
+    return setSample( getSampleId( aIdentifier ), aBuffer, sampleRate, format );
+}
+
+bool SampleManager::setSample( SampleId id, AudioBuffer* aBuffer, unsigned int sampleRate, SampleFormats::types format )
+{
+    return setSample( id, aBuffer, sampleRate, format, "" );
+}
+
+bool SampleManager::setSample( SampleId id, AudioBuffer* aBuffer, unsigned int sampleRate, SampleFormats::types format,
+                               std::string filePath )
+{
+    // existing samples are not overwritten
+
+    if ( aBuffer == nullptr || id < 0 || hasSample( id ))
+        return false;
+
+    AudioBuffer* buffer = aBuffer;
+
+    // convert to the engine rate (compact buffers cannot be resampled as they are only used for playback)
+    // conversions take place outside of the lock, given buffer is only deleted once the sample has been stored
+
+    if ( getResampling() && sampleRate != ( unsigned int ) AudioEngineProps::SAMPLE_RATE &&
+         dynamic_cast<CompactAudioBuffer*>( buffer ) == nullptr )
+    {
+        buffer     = Resampler::resample( buffer, sampleRate, AudioEngineProps::SAMPLE_RATE );
+        sampleRate = AudioEngineProps::SAMPLE_RATE;
+    }
+
+    // convert to compact format (unless given buffer is already compact)
+
+    if ( format != SampleFormats::NATIVE && dynamic_cast<CompactAudioBuffer*>( buffer ) == nullptr )
+    {
+        AudioBuffer* compactBuffer = new CompactAudioBuffer( buffer, format );
+
+        if ( buffer != aBuffer )
+            delete buffer;
+
+        buffer = compactBuffer;
+    }
+
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    // sample could have been registered by another thread during conversion
+
+    if ( id >= ( SampleId ) SampleManagerSamples::_samples.size() || hasSample( id ))
+    {
+        if ( buffer != aBuffer )
+            delete buffer;
+
+        return false;
+    }
+
+    if ( buffer != aBuffer )
+        delete aBuffer;
+
+    cachedSample* sample = new cachedSample();
+
+    sample->sampleLength = buffer->bufferSize;
+    sample->sampleRate   = sampleRate;
+    sample->sampleBuffer = buffer;
+    sample->filePath     = filePath;
+    sample->format       = format;
+    sample->references   = 0;
+    sample->removed      = false;
+
+    SampleManagerSamples::_samples[ id ] = sample;
+    SampleManagerSamples::_bufferMap.insert( std::pair<AudioBuffer*, cachedSample*>( buffer, sample ));
+    SampleManagerSamples::_memoryUsage += buffer->getMemoryUsage();
+
+    touch( sample );
+    applyMemoryBudget( sample );
+
+    return true;
+}
+
+bool SampleManager::loadSample( std::string aIdentifier, std::string filePath )
+{
+    return loadSample( getSampleId( aIdentifier ), filePath );
+}
+
+bool SampleManager::loadSample( SampleId id, std::string filePath )
+{
+    if ( id < 0 || hasSample( id ))
+        return false;
+
+    waveFile WAV = SampleCache::load( filePath, getLoadSampleRate() );
+
+    if ( WAV.buffer == nullptr )
+        return false;
+
+    // the source is associated upon registration so the sample can't be evicted without it
+    // (conversions of the buffer take place outside of the lock, see setSample())
+
+    if ( !setSample( id, WAV.buffer, WAV.sampleRate, getSampleFormat(), filePath )) {
+        delete WAV.buffer;
+        return false;
+    }
+    return true;
+}
+
+void SampleManager::setSampleSource( SampleId id, std::string filePath )
 {
-    cachedSample sample = { aBuffer->bufferSize, sampleRate, aBuffer };
+    SampleLock lock( SampleManagerSamples::_mutex );
 
-    // Assignment using member function insert() and STL pair
-    SampleManagerSamples::_sampleMap.insert( std::pair<std::string, cachedSample>( aIdentifier, sample ));
+    cachedSample* sample = getEntry( id );
+
+    if ( sample != nullptr )
+        sample->filePath = filePath;
 }
 
 AudioBuffer* SampleManager::getSample( std::string aIdentifier )
 {
-    if ( !hasSample( aIdentifier ))
+    return getSample( findSampleId( aIdentifier ));
+}
+
+AudioBuffer* SampleManager::getSample( SampleId id )
+{
+    std::unique_lock<std::recursive_mutex> lock( SampleManagerSamples::_mutex );
+
+    cachedSample* sample = getEntry( id );
+
+    if ( sample == nullptr )
         return nullptr;
 
-    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+    if ( sample->sampleBuffer == nullptr )
+    {
+        // sample was evicted, it is reloaded from its file outside of the lock. The
+        // render thread never reads from disk, there the evicted sample is unavailable
 
-    // key stored in first, value stored in second
-    return it->second.sampleBuffer;
+        if ( AudioEngineContext::getRenderingContext() != nullptr )
+            return nullptr;
+
+        std::string filePath        = sample->filePath;
+        unsigned int sampleRate     = sample->sampleRate;
+        SampleFormats::types format = sample->format;
+
+        lock.unlock();
+        AudioBuffer* buffer = loadBuffer( filePath, sampleRate, format );
+        lock.lock();
+
+        // the sample could have been removed or reloaded by another thread in the meantime
+
+        sample = getEntry( id );
+
+        if ( sample == nullptr || sample->sampleBuffer != nullptr || buffer == nullptr ) {
+            delete buffer;
+            return ( sample != nullptr ) ? sample->sampleBuffer : nullptr;
+        }
+        sample->sampleBuffer = buffer;
+
+        SampleManagerSamples::_bufferMap.insert( std::pair<AudioBuffer*, cachedSample*>( buffer, sample ));
+        SampleManagerSamples::_memoryUsage += buffer->getMemoryUsage();
+        ++SampleManagerSamples::_reloads;
+    }
+    touch( sample );
+    applyMemoryBudget( sample );
+
+    return sample->sampleBuffer;
 }
 
 int SampleManager::getSampleLength( std::string aIdentifier )
 {
-    if ( !hasSample( aIdentifier ))
-        return 0;
+    return getSampleLength( findSampleId( aIdentifier ));
+}
 
-    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+int SampleManager::getSampleLength( SampleId id )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
 
-    // key stored in first, value stored in second
-    return it->second.sampleLength;
+    cachedSample* sample = getEntry( id );
+    return ( sample != nullptr ) ? sample->sampleLength : 0;
 }
 
 int SampleManager::getSampleRateForSample( std::string aIdentifier )
 {
-    if ( !hasSample( aIdentifier ))
-        return AudioEngineProps::SAMPLE_RATE;
+    return getSampleRateForSample( findSampleId( aIdentifier ));
+}
 
-    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+int SampleManager::getSampleRateForSample( SampleId id )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
 
-    // key stored in first, value stored in second
-    return it->second.sampleRate;
+    cachedSample* sample = getEntry( id );
+    return ( sample != nullptr ) ? sample->sampleRate : AudioEngineProps::SAMPLE_RATE;
 }
 
 bool SampleManager::hasSample( std::string aIdentifier )
 {
-    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
-    return ( it != SampleManagerSamples::_sampleMap.end());
+    return hasSample( findSampleId( aIdentifier ));
 }
 
-void SampleManager::removeSample( std::string aIdentifier, bool free )
+bool SampleManager::hasSample( SampleId id )
 {
-    if ( hasSample( aIdentifier ))
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return getEntry( id ) != nullptr;
+}
+
+bool SampleManager::isSampleLoaded( std::string aIdentifier )
+{
+    return isSampleLoaded( findSampleId( aIdentifier ));
+}
+
+bool SampleManager::isSampleLoaded( SampleId id )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    cachedSample* sample = getEntry( id );
+    return sample != nullptr && sample->sampleBuffer != nullptr;
+}
+
+bool SampleManager::retainSample( AudioBuffer* aBuffer )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    std::map<AudioBuffer*, cachedSample*>::iterator it = SampleManagerSamples::_bufferMap.find( aBuffer );
+
+    if ( it == SampleManagerSamples::_bufferMap.end())
+        return false;
+
+    ++it->second->references;
+    touch( it->second );
+
+    return true;
+}
+
+void SampleManager::releaseSample( AudioBuffer* aBuffer )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    std::map<AudioBuffer*, cachedSample*>::iterator it = SampleManagerSamples::_bufferMap.find( aBuffer );
+
+    if ( it == SampleManagerSamples::_bufferMap.end())
+        return;
+
+    cachedSample* sample = it->second;
+
+    if ( --sample->references > 0 )
+        return;
+
+    sample->references = 0;
+
+    // sample was removed while it was still in use, it can now be deleted
+
+    if ( sample->removed )
+        destroyEntry( sample, true );
+    else
+        applyMemoryBudget( nullptr );
+}
+
+int SampleManager::getReferenceCount( std::string aIdentifier )
+{
+    return getReferenceCount( findSampleId( aIdentifier ));
+}
+
+int SampleManager::getReferenceCount( SampleId id )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    cachedSample* sample = getEntry( id );
+    return ( sample != nullptr ) ? sample->references : 0;
+}
+
+void SampleManager::setSampleFormat( SampleFormats::types format )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_sampleFormat = format;
+}
+
+SampleFormats::types SampleManager::getSampleFormat()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_sampleFormat;
+}
+
+void SampleManager::setResampling( bool value )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_resampling = value;
+}
+
+bool SampleManager::getResampling()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_resampling;
+}
+
+unsigned int SampleManager::getLoadSampleRate()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_resampling ? ( unsigned int ) AudioEngineProps::SAMPLE_RATE : 0;
+}
+
+void SampleManager::setMemoryBudget( size_t bytes )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_memoryBudget = bytes;
+    applyMemoryBudget( nullptr );
+}
+
+size_t SampleManager::getMemoryBudget()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_memoryBudget;
+}
+
+size_t SampleManager::getMemoryUsage( std::string aIdentifier )
+{
+    return getMemoryUsage( findSampleId( aIdentifier ));
+}
+
+size_t SampleManager::getMemoryUsage( SampleId id )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    cachedSample* sample = getEntry( id );
+    return ( sample != nullptr && sample->sampleBuffer != nullptr ) ? sample->sampleBuffer->getMemoryUsage() : 0;
+}
+
+size_t SampleManager::getTotalMemoryUsage()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_memoryUsage;
+}
+
+sampleManagerStats SampleManager::getStats()
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    sampleManagerStats stats = { 0, 0, 0, SampleManagerSamples::_memoryUsage, SampleManagerSamples::_memoryBudget,
+                                 SampleManagerSamples::_evictions, SampleManagerSamples::_reloads };
+
+    for ( cachedSample* sample : SampleManagerSamples::_samples )
     {
-        std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+        if ( sample == nullptr )
+            continue;
+
+        ++stats.samples;
 
-        if ( free )
-            delete it->second.sampleBuffer;
+        if ( sample->sampleBuffer != nullptr )
+            ++stats.loadedSamples;
 
-        SampleManagerSamples::_sampleMap.erase( SampleManagerSamples::_sampleMap.find( aIdentifier ));
+        if ( sample->references > 0 )
+            ++stats.referencedSamples;
     }
+    return stats;
+}
+
+void SampleManager::removeSample( std::string aIdentifier, bool free )
+{
+    removeSample( findSampleId( aIdentifier ), free );
+}
+
+void SampleManager::removeSample( SampleId id, bool free )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    cachedSample* sample = getEntry( id );
+
+    if ( sample == nullptr )
+        return;
+
+    SampleManagerSamples::_samples[ id ] = nullptr;
+
+    // referenced samples are deleted once their last reference is released
+
+    if ( free && sample->references > 0 )
+        sample->removed = true;
+    else
+        destroyEntry( sample, free );
 }
 
 void SampleManager::flushSamples()
 {
-    // invoke destructors on all AudioBuffers
+    SampleLock lock( SampleManagerSamples::_mutex );
 
-    std::map<std::string, cachedSample>::iterator it;
+    // invoke destructors on all AudioBuffers (that aren't referenced)
+    // the SampleIds remain interned so they can be reused when registering new samples
 
-    for ( it  = SampleManagerSamples::_sampleMap.begin();
-          it != SampleManagerSamples::_sampleMap.end(); ++it )
+    for ( cachedSample*& sample : SampleManagerSamples::_samples )
     {
-        delete it->second.sampleBuffer;
+        if ( sample == nullptr )
+            continue;
+
+        if ( sample->references > 0 )
+            sample->removed = true;
+        else
+            destroyEntry( sample, true );
+
+        sample = nullptr;
+    }
+}
+
+/* private methods */
+
+SampleId SampleManager::findSampleId( std::string aIdentifier )
+{
+    SampleLock lock( SampleManagerSamples::_mutex );
+
+    std::map<std::string, SampleId>::iterator it = SampleManagerSamples::_sampleIds.find( aIdentifier );
+
+    // key stored in first, value stored in second
+    return ( it != SampleManagerSamples::_sampleIds.end()) ? it->second : NO_SAMPLE;
+}
+
+cachedSample* SampleManager::getEntry( SampleId id )
+{
+    if ( id < 0 || id >= ( SampleId ) SampleManagerSamples::_samples.size())
+        return nullptr;
+
+    return SampleManagerSamples::_samples[ id ];
+}
+
+AudioBuffer* SampleManager::loadBuffer( std::string filePath, unsigned int sampleRate, SampleFormats::types format )
+{
+    // reload an evicted sample from its file (at the rate it was registered at)
+
+    waveFile WAV = SampleCache::load( filePath, sampleRate );
+
+    if ( WAV.buffer == nullptr || format == SampleFormats::NATIVE )
+        return WAV.buffer;
+
+    AudioBuffer* buffer = new CompactAudioBuffer( WAV.buffer, format );
+    delete WAV.buffer;
+
+    return buffer;
+}
+
+void SampleManager::unloadBuffer( cachedSample* sample )
+{
+    if ( sample->sampleBuffer == nullptr )
+        return;
+
+    SampleManagerSamples::_bufferMap.erase( sample->sampleBuffer );
+    SampleManagerSamples::_memoryUsage -= sample->sampleBuffer->getMemoryUsage();
+
+    delete sample->sampleBuffer;
+    sample->sampleBuffer = nullptr;
+}
+
+void SampleManager::touch( cachedSample* sample )
+{
+    sample->lastUse = ++SampleManagerSamples::_useCounter;
+}
+
+void SampleManager::applyMemoryBudget( cachedSample* keep )
+{
+    if ( SampleManagerSamples::_memoryBudget == 0 )
+        return;
+
+    while ( SampleManagerSamples::_memoryUsage > SampleManagerSamples::_memoryBudget )
+    {
+        // find the least recently used sample that can be evicted (e.g. isn't referenced
+        // and can be reloaded from its file), when none is found the budget is exceeded
+
+        cachedSample* candidate = nullptr;
+
+        for ( cachedSample* sample : SampleManagerSamples::_samples )
+        {
+            if ( sample == nullptr || sample == keep || sample->sampleBuffer == nullptr || sample->references > 0 || sample->filePath.empty() )
+                continue;
+
+            if ( candidate == nullptr || sample->lastUse < candidate->lastUse )
+                candidate = sample;
+        }
+
+        if ( candidate == nullptr )
+            return;
+
+        unloadBuffer( candidate );
+        ++SampleManagerSamples::_evictions;
+    }
+}
+
+void SampleManager::destroyEntry( cachedSample* sample, bool free )
+{
+    if ( free ) {
+        unloadBuffer( sample );
+    }
+    else if ( sample->sampleBuffer != nullptr ) {
+        // buffer is now owned by the caller
+        SampleManagerSamples::_bufferMap.erase( sample->sampleBuffer );
+        SampleManagerSamples::_memoryUsage -= sample->sampleBuffer->getMemoryUsage();
     }
-    SampleManagerSamples::_sampleMap.clear();
+    delete sample;
 }
 
 } // E.O namespace MWEngine
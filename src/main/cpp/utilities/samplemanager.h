@@ -24,55 +24,198 @@
 #define __MWENGINE__SAMPLEMANAGER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "definitions/sampleformats.h"
 #include <string>
 #include <map>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 namespace MWEngine {
 
+// handle to a sample registered in the SampleManager, see SampleManager::getSampleId()
+
+typedef int SampleId;
+
 typedef struct
 {
    int sampleLength;
    unsigned int sampleRate;
-   AudioBuffer* sampleBuffer;
+   AudioBuffer* sampleBuffer;      // null when the sample has been evicted from memory
+   std::string filePath;           // file the sample was loaded from (empty when registered from memory)
+   SampleFormats::types format;    // format the sample was registered in
+   int references;                 // amount of events referencing the sample
+   unsigned long lastUse;          // used to determine the least recently used sample on eviction
+   bool removed;                   // removed from the SampleManager while still referenced
 } cachedSample;
 
+typedef struct
+{
+   int samples;                    // amount of registered samples
+   int loadedSamples;              // amount of registered samples currently held in memory
+   int referencedSamples;          // amount of registered samples referenced by events
+   size_t memoryUsage;             // memory (in bytes) used by the samples held in memory
+   size_t memoryBudget;            // see SampleManager::setMemoryBudget()
+   int evictions;                  // amount of times a sample was evicted to meet the memory budget
+   int reloads;                    // amount of times an evicted sample was reloaded from disk
+} sampleManagerStats;
+
 /**
  * SampleManager is a static class that holds a map of Sampled audio, it can be
  * used to pool samples (AudioBuffers) that are to be used repeatedly or simultaneously, etc...
  * SampleManager will also manage the memory, when samples can be removed you can do
  * so via SampleManager which will in turn release the memory allocated by the AudioBuffers
+ *
+ * SampleEvents retain the samples they play back, a sample that is removed while it is still
+ * referenced is only deleted once the last event releases it. When a memory budget is set,
+ * samples that were loaded from file and aren't referenced are evicted from memory (least
+ * recently used first) and transparently reloaded from their file when requested again
+ *
+ * Sample identifiers are interned into SampleIds, which resolve to their sample in constant time.
+ * A SampleId remains valid for the lifetime of the application, also when the sample is removed
+ * and registered again under the same identifier. The methods accepting string identifiers
+ * are convenience wrappers that resolve the SampleId on each invocation, code that repeatedly
+ * queries the same sample (e.g. events) should hold onto the SampleId instead
+ *
+ * The SampleManager can be used from any thread (its state is guarded by a lock which is
+ * never held during disk reads or sample conversions)
  */
 class SampleManager
 {
     public:
 
+        static const SampleId NO_SAMPLE = -1;
+
+        // retrieve the SampleId for given identifier, creating a new SampleId when the identifier
+        // is unknown (a sample doesn't have to be registered yet to retrieve its SampleId)
+        static SampleId getSampleId( std::string aIdentifier );
+
         // store given AudioBuffer under given identifier name in this SampleManager
-        static void setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate );
+        // the sample is stored in the format specified by setSampleFormat()
+        static bool setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate );
+
+        // store given AudioBuffer under given identifier name in given format. NOTE : the SampleManager takes
+        // ownership of given AudioBuffer. When the sample is converted (e.g. to the engine sample rate or to
+        // a compact format like SampleFormats::PCM16) a converted copy is stored and given AudioBuffer is
+        // deleted, as such do not reference given AudioBuffer after this call, use getSample() to retrieve
+        // the stored AudioBuffer instead. Returns false when a sample is already registered under given
+        // identifier, in which case given AudioBuffer is left untouched (and remains owned by the caller)
+        static bool setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate,
+                               SampleFormats::types format );
+        static bool setSample( SampleId id, AudioBuffer* aBuffer, unsigned int sampleRate, SampleFormats::types format );
+
+        // read the WAV file at given path and store its contents under given identifier name
+        // samples loaded from file can be evicted from memory when exceeding the memory budget
+        // (files are read through the SampleCache when enabled) returns false when the file could not be read
+        static bool loadSample( std::string aIdentifier, std::string filePath );
+        static bool loadSample( SampleId id, std::string filePath );
+
+        // associate the sample registered under given SampleId with the file it was read from
+        // allowing it to be evicted when exceeding the memory budget (see loadSample())
+        static void setSampleSource( SampleId id, std::string filePath );
 
         // retrieve AudioBuffer registered under given identifier from this SampleManager
-        // returns 0 if no associated AudioBuffer is found
+        // returns 0 if no associated AudioBuffer is found. If the sample was evicted from
+        // memory, it is reloaded from its file (except when invoked from the render thread, which
+        // never reads from disk, in which case 0 is returned). NOTE : unreferenced samples can be
+        // evicted on subsequent SampleManager operations, pass the AudioBuffer to a SampleEvent
+        // (or use retainSample()) to hold onto it
         static AudioBuffer* getSample( std::string aIdentifier );
+        static AudioBuffer* getSample( SampleId id );
 
         // retrieve the length (in samples) of the AudioBuffer registered under given
         // identifier, returns 0 if no associated AudioBuffer is found
         static int getSampleLength( std::string aIdentifier );
+        static int getSampleLength( SampleId id );
 
         // retrieve the sample rate of the AudioBuffer registered under given
         // identifier, returns audio engine's sample rate if no associated AudioBuffer is found
         static int getSampleRateForSample( std::string aIdentifier );
+        static int getSampleRateForSample( SampleId id );
 
         // queries whether the SampleManager has an AudioBuffer registered under given identifier
         static bool hasSample( std::string aIdentifier );
+        static bool hasSample( SampleId id );
+
+        // queries whether the sample registered under given identifier is held in memory
+        // (e.g. hasn't been evicted to meet the memory budget)
+        static bool isSampleLoaded( std::string aIdentifier );
+        static bool isSampleLoaded( SampleId id );
+
+        // register/unregister a reference to given AudioBuffer. Referenced samples are neither evicted
+        // nor deleted by removeSample() and flushSamples() until their last reference is released
+        // retainSample() returns false when given AudioBuffer is not managed by the SampleManager
+        static bool retainSample( AudioBuffer* aBuffer );
+        static void releaseSample( AudioBuffer* aBuffer );
+
+        // retrieve the amount of references to the sample registered under given identifier
+        static int getReferenceCount( std::string aIdentifier );
+        static int getReferenceCount( SampleId id );
+
+        // the format in which samples are stored by setSample(), samples held in a compact format
+        // are converted to SAMPLE_TYPE during playback. FLOAT32 halves the memory used by samples
+        // (when SAMPLE_TYPE is double), PCM16 quarters it (and is lossless for 16-bit source material)
+        // defaults to SampleFormats::NATIVE (e.g. samples are held as SAMPLE_TYPE)
+        static void setSampleFormat( SampleFormats::types format );
+        static SampleFormats::types getSampleFormat();
+
+        // when enabled, samples registered at a sample rate other than the engine's are resampled
+        // to the engine rate (see Resampler) so SampleEvents can play them back without interpolation
+        // samples loaded from file are resampled prior to caching (see SampleCache). Disabled by default
+        // NOTE : samples are resampled at the time of registration, enable after setting the engine rate
+        static void setResampling( bool value );
+        static bool getResampling();
+
+        // the sample rate at which files should be loaded (0 when loading at the rate of the file)
+        static unsigned int getLoadSampleRate();
+
+        // the maximum amount of memory (in bytes) the samples may occupy, when exceeded
+        // unreferenced samples loaded from file are evicted. 0 (default) means unlimited
+        static void setMemoryBudget( size_t bytes );
+        static size_t getMemoryBudget();
+
+        // retrieve the memory (in bytes) used by the sample registered under given identifier
+        // returns 0 if no associated AudioBuffer is found (or when it has been evicted)
+        static size_t getMemoryUsage( std::string aIdentifier );
+        static size_t getMemoryUsage( SampleId id );
+
+        // retrieve the memory (in bytes) used by all registered samples
+        static size_t getTotalMemoryUsage();
+
+        static sampleManagerStats getStats();
 
         // remove the sample from the SampleManager, if free is true, the sample will also be deleted
         static void removeSample( std::string aIdentifier, bool free );
+        static void removeSample( SampleId id, bool free );
         static void flushSamples();
+
+    private:
+        // stores given AudioBuffer, associating the entry with the file it was read from upon its creation
+        // (samples loaded from file can't be evicted while their entry holds no path, see loadSample())
+        static bool setSample( SampleId id, AudioBuffer* aBuffer, unsigned int sampleRate, SampleFormats::types format,
+                               std::string filePath );
+        static SampleId findSampleId( std::string aIdentifier ); // NO_SAMPLE when identifier isn't interned
+        static cachedSample* getEntry( SampleId id );
+        static AudioBuffer* loadBuffer( std::string filePath, unsigned int sampleRate, SampleFormats::types format );
+        static void unloadBuffer( cachedSample* sample );
+        static void touch( cachedSample* sample );
+        static void applyMemoryBudget( cachedSample* keep );
+        static void destroyEntry( cachedSample* sample, bool free );
 };
 
 namespace SampleManagerSamples
 {
-    extern std::map<std::string, cachedSample> _sampleMap;
+    extern std::map<std::string, SampleId> _sampleIds;
+    extern std::vector<cachedSample*> _samples; // indexed by SampleId, null when no sample is registered
+    extern std::map<AudioBuffer*, cachedSample*> _bufferMap;
+    extern SampleFormats::types _sampleFormat;
+    extern bool _resampling;
+    extern size_t _memoryBudget;
+    extern size_t _memoryUsage;
+    extern unsigned long _useCounter;
+    extern int _evictions;
+    extern int _reloads;
+    extern std::recursive_mutex _mutex;
 }
 
 } // E.O namespace MWEngine
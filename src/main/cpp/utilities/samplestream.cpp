@@ -0,0 +1,151 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "samplestream.h"
+#include "../global.h"
+#include "debug.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MWEngine {
+
+// amount of bytes read to parse the WAV header, this should exceed the
+// size of the meta data chunks commonly found in front of the sample data
+
+static const size_t HEADER_READ_SIZE = 65536;
+
+const int SampleStream::HEAD_SIZE;
+
+/* constructor / destructor */
+
+SampleStream::SampleStream( std::string filePath )
+{
+    _filePath       = filePath;
+    _fileDescriptor = open( filePath.c_str(), O_RDONLY );
+    _head           = nullptr;
+
+    if ( _fileDescriptor < 0 ) {
+        Debug::log( "SampleStream::Error could not open file '%s'", filePath.c_str() );
+        return;
+    }
+
+    struct stat fileInfo;
+    std::vector<char> header( HEADER_READ_SIZE );
+
+    ssize_t bytesRead = 0;
+
+    if ( fstat( _fileDescriptor, &fileInfo ) == 0 )
+        bytesRead = pread( _fileDescriptor, header.data(), HEADER_READ_SIZE, 0 );
+
+    if ( bytesRead <= 0 ||
+        !WaveReader::parseFormat( header.data(), ( size_t ) bytesRead, ( size_t ) fileInfo.st_size, _format ))
+    {
+        Debug::log( "SampleStream::Error could not parse WAV file '%s'", filePath.c_str() );
+        close( _fileDescriptor );
+        _fileDescriptor = -1;
+        return;
+    }
+
+    // read the head of the file into memory
+
+    _head = new AudioBuffer( _format.amountOfChannels, std::min( HEAD_SIZE, _format.bufferSize ));
+    read( _head, 0, 0, _head->bufferSize, header );
+}
+
+SampleStream::~SampleStream()
+{
+    if ( _fileDescriptor >= 0 )
+        close( _fileDescriptor );
+
+    delete _head;
+}
+
+/* public methods */
+
+bool SampleStream::isValid()
+{
+    return _head != nullptr;
+}
+
+std::string SampleStream::getFilePath()
+{
+    return _filePath;
+}
+
+int SampleStream::getLength()
+{
+    return isValid() ? _format.bufferSize : 0;
+}
+
+int SampleStream::getAmountOfChannels()
+{
+    return isValid() ? ( int ) _format.amountOfChannels : 0;
+}
+
+unsigned int SampleStream::getSampleRate()
+{
+    return isValid() ? _format.sampleRate : ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
+}
+
+AudioBuffer* SampleStream::getHead()
+{
+    return _head;
+}
+
+int SampleStream::getHeadLength()
+{
+    return isValid() ? _head->bufferSize : 0;
+}
+
+int SampleStream::read( AudioBuffer* buffer, int bufferOffset, int position, int amount, std::vector<char>& scratch )
+{
+    amount = std::min( amount, _format.bufferSize - position );
+
+    if ( _fileDescriptor < 0 || amount <= 0 )
+        return 0;
+
+    size_t length = ( size_t ) amount * _format.blockAlign;
+
+    if ( scratch.size() < length )
+        scratch.resize( length );
+
+    // pread() does not alter the file offset, allowing reads from multiple threads
+
+    off_t offset     = ( off_t )( _format.dataOffset + ( size_t ) position * _format.blockAlign );
+    size_t bytesRead = 0;
+
+    while ( bytesRead < length ) {
+        ssize_t result = pread( _fileDescriptor, scratch.data() + bytesRead, length - bytesRead, offset + bytesRead );
+        if ( result <= 0 )
+            break;
+        bytesRead += ( size_t ) result;
+    }
+
+    amount = ( int )( bytesRead / _format.blockAlign );
+    WaveReader::decode( scratch.data(), _format, buffer, bufferOffset, amount );
+
+    return amount;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__SAMPLESTREAM_H_INCLUDED__
+#define __MWENGINE__SAMPLESTREAM_H_INCLUDED__
+
+#include "../audiobuffer.h"
+#include "wavereader.h"
+#include <string>
+#include <vector>
+
+/**
+ * SampleStream describes a WAV file that is played back directly from disk instead of
+ * being loaded into memory in its entirety (see SampleEvent::setSample()). Only the start of
+ * the file (the "head") is kept in memory, allowing instant playback while the remainder
+ * of the file is read in the background by the DiskStreamer.
+ *
+ * A SampleStream can be shared by multiple SampleEvents (each event reading through its own
+ * SampleStreamReader), it should only be deleted once no SampleEvent references it.
+ */
+namespace MWEngine {
+class SampleStream
+{
+    public:
+        SampleStream( std::string filePath );
+        ~SampleStream();
+
+        // amount of sample frames kept in memory for instant playback
+        static const int HEAD_SIZE = 32768;
+
+        // whether the file could be opened and describes a supported WAV file
+        bool isValid();
+
+        std::string getFilePath();
+        int getLength(); // total amount of sample frames
+        int getAmountOfChannels();
+        unsigned int getSampleRate();
+
+#ifndef SWIG
+        // internal to the engine
+
+        AudioBuffer* getHead();
+        int getHeadLength();
+
+        // reads amount of frames starting at given position from disk and writes them into
+        // given AudioBuffer at given bufferOffset. Given scratch vector holds the raw file data
+        // returns the amount of frames that were read
+
+        int read( AudioBuffer* buffer, int bufferOffset, int position, int amount, std::vector<char>& scratch );
+#endif
+
+    protected:
+        std::string _filePath;
+        int _fileDescriptor;
+        waveFormat _format;
+        AudioBuffer* _head;
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,296 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "samplestreamreader.h"
+#include <algorithm>
+
+namespace MWEngine {
+
+// the amount of frames the play position can be ahead of the filled ring buffer contents
+// before the reader considers the DiskStreamer to have fallen behind and restarts reading
+// from the play position (e.g. when the sequencer position has moved)
+
+static const int SEEK_THRESHOLD = SampleStreamReader::READ_SIZE * 4;
+
+const int SampleStreamReader::RING_SIZE;
+const int SampleStreamReader::READ_SIZE;
+const int SampleStreamReader::AMOUNT_ANCHORS;
+const int SampleStreamReader::NO_REQUEST;
+
+inline uint64_t pack( uint32_t generation, int position )
+{
+    return (( uint64_t ) generation << 32 ) | ( uint32_t ) position;
+}
+
+inline uint32_t getGeneration( uint64_t value )
+{
+    return ( uint32_t )( value >> 32 );
+}
+
+inline int getPosition( uint64_t value )
+{
+    return ( int )( uint32_t ) value;
+}
+
+/* constructor / destructor */
+
+SampleStreamReader::SampleStreamReader( SampleStream* stream )
+{
+    _stream     = stream;
+    _head       = stream->getHead();
+    _headLength = stream->getHeadLength();
+    _ring       = new AudioBuffer( std::max( 1, stream->getAmountOfChannels() ), RING_SIZE );
+
+    for ( int i = 0; i < AMOUNT_ANCHORS; ++i ) {
+        _anchors[ i ].store( nullptr );
+        _anchorRequests[ i ].store( NO_REQUEST );
+    }
+    _syncCount.store( 0 );
+
+    // the initial generation fills the ring buffer with the frames following the head
+
+    _generation     = 0;
+    _position       = 0;
+    _cursor         = 0;
+    _fillStart      = _headLength;
+    _available      = _headLength;
+    _diskGeneration = 0;
+    _diskFillStart  = _headLength;
+    _diskFillEnd    = _headLength;
+
+    _request.store( pack( 0, 0 ));
+    _seek.store   ( pack( 0, _headLength ));
+    _state.store  ( pack( 0, _headLength ));
+}
+
+SampleStreamReader::~SampleStreamReader()
+{
+    for ( int i = 0; i < AMOUNT_ANCHORS; ++i )
+        disposeAnchor( _anchors[ i ].load() );
+
+    for ( auto& retired : _retiredAnchors )
+        disposeAnchor( retired.second );
+
+    delete _ring;
+}
+
+/* public methods */
+
+SampleStream* SampleStreamReader::getStream()
+{
+    return _stream;
+}
+
+void SampleStreamReader::setAnchor( int index, int position )
+{
+    if ( index < 0 || index >= AMOUNT_ANCHORS )
+        return;
+
+    // positions inside the head of the stream need no anchor, unless
+    // they are too close to the end of the head to allow the ring to fill up
+
+    if ( position < 0 || position >= _stream->getLength() ||
+       ( _headLength == _stream->getLength() || position + SampleStream::HEAD_SIZE / 2 <= _headLength ))
+        position = -1;
+
+    // the contents are read by the DiskStreamer thread (see updateAnchors()), until then
+    // the previous anchor remains readable
+
+    _anchorRequests[ index ].store( position, std::memory_order_release );
+}
+
+void SampleStreamReader::sync()
+{
+    int position = _position;
+    int fillEnd  = getAvailable();
+
+    // detect whether the current generation can provide the frames following the
+    // last read position, if not (e.g. playback has looped or jumped) start a new generation
+
+    bool seek;
+
+    if ( position < _cursor )
+        seek = true;
+    else if ( position < _fillStart )
+        seek = getRegionEnd( position ) < _fillStart;
+    else
+        seek = position > fillEnd + SEEK_THRESHOLD;
+
+    if ( seek )
+    {
+        _fillStart = getRegionEnd( position );
+        fillEnd    = _fillStart;
+
+        ++_generation;
+        _seek.store( pack( _generation, _fillStart ), std::memory_order_release );
+    }
+    _cursor    = position;
+    _available = fillEnd;
+
+    _request.store( pack( _generation, position ), std::memory_order_release );
+
+    // let the DiskStreamer thread know anchors retired prior to this sync are no longer read
+
+    _syncCount.fetch_add( 1 );
+}
+
+bool SampleStreamReader::fill()
+{
+    if ( updateAnchors())
+        return true;
+
+    uint64_t request    = _request.load( std::memory_order_acquire );
+    uint32_t generation = getGeneration( request );
+
+    if ( generation != _diskGeneration )
+    {
+        uint64_t seek = _seek.load( std::memory_order_acquire );
+
+        if ( getGeneration( seek ) != generation )
+            return false; // request for more recent generation is pending
+
+        _diskGeneration = generation;
+        _diskFillStart  = getPosition( seek );
+        _diskFillEnd    = _diskFillStart;
+
+        _state.store( pack( _diskGeneration, _diskFillEnd ), std::memory_order_release );
+    }
+
+    // frames can be written up until a full ring size ahead of the read position
+    // (as the frames that are overwritten have been read by then)
+
+    int length = _stream->getLength();
+    int cursor = std::max( getPosition( request ), _diskFillStart );
+    int limit  = std::min( cursor + RING_SIZE, length );
+    int amount = std::min( READ_SIZE, limit - _diskFillEnd );
+
+    // wait until there is room for a full block (unless we're reading the last frames of the stream)
+
+    if ( amount <= 0 || ( amount < READ_SIZE && limit < length ))
+        return false;
+
+    int offset = _diskFillEnd & RING_MASK;
+    int first  = std::min( amount, RING_SIZE - offset );
+
+    int framesRead = _stream->read( _ring, offset, _diskFillEnd, first, _scratch );
+
+    if ( first < amount )
+        framesRead += _stream->read( _ring, 0, _diskFillEnd + first, amount - first, _scratch );
+
+    if ( framesRead <= 0 )
+        return false;
+
+    _diskFillEnd += framesRead;
+    _state.store( pack( _diskGeneration, _diskFillEnd ), std::memory_order_release );
+
+    return true;
+}
+
+int SampleStreamReader::getAvailable()
+{
+    uint64_t state = _state.load( std::memory_order_acquire );
+    return ( getGeneration( state ) == _generation ) ? getPosition( state ) : _fillStart;
+}
+
+/* protected methods */
+
+int SampleStreamReader::getRegionEnd( int position )
+{
+    // returns the end of the in memory region containing given position (or
+    // the position itself when it isn't held in memory)
+
+    int end = position;
+
+    if ( position < _headLength )
+        end = _headLength;
+
+    for ( int i = 0; i < AMOUNT_ANCHORS; ++i ) {
+        streamAnchor* anchor = _anchors[ i ].load( std::memory_order_acquire );
+        if ( anchor != nullptr && position >= anchor->start && position < anchor->start + anchor->buffer->bufferSize )
+            end = std::max( end, std::min( anchor->start + anchor->buffer->bufferSize, _stream->getLength() ));
+    }
+    return end;
+}
+
+bool SampleStreamReader::updateAnchors()
+{
+    // dispose the anchors the render thread can no longer be reading from
+
+    uint32_t syncCount = _syncCount.load();
+
+    for ( auto it = _retiredAnchors.begin(); it != _retiredAnchors.end(); ) {
+        if ( syncCount != it->first ) {
+            disposeAnchor( it->second );
+            it = _retiredAnchors.erase( it );
+        } else {
+            ++it;
+        }
+    }
+
+    bool updated = false;
+
+    for ( int i = 0; i < AMOUNT_ANCHORS; ++i )
+    {
+        int position = _anchorRequests[ i ].exchange( NO_REQUEST, std::memory_order_acquire );
+
+        if ( position == NO_REQUEST )
+            continue;
+
+        streamAnchor* current = _anchors[ i ].load();
+
+        if ( current == nullptr ? position < 0 : current->start == position )
+            continue;
+
+        streamAnchor* anchor = nullptr;
+
+        if ( position >= 0 )
+        {
+            anchor = new streamAnchor();
+            anchor->start  = position;
+            anchor->buffer = new AudioBuffer( _ring->amountOfChannels, SampleStream::HEAD_SIZE );
+
+            if ( _stream->read( anchor->buffer, 0, position, anchor->buffer->bufferSize, _scratch ) <= 0 ) {
+                disposeAnchor( anchor );
+                anchor = nullptr;
+            }
+        }
+
+        streamAnchor* retired = _anchors[ i ].exchange( anchor );
+
+        if ( retired != nullptr )
+            _retiredAnchors.emplace_back( _syncCount.load(), retired );
+
+        updated = true;
+    }
+    return updated;
+}
+
+void SampleStreamReader::disposeAnchor( streamAnchor* anchor )
+{
+    if ( anchor == nullptr )
+        return;
+
+    delete anchor->buffer;
+    delete anchor;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,152 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__SAMPLESTREAMREADER_H_INCLUDED__
+#define __MWENGINE__SAMPLESTREAMREADER_H_INCLUDED__
+
+#include "samplestream.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * SampleStreamReader provides a single voice (e.g. a SampleEvent) with the contents
+ * of a SampleStream. Sample frames are read from the in memory head of the stream,
+ * from the anchors (regions the voice can instantly jump to, e.g. a loop start) or
+ * from a ring buffer that is filled ahead of the play position by the DiskStreamer thread.
+ *
+ * read() and sync() are invoked by the render thread, fill() by the DiskStreamer thread.
+ * Both communicate through atomic values only. Anchors are read from disk by the DiskStreamer
+ * thread as well, upon completion they are published by swapping the anchor pointer. Each jump in the play position (looping,
+ * retriggering or sequencer repositioning) starts a new "generation" for which the ring
+ * buffer is refilled from the new position onwards. Frames that are not available (yet)
+ * are read as silence.
+ */
+namespace MWEngine {
+class SampleStreamReader
+{
+    public:
+        SampleStreamReader( SampleStream* stream );
+        ~SampleStreamReader();
+
+        static const int RING_SIZE      = 65536; // in sample frames, must be a power of two
+        static const int READ_SIZE      = 4096;  // amount of frames read from disk in a single pass
+        static const int AMOUNT_ANCHORS = 2;
+
+        SampleStream* getStream();
+
+        // keeps the region starting at given position in memory (at given anchor index)
+        // so playback can instantly jump to it, e.g. a loop or buffer range start offset
+        // this merely requests the anchor, its contents are read by the DiskStreamer thread
+
+        void setAnchor( int index, int position );
+
+        // render thread : retrieve the sample for given channel at given position
+
+        inline SAMPLE_TYPE read( int channel, int position )
+        {
+            _position = position;
+
+            if ( position < _headLength )
+                return _head->getBufferForChannel( channel )[ position ];
+
+            for ( int i = 0; i < AMOUNT_ANCHORS; ++i ) {
+                streamAnchor* anchor = _anchors[ i ].load( std::memory_order_acquire );
+                if ( anchor != nullptr && position >= anchor->start && position < anchor->start + anchor->buffer->bufferSize )
+                    return anchor->buffer->getBufferForChannel( channel )[ position - anchor->start ];
+            }
+
+            if ( position >= _cursor && position >= _fillStart && position < _available )
+                return _ring->getBufferForChannel( channel )[ position & RING_MASK ];
+
+            return 0.0;
+        }
+
+        // render thread : invoke prior to reading a new buffer, this publishes
+        // the last read position to the DiskStreamer and detects jumps in playback
+
+        void sync();
+
+        // DiskStreamer thread : reads the requested anchors and the next block of frames into
+        // the ring buffer, returns false when there was nothing to read
+
+        bool fill();
+
+        // the amount of frames available in the ring buffer for the current
+        // play position (this includes the frames in memory)
+
+        int getAvailable();
+
+    protected:
+        static const int RING_MASK  = RING_SIZE - 1;
+        static const int NO_REQUEST = -2;
+
+        // an anchor is immutable once published, a changed anchor is read into a new
+        // buffer which replaces the current one (which is disposed once the render thread
+        // has synced, as it could have been reading from it during the current buffer)
+
+        typedef struct
+        {
+            AudioBuffer* buffer;
+            int start;
+        } streamAnchor;
+
+        SampleStream* _stream;
+        AudioBuffer* _head;
+        int _headLength;
+
+        std::atomic<streamAnchor*> _anchors[ AMOUNT_ANCHORS ];
+        std::atomic<int> _anchorRequests[ AMOUNT_ANCHORS ]; // requested start position (-1 clears the anchor)
+        std::atomic<uint32_t> _syncCount;
+
+        AudioBuffer* _ring;
+
+        // render thread state
+
+        uint32_t _generation;
+        int _position;  // last read position
+        int _cursor;    // last published read position
+        int _fillStart; // the position the ring is filled from for the current generation
+        int _available; // the position the ring is filled up to for the current generation
+
+        // DiskStreamer thread state
+
+        uint32_t _diskGeneration;
+        int _diskFillStart;
+        int _diskFillEnd;
+        std::vector<char> _scratch;
+        std::vector<std::pair<uint32_t, streamAnchor*>> _retiredAnchors; // sync count upon retirement
+
+        // shared state, each holds a generation (upper 32-bits) and a sample frame position
+
+        std::atomic<uint64_t> _request; // last read position (render thread)
+        std::atomic<uint64_t> _seek;    // position to fill from on a new generation (render thread)
+        std::atomic<uint64_t> _state;   // position the ring has been filled up to (DiskStreamer thread)
+
+        int getRegionEnd( int position );
+        bool updateAnchors();
+        void disposeAnchor( streamAnchor* anchor );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "stemexporter.h"
+#include <algorithm>
+#include <thread>
+
+namespace MWEngine {
+namespace StemExporterStems
+{
+    std::vector<stem> _stems;
+    AudioBuffer* _mixBuffer = nullptr;
+    std::atomic<bool> _exporting( false );
+    std::atomic<int> _activeWrites( 0 );
+    bool _prepared = false;
+    std::mutex _mutex;
+}
+
+// registers a write in progress, the writers are not disposed while the render thread is writing
+
+inline bool beginWrite()
+{
+    StemExporterStems::_activeWrites.fetch_add( 1 );
+
+    if ( StemExporterStems::_exporting.load())
+        return true;
+
+    StemExporterStems::_activeWrites.fetch_sub( 1 );
+    return false;
+}
+
+inline void endWrite()
+{
+    StemExporterStems::_activeWrites.fetch_sub( 1 );
+}
+
+/* public methods */
+
+bool StemExporter::addChannel( AudioChannel* channel, std::string outputFile, bool preChain )
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( StemExporterStems::_prepared )
+        return false;
+
+    StemExporterStems::_stems.push_back({ channel, nullptr, preChain, outputFile, nullptr });
+    return true;
+}
+
+bool StemExporter::addGroup( ChannelGroup* group, std::string outputFile, bool preChain )
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( StemExporterStems::_prepared )
+        return false;
+
+    StemExporterStems::_stems.push_back({ nullptr, group, preChain, outputFile, nullptr });
+    return true;
+}
+
+bool StemExporter::removeChannel( AudioChannel* channel )
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( StemExporterStems::_prepared )
+        return false;
+
+    std::vector<stem>& stems = StemExporterStems::_stems;
+    size_t amount = stems.size();
+
+    stems.erase( std::remove_if( stems.begin(), stems.end(), [ channel ]( const stem& s ) {
+        return s.channel == channel;
+    }), stems.end());
+
+    return stems.size() != amount;
+}
+
+bool StemExporter::removeGroup( ChannelGroup* group )
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( StemExporterStems::_prepared )
+        return false;
+
+    std::vector<stem>& stems = StemExporterStems::_stems;
+    size_t amount = stems.size();
+
+    stems.erase( std::remove_if( stems.begin(), stems.end(), [ group ]( const stem& s ) {
+        return s.group == group;
+    }), stems.end());
+
+    return stems.size() != amount;
+}
+
+int StemExporter::getAmountOfStems()
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+    return ( int ) StemExporterStems::_stems.size();
+}
+
+void StemExporter::clear()
+{
+    finish();
+
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+    StemExporterStems::_stems.clear();
+}
+
+bool StemExporter::prepare( int chunkSize )
+{
+    finish();
+
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( StemExporterStems::_stems.empty())
+        return false;
+
+    // the stems are written while bouncing, as such the writers wait for
+    // storage rather than discarding audio when their ring buffer is full
+
+    for ( stem& s : StemExporterStems::_stems ) {
+        s.writer = new WaveStreamWriter();
+        s.writer->open( s.outputFile, chunkSize, AudioEngineProps::OUTPUT_CHANNELS, true );
+    }
+
+    if ( StemExporterStems::_mixBuffer == nullptr )
+        StemExporterStems::_mixBuffer = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, AudioEngineProps::BUFFER_SIZE );
+
+    StemExporterStems::_prepared = true;
+    StemExporterStems::_exporting.store( true );
+
+    return true;
+}
+
+bool StemExporter::finish()
+{
+    std::lock_guard<std::mutex> guard( StemExporterStems::_mutex );
+
+    if ( !StemExporterStems::_prepared )
+        return false;
+
+    // stop the render thread from writing and wait for a write that is in progress to complete
+    // before the writers are disposed
+
+    stop();
+
+    while ( StemExporterStems::_activeWrites.load() > 0 )
+        std::this_thread::yield();
+
+    StemExporterStems::_prepared = false;
+
+    for ( stem& s : StemExporterStems::_stems ) {
+        s.writer->close();
+        delete s.writer;
+        s.writer = nullptr;
+    }
+
+    delete StemExporterStems::_mixBuffer;
+    StemExporterStems::_mixBuffer = nullptr;
+
+    return true;
+}
+
+void StemExporter::stop()
+{
+    StemExporterStems::_exporting.store( false );
+}
+
+bool StemExporter::isExporting()
+{
+    return StemExporterStems::_exporting.load();
+}
+
+void StemExporter::writeChannel( AudioChannel* channel, AudioBuffer* buffer, int amountOfSamples, bool preChain, SAMPLE_TYPE volume )
+{
+    if ( !beginWrite())
+        return;
+
+    AudioBuffer* mixBuffer = StemExporterStems::_mixBuffer;
+    bool mixed = false;
+
+    for ( stem& s : StemExporterStems::_stems )
+    {
+        if ( s.channel != channel || s.preChain != preChain )
+            continue;
+
+        if ( preChain ) {
+            s.writer->write( buffer, amountOfSamples );
+            continue;
+        }
+
+        // post chain, apply the channels volume and panning as applied when mixing into the output
+
+        if ( !mixed ) {
+            mixBuffer->silenceBuffers();
+            channel->mixBuffer( mixBuffer, ( float ) volume );
+            mixed = true;
+        }
+        s.writer->write( mixBuffer, amountOfSamples );
+    }
+    endWrite();
+}
+
+void StemExporter::writeGroup( ChannelGroup* group, AudioBuffer* buffer, int amountOfSamples, bool preChain, SAMPLE_TYPE volume )
+{
+    if ( !beginWrite())
+        return;
+
+    AudioBuffer* mixBuffer = StemExporterStems::_mixBuffer;
+    bool mixed = false;
+
+    for ( stem& s : StemExporterStems::_stems )
+    {
+        if ( s.group != group || s.preChain != preChain )
+            continue;
+
+        if ( preChain ) {
+            s.writer->write( buffer, amountOfSamples );
+            continue;
+        }
+
+        // post chain, apply the groups volume as applied when mixing into the output
+
+        if ( !mixed ) {
+            mixBuffer->silenceBuffers();
+            mixBuffer->mergeBuffers( buffer, 0, 0, ( float ) volume );
+            mixed = true;
+        }
+        s.writer->write( mixBuffer, amountOfSamples );
+    }
+    endWrite();
+}
+
+} // E.O namespace MWEngine
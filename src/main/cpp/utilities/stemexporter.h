@@ -0,0 +1,114 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__STEMEXPORTER_H_INCLUDED__
+#define __MWENGINE__STEMEXPORTER_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "audiochannel.h"
+#include "channelgroup.h"
+#include "wavestreamwriter.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MWEngine {
+
+#ifndef SWIG
+// a single AudioChannel or ChannelGroup output written into its own file
+
+typedef struct
+{
+    AudioChannel* channel;
+    ChannelGroup* group;
+    bool preChain;
+    std::string outputFile;
+    WaveStreamWriter* writer;
+} stem;
+#endif
+
+/**
+ * StemExporter writes the output of individual AudioChannels and ChannelGroups into
+ * separate WAV files while bouncing (see SequencerController::setBounceState()), alongside
+ * the master output. This allows exporting all stems of a song in a single render pass.
+ *
+ * Stems are tapped either pre chain (the dry output, prior to applying the processing chain,
+ * volume and panning) or post chain (as mixed into the output). Each stem is streamed
+ * onto storage by its own WaveStreamWriter.
+ *
+ * Stems can only be registered / removed while no bounce is in progress and should
+ * be removed prior to disposing their AudioChannel / ChannelGroup.
+ *
+ * The output files are opened and finalized outside of the render thread (see prepare() and
+ * finish()), the render thread merely writes into the stems and stops writing by means of stop().
+ */
+class StemExporter
+{
+    public:
+        static bool addChannel( AudioChannel* channel, std::string outputFile, bool preChain );
+        static bool addGroup( ChannelGroup* group, std::string outputFile, bool preChain );
+        static bool removeChannel( AudioChannel* channel );
+        static bool removeGroup( ChannelGroup* group );
+        static int getAmountOfStems();
+        static void clear();
+
+#ifndef SWIG
+        // open the output files of all registered stems, chunkSize describes the size (in sample frames)
+        // of the ring buffer of each writer. Returns false when there are no stems to export
+
+        static bool prepare( int chunkSize );
+
+        // complete the export, finalizing all output files. Waits for the render thread to complete
+        // a write that is in progress, as such this should not be invoked by the render thread
+        // Returns false when there was no export to finish (e.g. safe to invoke repeatedly)
+
+        static bool finish();
+
+        // render thread : stops writing into the stems (e.g. when the bounce has completed)
+        // the output files are finalized once finish() is invoked
+
+        static void stop();
+
+        static bool isExporting();
+
+        // invoked by the engine during the render cycle for each AudioChannel / ChannelGroup
+        // volume describes the mix volume applied when writing post chain
+
+        static void writeChannel( AudioChannel* channel, AudioBuffer* buffer, int amountOfSamples, bool preChain, SAMPLE_TYPE volume );
+        static void writeGroup( ChannelGroup* group, AudioBuffer* buffer, int amountOfSamples, bool preChain, SAMPLE_TYPE volume );
+#endif
+};
+
+namespace StemExporterStems
+{
+    extern std::vector<stem> _stems;
+    extern AudioBuffer* _mixBuffer;
+    extern std::atomic<bool> _exporting; // whether the render thread writes into the stems
+    extern std::atomic<int> _activeWrites; // amount of writes in progress on the render thread
+    extern bool _prepared;               // whether the output files are open
+    extern std::mutex _mutex;            // guards the registered stems against concurrent (de)registration
+}
+
+} // E.O namespace MWEngine
+
+#endif
@@ -23,49 +23,99 @@
 #include "wavereader.h"
 #include "../global.h"
 #include "debug.h"
-#include "utils.h"
-#include <stdio.h>
-#include <stdlib.h>
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace MWEngine {
 
 /**
- * structs used to parse WAV file headers
- * see http://soundfile.sapp.org/doc/WaveFormat/
+ * WAV format codes
+ * see http://soundfile.sapp.org/doc/WaveFormat/ and
+ * https://docs.microsoft.com/en-us/windows/win32/api/mmreg/ns-mmreg-waveformatextensible
  */
-struct wav_header
-{
-    char fileType[4];           // "RIFF" = 0x46464952
-    UINT32 fileSize;            // in bytes
-    char format[4];             // "WAVE" = 0x45564157
-    char formatName[4];         // "fmt " = 0x20746D66
-    UINT32 formatLength;
-    INT16 audioFormat;          // 1 == PCM, 3 == IEEE float, 6 = A-law, 7 = µ-law
-    INT16 amountOfChannels;
-    UINT32 sampleRate;
-    UINT32 bytesPerSecond;
-    INT16 blockAlign;
-    INT16 bitsPerSample;
-};
-
-struct wav_header_data_chunk
-{
-    char ID[4];         // "data" = 0x61746164
-    UINT32 size;
-};
+static const uint16_t WAVE_FORMAT_PCM        = 0x0001;
+static const uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static const uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// amount of frames converted per iteration, keeps the source data in cache
+// while deinterleaving all channels
+
+static const int DECODE_BLOCK_SIZE = 4096;
 
 /* internal methods */
 
+// note that RIFF files are little endian
+
+inline uint16_t readUInt16( const char* data )
+{
+    const unsigned char* bytes = ( const unsigned char* ) data;
+    return ( uint16_t )( bytes[ 0 ] | ( bytes[ 1 ] << 8 ));
+}
+
+inline uint32_t readUInt32( const char* data )
+{
+    const unsigned char* bytes = ( const unsigned char* ) data;
+    return ( uint32_t ) bytes[ 0 ] | (( uint32_t ) bytes[ 1 ] << 8 ) |
+           (( uint32_t ) bytes[ 2 ] << 16 ) | (( uint32_t ) bytes[ 3 ] << 24 );
+}
+
+/**
+ * deinterleave kernels, these convert the interleaved sample data into the
+ * channel buffers of given AudioBufferView. Data is processed in blocks where each
+ * channel is written contiguously so the compiler can vectorize the conversion.
+ * Source samples are read using memcpy as the data is not guaranteed to be aligned.
+ */
 template <typename T>
-inline void convert( T, AudioBuffer* buffer, FILE* fp, int sampleSize, SAMPLE_TYPE maxValue )
+inline void deinterleave( const char* data, size_t stride, AudioBufferView& output, SAMPLE_TYPE bias, SAMPLE_TYPE scale )
 {
-    T input;
-    for ( int i = 0; i < buffer->bufferSize; ++i )
+    int amountOfChannels = output.amountOfChannels;
+    int amount           = output.bufferSize;
+
+    for ( int start = 0; start < amount; start += DECODE_BLOCK_SIZE )
     {
-        for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
-            fread( &input, ( size_t ) sampleSize, 1, fp );
-            buffer->getBufferForChannel( c )[ i ] = (( SAMPLE_TYPE ) input ) / maxValue;
+        int end = std::min( start + DECODE_BLOCK_SIZE, amount );
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* channelBuffer = output.getBufferForChannel( c );
+            const char* input          = data + start * stride + c * sizeof( T );
+
+            for ( int i = start; i < end; ++i, input += stride ) {
+                T value;
+                memcpy( &value, input, sizeof( T ));
+                channelBuffer[ i ] = (( SAMPLE_TYPE ) value + bias ) * scale;
+            }
+        }
+    }
+}
+
+// 24-bit samples have no native data type, the three bytes are shifted into
+// the upper bits of a 32-bit integer so its sign is preserved
+
+inline void deinterleavePCM24( const char* data, size_t stride, AudioBufferView& output )
+{
+    int amountOfChannels = output.amountOfChannels;
+    int amount           = output.bufferSize;
+    SAMPLE_TYPE scale    = 1.0 / 8388607.0;
+
+    for ( int start = 0; start < amount; start += DECODE_BLOCK_SIZE )
+    {
+        int end = std::min( start + DECODE_BLOCK_SIZE, amount );
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* channelBuffer = output.getBufferForChannel( c );
+            const unsigned char* input = ( const unsigned char* ) data + start * stride + c * 3;
+
+            for ( int i = start; i < end; ++i, input += stride ) {
+                int32_t value = ( int32_t )(( uint32_t ) input[ 0 ] << 8 | ( uint32_t ) input[ 1 ] << 16 | ( uint32_t ) input[ 2 ] << 24 ) >> 8;
+                channelBuffer[ i ] = ( SAMPLE_TYPE ) value * scale;
+            }
         }
     }
 }
@@ -74,157 +124,55 @@ inline void convert( T, AudioBuffer* buffer, FILE* fp, int sampleSize, SAMPLE_TY
 
 waveFile WaveReader::fileToBuffer( std::string inputFile )
 {
-    FILE* fp;
     waveFile out = { ( unsigned int ) AudioEngineProps::SAMPLE_RATE, nullptr };
 
-    fp = fopen( inputFile.c_str(), "rb" );
+    int fd = open( inputFile.c_str(), O_RDONLY );
 
-    if ( !fp ) {
+    if ( fd < 0 ) {
         Debug::log( "WaveReader::Error could not open file '%s'", inputFile.c_str() );
         return out;
     }
 
-    // get the WAV file properties
-
-    wav_header header;
-    fread( &header, sizeof( header ), 1, fp );
-
-    // validate the WAV file header data
+    struct stat fileInfo;
 
-    if ( !strstr( header.fileType,   "RIFF" ) ||
-         !strstr( header.format,     "WAVE" ) ||
-         !strstr( header.formatName, "fmt " )) // yes, the trailing space belongs in there!
-    {
-        Debug::log( "WaveReader::Error not a valid WAVE file" );
+    if ( fstat( fd, &fileInfo ) != 0 || fileInfo.st_size <= 0 ) {
+        Debug::log( "WaveReader::Error could not determine size of file '%s'", inputFile.c_str() );
+        close( fd );
         return out;
     }
 
-#ifdef DEBUG
+    size_t length = ( size_t ) fileInfo.st_size;
 
+#ifdef DEBUG
     Debug::log( "About to parse data for WAV file '%s'", inputFile.c_str() );
-    Debug::log( "File size        : %d", header.fileSize );
-    Debug::log( "Audio format     : %d", header.audioFormat );
-    Debug::log( "Channel amount   : %d", header.amountOfChannels );
-    Debug::log( "Sample rate      : %d", header.sampleRate );
-    Debug::log( "Bytes per second : %d", header.bytesPerSecond );
-    Debug::log( "Block align      : %d", header.blockAlign );
-    Debug::log( "Bits per sample  : %d", header.bitsPerSample );
-
 #endif
 
-    // the data chunk can be offset in case the WAV file contains
-    // meta data, seek for the data definition
+    // map the file into memory so the sample data can be converted without intermediate copies
 
-    wav_header_data_chunk dataChunk;
+    void* data = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
 
-    while ( true )
+    if ( data != MAP_FAILED )
     {
-        fread( &dataChunk, sizeof( dataChunk ), 1, fp );
-
-        if ( *( unsigned int* ) &dataChunk.ID == 0x61746164 )
-            break;
-
-        // skip chunk data bytes
-
-        if ( dataChunk.size > header.fileSize ) {
-
-            // unless this occurs; when the reported data chunk size exceeds the fileSize reported
-            // by the header, this is a clear indication that we're dealing with a corrupted file
-            // header. "Rewind" fread position and attempt to read file by assuming next chunk
-            // is data (in other words: assume no metadata is present in the header)
-
-            Debug::log( "WaveReader::Warning data chunk parsing failure. Assuming header corruption, attempting to read data as-is" );
-
-            fseek( fp, -( sizeof dataChunk ), SEEK_CUR );
-
-            fread( dataChunk.ID,    sizeof( char ), 4, fp );
-            fread( &dataChunk.size, sizeof( unsigned int ), 1, fp );
-
-            break;
-        }
-        else {
-            fseek( fp, dataChunk.size, SEEK_CUR );
-        }
-
-        if ( feof( fp )) {
-            Debug::log( "WaveReader::Error could not find data chunk" );
-            return out;
-        }
-    }
-
-    unsigned int amountOfSamples = dataChunk.size * 8 / header.bitsPerSample;
-    unsigned int bufferSize      = amountOfSamples / header.amountOfChannels;
-
-    if ( amountOfSamples <= 0 ) {
-        Debug::log( "WaveReader::Error could not find sample data" );
-        return out;
+        madvise( data, length, MADV_SEQUENTIAL );
+        out = memoryToBuffer(( const char* ) data, length );
+        munmap( data, length );
     }
+    else
+    {
+        // memory mapping unavailable, read the file contents in a single block
 
-    int sampleSize = header.bitsPerSample / 8;
-    int i;
-
-    out.sampleRate = ( unsigned int ) header.sampleRate;
-    out.buffer     = new AudioBuffer( header.amountOfChannels, bufferSize );
-
-    // Read samples from WAV file and convert data into MWEngine AudioBuffer
-
-    switch ( header.bitsPerSample ) {
-        // by default we will treat files as 16-bit
-        default:
-            Debug::log( "WaveReader::Warning no support for %s-bit file. Treating as 16-bit", header.bitsPerSample );
-        // 16-bit
-        case 16:
-            convert(
-                ( short ) 0, out.buffer, fp, sampleSize,
-                ( SAMPLE_TYPE ) ( header.audioFormat == 3 ? 1 : 32767 )
-            );
-            break;
-
-        // 24-bit (via char array conversion as there is no 24-bit data type)
-        case 24:
-            unsigned char input[ 3 ];
-            long output;
-            for ( int i = 0; i < bufferSize; ++i )
-            {
-                for ( int c = 0; c < header.amountOfChannels; ++c ) {
-                    fread( &input, sizeof( char ), 3, fp );
-                    // note that RIFF files are little endian
-                    if ( input[ 2 ] & 0x80 ) {
-                        // value is negative
-                        output = ( 0xff << 24 ) | ( input[ 2 ] << 16 ) | ( input[ 1 ] << 8 ) | ( input[ 0 ] << 0 );
-                    } else {
-                        output = ( input[ 2 ] << 16 ) | ( input[ 1 ] << 8 ) | (input[ 0 ] << 0 );
-                    }
-                    out.buffer->getBufferForChannel( c )[ i ] = (( SAMPLE_TYPE ) output ) / 8388607.;
-                }
-            }
-            break;
-
-        // 32-bit
-        case 32:
-            convert(
-                ( float ) 0, out.buffer, fp, sampleSize,
-                ( SAMPLE_TYPE ) ( header.audioFormat == 3 ? 1 : 2147483647 )
-            );
-            break;
-
-        // 64-bit
-        case 64:
-            convert(
-                ( double ) 0, out.buffer, fp, sampleSize,
-                ( SAMPLE_TYPE ) ( header.audioFormat == 3 ? 1 : 9223372036854775807 )
-            );
-            break;
+        std::vector<char> bytes( length );
+        size_t bytesRead = 0;
 
-        // 8-bit (note: 8-bit WAV files are unsigned)
-        case 8:
-            convert(( unsigned char ) 0, out.buffer, fp, sampleSize, ( SAMPLE_TYPE ) 255 );
-            break;
+        while ( bytesRead < length ) {
+            ssize_t result = read( fd, bytes.data() + bytesRead, length - bytesRead );
+            if ( result <= 0 )
+                break;
+            bytesRead += ( size_t ) result;
+        }
+        out = memoryToBuffer( bytes.data(), bytesRead );
     }
-
-    // free allocated resources
-
-    fclose( fp );
+    close( fd );
 
     return out;
 }
@@ -254,77 +202,192 @@ WaveTable* WaveReader::fileToTable( std::string inputFile )
 
 waveFile WaveReader::byteArrayToBuffer( const std::vector<char>& byteArray )
 {
-    // TODO: this mostly mirrors the fileToBuffer-method, clean this up!
+    return memoryToBuffer( byteArray.data(), byteArray.size() );
+}
 
-    AudioBuffer* buffer = nullptr;
+waveFile WaveReader::memoryToBuffer( const char* data, size_t length )
+{
+    waveFile out = { ( unsigned int ) AudioEngineProps::SAMPLE_RATE, nullptr };
+    waveFormat format;
+
+    if ( !parseFormat( data, length, length, format ))
+        return out;
 
-    // first we'll check the necessary headers identifying the WAV file
+    out.sampleRate = format.sampleRate;
+    out.buffer     = new AudioBuffer( format.amountOfChannels, format.bufferSize );
 
-    char id[ 5 ];
-    short* temp_buffer;
-    short amountOfChannels;
-    unsigned long format, sampleRate, dataSize;
-    size_t i, l, w;
+    decode( data + format.dataOffset, format, out.buffer, 0, format.bufferSize );
 
-    sliceString( byteArray, id, 0, 4 );
-    id[ 4 ] = '\0';
+    return out;
+}
 
-    if ( !strcmp( id, "RIFF" ))
+bool WaveReader::parseFormat( const char* data, size_t length, size_t fileSize, waveFormat& format )
+{
+    // validate the WAV file header data
+
+    if ( length < 12 || memcmp( data, "RIFF", 4 ) != 0 || memcmp( data + 8, "WAVE", 4 ) != 0 ) {
+        Debug::log( "WaveReader::Error not a valid WAVE file" );
+        return false;
+    }
+
+    uint16_t audioFormat      = 0;
+    uint16_t amountOfChannels = 0;
+    uint16_t blockAlign       = 0;
+    uint16_t bitsPerSample    = 0;
+    uint32_t sampleRate       = 0;
+    bool hasFormat            = false;
+    bool hasData              = false;
+
+    size_t dataSize = 0;
+    size_t offset   = 12;
+
+    // walk through the chunks, the data chunk can be preceded by any amount of chunks
+    // containing meta data and can even precede the format chunk, in which case the
+    // walk continues until the format chunk has been found
+
+    while ( offset + 8 <= length )
     {
-        sliceString( byteArray, id, 8, 4 );
-        id[ 4 ] = '\0';
+        const char* chunk  = data + offset;
+        uint32_t chunkSize = readUInt32( chunk + 4 );
+        size_t available   = length - ( offset + 8 );
+        size_t remaining   = fileSize - ( offset + 8 );
 
-        if ( !strcmp( id, "WAVE" ))
+        if ( memcmp( chunk, "fmt ", 4 ) == 0 && chunkSize >= 16 && available >= 16 )
         {
-            // read the header data (see http://soundfile.sapp.org/doc/WaveFormat/)
+            audioFormat      = readUInt16( chunk + 8 );
+            amountOfChannels = readUInt16( chunk + 10 );
+            sampleRate       = readUInt32( chunk + 12 );
+            blockAlign       = readUInt16( chunk + 20 );
+            bitsPerSample    = readUInt16( chunk + 22 );
+            hasFormat        = true;
+
+            // WAVE_FORMAT_EXTENSIBLE describes the actual format in the first
+            // two bytes of its SubFormat GUID (at offset 24 within the chunk data)
+
+            if ( audioFormat == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40 && available >= 40 )
+                audioFormat = readUInt16( chunk + 32 );
+        }
+        else if ( memcmp( chunk, "data", 4 ) == 0 )
+        {
+            // note the reported size can exceed the actual size for truncated
+            // files or files that were written as a stream (size is 0xFFFFFFFF)
 
-            format           = sliceLong( byteArray, 20, true );
-            amountOfChannels = ( short ) sliceLong( byteArray, 22, true );
-            sampleRate       = sliceLong( byteArray, 24, true );
-            dataSize         = sliceLong( byteArray, 40, true );
-            temp_buffer     = ( short* ) malloc( dataSize );
+            format.dataOffset = offset + 8;
+            dataSize          = std::min(( size_t ) chunkSize, remaining );
+            hasData           = true;
 
-            Debug::log("WaveReader::reading %d channels w/ %d samples @ %d Hz", amountOfChannels, dataSize, sampleRate );
+            if ( hasFormat )
+                break;
+        }
+        else if ( chunkSize > remaining && hasFormat )
+        {
+            // when the reported chunk size exceeds the file size, this is a clear indication that
+            // we're dealing with a corrupted file header. Attempt to read the chunk contents as data
 
-            // in Android NDK 26 reading of byte array is horribly broken...
+            Debug::log( "WaveReader::Warning data chunk parsing failure. Assuming header corruption, attempting to read data as-is" );
 
-            if ( dataSize <= 1 ) {
-                Debug::log( "WaveReader::Could not parse WAVE file" );
-                waveFile out = { ( unsigned int ) sampleRate, buffer };
-                return out;
-            }
+            format.dataOffset = offset + 8;
+            dataSize          = remaining;
+            hasData           = true;
+            break;
+        }
+        // chunks are word aligned
+        offset += 8 + ( size_t ) chunkSize + ( chunkSize & 1 );
+    }
 
-            // 2 is sizeof short (16-bits, thus 2 bytes)
+    if ( !hasFormat || !hasData ) {
+        Debug::log( "WaveReader::Error could not find %s chunk", hasFormat ? "data" : "format" );
+        return false;
+    }
 
-            for ( i = 44, l = i + dataSize, w = 0; i < l; i += 2, ++w )
-                temp_buffer[ w ] = ( uint8_t ) byteArray[ i ] | (( uint8_t ) byteArray[ i + 1 ] << 8 );
+#ifdef DEBUG
 
-            unsigned long bufferSize = ( dataSize / sizeof( short )) / amountOfChannels;
+    Debug::log( "Audio format     : %d", audioFormat );
+    Debug::log( "Channel amount   : %d", amountOfChannels );
+    Debug::log( "Sample rate      : %d", sampleRate );
+    Debug::log( "Block align      : %d", blockAlign );
+    Debug::log( "Bits per sample  : %d", bitsPerSample );
 
-            buffer = new AudioBuffer( amountOfChannels, ( int ) bufferSize );
+#endif
 
-            // convert short values into SAMPLE_TYPE
+    int sampleSize = bitsPerSample / 8;
 
-            SAMPLE_TYPE MAX_VALUE = ( SAMPLE_TYPE ) 32767; // max size for either side of a signed short
+    if ( amountOfChannels == 0 || sampleSize == 0 ) {
+        Debug::log( "WaveReader::Error invalid format description" );
+        return false;
+    }
 
-            int cb = 0;
+    // some writers report an invalid block align, calculate it from the format when necessary
 
-            for ( i = 0; i < bufferSize; ++i, cb += amountOfChannels )
-            {
-                for ( int c = 0; c < amountOfChannels; ++c )
-                    buffer->getBufferForChannel( c )[ i ] = ( SAMPLE_TYPE )( temp_buffer[ cb + c ]) / MAX_VALUE;
-            }
-            free( temp_buffer );
-        }
-        else
-            Debug::log( "WaveReader::Error not a valid WAVE file" );
+    if ( blockAlign < amountOfChannels * sampleSize )
+        blockAlign = ( uint16_t )( amountOfChannels * sampleSize );
+
+    format.bufferSize = ( int )( dataSize / blockAlign );
+
+    if ( format.bufferSize <= 0 ) {
+        Debug::log( "WaveReader::Error could not find sample data" );
+        return false;
     }
-    else
-        Debug::log( "WaveReader::Error not a valid WAVE file (no RIFF header)" );
 
-    waveFile out = { ( unsigned int ) sampleRate, buffer };
+    bool isFloat = ( audioFormat == WAVE_FORMAT_IEEE_FLOAT );
 
-    return out;
+    if ( !isFloat && audioFormat != WAVE_FORMAT_PCM ) {
+        Debug::log( "WaveReader::Error no support for audio format %d", audioFormat );
+        return false;
+    }
+
+    // 8, 16, 24 and 32-bit integers and 32 and 64-bit floating point values are supported
+
+    bool supported = isFloat ? ( bitsPerSample == 32 || bitsPerSample == 64 ) :
+                     ( bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32 );
+
+    if ( !supported ) {
+        Debug::log( "WaveReader::Error no support for %d-bit file", bitsPerSample );
+        return false;
+    }
+
+    format.audioFormat      = audioFormat;
+    format.amountOfChannels = amountOfChannels;
+    format.sampleRate       = sampleRate;
+    format.bitsPerSample    = bitsPerSample;
+    format.blockAlign       = blockAlign;
+
+    return true;
+}
+
+void WaveReader::decode( const char* data, const waveFormat& format, AudioBuffer* buffer, int bufferOffset, int amount )
+{
+    // convert sample data into the given range of the MWEngine AudioBuffer
+
+    AudioBufferView output( buffer, bufferOffset, amount );
+    size_t stride = format.blockAlign;
+
+    switch ( format.bitsPerSample )
+    {
+        // 8-bit (note: 8-bit WAV files are unsigned)
+        case 8:
+            deinterleave<uint8_t>( data, stride, output, -128.0, 1.0 / 128.0 );
+            break;
+
+        case 16:
+            deinterleave<int16_t>( data, stride, output, 0.0, 1.0 / 32767.0 );
+            break;
+
+        case 24:
+            deinterleavePCM24( data, stride, output );
+            break;
+
+        case 32:
+            if ( format.audioFormat == WAVE_FORMAT_IEEE_FLOAT )
+                deinterleave<float>( data, stride, output, 0.0, 1.0 );
+            else
+                deinterleave<int32_t>( data, stride, output, 0.0, 1.0 / 2147483647.0 );
+            break;
+
+        case 64:
+            deinterleave<double>( data, stride, output, 0.0, 1.0 );
+            break;
+    }
 }
 
 } // E.O namespace MWEngine
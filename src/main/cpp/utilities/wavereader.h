@@ -20,9 +20,13 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#ifndef __MWENGINE__WAVEREADER_H_INCLUDED__
+#define __MWENGINE__WAVEREADER_H_INCLUDED__
+
 #include "../audiobuffer.h"
 #include "../wavetable.h"
 #include <string>
+#include <vector>
 
 namespace MWEngine {
 
@@ -32,6 +36,19 @@ typedef struct
    AudioBuffer* buffer;
 } waveFile;
 
+// describes the format and location of the sample data inside a WAV file
+
+typedef struct
+{
+    unsigned int audioFormat;      // PCM or IEEE float (extensible formats are resolved to either)
+    unsigned int amountOfChannels;
+    unsigned int sampleRate;
+    unsigned int bitsPerSample;
+    unsigned int blockAlign;       // size (in bytes) of a single sample frame
+    size_t dataOffset;             // offset (in bytes) of the sample data relative to the file start
+    int bufferSize;                // amount of sample frames in the file
+} waveFormat;
+
 class WaveReader
 {
     public:
@@ -50,6 +67,31 @@ class WaveReader
 
         static WaveTable* fileToTable( std::string inputFile );
 
+        // reads the WAV data from given byte array, see memoryToBuffer()
+
         static waveFile byteArrayToBuffer( const std::vector<char>& byteArray );
+
+        // parses the WAV file contents at given memory location and returns an
+        // AudioBuffer representing the files sample data. Supports 8, 16, 24 and 32-bit PCM,
+        // 32 and 64-bit floating point and WAVE_FORMAT_EXTENSIBLE files. The
+        // sample data is converted directly from given memory (no intermediate copies).
+        // NOTE : if the data does not describe a valid WAV file a null pointer is returned
+        // for the waveFile buffer
+
+        static waveFile memoryToBuffer( const char* data, size_t length );
+
+        // parses the WAV header at given memory location into given waveFormat. Given data
+        // only needs to contain the header chunks, fileSize describes the size of the entire file
+        // (used to determine the amount of available sample frames). Returns false when the data
+        // does not describe a valid, supported WAV file
+
+        static bool parseFormat( const char* data, size_t length, size_t fileSize, waveFormat& format );
+
+        // converts the interleaved sample data at given memory location (described by given format)
+        // into the channels of given AudioBuffer, writing amount frames starting at given bufferOffset
+
+        static void decode( const char* data, const waveFormat& format, AudioBuffer* buffer, int bufferOffset, int amount );
 };
 } // E.O namespace MWEngine
+
+#endif
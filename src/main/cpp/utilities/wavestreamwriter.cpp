@@ -0,0 +1,302 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "wavestreamwriter.h"
+#include "wavewriter.h"
+#include <algorithm>
+#include <chrono>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+WaveStreamWriter::WaveStreamWriter() :
+    _writtenBytes( 0 ), _ringBuffer( nullptr ), _ringBufferSize( 0 ), _readIndex( 0 ), _writeIndex( 0 ),
+    _droppedFrames( 0 ), _amountOfChannels( 1 ), _writeInterval( 1 ), _blocking( false ), _open( false ), _writing( false ),
+    _drainRequested( false ), _activeWrites( 0 )
+{
+
+}
+
+WaveStreamWriter::~WaveStreamWriter()
+{
+    close();
+    delete[] _ringBuffer;
+}
+
+/* public methods */
+
+bool WaveStreamWriter::open( std::string outputFile, int ringBufferSize, int amountOfChannels, bool blocking )
+{
+    // complete a stream that is still in progress
+
+    if ( _open )
+        close();
+
+    // a producing thread can no longer be writing into the ring buffer (as the stream is closed)
+    // wait for a write that was still in progress so the ring buffer can safely be replaced
+
+    waitForWrites();
+
+    _amountOfChannels = amountOfChannels;
+    _blocking         = blocking;
+
+    // the header is written with an empty data size, which is
+    // updated once the size of the full recording is known
+
+    _outputStream = WaveWriter::createWAVStream(
+        outputFile.c_str(), 0, AudioEngineProps::SAMPLE_RATE, _amountOfChannels
+    );
+
+    if ( !_outputStream.is_open())
+        return false;
+
+    // the ring buffer is only reallocated when its size changes
+
+    int frames  = std::max( ringBufferSize, ( int ) AudioEngineProps::BUFFER_SIZE );
+    size_t size = ( size_t ) frames * _amountOfChannels;
+
+    if ( size != _ringBufferSize )
+    {
+        delete[] _ringBuffer;
+        _ringBuffer     = new INT16[ size ];
+        _ringBufferSize = size;
+    }
+
+    // drain the ring buffer at (at most) a quarter of its duration so the producing thread
+    // can continue enqueuing while the writer thread is appending to the output file
+
+    _writeInterval = std::min( 250, std::max( 1, ( int )(( frames * 1000L ) / AudioEngineProps::SAMPLE_RATE / 4 )));
+    _writtenBytes  = 0;
+
+    _readIndex.store( 0 );
+    _writeIndex.store( 0 );
+    _droppedFrames.store( 0 );
+
+    _writing      = true;
+    _writerThread = std::thread( &WaveStreamWriter::writerLoop, this );
+
+    _open = true;
+
+    return true;
+}
+
+bool WaveStreamWriter::close()
+{
+    if ( !_open )
+        return false;
+
+    _open = false;
+
+    // wait for the producing thread to complete a write that is in progress (the writer
+    // thread is still running, so a write blocking on free space in the ring buffer can complete)
+
+    waitForWrites();
+
+    // stop the writer thread, which appends all remaining
+    // audio in the ring buffer before exiting
+
+    {
+        std::lock_guard<std::mutex> guard( _writerMutex );
+        _writing = false;
+    }
+    _writerCondition.notify_one();
+
+    if ( _writerThread.joinable())
+        _writerThread.join();
+
+    WaveWriter::updateWAVHeader( _outputStream, _writtenBytes );
+    _outputStream.close();
+
+    return true;
+}
+
+bool WaveStreamWriter::isOpen()
+{
+    return _open;
+}
+
+void WaveStreamWriter::write( AudioBuffer* aBuffer, int amountOfSamples )
+{
+    if ( !beginWrite())
+        return;
+
+    int maxChannelIndex  = aBuffer->amountOfChannels - 1;
+    size_t amountToWrite = ( size_t ) amountOfSamples * _amountOfChannels;
+
+    if ( !reserveSpace( amountToWrite )) {
+        endWrite();
+        return;
+    }
+
+    size_t position = _writeIndex.load( std::memory_order_relaxed ) % _ringBufferSize;
+
+    for ( int i = 0; i < amountOfSamples; ++i )
+    {
+        for ( int c = 0; c < _amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE sample = aBuffer->getBufferForChannel( std::min( c, maxChannelIndex ))[ i ];
+            _ringBuffer[ position ] = ( INT16 )( std::min( 1.0, std::max( -1.0, ( double ) sample )) * 32767 );
+
+            if ( ++position == _ringBufferSize )
+                position = 0;
+        }
+    }
+    commitSamples( amountToWrite );
+    endWrite();
+}
+
+void WaveStreamWriter::write( float* aBuffer, int aBufferSize, int amountOfChannels )
+{
+    if ( !beginWrite())
+        return;
+
+    int maxChannelIndex  = amountOfChannels - 1;
+    size_t amountToWrite = ( size_t ) aBufferSize * _amountOfChannels;
+
+    if ( !reserveSpace( amountToWrite )) {
+        endWrite();
+        return;
+    }
+
+    size_t position = _writeIndex.load( std::memory_order_relaxed ) % _ringBufferSize;
+
+    for ( int i = 0, c = 0; i < aBufferSize; ++i, c += amountOfChannels )
+    {
+        for ( int ci = 0; ci < _amountOfChannels; ++ci )
+        {
+            float sample = aBuffer[ c + std::min( ci, maxChannelIndex ) ];
+            _ringBuffer[ position ] = ( INT16 )( std::min( 1.f, std::max( -1.f, sample )) * 32767 );
+
+            if ( ++position == _ringBufferSize )
+                position = 0;
+        }
+    }
+    commitSamples( amountToWrite );
+    endWrite();
+}
+
+size_t WaveStreamWriter::getDroppedFrames()
+{
+    return _droppedFrames.load();
+}
+
+/* protected methods */
+
+/**
+ * registers a write in progress, returns false when the stream isn't open. The stream
+ * state (e.g. the ring buffer) is not modified while a write is in progress as closing
+ * the stream awaits the completion of the write (see waitForWrites())
+ */
+bool WaveStreamWriter::beginWrite()
+{
+    _activeWrites.fetch_add( 1 );
+
+    if ( _open )
+        return true;
+
+    _activeWrites.fetch_sub( 1 );
+    return false;
+}
+
+void WaveStreamWriter::endWrite()
+{
+    _activeWrites.fetch_sub( 1 );
+}
+
+void WaveStreamWriter::waitForWrites()
+{
+    while ( _activeWrites.load() > 0 )
+        std::this_thread::yield();
+}
+
+void WaveStreamWriter::writerLoop()
+{
+    while ( _writing )
+    {
+        drainRingBuffer();
+
+        std::unique_lock<std::mutex> lock( _writerMutex );
+        _writerCondition.wait_for( lock, std::chrono::milliseconds( _writeInterval ), [ this ] { return !_writing || _drainRequested; });
+        _drainRequested = false;
+    }
+    drainRingBuffer();
+}
+
+/**
+ * appends all samples enqueued by the producing thread
+ * into the output file, executed by the writer thread
+ */
+void WaveStreamWriter::drainRingBuffer()
+{
+    size_t read    = _readIndex.load( std::memory_order_relaxed );
+    size_t written = _writeIndex.load( std::memory_order_acquire );
+
+    while ( read < written )
+    {
+        // write the contiguous range up until the end of the ring buffer
+
+        size_t position = read % _ringBufferSize;
+        size_t amount   = std::min( written - read, _ringBufferSize - position );
+
+        WaveWriter::appendBufferToStream( _outputStream, _ringBuffer + position, amount * sizeof( INT16 ));
+
+        read          += amount;
+        _writtenBytes += amount * sizeof( INT16 );
+
+        _readIndex.store( read, std::memory_order_release );
+    }
+}
+
+/**
+ * checks whether the ring buffer can hold given amount of samples, when this is not
+ * the case while blocking, we wake the writer thread and wait for it to free up
+ * space, otherwise the samples are discarded
+ */
+bool WaveStreamWriter::reserveSpace( size_t amountOfSamples )
+{
+    if ( amountOfSamples > _ringBufferSize ) {
+        _droppedFrames += amountOfSamples / _amountOfChannels;
+        return false;
+    }
+
+    size_t written = _writeIndex.load( std::memory_order_relaxed );
+
+    while ( _ringBufferSize - ( written - _readIndex.load( std::memory_order_acquire )) < amountOfSamples )
+    {
+        if ( !_blocking || !_writing ) {
+            _droppedFrames += amountOfSamples / _amountOfChannels;
+            return false;
+        }
+        _drainRequested = true;
+        _writerCondition.notify_one();
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void WaveStreamWriter::commitSamples( size_t amountOfSamples )
+{
+    _writeIndex.store( _writeIndex.load( std::memory_order_relaxed ) + amountOfSamples, std::memory_order_release );
+}
+
+} // E.O namespace MWEngine
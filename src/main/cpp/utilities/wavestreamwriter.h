@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__WAVESTREAMWRITER_H_INCLUDED__
+#define __MWENGINE__WAVESTREAMWRITER_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "audiosink.h"
+#include "global.h"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * WaveStreamWriter streams audio into a single PCM .WAV file on disk.
+ *
+ * The writing thread (e.g. the render thread) converts its audio to PCM and enqueues
+ * it into a lock-free single producer / single consumer ring buffer. A dedicated writer
+ * thread drains the ring buffer and appends its contents directly to the output file.
+ * The WAV header is patched with the final data size once the stream is closed.
+ * As such, memory usage is bounded by the ring buffer size regardless of the
+ * recording duration and no temporary files are written.
+ */
+namespace MWEngine {
+class WaveStreamWriter : public AudioSink
+{
+    public:
+        WaveStreamWriter();
+        ~WaveStreamWriter();
+
+        /**
+         * Opens given outputFile for writing. ringBufferSize describes the size (in sample
+         * frames) of the ring buffer that holds the written audio until the writer thread
+         * has appended it to the output file. When blocking, write() waits for the writer
+         * thread when the ring buffer is full (e.g. when bouncing, where no hardware deadline
+         * applies), otherwise audio that cannot be enqueued is discarded.
+         * Returns false when the file could not be opened.
+         */
+        bool open( std::string outputFile, int ringBufferSize, int amountOfChannels, bool blocking );
+
+        /**
+         * Waits for the writer thread to append all pending audio to the output
+         * file and finalizes the WAV header. Returns false when the stream wasn't open.
+         */
+        bool close();
+
+        bool isOpen();
+
+        /**
+         * Enqueue audio for writing. When given buffer has less channels than the output file,
+         * its last channel is duplicated onto the remaining channels. When it has more channels,
+         * the channels exceeding the amount of channels of the output file are omitted
+         */
+        void write( AudioBuffer* aBuffer, int amountOfSamples );
+        void write( float* aBuffer, int aBufferSize, int amountOfChannels );
+
+        /**
+         * Amount of sample frames that were discarded since opening the stream as the
+         * writer thread could not keep up with the producing thread (e.g. due to slow storage)
+         */
+        size_t getDroppedFrames();
+
+    protected:
+        std::ofstream _outputStream;
+        size_t _writtenBytes;          // size of the PCM data written into the output file
+
+        INT16* _ringBuffer;            // interleaved PCM samples awaiting write
+        size_t _ringBufferSize;        // size of the ring buffer (in samples)
+        std::atomic<size_t> _readIndex;  // total amount of samples read by the writer thread
+        std::atomic<size_t> _writeIndex; // total amount of samples enqueued by the producing thread
+        std::atomic<size_t> _droppedFrames;
+
+        int  _amountOfChannels;
+        int  _writeInterval;           // interval (in milliseconds) at which the writer thread drains the ring buffer
+        bool _blocking;
+
+        std::atomic<bool> _open;
+        std::atomic<bool> _writing;
+        std::atomic<bool> _drainRequested;   // whether the producing thread awaits free space in the ring buffer
+        std::atomic<int>  _activeWrites;     // amount of write() invocations in progress (see waitForWrites())
+
+        std::thread _writerThread;
+        std::mutex _writerMutex;
+        std::condition_variable _writerCondition;
+
+        bool beginWrite();
+        void endWrite();
+        void waitForWrites();
+        void writerLoop();
+        void drainRingBuffer();
+        bool reserveSpace( size_t amountOfSamples );
+        void commitSamples( size_t amountOfSamples );
+};
+} // E.O namespace MWEngine
+
+#endif
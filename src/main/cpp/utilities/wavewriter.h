@@ -69,6 +69,22 @@ class WaveWriter
             return stream;
         }
 
+        /**
+         * Updates the header of a stream created by createWAVStream() to describe
+         * given size of the written WAV data. This allows appending buffers
+         * into a stream when the final size is not known up front.
+         */
+        static void updateWAVHeader( std::ofstream& stream, size_t totalBufSize )
+        {
+            std::streampos position = stream.tellp();
+
+            stream.seekp( 4 );
+            t_streamwrite<UINT32>( stream, 36 + totalBufSize ); // file size
+            stream.seekp( 40 );
+            t_streamwrite<UINT32>( stream, totalBufSize );      // data size
+            stream.seekp( position );
+        }
+
         /**
          * Appends the contents of given buffer to given stream
          */
@@ -507,17 +507,6 @@ public final class MWEngineActivity extends Activity {
                     Log.d( LOG_TAG, "seq. position: " + sequencerPosition + ", buffer offset: " + aNotificationValue +
                             ", elapsed samples: " + elapsedSamples );
                     break;
-                case RECORDED_SNIPPET_READY:
-                    runOnUiThread( new Runnable() {
-                        public void run() {
-                            // we run the saving on a different thread to prevent buffer under runs while rendering audio
-                            _engine.saveRecordedSnippet( aNotificationValue ); // notification value == snippet buffer index
-                        }
-                    });
-                    break;
-                case RECORDED_SNIPPET_SAVED:
-                    Log.d( LOG_TAG, "Recorded snippet " + aNotificationValue + " saved to storage" );
-                    break;
             }
         }
     }
@@ -70,10 +70,12 @@ public final class MWEngine extends Thread
          * SEQUENCER_POSITION_UPDATED fired when Sequencer has advanced a step, payload describes
          *                            the precise buffer offset of the Sequencer when the notification fired
          *                            (as a value in the range of 0 - BUFFER_SIZE)
-         * RECORDED_SNIPPET_READY     fired when a recording snippet of the requested size is ready for
-         *                            writing onto storage, payload describes snippets buffer index (see DiskWriter)
-         * RECORDED_SNIPPET_SAVED     fired when snippet has been saved onto storage, payload describes snippets number
          * BOUNCE_COMPLETE            fired when the offline bouncing of the Sequencer range has completed
+         * OFFLINE_RENDER_PROGRESS    fired while rendering through AudioEngine.renderOffline(), payload describes the rendered percentage
+         * SAMPLE_LOAD_PROGRESS       fired when the SampleLoader has processed a file, payload describes the amount of processed files
+         * SAMPLE_LOAD_ERROR          fired when the SampleLoader could not read a file, payload describes the index of the file
+         * SAMPLE_LOAD_COMPLETE       fired when the SampleLoader has registered its samples in the SampleManager,
+         *                            payload describes the amount of registered samples
          */
         void handleNotification( int aNotificationId, int aNotificationValue );
     }
@@ -288,15 +290,15 @@ public final class MWEngine extends Thread
     /**
      * Records the audio coming in from the Android device input onto the Android
      * device's storage. Note this can also be done while the engine is running a sequence /
-     * synthesizing live events. Given outputFile will contain recorded .WAV data with a buffer length
-     * represented by given maxDurationInMilliSeconds
+     * synthesizing live events. Given outputFile will contain the recorded .WAV data
      *
      * Requires RECORD_DEVICE_INPUT to be enabled in global.h as well as the
      * appropriate permissions defined in the AndroidManifest and granted by the user at runtime.
      *
      * @param recordingActive {boolean} toggle the recording state on/off
      * @param outputFile {string} name of the WAV file to create and write the recording into
-     * @param maxDurationInMilliSeconds {int} the size (in milliseconds) of each individual written buffer
+     * @param maxDurationInMilliSeconds {int} the size (in milliseconds) of the buffer holding recorded audio
+     *                                   in memory until it has been written onto storage
      */
     public void setRecordFromDeviceInputState( boolean recordingActive, String outputFile, int maxDurationInMilliSeconds ) {
         int maxRecordBuffers = 0;
@@ -311,10 +313,10 @@ public final class MWEngine extends Thread
     }
 
     /**
-     * Invoke when RECORDED_SNIPPET_READY fires. This will write an in-memory audio recording
-     * snippet onto device storage. Execute as soon as notification as fired for continuous recording,
-     * invoke from a different thread than the audio rendering thread to prevent buffer under runs.
+     * @deprecated recordings are streamed onto device storage while recording, there
+     * are no longer snippets that require saving (RECORDED_SNIPPET_READY is no longer broadcast)
      */
+    @Deprecated
     public void saveRecordedSnippet( int snippetBufferIndex ) {
         _sequencerController.saveRecordedSnippet( snippetBufferIndex );
     }
@@ -447,7 +449,7 @@ public final class MWEngine extends Thread
     /* helper functions */
 
     private int calculateRecordingSnippetBufferSize() {
-        // we divide a recording into 15 second snippets (these are combined when recording finishes)
+        // recorded audio is buffered for up to 15 seconds while it is being written onto storage
         final double amountOfMinutes = .25;
 
         // convert milliseconds to sample buffer size